@@ -40,6 +40,7 @@
 #pragma message ("Build date: " __DATE__ " " __TIME__)
 
 #include "printf.h"
+#include "cmsis_os2.h"
 #include "sl_assert.h"
 #include "sl_memory_manager.h"
 #include "sl_memory_manager_region_config.h"
@@ -53,6 +54,13 @@
 #include "sl_wisun_version.h"
 
 #include "app.h"
+#include "app_tlv.h"
+#include "app_notify.h"
+#include "app_task_deadline.h"
+
+#if __has_include("app_action_scheduler.h")
+  #include "app_action_scheduler.h"
+#endif
 
 #if __has_include("app_list_configs.h")
   /* app_list_configs.c/.h can be added/removed from the project */
@@ -275,6 +283,65 @@
   #define CHIP SL_BOARD_NAME
 #endif
 
+// Status period used when auto_send_sec is 0
+#define APP_TASK_DEFAULT_STATUS_PERIOD_S 60
+
+// app_task() still needs to poll sockets opened in non-blocking mode
+#ifdef    APP_UDP_SERVER_H
+  #if (WITH_UDP_SERVER == SO_NONBLOCK)
+    #define APP_TASK_SOCKET_POLL_MSEC 10
+  #endif /* (WITH_UDP_SERVER == SO_NONBLOCK) */
+#endif /* APP_UDP_SERVER_H */
+#ifdef    APP_TCP_SERVER_H
+  #if (WITH_TCP_SERVER == SO_NONBLOCK)
+    #define APP_TASK_SOCKET_POLL_MSEC 10
+  #endif /* (WITH_TCP_SERVER == SO_NONBLOCK) */
+#endif /* APP_TCP_SERVER_H */
+
+// app_task() wake-up accounting, to compare FFN/LFN activity
+typedef struct {
+  uint32_t wakeups;           // number of app_task() wake-ups
+  uint32_t deadlines;         // wake-ups on timeout (status, heap, buttons, LEDs)
+  uint32_t send_asap_events;  // wake-ups on APP_TASK_EVENT_SEND_ASAP
+  uint32_t join_state_events; // wake-ups on APP_TASK_EVENT_JOIN_STATE
+  uint32_t socket_events;     // wake-ups on APP_TASK_EVENT_SOCKET
+  uint64_t busy_ticks;        // sleeptimer ticks spent in app_do_your_things()
+  uint64_t start_tick;        // reference sleeptimer tick
+} app_task_loop_stats_t;
+
+// Values computed once per status message, shared by the JSON and TLV encodings.
+// app_status_record() builds them from locals and the stats snapshot, as it's
+//  called by the CoAP handler thread, which shall not write app_task's globals
+typedef struct {
+  sl_wisun_join_state_t    join_state;
+  char                     parent_tag[8];
+  sl_wisun_neighbor_info_t parent_info;
+  uint32_t                 hop_count;
+  uint64_t status_sec;             // running time
+  uint64_t current_state_sec;      // time in the current (dis)connected state
+  uint64_t connected_total_sec;    // including the current connection
+  uint64_t disconnected_total_sec; // including the current disconnection
+  float    availability;
+} app_status_values_t;
+
+// Size and encoding time of the notification messages, per format
+typedef struct {
+  uint32_t count;
+  uint32_t bytes;
+  uint64_t ticks;
+} app_encoding_stats_t;
+
+typedef struct {
+  app_encoding_stats_t json;
+  app_encoding_stats_t tlv;
+  app_encoding_stats_t delta;   // status messages sent as keyframes or deltas
+  uint32_t keyframes;
+  uint32_t batch_samples;       // status samples added to batches
+  uint32_t batches;             // batch datagrams
+  uint64_t start_sec;           // reference for the per-hour rates
+  uint32_t em_ticks[3];         // power manager ticks in EM0/1/2 at reset
+} app_notification_stats_t;
+
 // -----------------------------------------------------------------------------
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
@@ -285,18 +352,27 @@ void        _check_neighbors(void);
 #endif /* APP_CHECK_NEIGHBORS_H */
 char*       _connection_json_string();
 char*       _status_json_string (char * start_text);
+void        _status_values(app_status_values_t *values, sl_wisun_join_state_t state);
+void        _status_values_from_globals(app_status_values_t *values);
+uint16_t    _status_tlv(uint8_t *buf, uint16_t size);
+void        _status_tlv_fields(app_tlv_writer_t *writer, const app_status_values_t *values);
+uint16_t    _connection_tlv(uint8_t *buf, uint16_t size);
+void        _encoding_stats_add(app_encoding_stats_t *stats, uint16_t len, uint64_t start_tick);
+char*       _mac_to_str(const sl_wisun_mac_address_t *mac, char *str);
 char        device_mac_string[40];
 sl_wisun_network_info_t network_info;
 sl_wisun_mac_address_t _get_parent_mac_address_and_update_parent_info(void);
 sl_status_t _select_destinations(void);
 sl_status_t _open_udp_sockets(void);
-
-#ifdef    SL_WISUN_COAP_H
-sl_status_t _coap_notify(char* json_string);
-#endif /* SL_WISUN_COAP_H */
+uint32_t    _status_period_sec(void);
+uint32_t    _msec_to_next_deadline(void);
 
 uint8_t print_and_send_messages (char *in_msg, bool _with_time,
                             bool _to_console, bool _to_rtt, bool _to_udp, bool _to_coap);
+uint8_t print_and_send_notification (uint8_t msg_type, char *json_msg, bool _with_time,
+                            bool _to_console, bool _to_rtt, bool _to_udp, bool _to_coap);
+uint8_t _batch_status(const uint8_t *record, uint16_t record_len, bool _to_udp, bool _to_coap);
+uint8_t _batch_flush(bool _to_udp, bool _to_coap);
 
 // -----------------------------------------------------------------------------
 //                                Global Variables
@@ -321,13 +397,23 @@ uint64_t connected_delay_sec;
 uint64_t next_status_sec;
 uint16_t loop;
 
+// app_task() event flags, set by app_task_notify()
+osEventFlagsId_t app_task_flags = NULL;
+app_task_loop_stats_t app_task_loop_stats;
+
 #ifdef    APP_TRACK_HEAP
 sl_memory_heap_info_t app_heap_info;
 #define APP_TRACK_HEAP_PERIOD_S  5 //second
  #ifdef    APP_TRACK_HEAP_DIFF
 size_t app_previous_heap_free;
  #endif /* APP_TRACK_HEAP_DIFF */
-bool   refresh_heap;
+void   _heap_sample(void);
+ #ifdef    APP_ACTION_SCHEDULER_H
+void   _heap_sample_start(void);
+static uint32_t app_scheduler_heap_sample_cb(void *context);
+ #else  /* APP_ACTION_SCHEDULER_H */
+uint64_t next_heap_sec;
+ #endif /* APP_ACTION_SCHEDULER_H */
 #endif /* APP_TRACK_HEAP */
 
 bool time_to_send_status = true;
@@ -381,9 +467,6 @@ char  coap_notification_ipv6_string[40];
 sl_wisun_socket_id_t udp_notification_socket_id = 0;
 sl_wisun_socket_id_t coap_notification_socket_id = 0;
 
-char udp_msg[1024];
-char coap_msg[1024];
-
 uint8_t  trace_level = SL_WISUN_TRACE_LEVEL_INFO;    // Trace level for all trace groups
 
 // UDP ports
@@ -392,33 +475,26 @@ uint8_t  trace_level = SL_WISUN_TRACE_LEVEL_INFO;    // Trace level for all trac
 
 #define SL_WISUN_STATUS_CONNECTION_URI_PATH  "/status/connection"
 #define SL_WISUN_STATUS_JSON_STR_MAX_LEN 512
+#define SL_WISUN_STATUS_TLV_MAX_LEN      256
+
+uint8_t tlv_msg[SL_WISUN_STATUS_TLV_MAX_LEN];
+uint8_t tlv_delta_msg[SL_WISUN_STATUS_TLV_MAX_LEN];
+app_tlv_delta_t status_delta;
+app_notification_stats_t app_notification_stats;
+
+// Status batch: samples are added to the batch datagram as they come
+#define APP_BATCH_MAX_LEN   SL_WISUN_STATUS_JSON_STR_MAX_LEN
+uint8_t batch_msg[APP_BATCH_MAX_LEN];
+app_tlv_batch_t status_batch;
+bool batch_asap;                     // send_asap also flushes the batch
 
 #ifdef    SL_SIMPLE_BUTTON_INSTANCES_H
   bool B0;
   bool B1;
-  bool check_buttons;
+  uint64_t next_button_sec;
   #define BUTTON_CHECK_DELAY 2
 #endif /* SL_SIMPLE_BUTTON_INSTANCES_H */
 
-// CoAP Notification channel structure definition
-#ifdef   SL_WISUN_COAP_H
-typedef struct sl_wisun_coap_notify_ch {
-  /// Notification socket
-  int32_t sockid;
-  /// Notification address
-  sockaddr_in6_t addr;
-  /// Notification packet
-  sl_wisun_coap_packet_t pkt;
-} sl_wisun_coap_notify_ch_t;
-
-// CoAP Notification channel structure instance and defaults
-static sl_wisun_coap_notify_ch_t coap_notify_ch = {
-  .sockid = -1L,
-  .addr = { 0U },
-  .pkt = { 0U },
-};
-#endif /* SL_WISUN_COAP_H */
-
 // -----------------------------------------------------------------------------
 //                          Public Function Definitions
 // -----------------------------------------------------------------------------
@@ -662,6 +738,10 @@ uint8_t app_join_network(uint8_t network_index) {
     app_parameters.network_index,
     this_network.device_type,
     device_type_string);
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+  // '/info/device_type' and '/info/all' need to be rebuilt
+  app_coap_info_cache_invalidate();
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
 
 #ifdef TRACK_HEAP_PER_THREAD
     printfBoth("TRACK_HEAP_PER_THREAD\n");
@@ -1022,6 +1102,8 @@ void app_task(void *args)
 {
   (void) args;
   uint32_t osdelay_msec;
+  uint32_t events;
+  uint64_t busy_start_tick;
 
 #ifdef    SL_CATALOG_SIMPLE_BUTTON_PRESENT
   uint8_t startup_option = 0;
@@ -1130,7 +1212,10 @@ void app_task(void *args)
 
   // Set device_tag to last 2 bytes of MAC address
   sl_wisun_get_mac_address(&device_mac);
-  sprintf(device_mac_string, "%s", app_wisun_mac_addr_to_str(&device_mac));
+  _mac_to_str(&device_mac, device_mac_string);
+#ifdef    APP_SEND_SLOT_H
+  app_send_slot_init(&device_mac);
+#endif /* APP_SEND_SLOT_H */
   sprintf(device_tag, "%02x%02x", device_mac.address[6], device_mac.address[7]);
   printfBoth("device MAC %s\n", device_mac_string);
   printfBoth("device_tag %s\n", device_tag);
@@ -1141,7 +1226,6 @@ void app_task(void *args)
   B1 = ( sl_button_get_state(&sl_button_btn1) == SL_SIMPLE_BUTTON_PRESSED );
   startup_option = (B1 << 1) + B0;
   printfBoth("Startup option %d ('%d%d')\n", startup_option, B1, B0);
-  check_buttons = true;
   if (startup_option > 0) {
     if (startup_option <= 3) {
       printfBoth("Changing network_index from %d to %d based on buttons\n",
@@ -1157,6 +1241,10 @@ void app_task(void *args)
   with_time = to_console = to_rtt = true;
   to_udp = to_coap = false;
 
+  // Event flags used to wake up app_task() on join state changes, socket events or send_asap
+  app_task_flags = osEventFlagsNew(NULL);
+  assert(app_task_flags != NULL);
+
   // Register our join state custom callback function with the event manager (aka 'em')
   app_wisun_em_custom_callback_register(SL_WISUN_MSG_JOIN_STATE_IND_ID , _join_state_custom_callback);
 
@@ -1286,6 +1374,10 @@ void app_task(void *args)
   //  also get ready for CoAP communication
   _open_udp_sockets();
 
+#ifdef    APP_COAP_OBSERVE_H
+  app_coap_observe_init();
+#endif /* APP_COAP_OBSERVE_H */
+
   // Once connected for the first time, reduce RTT traces to the minimum
   TRACES_WHEN_CONNECTED;
 
@@ -1301,7 +1393,7 @@ void app_task(void *args)
 
   sl_wisun_get_ip_address(SL_WISUN_IP_ADDRESS_TYPE_GLOBAL, &global_ipv6);
   printf("OTA DFU 'start' command:\n");
-  sprintf(device_global_ipv6_string, app_wisun_trace_util_get_ip_str(&global_ipv6));
+  sl_wisun_ip6tos(global_ipv6.address, device_global_ipv6_string);
   printf(" coap-client -m post -N -B 10 -t text/plain coap://[%s]:%d%s -e \"start\"\n",
         device_global_ipv6_string,
         5683,
@@ -1340,7 +1432,7 @@ void app_task(void *args)
   // Print and send initial connection message
   to_udp  = true;
   to_coap = false;
-  print_and_send_messages (_connection_json_string(""),
+  print_and_send_notification (APP_TLV_MSG_CONNECTION, _connection_json_string(""),
               with_time, to_console, to_rtt, to_udp, to_coap);
 
 
@@ -1358,7 +1450,9 @@ void app_task(void *args)
   #ifdef    APP_TRACK_HEAP_DIFF
   app_previous_heap_free = app_heap_info.free_size;
   #endif /* APP_TRACK_HEAP_DIFF */
-  refresh_heap = true;
+  #ifdef    APP_ACTION_SCHEDULER_H
+  _heap_sample_start();
+  #endif /* APP_ACTION_SCHEDULER_H */
 #endif /* APP_TRACK_HEAP */
 
   printfBothTime("network[%d].auto_send_sec %d\n", app_parameters.network_index, network[app_parameters.network_index].auto_send_sec);
@@ -1381,20 +1475,23 @@ void app_task(void *args)
     // Put your application code here!                                       //
     ///////////////////////////////////////////////////////////////////////////
   loop = 1;
+#ifdef    APP_SEND_SLOT_H
+  // Send the first status in this device's slot, not all devices at once
+  next_status_sec = app_send_slot_first_sec(now_sec() - connection_timestamp, _status_period_sec());
+#else  /* APP_SEND_SLOT_H */
   next_status_sec = now_sec() - connection_timestamp;
+#endif /* APP_SEND_SLOT_H */
+#if defined(APP_TRACK_HEAP) && !defined(APP_ACTION_SCHEDULER_H)
+  next_heap_sec = next_status_sec;
+#endif /* APP_TRACK_HEAP && !APP_ACTION_SCHEDULER_H */
+#ifdef    SL_SIMPLE_BUTTON_INSTANCES_H
+  next_button_sec = next_status_sec;
+#endif /* SL_SIMPLE_BUTTON_INSTANCES_H */
+  app_task_loop_stats_reset();
   while (1) {
+    busy_start_tick = sl_sleeptimer_get_tick_count64();
     app_do_your_things();
-    // Wait auto_send_sec
-    if (network[app_parameters.network_index].auto_send_sec == 0) {
-      osdelay_msec = 60*1000;
-    } else {
-      osdelay_msec = network[app_parameters.network_index].auto_send_sec*1000;
-    }
-
-    //Router Device never sleep decrease polling time for best performances
-    if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
-      osdelay_msec = 1;
-    }
+    app_task_loop_stats.busy_ticks += sl_sleeptimer_get_tick_count64() - busy_start_tick;
 
     if (network[app_parameters.network_index].device_type == SL_WISUN_LFN) {
 
@@ -1413,10 +1510,65 @@ void app_task(void *args)
     #endif /* SL_CATALOG_POWER_MANAGER_DEEPSLEEP_PRESENT */
     }
 
-    osDelay(osdelay_msec);
+    // Block until the next deadline, unless an event comes first
+    osdelay_msec = _msec_to_next_deadline();
+    events = osEventFlagsWait(app_task_flags, APP_TASK_EVENTS_ALL, osFlagsWaitAny, osdelay_msec);
+    app_task_loop_stats.wakeups++;
+    if (events & osFlagsError) {
+      app_task_loop_stats.deadlines++;
+    } else {
+      if (events & APP_TASK_EVENT_SEND_ASAP ) app_task_loop_stats.send_asap_events++;
+      if (events & APP_TASK_EVENT_JOIN_STATE) app_task_loop_stats.join_state_events++;
+      if (events & APP_TASK_EVENT_SOCKET    ) app_task_loop_stats.socket_events++;
+    }
+  }
+}
+
+void app_task_notify(uint32_t events) {
+  if (app_task_flags != NULL) {
+    (void)osEventFlagsSet(app_task_flags, events & APP_TASK_EVENTS_ALL);
   }
 }
 
+void app_task_loop_stats_reset(void) {
+  memset(&app_task_loop_stats, 0, sizeof(app_task_loop_stats));
+  app_task_loop_stats.start_tick = sl_sleeptimer_get_tick_count64();
+}
+
+char* app_task_loop_stats_string(char *buf, uint16_t size) {
+  #define LOOP_STATS_JSON_FORMAT_STR           \
+    "{\n"                                      \
+    "  \"wakeups\": \"%lu\",\n"                \
+    "  \"deadlines\": \"%lu\",\n"              \
+    "  \"send_asap\": \"%lu\",\n"              \
+    "  \"join_state\": \"%lu\",\n"             \
+    "  \"socket\": \"%lu\",\n"                 \
+    "  \"elapsed\": \"%s\",\n"                 \
+    "  \"wakeups_per_sec\": \"%.3f\",\n"       \
+    "  \"duty_cycle_percent\": \"%.4f\"\n"     \
+    "}\n"
+  uint64_t elapsed_ticks;
+  uint32_t tick_freq_hz;
+  float    elapsed_sec = 0.0;
+
+  elapsed_ticks = sl_sleeptimer_get_tick_count64() - app_task_loop_stats.start_tick;
+  tick_freq_hz  = sl_sleeptimer_get_timer_frequency();
+  if (tick_freq_hz) {
+    elapsed_sec = (float)elapsed_ticks / tick_freq_hz;
+  }
+  snprintf(buf, size, LOOP_STATS_JSON_FORMAT_STR,
+    app_task_loop_stats.wakeups,
+    app_task_loop_stats.deadlines,
+    app_task_loop_stats.send_asap_events,
+    app_task_loop_stats.join_state_events,
+    app_task_loop_stats.socket_events,
+    dhms((sl_sleeptimer_timestamp_64_t)elapsed_sec),
+    (elapsed_sec > 0) ? app_task_loop_stats.wakeups / elapsed_sec : 0.0,
+    (elapsed_ticks > 0) ? 100.0 * app_task_loop_stats.busy_ticks / elapsed_ticks : 0.0
+  );
+  return buf;
+}
+
 // -----------------------------------------------------------------------------
 //                          Static Function Definitions
 // -----------------------------------------------------------------------------
@@ -1443,6 +1595,10 @@ void app_do_your_things() {
     #endif /* (WITH_UDP_SERVER == SO_NONBLOCK) */
     #endif /* APP_UDP_SERVER_H */
 
+    #ifdef    APP_COAP_OBSERVE_H
+      app_coap_observe_process();
+    #endif /* APP_COAP_OBSERVE_H */
+
   #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
     if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
       // 1 Sec join state 5 indicator
@@ -1485,7 +1641,16 @@ void app_do_your_things() {
 
   if (connected_delay_sec >= next_status_sec || send_asap) {
     time_to_send_status = true;
-    next_status_sec = connected_delay_sec + network[app_parameters.network_index].auto_send_sec;
+    batch_asap = send_asap;
+#ifdef    APP_SEND_SLOT_H
+    if (to_udp) {
+      // Adapt the backoff to the congestion seen since the previous status
+      app_send_slot_sent(connected_delay_sec < next_status_sec);
+    }
+    next_status_sec = app_send_slot_next_sec(connected_delay_sec, _status_period_sec());
+#else  /* APP_SEND_SLOT_H */
+    next_status_sec = connected_delay_sec + _status_period_sec();
+#endif /* APP_SEND_SLOT_H */
   } else {
     time_to_send_status = false;
   }
@@ -1499,7 +1664,7 @@ void app_do_your_things() {
     }
 #endif /* SL_CATALOG_POWER_MANAGER_PRESENT */
 
-    print_and_send_messages (_status_json_string(""), with_time, to_console, to_rtt, to_udp, to_coap);
+    print_and_send_notification (APP_TLV_MSG_STATUS, _status_json_string(""), with_time, to_console, to_rtt, to_udp, to_coap);
     #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
     if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
       sl_led_toggle(&sl_led_led0);
@@ -1508,58 +1673,117 @@ void app_do_your_things() {
     #endif /* SL_CATALOG_SIMPLE_LED_PRESENT */
   }
 
+#if defined(APP_TRACK_HEAP) && !defined(APP_ACTION_SCHEDULER_H)
+  // Refresh heap info every APP_TRACK_HEAP_PERIOD_S (sampled by the action scheduler if present)
+  if (connected_delay_sec >= next_heap_sec) {
+    next_heap_sec = connected_delay_sec + APP_TRACK_HEAP_PERIOD_S;
+    _heap_sample();
+  }
+#endif /* APP_TRACK_HEAP && !APP_ACTION_SCHEDULER_H */
+
+#ifdef    SL_CATALOG_SIMPLE_BUTTON_PRESENT
+  if (connected_delay_sec >= next_button_sec) {
+    next_button_sec = connected_delay_sec + BUTTON_CHECK_DELAY;
+    B0 = ( sl_button_get_state(&sl_button_btn0) == SL_SIMPLE_BUTTON_PRESSED );
+    B1 = ( sl_button_get_state(&sl_button_btn1) == SL_SIMPLE_BUTTON_PRESSED );
+    #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
+      if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
+        if (B0) sl_led_turn_on(&sl_led_led0);
+        if (B1) sl_led_turn_on(&sl_led_led1);
+      }
+    #endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
+    if (B0 + B1) {
+      print_and_send_messages (_button_json_string(""),
+                with_time, to_console, to_rtt, to_udp, to_coap);
+    #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
+      if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
+        sl_led_turn_off(&sl_led_led0);
+        sl_led_turn_off(&sl_led_led1);
+      }
+    #endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
+    }
+  }
+#endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
+
+}
+
 #ifdef    APP_TRACK_HEAP
-  // Refresh heap info once then disable the refresh
-  if ((refresh_heap) && (connected_delay_sec % APP_TRACK_HEAP_PERIOD_S != 1)) {
-    sl_memory_get_heap_info(&app_heap_info);
+void _heap_sample(void) {
+  sl_memory_get_heap_info(&app_heap_info);
   #ifdef    APP_TRACK_HEAP_DIFF
-    if (app_previous_heap_free == 0) { app_previous_heap_free = app_heap_info.free_size; }
-    if (app_previous_heap_free != app_heap_info.free_size) {
-      printfBothTime("heap free %8d used %8d %6.2f%% (free diff %5d)\n",
-                  app_heap_info.free_size,
-                  app_heap_info.used_size,
-                  1.0*app_heap_info.used_size / (app_heap_info.total_size / 100),
-                  app_heap_info.free_size - app_previous_heap_free
-      );
-      refresh_heap = false;
-    }
-    app_previous_heap_free = app_heap_info.free_size;
+  if (app_previous_heap_free == 0) { app_previous_heap_free = app_heap_info.free_size; }
+  if (app_previous_heap_free != app_heap_info.free_size) {
+    printfBothTime("heap free %8d used %8d %6.2f%% (free diff %5d)\n",
+                app_heap_info.free_size,
+                app_heap_info.used_size,
+                1.0*app_heap_info.used_size / (app_heap_info.total_size / 100),
+                app_heap_info.free_size - app_previous_heap_free
+    );
+  }
+  app_previous_heap_free = app_heap_info.free_size;
   #endif /* APP_TRACK_HEAP_DIFF */
-    refresh_heap = false;
+}
+
+ #ifdef    APP_ACTION_SCHEDULER_H
+// Heap sampled at a fixed rate by the action scheduler, without waking up app_task().
+//  LFNs sample once per status period, not to wake up more often than for the status
+void _heap_sample_start(void) {
+  uint32_t period_ms = APP_TRACK_HEAP_PERIOD_S * 1000;
+
+  if (network[app_parameters.network_index].device_type == SL_WISUN_LFN) {
+    period_ms = _status_period_sec() * 1000;
+  }
+  if (!app_scheduler_action_schedule_ex(app_scheduler_heap_sample_cb, period_ms, period_ms,
+                                        APP_SCHEDULER_FIXED_RATE_SKIP, NULL)) {
+    printfBothTime("Failed to schedule heap sampling\n");
   }
-  // Enable heap info refresh for next time
-  if (connected_delay_sec % APP_TRACK_HEAP_PERIOD_S == 1) { refresh_heap = true; }
+}
+
+static uint32_t app_scheduler_heap_sample_cb(void *context) {
+  (void)context;
+  _heap_sample();
+  return 0U;
+}
+ #endif /* APP_ACTION_SCHEDULER_H */
 #endif /* APP_TRACK_HEAP */
 
-#ifdef    SL_CATALOG_SIMPLE_BUTTON_PRESENT
-  if (connected_delay_sec % BUTTON_CHECK_DELAY == 0) {
-    if (check_buttons == true) {
-      check_buttons = false;
-      B0 = ( sl_button_get_state(&sl_button_btn0) == SL_SIMPLE_BUTTON_PRESSED );
-      B1 = ( sl_button_get_state(&sl_button_btn1) == SL_SIMPLE_BUTTON_PRESSED );
-      #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
-        if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
-          if (B0) sl_led_turn_on(&sl_led_led0);
-          if (B1) sl_led_turn_on(&sl_led_led1);
-        }
-      #endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
-      if (B0 + B1) {
-        print_and_send_messages (_button_json_string(""),
-                  with_time, to_console, to_rtt, to_udp, to_coap);
-      #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
-        if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
-          sl_led_turn_off(&sl_led_led0);
-          sl_led_turn_off(&sl_led_led1);
-        }
-      #endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
-      }
-    }
+uint32_t _status_period_sec(void) {
+  if (network[app_parameters.network_index].auto_send_sec == 0) {
+    return APP_TASK_DEFAULT_STATUS_PERIOD_S;
   }
-  if (connected_delay_sec % BUTTON_CHECK_DELAY == 1) {
-    check_buttons = true;
+  return network[app_parameters.network_index].auto_send_sec;
+}
+
+// Delay (in msec) until the earliest app_task() deadline, counted like connected_delay_sec
+uint32_t _msec_to_next_deadline(void) {
+  uint64_t deadlines_sec[APP_TASK_DEADLINE_MAX_COUNT];
+  uint8_t  count = 0;
+  uint32_t max_msec = UINT32_MAX;
+
+  deadlines_sec[count++] = next_status_sec;
+  // LFNs only wake up for the status, heap and buttons are checked at the same time
+  if (network[app_parameters.network_index].device_type == SL_WISUN_ROUTER) {
+  #if defined(APP_TRACK_HEAP) && !defined(APP_ACTION_SCHEDULER_H)
+    deadlines_sec[count++] = next_heap_sec;
+  #endif /* APP_TRACK_HEAP && !APP_ACTION_SCHEDULER_H */
+  #ifdef    SL_SIMPLE_BUTTON_INSTANCES_H
+    deadlines_sec[count++] = next_button_sec;
+  #endif /* SL_SIMPLE_BUTTON_INSTANCES_H */
+  #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
+    // LEDs follow connected_delay_sec % 4
+    deadlines_sec[count++] = connected_delay_sec + 1;
+  #endif /* SL_CATALOG_SIMPLE_LED_PRESENT */
   }
-#endif /* SL_CATALOG_SIMPLE_BUTTON_PRESENT */
 
+#ifdef    APP_COAP_OBSERVE_H
+  // Observed resources are checked, and deferred group responses sent, at their own pace
+  max_msec = app_coap_observe_msec_to_next();
+#endif /* APP_COAP_OBSERVE_H */
+
+#ifdef    APP_TASK_SOCKET_POLL_MSEC
+  if (max_msec > APP_TASK_SOCKET_POLL_MSEC) { max_msec = APP_TASK_SOCKET_POLL_MSEC; }
+#endif /* APP_TASK_SOCKET_POLL_MSEC */
+  return app_task_deadline_msec(deadlines_sec, count, connection_timestamp, max_msec);
 }
 
 void app_reset_statistics(void) {
@@ -1571,49 +1795,27 @@ void app_reset_statistics(void) {
 }
 
 sl_wisun_mac_address_t _get_parent_mac_address_and_update_parent_info(void) {
-  sl_status_t ret;
-  uint8_t neighbor_count;
-  uint8_t i;
-  sl_wisun_neighbor_info_t neighbor_info;
-
-  // fill with zeros
-  for ( i = 0 ; i<  SL_WISUN_MAC_ADDRESS_SIZE ; i++) {
-      parent_mac.address[i] = 0;
-      secondary_mac.address[i] = 0;
-  }
+  const app_stats_snapshot_t *snapshot;
 
-  ret = sl_wisun_get_neighbor_count(&neighbor_count);
-  if (ret) {
-    printfBothTime("[Failed: sl_wisun_get_neighbor_count() returned 0x%04x]\n", (uint16_t)ret);
-    neighbor_count = 0;
-  }
-
-  if (neighbor_count) {
-    sl_wisun_mac_address_t *neighbor_mac_addresses = NULL;
-    neighbor_mac_addresses = sl_malloc(sizeof(sl_wisun_mac_address_t) * neighbor_count);
-    if (neighbor_mac_addresses == NULL) {
-      printfBothTime("[Failed: memory allocation for %d sl_wisun_mac_address_t in neighbor_mac_addresses returned NULL]\n", (uint16_t)neighbor_count);
-    } else {
-      ret = sl_wisun_get_neighbors(&neighbor_count, neighbor_mac_addresses);
-      if (ret) {printfBothTime("[Failed: sl_wisun_get_neighbors() returned 0x%04x]\n", (uint16_t)ret);}
-      for (i = 0 ; i < neighbor_count; i++) {
-          sl_wisun_get_neighbor_info(&neighbor_mac_addresses[i], &neighbor_info);
-          if (neighbor_info.type == SL_WISUN_NEIGHBOR_TYPE_PRIMARY_PARENT  ) {
-            sl_wisun_get_neighbor_info(&neighbor_mac_addresses[i], &parent_info);
-            parent_mac = neighbor_mac_addresses[i];
-          }
-          if (neighbor_info.type == SL_WISUN_NEIGHBOR_TYPE_SECONDARY_PARENT) {
-            sl_wisun_get_neighbor_info(&neighbor_mac_addresses[i], &secondary_info);
-            secondary_mac = neighbor_mac_addresses[i];
-          }
-      }
-      sl_free(neighbor_mac_addresses);
-    }
-  }
+  // Parent info comes from the shared snapshot, refreshed only if too old
+  snapshot = app_stats_snapshot_acquire();
+  parent_mac     = snapshot->parent_mac;
+  parent_info    = snapshot->parent_info;
+  secondary_mac  = snapshot->secondary_mac;
+  secondary_info = snapshot->secondary_info;
+  app_stats_snapshot_release();
 
   return parent_mac;
 }
 
+// Same format as app_wisun_mac_addr_to_str(), without allocation
+char* _mac_to_str(const sl_wisun_mac_address_t *mac, char *str) {
+  sprintf(str, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+          mac->address[0], mac->address[1], mac->address[2], mac->address[3],
+          mac->address[4], mac->address[5], mac->address[6], mac->address[7]);
+  return str;
+}
+
 void refresh_parent_tag(void) {
   _get_parent_mac_address_and_update_parent_info();
   sprintf(parent_tag   , "%02x%02x", parent_mac.address[6]   , parent_mac.address[7]   );
@@ -1636,6 +1838,8 @@ void  _join_state_custom_callback(sl_wisun_evt_t *evt) {
   }
   if (join_state != previous_join_state) {
     // join_state changed...
+    // parents and statistics stored in the snapshot are no longer relevant
+    app_stats_snapshot_invalidate();
     // print current join_state
     printfBothTime("[Join state %u->%u]\n", previous_join_state, join_state);
     if (join_state < min_join_state) { min_join_state = join_state; }
@@ -1683,7 +1887,7 @@ void  _join_state_custom_callback(sl_wisun_evt_t *evt) {
       if (udp_notification_socket_id) {
         to_udp = true;
         to_coap = false;
-        print_and_send_messages (_connection_json_string(""),
+        print_and_send_notification (APP_TLV_MSG_CONNECTION, _connection_json_string(""),
             with_time, to_console, to_rtt, to_udp, to_coap);
       }
       TRACES_WHEN_CONNECTED;
@@ -1712,6 +1916,7 @@ void  _join_state_custom_callback(sl_wisun_evt_t *evt) {
     leds_f_join_state(join_state);
     #endif /* SL_CATALOG_SIMPLE_LED_PRESENT */
 
+    app_task_notify(APP_TASK_EVENT_JOIN_STATE);
   }
 }
 
@@ -1751,14 +1956,20 @@ char* _connection_json_string () {
 
   char sec_string[20];
   uint64_t connection_sec;
-
-  sl_wisun_get_network_info(&network_info);
+  uint64_t start_tick;
+  int len;
+  const app_stats_snapshot_t *snapshot;
+
+  start_tick = sl_sleeptimer_get_tick_count64();
+  snapshot = app_stats_snapshot_acquire();
+  network_info = snapshot->network_info;
+  app_stats_snapshot_release();
   connection_sec = now_sec();
   sprintf(sec_string, "%s", dhms(connection_sec));
   refresh_parent_tag();
   msg_count++;
 
-  snprintf(json_string, SL_WISUN_COAP_RESOURCE_HND_SOCK_BUFF_SIZE,
+  len = snprintf(json_string, SL_WISUN_COAP_RESOURCE_HND_SOCK_BUFF_SIZE,
     CONNECTION_JSON_FORMAT_STR,
     DEVICE_CHIP_ITEMS,
     PARENT_INFO_ITEMS,
@@ -1774,9 +1985,69 @@ char* _connection_json_string () {
     app_join_state_delay_sec[5],
     application
   );
+  _encoding_stats_add(&app_notification_stats.json, (uint16_t)len, start_tick);
   return json_string;
 };
 
+// Binary version of _connection_json_string(), to be called right after it
+uint16_t _connection_tlv(uint8_t *buf, uint16_t size) {
+  app_tlv_writer_t writer;
+  uint64_t start_tick;
+  uint16_t len;
+
+  start_tick = sl_sleeptimer_get_tick_count64();
+  app_tlv_begin(&writer, buf, size, APP_TLV_MSG_CONNECTION);
+  app_tlv_put_bytes(&writer, APP_TLV_ID_IPV6, device_global_ipv6.address, sizeof(device_global_ipv6.address));
+  app_tlv_put_str  (&writer, APP_TLV_ID_DEVICE, device_tag);
+  app_tlv_put_str  (&writer, APP_TLV_ID_CHIP, chip);
+  app_tlv_put_str  (&writer, APP_TLV_ID_TYPE, device_type_string);
+  app_tlv_put_bytes(&writer, APP_TLV_ID_MAC, device_mac.address, SL_WISUN_MAC_ADDRESS_SIZE);
+  app_tlv_put_str  (&writer, APP_TLV_ID_PARENT, parent_tag);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RPL_RANK, parent_info.rpl_rank);
+  app_tlv_put_uint (&writer, APP_TLV_ID_ETX, parent_info.etx);
+  app_tlv_put_uint (&writer, APP_TLV_ID_ROUTING_COST, parent_info.routing_cost);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RSL_IN, parent_info.rsl_in);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RSL_OUT, parent_info.rsl_out);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RUNNING, now_sec());
+  app_tlv_put_uint (&writer, APP_TLV_ID_MSG_COUNT, msg_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PAN_ID, network_info.pan_id);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PREFERRED_PAN_ID, network[app_parameters.network_index].preferred_pan_id);
+  app_tlv_put_uint (&writer, APP_TLV_ID_HOP_COUNT, network_info.hop_count);
+  app_tlv_put_uint_list(&writer, APP_TLV_ID_JOIN_STATES_SEC, &app_join_state_delay_sec[1], 5);
+  app_tlv_put_str  (&writer, APP_TLV_ID_APPLICATION, application);
+  len = app_tlv_end(&writer);
+  _encoding_stats_add(&app_notification_stats.tlv, len, start_tick);
+  return len;
+}
+
+void _status_values(app_status_values_t *values, sl_wisun_join_state_t state) {
+  values->join_state = state;
+  values->status_sec = now_sec();
+
+  if (state == SL_WISUN_JOIN_STATE_OPERATIONAL) {
+    values->current_state_sec      = values->status_sec - connection_time_sec;
+    values->connected_total_sec    = connected_total_sec + values->current_state_sec;
+    values->disconnected_total_sec = disconnected_total_sec;
+  } else {
+    values->current_state_sec      = values->status_sec - disconnection_time_sec;
+    values->connected_total_sec    = connected_total_sec;
+    values->disconnected_total_sec = disconnected_total_sec + values->current_state_sec;
+  }
+  if (values->connected_total_sec + values->disconnected_total_sec) {
+    values->availability = 100.0*values->connected_total_sec/(values->connected_total_sec + values->disconnected_total_sec);
+  } else {
+    values->availability = 100.0;
+  }
+}
+
+// Status values of app_task, from its globals (refreshed by app_task)
+void _status_values_from_globals(app_status_values_t *values) {
+  _status_values(values, join_state);
+  snprintf(values->parent_tag, sizeof(values->parent_tag), "%s", parent_tag);
+  values->parent_info = parent_info;
+  values->hop_count   = network_info.hop_count;
+}
+
 char* _status_json_string (char * start_text) {
   #define CONNECTED_JSON_FORMAT_STR        \
     "%s"                                   \
@@ -1811,56 +2082,36 @@ char* _status_json_string (char * start_text) {
   char disconnected_string[20];
   char connected_sec_string[20];
   char disconnected_sec_string[20];
-  float availability;
-  // sl_wisun_statistics_t is a union, so we need one per statistics type
-  sl_wisun_statistics_t         network_statistics;
-  sl_wisun_statistics_t         mac_statistics;
-  sl_wisun_statistics_t         phy_statistics;
-
-  uint64_t status_sec;
-  uint64_t current_state_sec;
+  app_status_values_t values;
+  const app_stats_snapshot_t *snapshot;
+  uint64_t start_tick;
+  int len;
 
+  start_tick = sl_sleeptimer_get_tick_count64();
   // Make sure of the join state
   sl_wisun_get_join_state(&join_state);
   msg_count++;
 
-  status_sec = now;
+  _status_values(&values, join_state);
 
   if (join_state == SL_WISUN_JOIN_STATE_OPERATIONAL) {
-    current_state_sec = status_sec - connection_time_sec;
-    sprintf(connected_string,       "%s", dhms(current_state_sec));
+    sprintf(connected_string,       "%s", dhms(values.current_state_sec));
     sprintf(disconnected_string,    "no");
-    sprintf(connected_sec_string,   "%s", dhms(connected_total_sec + current_state_sec));
-    sprintf(disconnected_sec_string,"%s", dhms(disconnected_total_sec));
-    if (connected_total_sec + current_state_sec + disconnected_total_sec) {
-        availability = 100.0*(connected_total_sec + current_state_sec)/(connected_total_sec + current_state_sec + disconnected_total_sec);
-    } else {
-        availability = 100.0;
-    }
   } else {
-    current_state_sec = status_sec - disconnection_time_sec;
     sprintf(connected_string, " no (join_state %d)", join_state);
-    sprintf(disconnected_string,    "%s", dhms(current_state_sec));
-    sprintf(connected_sec_string,   "%s", dhms(connected_total_sec));
-    sprintf(disconnected_sec_string,"%s", dhms(disconnected_total_sec + current_state_sec));
-    if (connected_total_sec + disconnected_total_sec + current_state_sec) {
-        availability = 100.0*(connected_total_sec)/(connected_total_sec + disconnected_total_sec + current_state_sec);
-    } else {
-        availability = 100.0;
-    }
+    sprintf(disconnected_string,    "%s", dhms(values.current_state_sec));
   }
-  // Refresh network info
-  sl_wisun_get_network_info(&network_info);
-  // Refresh statistics used in status
-  sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_NETWORK, &network_statistics);
-  sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_MAC    , &mac_statistics);
-  sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_PHY    , &phy_statistics);
+  sprintf(connected_sec_string,   "%s", dhms(values.connected_total_sec));
+  sprintf(disconnected_sec_string,"%s", dhms(values.disconnected_total_sec));
 
+  // Network info, statistics and parent info all come from the same snapshot
+  snapshot = app_stats_snapshot_acquire();
+  network_info = snapshot->network_info;
   refresh_parent_tag();
 
-  sprintf(running_sec_string, "%s", dhms(status_sec));
+  sprintf(running_sec_string, "%s", dhms(values.status_sec));
 
-  snprintf(json_string, SL_WISUN_COAP_RESOURCE_HND_SOCK_BUFF_SIZE,
+  len = snprintf(json_string, SL_WISUN_COAP_RESOURCE_HND_SOCK_BUFF_SIZE,
     CONNECTED_JSON_FORMAT_STR,
     start_text,
     DEVICE_CHIP_ITEMS,
@@ -1872,25 +2123,248 @@ char* _status_json_string (char * start_text) {
     disconnected_string,
     connection_count,
     network_connection_count,
-    availability,
+    values.availability,
     connected_sec_string,
     disconnected_sec_string,
     network_info.hop_count,
-    phy_statistics.phy.crc_fails,
-    phy_statistics.phy.tx_timeouts,
-    phy_statistics.phy.rx_timeouts,
-    mac_statistics.mac.failed_cca_count,
-    mac_statistics.mac.tx_count,
-    mac_statistics.mac.tx_failed_count,
-    mac_statistics.mac.rx_count,
-    mac_statistics.mac.rx_availability_percentage,
-    network_statistics.network.ip_no_route,
-    network_statistics.network.ip_routeloop_detect
+    snapshot->phy.phy.crc_fails,
+    snapshot->phy.phy.tx_timeouts,
+    snapshot->phy.phy.rx_timeouts,
+    snapshot->mac.mac.failed_cca_count,
+    snapshot->mac.mac.tx_count,
+    snapshot->mac.mac.tx_failed_count,
+    snapshot->mac.mac.rx_count,
+    snapshot->mac.mac.rx_availability_percentage,
+    snapshot->network.network.ip_no_route,
+    snapshot->network.network.ip_routeloop_detect
   );
+  app_stats_snapshot_release();
+  _encoding_stats_add(&app_notification_stats.json, (uint16_t)len, start_tick);
 
   return json_string;
 }
 
+// Binary version of _status_json_string(), to be called right after it
+uint16_t _status_tlv(uint8_t *buf, uint16_t size) {
+  app_tlv_writer_t writer;
+  app_status_values_t values;
+  uint64_t start_tick;
+  uint16_t len;
+
+  start_tick = sl_sleeptimer_get_tick_count64();
+  _status_values_from_globals(&values);
+
+  app_tlv_begin(&writer, buf, size, APP_TLV_MSG_STATUS);
+  _status_tlv_fields(&writer, &values);
+  len = app_tlv_end(&writer);
+  _encoding_stats_add(&app_notification_stats.tlv, len, start_tick);
+  return len;
+}
+
+// Current status record, with the fields only sent on request, for the /batch CoAP resource
+uint16_t app_status_record(uint8_t *buf, uint16_t size) {
+  app_tlv_writer_t writer;
+  app_status_values_t values;
+  const app_stats_snapshot_t *snapshot;
+  sl_wisun_join_state_t state = SL_WISUN_JOIN_STATE_DISCONNECTED;
+  sl_wisun_statistics_fhss_t       fhss;
+  sl_wisun_statistics_wisun_t      wisun;
+  sl_wisun_statistics_regulation_t regulation;
+  sl_wisun_neighbor_info_t secondary_info;
+  char     secondary_tag[8];
+  uint32_t pan_id;
+  uint8_t  neighbor_count;
+
+  // Called by the CoAP handler thread: only locals and the snapshot, app_task's
+  //  join_state/parent_tag/parent_info are left untouched
+  sl_wisun_get_join_state(&state);
+  _status_values(&values, state);
+  snapshot = app_stats_snapshot_acquire();
+  snprintf(values.parent_tag, sizeof(values.parent_tag), "%02x%02x",
+           snapshot->parent_mac.address[6], snapshot->parent_mac.address[7]);
+  values.parent_info = snapshot->parent_info;
+  values.hop_count   = snapshot->network_info.hop_count;
+  pan_id             = snapshot->network_info.pan_id;
+  neighbor_count     = snapshot->neighbor_count;
+  snprintf(secondary_tag, sizeof(secondary_tag), "%02x%02x",
+           snapshot->secondary_mac.address[6], snapshot->secondary_mac.address[7]);
+  secondary_info     = snapshot->secondary_info;
+  fhss               = snapshot->fhss.fhss;
+  wisun              = snapshot->wisun.wisun;
+  regulation         = snapshot->regulation.regulation;
+  app_stats_snapshot_release();
+
+  app_tlv_begin(&writer, buf, size, APP_TLV_MSG_STATUS);
+  _status_tlv_fields(&writer, &values);
+  app_tlv_put_str  (&writer, APP_TLV_ID_APPLICATION, application);
+  app_tlv_put_str  (&writer, APP_TLV_ID_VERSION, version);
+  app_tlv_put_str  (&writer, APP_TLV_ID_BOARD, SL_BOARD_NAME);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PAN_ID, pan_id);
+  app_tlv_put_uint_list(&writer, APP_TLV_ID_JOIN_STATES_SEC, &app_join_state_delay_sec[1], 5);
+  app_tlv_put_uint (&writer, APP_TLV_ID_NEIGHBOR_COUNT, neighbor_count);
+  // Parents, as in /status/parent and /status/neighbor (the other neighbors are only there)
+  app_tlv_put_uint (&writer, APP_TLV_ID_PARENT_MAC_TX_COUNT, values.parent_info.mac_tx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PARENT_MAC_TX_FAILED_COUNT, values.parent_info.mac_tx_failed_count);
+  app_tlv_put_str  (&writer, APP_TLV_ID_SECONDARY, secondary_tag);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_RPL_RANK, secondary_info.rpl_rank);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_ETX, secondary_info.etx);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_RSL_IN, secondary_info.rsl_in);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_RSL_OUT, secondary_info.rsl_out);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_MAC_TX_COUNT, secondary_info.mac_tx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_SECONDARY_MAC_TX_FAILED_COUNT, secondary_info.mac_tx_failed_count);
+  // Stack statistics not in the status messages, as in /statistics/stack/<type>
+  app_tlv_put_int  (&writer, APP_TLV_ID_FHSS_DRIFT_COMPENSATION, fhss.drift_compensation);
+  app_tlv_put_uint (&writer, APP_TLV_ID_FHSS_HOP_COUNT, fhss.hop_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_FHSS_SYNCH_INTERVAL, fhss.synch_interval);
+  app_tlv_put_int  (&writer, APP_TLV_ID_FHSS_PREV_AVG_SYNCH_FIX, fhss.prev_avg_synch_fix);
+  app_tlv_put_uint (&writer, APP_TLV_ID_FHSS_SYNCH_LOST, fhss.synch_lost);
+  app_tlv_put_uint (&writer, APP_TLV_ID_FHSS_UNKNOWN_NEIGHBOR, fhss.unknown_neighbor);
+  app_tlv_put_uint (&writer, APP_TLV_ID_WISUN_PAN_CONTROL_TX_COUNT, wisun.pan_control_tx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_WISUN_PAN_CONTROL_RX_COUNT, wisun.pan_control_rx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_REGULATION_ARIB_TX_DURATION_MS, regulation.arib.tx_duration_ms);
+  return app_tlv_end(&writer);
+}
+
+// Fields of a status message, shared by the notifications and app_status_record()
+void _status_tlv_fields(app_tlv_writer_t *writer, const app_status_values_t *values) {
+  const app_stats_snapshot_t *snapshot;
+
+  app_tlv_put_bytes(writer, APP_TLV_ID_IPV6, device_global_ipv6.address, sizeof(device_global_ipv6.address));
+  app_tlv_put_str  (writer, APP_TLV_ID_DEVICE, device_tag);
+  app_tlv_put_str  (writer, APP_TLV_ID_CHIP, chip);
+  app_tlv_put_str  (writer, APP_TLV_ID_TYPE, device_type_string);
+  app_tlv_put_bytes(writer, APP_TLV_ID_MAC, device_mac.address, SL_WISUN_MAC_ADDRESS_SIZE);
+  app_tlv_put_str  (writer, APP_TLV_ID_PARENT, values->parent_tag);
+  app_tlv_put_uint (writer, APP_TLV_ID_RPL_RANK, values->parent_info.rpl_rank);
+  app_tlv_put_uint (writer, APP_TLV_ID_ETX, values->parent_info.etx);
+  app_tlv_put_uint (writer, APP_TLV_ID_ROUTING_COST, values->parent_info.routing_cost);
+  app_tlv_put_uint (writer, APP_TLV_ID_RSL_IN, values->parent_info.rsl_in);
+  app_tlv_put_uint (writer, APP_TLV_ID_RSL_OUT, values->parent_info.rsl_out);
+  app_tlv_put_uint (writer, APP_TLV_ID_RUNNING, values->status_sec);
+  app_tlv_put_uint (writer, APP_TLV_ID_MSG_COUNT, msg_count);
+#ifdef    APP_TRACK_HEAP
+  if (app_heap_info.total_size) {
+    app_tlv_put_uint(writer, APP_TLV_ID_HEAP_USED, (uint64_t)app_heap_info.used_size * 10000 / app_heap_info.total_size);
+  }
+#endif /* APP_TRACK_HEAP */
+  // The receiver rebuilds the 'connected'/'disconnected' strings from join_state
+  app_tlv_put_uint (writer, APP_TLV_ID_JOIN_STATE, values->join_state);
+  if (values->join_state == SL_WISUN_JOIN_STATE_OPERATIONAL) {
+    app_tlv_put_uint(writer, APP_TLV_ID_CONNECTED, values->current_state_sec);
+  } else {
+    app_tlv_put_uint(writer, APP_TLV_ID_DISCONNECTED, values->current_state_sec);
+  }
+  app_tlv_put_uint (writer, APP_TLV_ID_CONNECTIONS, connection_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_NETWORK_CONNECTIONS, network_connection_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_AVAILABILITY, (uint64_t)(values->availability * 100));
+  app_tlv_put_uint (writer, APP_TLV_ID_CONNECTED_TOTAL, values->connected_total_sec);
+  app_tlv_put_uint (writer, APP_TLV_ID_DISCONNECTED_TOTAL, values->disconnected_total_sec);
+  app_tlv_put_uint (writer, APP_TLV_ID_HOP_COUNT, values->hop_count);
+
+  snapshot = app_stats_snapshot_acquire();
+  app_tlv_put_uint (writer, APP_TLV_ID_PHY_CRC_FAILS, snapshot->phy.phy.crc_fails);
+  app_tlv_put_uint (writer, APP_TLV_ID_PHY_TX_TIMEOUTS, snapshot->phy.phy.tx_timeouts);
+  app_tlv_put_uint (writer, APP_TLV_ID_PHY_RX_TIMEOUTS, snapshot->phy.phy.rx_timeouts);
+  app_tlv_put_uint (writer, APP_TLV_ID_MAC_FAILED_CCA_COUNT, snapshot->mac.mac.failed_cca_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_MAC_TX_COUNT, snapshot->mac.mac.tx_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_MAC_TX_FAILED_COUNT, snapshot->mac.mac.tx_failed_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_MAC_RX_COUNT, snapshot->mac.mac.rx_count);
+  app_tlv_put_uint (writer, APP_TLV_ID_MAC_RX_AVAILABILITY_PERCENTAGE, snapshot->mac.mac.rx_availability_percentage);
+  app_tlv_put_uint (writer, APP_TLV_ID_NETWORK_IP_NO_ROUTE, snapshot->network.network.ip_no_route);
+  app_tlv_put_uint (writer, APP_TLV_ID_NETWORK_IP_ROUTELOOP_DETECT, snapshot->network.network.ip_routeloop_detect);
+  app_stats_snapshot_release();
+}
+
+void _encoding_stats_add(app_encoding_stats_t *stats, uint16_t len, uint64_t start_tick) {
+  stats->count++;
+  stats->bytes += len;
+  stats->ticks += sl_sleeptimer_get_tick_count64() - start_tick;
+}
+
+void app_notification_stats_reset(void) {
+  memset(&app_notification_stats, 0, sizeof(app_notification_stats));
+  app_notify_reset();
+  app_notification_stats.start_sec = now_sec();
+#ifdef    SL_CATALOG_POWER_MANAGER_PRESENT
+  memcpy(app_notification_stats.em_ticks, pm_ticks_in_EM, sizeof(app_notification_stats.em_ticks));
+#endif /* SL_CATALOG_POWER_MANAGER_PRESENT */
+}
+
+char* app_notification_stats_string(char *buf, uint16_t size) {
+  #define NOTIFICATION_STATS_JSON_FORMAT_STR \
+    "{\n"                                    \
+    "  \"format\": \"%s\",\n"                \
+    "  \"json_count\": \"%lu\",\n"           \
+    "  \"json_bytes_per_msg\": \"%.1f\",\n"  \
+    "  \"json_usec_per_msg\": \"%.1f\",\n"   \
+    "  \"tlv_count\": \"%lu\",\n"            \
+    "  \"tlv_bytes_per_msg\": \"%.1f\",\n"   \
+    "  \"tlv_usec_per_msg\": \"%.1f\",\n"    \
+    "  \"keyframe_interval\": \"%d\",\n"     \
+    "  \"delta_count\": \"%lu\",\n"          \
+    "  \"delta_keyframes\": \"%lu\",\n"      \
+    "  \"delta_bytes_per_msg\": \"%.1f\",\n" \
+    "  \"sends\": \"%lu\",\n"                \
+    "  \"bytes_copied_per_send\": \"%.1f\",\n" \
+    "  \"allocs_per_send\": \"%.2f\",\n"     \
+    "  \"batch_count\": \"%d\",\n"           \
+    "  \"batch_samples\": \"%lu\",\n"        \
+    "  \"batches\": \"%lu\",\n"              \
+    "  \"samples_per_batch\": \"%.1f\",\n"   \
+    "  \"sends_per_hour\": \"%.1f\",\n"      \
+    "  \"em2_pct\": \"%s\"\n"               \
+    "}\n"
+  app_encoding_stats_t *json = &app_notification_stats.json;
+  app_encoding_stats_t *tlv  = &app_notification_stats.tlv;
+  app_encoding_stats_t *delta = &app_notification_stats.delta;
+  app_notify_counters_t notify;
+  float usec_per_tick;
+  float elapsed_hours;
+  char em2_pct[10];
+#ifdef    SL_CATALOG_POWER_MANAGER_PRESENT
+  uint32_t em_ticks[3];
+  uint8_t  i;
+#endif /* SL_CATALOG_POWER_MANAGER_PRESENT */
+
+  app_notify_counters(&notify);
+  usec_per_tick = 1000000.0 / sl_sleeptimer_get_timer_frequency();
+  elapsed_hours = (now_sec() - app_notification_stats.start_sec) / 3600.0;
+  // EM2 residency since the last reset, if the power manager is used
+  snprintf(em2_pct, sizeof(em2_pct), "n/a");
+#ifdef    SL_CATALOG_POWER_MANAGER_PRESENT
+  for (i = 0; i < 3; i++) {
+    em_ticks[i] = pm_ticks_in_EM[i] - app_notification_stats.em_ticks[i];
+  }
+  if (em_ticks[0] + em_ticks[1] + em_ticks[2]) {
+    snprintf(em2_pct, sizeof(em2_pct), "%.1f", 100.0 * em_ticks[2] /
+             ((float)em_ticks[0] + em_ticks[1] + em_ticks[2]));
+  }
+#endif /* SL_CATALOG_POWER_MANAGER_PRESENT */
+  snprintf(buf, size, NOTIFICATION_STATS_JSON_FORMAT_STR,
+    (app_parameters.notification_format == APP_NOTIFICATION_FORMAT_TLV) ? "tlv" : "json",
+    json->count,
+    json->count ? (float)json->bytes / json->count : 0.0,
+    json->count ? json->ticks * usec_per_tick / json->count : 0.0,
+    tlv->count,
+    tlv->count ? (float)tlv->bytes / tlv->count : 0.0,
+    tlv->count ? tlv->ticks * usec_per_tick / tlv->count : 0.0,
+    app_parameters.keyframe_interval,
+    delta->count,
+    app_notification_stats.keyframes,
+    delta->count ? (float)delta->bytes / delta->count : 0.0,
+    notify.sends,
+    notify.sends ? (float)notify.bytes_copied / notify.sends : 0.0,
+    notify.sends ? (float)notify.allocs / notify.sends : 0.0,
+    app_parameters.batch_count,
+    app_notification_stats.batch_samples,
+    app_notification_stats.batches,
+    app_notification_stats.batches ? (float)app_notification_stats.batch_samples / app_notification_stats.batches : 0.0,
+    (elapsed_hours > 0) ? notify.sends / elapsed_hours : 0.0,
+    em2_pct
+  );
+  return buf;
+}
+
 sl_status_t _select_destinations(void) {
   sl_status_t ret = SL_STATUS_OK;
 
@@ -1930,6 +2404,7 @@ sl_status_t _open_udp_sockets(void){
 
   udp_notification_sockaddr_in6.sin6_family = AF_INET6;
   udp_notification_sockaddr_in6.sin6_port = htons(UDP_NOTIFICATION_PORT);
+  app_notify_set_udp(udp_notification_socket_id, &udp_notification_sockaddr_in6);
 
 #ifdef    SL_CATALOG_WISUN_COAP_PRESENT
   // (UDP) CoAP Notifications (autonomously sent by the device)
@@ -1941,76 +2416,18 @@ sl_status_t _open_udp_sockets(void){
   coap_notification_sockaddr_in6.sin6_family = AF_INET6;
   coap_notification_sockaddr_in6.sin6_port = htons(COAP_NOTIFICATION_PORT);
 
-  coap_notify_ch.sockid = coap_notification_socket_id;
-  coap_notify_ch.addr = coap_notification_sockaddr_in6;
-
-  // Prepare CoAP notification packet
-  coap_notify_ch.pkt.msg_code = COAP_MSG_CODE_REQUEST_PUT;
-  coap_notify_ch.pkt.msg_id = 9002U;
-  coap_notify_ch.pkt.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
-  coap_notify_ch.pkt.content_format = COAP_CT_JSON;
-  coap_notify_ch.pkt.uri_path_ptr = (uint8_t *)SL_WISUN_STATUS_CONNECTION_URI_PATH;
-  coap_notify_ch.pkt.uri_path_len = sl_strnlen(
-       (char *) SL_WISUN_STATUS_CONNECTION_URI_PATH,
-                SL_WISUN_STATUS_JSON_STR_MAX_LEN);
-
-  coap_notify_ch.pkt.token_ptr = NULL;
-  coap_notify_ch.pkt.token_len = 0U;
-  coap_notify_ch.pkt.options_list_ptr = NULL;
+  app_notify_set_coap(coap_notification_socket_id, &coap_notification_sockaddr_in6,
+                      SL_WISUN_STATUS_CONNECTION_URI_PATH);
 #endif /* SL_CATALOG_WISUN_COAP_PRESENT */
 
   return SL_STATUS_OK;
 
 };
 
-#ifdef    SL_WISUN_COAP_H
-sl_status_t _coap_notify(char* json_string)
-{
-  sl_status_t ret = SL_STATUS_OK;
-  uint16_t req_buff_size = 0UL;
-  uint8_t * buff = NULL;
-
-  coap_notify_ch.pkt.payload_ptr = (uint8_t *)json_string;
-  coap_notify_ch.pkt.payload_len = sl_strnlen((char *) coap_notify_ch.pkt.payload_ptr,
-                                              SL_WISUN_STATUS_JSON_STR_MAX_LEN);
-
-  req_buff_size = sl_wisun_coap_builder_calc_size(&coap_notify_ch.pkt);
-
-  buff = (uint8_t *) sl_malloc(req_buff_size);
-  if (buff == NULL) {
-    printfBothTime("_coap_notify() error on line %d: sl_wisun_coap_malloc buff(%d)\n", __LINE__,
-                  req_buff_size);
-    return __LINE__;
-  }
-  if (sl_wisun_coap_builder(buff, &coap_notify_ch.pkt) < 0) {
-    printfBothTime("_coap_notify() error on line %d: sl_wisun_coap_builder()\n", __LINE__);
-  } else {
-      /* Casting udp_notification_sockaddr_in6 (type sockaddr_in6_t) to (const struct sockaddr *) to match POSIX socket interface */
-      if (sendto(coap_notify_ch.sockid,
-                  buff,
-                  req_buff_size,
-                  0,
-                  (const struct sockaddr *) &coap_notification_sockaddr_in6,
-                  sizeof(sockaddr_in6_t)) == -1) {
-          printfBothTime("_coap_notify() error on line %d\n", __LINE__);
-          ret = SL_STATUS_TRANSMIT;
-      }
-  }
-  sl_free(buff);
-  return ret;
-}
-#endif /* SL_WISUN_COAP_H */
-
 uint8_t print_and_send_messages (char *in_msg, bool _with_time,
                             bool _to_console, bool _to_rtt, bool _to_udp, bool _to_coap) {
-#ifdef    SL_WISUN_COAP_H
-  sl_status_t ret = SL_STATUS_OK;
-  uint16_t coap_msg_len;
-#else
-  to_coap = false;
-#endif /* SL_WISUN_COAP_H */
   uint8_t messages_processed = 0;
-  uint16_t udp_msg_len;
+  uint16_t msg_len;
 
   if (_to_console == true) { // Print to console
       if (_with_time == true) {
@@ -2032,34 +2449,106 @@ uint8_t print_and_send_messages (char *in_msg, bool _with_time,
 #else /* SEGGER_RTT_printf */
   (void) _to_rtt;
 #endif /* SEGGER_RTT_printf */
-  if (_to_udp == true) {     // Send to UDP port
-    udp_msg_len  = snprintf(udp_msg,  1024, "%s", in_msg);
-    if (sendto(udp_notification_socket_id,
-                (uint8_t *)udp_msg,
-                udp_msg_len,
-                0L,
-                (const struct sockaddr *) &udp_notification_sockaddr_in6,
-                sizeof(sockaddr_in6_t)) == -1) {
-      printfBothTime("\n[Failed (%s line %d): unable to send to the UDP notification socket (%d %s/%d)] udp_msg_len %d\n", __FILE__, __LINE__,
-              (int)udp_notification_socket_id, udp_notification_ipv6_string , UDP_NOTIFICATION_PORT, udp_msg_len);
-    } else {
-      messages_processed++;
-    }
+  // The same message is sent to both UDP and CoAP, without intermediate copies
+  msg_len = (uint16_t)strlen(in_msg);
+  if ((_to_coap == true) && (msg_len > SL_WISUN_STATUS_JSON_STR_MAX_LEN)) {
+    printfBothTime("\n[Failed (line %d): CoAP message len %d is higher than MAX %d]. Message not sent because it would overflow\n", __LINE__,
+            msg_len, SL_WISUN_STATUS_JSON_STR_MAX_LEN);
+    _to_coap = false;
   }
-#ifdef    SL_WISUN_COAP_H
-  if (_to_coap == true) {    // Send to CoAP notification port
-    coap_msg_len = snprintf(coap_msg, 1024, "%s", in_msg);
-    if (coap_msg_len > SL_WISUN_STATUS_JSON_STR_MAX_LEN) {
-        printfBothTime("\n[Failed (line %d): CoAP message len %d is higher than MAX %d]. Message not sent because it would overflow\n", __LINE__,
-                coap_msg_len, SL_WISUN_STATUS_JSON_STR_MAX_LEN);
-    } else {
-      ret = _coap_notify(coap_msg);
-      IF_ERROR(ret, "[Failed (line %d): unable to send to the CoAP notification socket (%d %s/%d): 0x%04x. Check sl_status.h]\n", __LINE__,
-              (int)coap_notification_socket_id, coap_notification_ipv6_string, COAP_NOTIFICATION_PORT, (uint16_t)ret);
-      if (ret == SL_STATUS_OK) messages_processed++;
+  messages_processed += app_notify_send((const uint8_t *)in_msg, msg_len, false, _to_udp, _to_coap);
+
+  return messages_processed;
+}
+
+// Status and connection messages: always printed as JSON,
+//  sent as JSON or TLV depending on app_parameters.notification_format.
+//  TLV status messages are delta-encoded if app_parameters.keyframe_interval is set
+uint8_t print_and_send_notification (uint8_t msg_type, char *json_msg, bool _with_time,
+                            bool _to_console, bool _to_rtt, bool _to_udp, bool _to_coap) {
+  uint8_t messages_processed;
+  uint16_t tlv_len;
+  uint8_t *msg;
+  uint64_t start_tick;
+
+  if (app_parameters.notification_format != APP_NOTIFICATION_FORMAT_TLV) {
+    return print_and_send_messages(json_msg, _with_time, _to_console, _to_rtt, _to_udp, _to_coap);
+  }
+
+  messages_processed = print_and_send_messages(json_msg, _with_time, _to_console, _to_rtt, false, false);
+  if ((_to_udp == false) && (_to_coap == false)) {
+    return messages_processed;
+  }
+
+  msg = tlv_msg;
+  if (msg_type == APP_TLV_MSG_STATUS) {
+    tlv_len = _status_tlv(tlv_msg, SL_WISUN_STATUS_TLV_MAX_LEN);
+    if (tlv_len && (app_parameters.batch_count > 1)) {
+      return messages_processed + _batch_status(tlv_msg, tlv_len, _to_udp, _to_coap);
     }
+    if (tlv_len && app_parameters.keyframe_interval) {
+      start_tick = sl_sleeptimer_get_tick_count64();
+      msg = tlv_delta_msg;
+      tlv_len = app_tlv_delta_encode(&status_delta, app_parameters.keyframe_interval,
+                                     tlv_msg, tlv_len, tlv_delta_msg, SL_WISUN_STATUS_TLV_MAX_LEN);
+      _encoding_stats_add(&app_notification_stats.delta, tlv_len, start_tick);
+      if (status_delta.keyframe_seq == status_delta.seq) {
+        app_notification_stats.keyframes++;
+      }
+    }
+  } else {
+    tlv_len = _connection_tlv(tlv_msg, SL_WISUN_STATUS_TLV_MAX_LEN);
+    // The receiver may have missed status messages: restart with a keyframe
+    app_tlv_delta_reset(&status_delta);
+    // Send pending samples first, to keep messages in order
+    if (status_batch.count) {
+      messages_processed += _batch_flush(_to_udp, _to_coap);
+    }
+  }
+  if (tlv_len == 0) {
+    printfBothTime("\n[Failed (line %d): TLV message type %d is longer than %d bytes]. Message not sent\n", __LINE__,
+            msg_type, SL_WISUN_STATUS_TLV_MAX_LEN);
+    return messages_processed;
   }
-#endif /* SL_WISUN_COAP_H */
 
+  return messages_processed + app_notify_send(msg, tlv_len, true, _to_udp, _to_coap);
+}
+
+// Add a status record to the batch, sending the batch once a threshold is reached
+uint8_t _batch_status(const uint8_t *record, uint16_t record_len, bool _to_udp, bool _to_coap) {
+  app_tlv_batch_result_t result;
+  uint16_t max_bytes;
+  uint8_t messages_processed = 0;
+
+  max_bytes = app_parameters.batch_max_bytes;
+  if ((max_bytes == 0) || (max_bytes > sizeof(batch_msg))) {
+    max_bytes = sizeof(batch_msg);
+  }
+  result = app_tlv_batch_add(&status_batch, batch_msg, max_bytes, app_parameters.batch_count,
+                             app_parameters.batch_max_age_sec, now_sec(), record, record_len);
+  if (result == APP_TLV_BATCH_FULL) {
+    messages_processed += _batch_flush(_to_udp, _to_coap);
+    result = app_tlv_batch_add(&status_batch, batch_msg, max_bytes, app_parameters.batch_count,
+                               app_parameters.batch_max_age_sec, now_sec(), record, record_len);
+  }
+  if (result == APP_TLV_BATCH_TOO_LONG) {
+    // Does not fit in a batch: send it alone
+    return messages_processed + app_notify_send(record, record_len, true, _to_udp, _to_coap);
+  }
+  app_notification_stats.batch_samples++;
+  if (batch_asap || (result == APP_TLV_BATCH_READY)) {
+    messages_processed += _batch_flush(_to_udp, _to_coap);
+  }
   return messages_processed;
 }
+
+uint8_t _batch_flush(bool _to_udp, bool _to_coap) {
+  uint16_t len;
+
+  len = app_tlv_batch_end(&status_batch, now_sec());
+  if (len == 0) {
+    return 0;
+  }
+  app_notification_stats.batches++;
+  return app_notify_send(batch_msg, len, true, _to_udp, _to_coap);
+}
@@ -65,11 +65,22 @@ extern "C" {
   #include "app_check_neighbors.h"
 #endif
 
+#if __has_include("app_stats_snapshot.h")
+  #include "app_stats_snapshot.h"
+#endif
+
+#if __has_include("app_send_slot.h")
+  #include "app_send_slot.h"
+#endif
+
 #ifdef   SL_CATALOG_WISUN_COAP_PRESENT
   // app_coap.c/h can only be used if the WI-SUN CoAP Component is present
   #if __has_include("app_coap.h")
     #include "app_coap.h"
   #endif
+  #if __has_include("app_coap_observe.h")
+    #include "app_coap_observe.h"
+  #endif
 #endif /* SL_CATALOG_WISUN_COAP_PRESENT */
 
 #if __has_include("ltn_config.h")
@@ -122,6 +133,17 @@ extern "C" {
 #define   SL_WISUN_COAP_RESOURCE_HND_SOCK_BUFF_SIZE 1024
 #endif /* SL_CATALOG_WISUN_COAP_PRESENT */
 
+// Events waking up app_task() before its next deadline (see app_task_notify())
+#define APP_TASK_EVENT_SEND_ASAP    (1UL << 0)
+#define APP_TASK_EVENT_JOIN_STATE   (1UL << 1)
+#define APP_TASK_EVENT_SOCKET       (1UL << 2)
+#define APP_TASK_EVENTS_ALL         (APP_TASK_EVENT_SEND_ASAP  | \
+                                     APP_TASK_EVENT_JOIN_STATE | \
+                                     APP_TASK_EVENT_SOCKET)
+
+// Largest app_status_record() record (about 400 bytes with long application/version strings)
+#define APP_STATUS_RECORD_MAX_LEN   480
+
 // -----------------------------------------------------------------------------
 //                                Global Variables
 // -----------------------------------------------------------------------------
@@ -143,6 +165,20 @@ uint8_t app_join_network(uint8_t network_index);
 void app_task(void *args);
 void app_do_your_things();
 void app_reset_statistics(void);
+
+/* Wake app_task() up for the given APP_TASK_EVENT_xxx events. Safe from callbacks */
+void app_task_notify(uint32_t events);
+
+/* app_task() wake-up counters, as a JSON string in 'buf' */
+char* app_task_loop_stats_string(char *buf, uint16_t size);
+void  app_task_loop_stats_reset(void);
+
+/* Notification size and encoding time per format, as a JSON string in 'buf' */
+char* app_notification_stats_string(char *buf, uint16_t size);
+void  app_notification_stats_reset(void);
+
+/* Current status as a TLV record (see app_tlv.h), including the fields only sent on request */
+uint16_t app_status_record(uint8_t *buf, uint16_t size);
 void refresh_parent_tag(void);
 
 char* status_json_string (char * start_text);
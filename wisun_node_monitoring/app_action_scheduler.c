@@ -45,16 +45,46 @@
 #include "sl_sleeptimer.h"
 #include "cmsis_os2.h"
 #include "em_core.h"
+#include "em_device.h"
 #include "printf.h"
 
+#if (APP_SCHEDULER_MAX_SLOTS < 1U) || (APP_SCHEDULER_MAX_SLOTS > APP_SCHEDULER_SLOTS_LIMIT)
+  #error "APP_SCHEDULER_MAX_SLOTS must be between 1 and APP_SCHEDULER_SLOTS_LIMIT"
+#endif
+#if (APP_SCHEDULER_SLOTS_LIMIT > 4096U)
+  #error "APP_SCHEDULER_SLOTS_LIMIT must be at most 4096"
+#endif
+
 // -----------------------------------------------------------------------------
 // Local state
 // -----------------------------------------------------------------------------
 
+// Binary min-heap: g_scheduler_queue[0] is the next deadline, the children of
+// entry i are entries 2i+1 and 2i+2
 static app_scheduler_action_state_t g_scheduler_queue[APP_SCHEDULER_MAX_SLOTS];
-static uint8_t g_scheduler_count;
+
+// Entries of the same callback hash, linked by heap index: g_scheduler_buckets[] is the
+// first entry of each bucket, g_scheduler_links[i] the previous and next entries of entry i.
+// The links follow the entries when the heap moves them, so the entries of a callback are
+// found without scanning the heap.
+#define APP_SCHEDULER_NO_ENTRY 0xFFFFU
+typedef struct {
+  uint16_t prev;
+  uint16_t next;
+} queue_link_t;
+static queue_link_t g_scheduler_links[APP_SCHEDULER_MAX_SLOTS];
+static uint16_t g_scheduler_buckets[APP_SCHEDULER_MAX_SLOTS];
+static uint16_t g_scheduler_count;
+static uint32_t g_scheduler_sequence;
 static sl_sleeptimer_timer_handle_t g_scheduler_timer;
 
+// Usage counters, updated in the critical sections
+static uint16_t g_scheduler_max_count;
+static uint32_t g_scheduler_scheduled;
+static uint32_t g_scheduler_rejected;
+static uint32_t g_scheduler_fired;
+static uint32_t g_scheduler_max_critical_cycles;
+
 static osThreadId_t g_scheduler_task_id;
 static osEventFlagsId_t g_scheduler_flags;
 
@@ -74,6 +104,10 @@ static const osThreadAttr_t g_scheduler_task_attr = {
 
 static void scheduler_timer_cb(sl_sleeptimer_timer_handle_t *handle, void *data);
 
+#ifndef MIN
+  #define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
@@ -91,37 +125,202 @@ static uint64_t now_ms(void)
   return (ticks * 1000ULL) / (uint64_t)freq;
 }
 
-// Remove one entry and keep the queue densely packed and deadline ordered (index 0 = next deadline)
-static void queue_remove(uint8_t idx)
+// Critical section length, from the cycle count at its start
+static void critical_section_end(uint32_t start_cycles)
 {
-  uint8_t i;
+  uint32_t cycles = DWT->CYCCNT - start_cycles;
 
-  if (idx >= g_scheduler_count) {
-    return;
+  if (cycles > g_scheduler_max_critical_cycles) {
+    g_scheduler_max_critical_cycles = cycles;
   }
+}
 
-  for (i = idx; (i + 1U) < g_scheduler_count; ++i) {
-    g_scheduler_queue[i] = g_scheduler_queue[i + 1U];
+// Heap order: earliest deadline first, then first scheduled first (as the former sorted array)
+static bool queue_before(const app_scheduler_action_state_t *a,
+                         const app_scheduler_action_state_t *b)
+{
+  if (a->deadline_ms != b->deadline_ms) {
+    return a->deadline_ms < b->deadline_ms;
   }
+  return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+// Hash bucket of a callback, for the entries of the same callback
+static uint16_t queue_bucket(app_scheduler_action_fn_t action_fn)
+{
+  // Thumb function addresses are odd: drop bit 0 before the multiplicative hash
+  return (uint16_t)((uint32_t)((uint32_t)((uintptr_t)action_fn >> 1) * 2654435761UL)
+                    % APP_SCHEDULER_MAX_SLOTS);
+}
 
-  if (g_scheduler_count > 0U) {
-    g_scheduler_count--;
-    memset(&g_scheduler_queue[g_scheduler_count], 0, sizeof(g_scheduler_queue[0]));
+// Add the entry at 'idx' first in the list of its bucket
+static void queue_link(uint16_t idx)
+{
+  uint16_t bucket = queue_bucket(g_scheduler_queue[idx].action_fn);
+  uint16_t head = g_scheduler_buckets[bucket];
+
+  g_scheduler_links[idx].prev = APP_SCHEDULER_NO_ENTRY;
+  g_scheduler_links[idx].next = head;
+  if (head != APP_SCHEDULER_NO_ENTRY) {
+    g_scheduler_links[head].prev = idx;
   }
+  g_scheduler_buckets[bucket] = idx;
 }
 
-// Insert while preserving deadline order so queue[0] is always the next due item.
-static void queue_insert(const app_scheduler_action_state_t *state)
+// Remove the entry at 'idx' from the list of its bucket
+static void queue_unlink(uint16_t idx)
+{
+  uint16_t prev = g_scheduler_links[idx].prev;
+  uint16_t next = g_scheduler_links[idx].next;
+
+  if (prev != APP_SCHEDULER_NO_ENTRY) {
+    g_scheduler_links[prev].next = next;
+  } else {
+    g_scheduler_buckets[queue_bucket(g_scheduler_queue[idx].action_fn)] = next;
+  }
+  if (next != APP_SCHEDULER_NO_ENTRY) {
+    g_scheduler_links[next].prev = prev;
+  }
+}
+
+// Move a linked entry from 'from' to 'to', its neighbors in the bucket list follow it
+static void queue_move(uint16_t to, uint16_t from)
+{
+  queue_link_t link = g_scheduler_links[from];
+
+  g_scheduler_queue[to] = g_scheduler_queue[from];
+  g_scheduler_links[to] = link;
+  if (link.prev != APP_SCHEDULER_NO_ENTRY) {
+    g_scheduler_links[link.prev].next = to;
+  } else {
+    g_scheduler_buckets[queue_bucket(g_scheduler_queue[to].action_fn)] = to;
+  }
+  if (link.next != APP_SCHEDULER_NO_ENTRY) {
+    g_scheduler_links[link.next].prev = to;
+  }
+}
+
+// Move the unlinked 'state' up from the hole at 'idx' to its place, then link it
+static void queue_sift_up(uint16_t idx, const app_scheduler_action_state_t *state)
 {
-  uint8_t i = g_scheduler_count;
+  while (idx > 0U) {
+    uint16_t parent = (uint16_t)((idx - 1U) / 2U);
 
-  while ((i > 0U) && (g_scheduler_queue[i - 1U].deadline_ms > state->deadline_ms)) {
-    g_scheduler_queue[i] = g_scheduler_queue[i - 1U];
-    i--;
+    if (!queue_before(state, &g_scheduler_queue[parent])) {
+      break;
+    }
+    queue_move(idx, parent);
+    idx = parent;
   }
+  g_scheduler_queue[idx] = *state;
+  queue_link(idx);
+}
 
-  g_scheduler_queue[i] = *state;
+// Move the unlinked 'state' down from the hole at 'idx' to its place, then link it
+static void queue_sift_down(uint16_t idx, const app_scheduler_action_state_t *state)
+{
+  for (;;) {
+    uint32_t child = 2U * (uint32_t)idx + 1U;
+
+    if (child >= g_scheduler_count) {
+      break;
+    }
+    if (((child + 1U) < g_scheduler_count)
+        && queue_before(&g_scheduler_queue[child + 1U], &g_scheduler_queue[child])) {
+      child++;
+    }
+    if (!queue_before(&g_scheduler_queue[child], state)) {
+      break;
+    }
+    queue_move(idx, (uint16_t)child);
+    idx = (uint16_t)child;
+  }
+  g_scheduler_queue[idx] = *state;
+  queue_link(idx);
+}
+
+// Remove the entry at 'idx', replaced by the last one moved up or down to its place (O(log n))
+static void queue_remove_at(uint16_t idx)
+{
+  app_scheduler_action_state_t last;
+
+  queue_unlink(idx);
+  g_scheduler_count--;
+  if (idx != g_scheduler_count) {
+    last = g_scheduler_queue[g_scheduler_count];
+    queue_unlink(g_scheduler_count);
+    if ((idx > 0U) && queue_before(&last, &g_scheduler_queue[(idx - 1U) / 2U])) {
+      queue_sift_up(idx, &last);
+    } else {
+      queue_sift_down(idx, &last);
+    }
+  }
+  memset(&g_scheduler_queue[g_scheduler_count], 0, sizeof(g_scheduler_queue[0]));
+}
+
+// Remove the next due entry (queue[0])
+static void queue_remove_first(void)
+{
+  if (g_scheduler_count == 0U) {
+    return;
+  }
+  queue_remove_at(0U);
+}
+
+// Insert at the end of the heap and move up to its place, so queue[0] is always the next due item.
+static void queue_insert(const app_scheduler_action_state_t *state)
+{
+  app_scheduler_action_state_t local = *state;
+
+  local.sequence = g_scheduler_sequence++;
   g_scheduler_count++;
+  queue_sift_up((uint16_t)(g_scheduler_count - 1U), &local);
+  if (g_scheduler_count > g_scheduler_max_count) {
+    g_scheduler_max_count = g_scheduler_count;
+  }
+}
+
+// First entry of 'action_fn' in its bucket, or APP_SCHEDULER_NO_ENTRY
+static uint16_t queue_find(app_scheduler_action_fn_t action_fn)
+{
+  uint16_t idx = g_scheduler_buckets[queue_bucket(action_fn)];
+
+  while ((idx != APP_SCHEDULER_NO_ENTRY) && (g_scheduler_queue[idx].action_fn != action_fn)) {
+    idx = g_scheduler_links[idx].next;
+  }
+  return idx;
+}
+
+// Entry of 'action_fn' with the earliest deadline, or APP_SCHEDULER_NO_ENTRY
+static uint16_t queue_find_earliest(app_scheduler_action_fn_t action_fn)
+{
+  uint16_t idx;
+  uint16_t earliest = APP_SCHEDULER_NO_ENTRY;
+
+  // Only the entries of the same bucket: the instances of this callback (usually one)
+  //  and the callbacks with the same hash
+  for (idx = queue_find(action_fn); idx != APP_SCHEDULER_NO_ENTRY; idx = g_scheduler_links[idx].next) {
+    if ((g_scheduler_queue[idx].action_fn == action_fn)
+        && ((earliest == APP_SCHEDULER_NO_ENTRY)
+            || queue_before(&g_scheduler_queue[idx], &g_scheduler_queue[earliest]))) {
+      earliest = idx;
+    }
+  }
+  return earliest;
+}
+
+// Remove all entries of 'action_fn', found in their bucket: O(log n) per entry
+static bool queue_remove_all(app_scheduler_action_fn_t action_fn)
+{
+  uint16_t idx;
+  bool removed = false;
+
+  // Removing an entry moves the last one: look again from the bucket head
+  while ((idx = queue_find(action_fn)) != APP_SCHEDULER_NO_ENTRY) {
+    queue_remove_at(idx);
+    removed = true;
+  }
+  return removed;
 }
 
 // Must be called with the scheduler lock held. It always arms only the earliest deadline.
@@ -157,6 +356,61 @@ static void rearm_timer_locked(void)
   }
 }
 
+// Lateness of the callback start, against the ideal deadline
+static void record_start(app_scheduler_action_state_t *local, uint64_t current_ms)
+{
+  uint64_t late_ms = (current_ms > local->deadline_ms) ? (current_ms - local->deadline_ms) : 0U;
+
+  local->stats.runs++;
+  local->stats.total_late_ms += late_ms;
+  if (late_ms > local->stats.max_late_ms) {
+    local->stats.max_late_ms = (late_ms > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)late_ms;
+  }
+}
+
+// Next deadline of a periodic action, after its callback returned
+static void reschedule_periodic(app_scheduler_action_state_t *local)
+{
+  uint64_t current_ms = now_ms();
+  uint64_t missed;
+
+  if (local->mode == APP_SCHEDULER_FIXED_DELAY) {
+    // The next period starts after the current callback finishes.
+    local->start_ms = current_ms;
+    local->deadline_ms = current_ms + (uint64_t)local->period_ms;
+    return;
+  }
+
+  // Fixed rate: the next deadline only depends on the first one, whatever the
+  // callback duration and worker latency.
+  local->deadline_ms += (uint64_t)local->period_ms;
+  if (local->deadline_ms > current_ms) {
+    local->catching_up = false;
+    return;
+  }
+
+  // Overrun: the next deadline(s) already passed. Counted once, for the callback
+  // that overran: the catch-up runs that follow also return after their next
+  // deadline, but only because they started late.
+  if (!local->catching_up) {
+    local->stats.overruns++;
+  }
+  missed = (current_ms - local->deadline_ms) / (uint64_t)local->period_ms + 1U;
+  if (local->mode == APP_SCHEDULER_FIXED_RATE_SKIP) {
+    // Resume at the next deadline still in the future
+    local->deadline_ms += missed * (uint64_t)local->period_ms;
+    local->stats.skipped += (uint32_t)MIN(missed, 0xFFFFFFFFULL);
+  } else {
+    local->catching_up = true;
+    if (missed > APP_SCHEDULER_MAX_CATCH_UP) {
+      // Catch up, but only run the last APP_SCHEDULER_MAX_CATCH_UP missed periods
+      missed -= APP_SCHEDULER_MAX_CATCH_UP;
+      local->deadline_ms += missed * (uint64_t)local->period_ms;
+      local->stats.skipped += (uint32_t)MIN(missed, 0xFFFFFFFFULL);
+    }
+  }
+}
+
 // Thin wrapper around the user callback so NULL handling stays in one place.
 static uint32_t execute_action(const app_scheduler_action_state_t *local)
 {
@@ -176,26 +430,32 @@ static void process_due_actions(void)
     bool have_due = false;
     bool requeue = false;
     uint64_t current_ms;
+    uint32_t start_cycles;
 
     CORE_DECLARE_IRQ_STATE;
     CORE_ENTER_CRITICAL();
+    start_cycles = DWT->CYCCNT;
 
     if (g_scheduler_count > 0U) {
       current_ms = now_ms();
       if (g_scheduler_queue[0].deadline_ms <= current_ms) {
         local = g_scheduler_queue[0];
-        queue_remove(0U);
+        queue_remove_first();
+        record_start(&local, current_ms);
+        g_scheduler_fired++;
         have_due = true;
       }
     }
 
     if (!have_due) {
       rearm_timer_locked();
+      critical_section_end(start_cycles);
       CORE_EXIT_CRITICAL();
       break;
     }
 
     // User code runs outside the critical section to avoid blocking scheduling.
+    critical_section_end(start_cycles);
     CORE_EXIT_CRITICAL();
 
     uint32_t result = execute_action(&local);
@@ -204,20 +464,21 @@ static void process_due_actions(void)
                      (unsigned long)result);
     }
 
-    // Periodic actions use fixed-delay scheduling: the next period starts after
-    // the current callback finishes.
     if (local.periodic) {
-      local.start_ms = now_ms();
-      local.deadline_ms = local.start_ms + (uint64_t)local.period_ms;
+      reschedule_periodic(&local);
       requeue = true;
     }
 
     if (requeue) {
       CORE_ENTER_CRITICAL();
+      start_cycles = DWT->CYCCNT;
       if (g_scheduler_count < APP_SCHEDULER_MAX_SLOTS) {
         queue_insert(&local);
+      } else {
+        g_scheduler_rejected++;
       }
       rearm_timer_locked();
+      critical_section_end(start_cycles);
       CORE_EXIT_CRITICAL();
     }
   }
@@ -257,9 +518,14 @@ static void scheduler_task(void *argument)
 void app_scheduler_action_init(void)
 {
   memset(g_scheduler_queue, 0, sizeof(g_scheduler_queue));
+  memset(g_scheduler_buckets, 0xFF, sizeof(g_scheduler_buckets));
   g_scheduler_count = 0U;
   memset(&g_scheduler_timer, 0, sizeof(g_scheduler_timer));
 
+  // Cycle counter, for the critical sections length
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
   g_scheduler_flags = osEventFlagsNew(NULL);
   g_scheduler_task_id = osThreadNew(scheduler_task, NULL, &g_scheduler_task_attr);
   (void)g_scheduler_task_id;
@@ -269,16 +535,28 @@ bool app_scheduler_action_schedule(app_scheduler_action_fn_t action_fn,
                                    uint32_t delay_ms,
                                    uint32_t period_ms,
                                    void *context)
+{
+  return app_scheduler_action_schedule_ex(action_fn, delay_ms, period_ms,
+                                          APP_SCHEDULER_FIXED_DELAY, context);
+}
+
+bool app_scheduler_action_schedule_ex(app_scheduler_action_fn_t action_fn,
+                                      uint32_t delay_ms,
+                                      uint32_t period_ms,
+                                      app_scheduler_mode_t mode,
+                                      void *context)
 {
   app_scheduler_action_state_t state;
+  uint32_t start_cycles;
 
-  if (action_fn == NULL) {
+  if ((action_fn == NULL) || (mode > APP_SCHEDULER_FIXED_RATE_SKIP)) {
     return false;
   }
 
   memset(&state, 0, sizeof(state));
   state.active = true;
   state.periodic = (period_ms != 0U);
+  state.mode = (uint8_t)mode;
   state.action_fn = action_fn;
   state.delay_ms = delay_ms;
   state.period_ms = period_ms;
@@ -288,12 +566,17 @@ bool app_scheduler_action_schedule(app_scheduler_action_fn_t action_fn,
 
   CORE_DECLARE_IRQ_STATE;
   CORE_ENTER_CRITICAL();
+  start_cycles = DWT->CYCCNT;
   if (g_scheduler_count >= APP_SCHEDULER_MAX_SLOTS) {
+    g_scheduler_rejected++;
+    critical_section_end(start_cycles);
     CORE_EXIT_CRITICAL();
     return false;
   }
   queue_insert(&state);
+  g_scheduler_scheduled++;
   rearm_timer_locked();
+  critical_section_end(start_cycles);
   CORE_EXIT_CRITICAL();
 
   return true;
@@ -301,25 +584,20 @@ bool app_scheduler_action_schedule(app_scheduler_action_fn_t action_fn,
 
 bool app_scheduler_action_stop(app_scheduler_action_fn_t action_fn)
 {
-  bool stopped = false;
-  uint8_t i;
+  bool stopped;
+  uint32_t start_cycles;
 
   CORE_DECLARE_IRQ_STATE;
   CORE_ENTER_CRITICAL();
+  start_cycles = DWT->CYCCNT;
 
-  for (i = 0U; i < g_scheduler_count;) {
-    if (g_scheduler_queue[i].action_fn == action_fn) {
-      queue_remove(i);
-      stopped = true;
-    } else {
-      i++;
-    }
-  }
+  stopped = queue_remove_all(action_fn);
 
   if (stopped) {
     rearm_timer_locked();
   }
 
+  critical_section_end(start_cycles);
   CORE_EXIT_CRITICAL();
   return stopped;
 }
@@ -327,26 +605,130 @@ bool app_scheduler_action_stop(app_scheduler_action_fn_t action_fn)
 bool app_scheduler_action_get_remaining(app_scheduler_action_fn_t action_fn,
                                         uint32_t *remaining_ms)
 {
-  uint8_t i;
+  uint16_t idx;
   uint64_t current_ms;
-  bool found = false;
+  uint64_t deadline_ms = 0U;
+  bool found;
 
   CORE_DECLARE_IRQ_STATE;
   CORE_ENTER_CRITICAL();
   current_ms = now_ms();
-  for (i = 0U; i < g_scheduler_count; ++i) {
-    if (g_scheduler_queue[i].action_fn == action_fn) {
-      uint64_t remaining = (g_scheduler_queue[i].deadline_ms > current_ms)
-                           ? (g_scheduler_queue[i].deadline_ms - current_ms)
-                           : 0U;
-      if (remaining_ms != NULL) {
-        *remaining_ms = (remaining > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)remaining;
-      }
-      found = true;
-      break;
-    }
+  idx = queue_find_earliest(action_fn);
+  found = (idx != APP_SCHEDULER_NO_ENTRY);
+  if (found) {
+    deadline_ms = g_scheduler_queue[idx].deadline_ms;
   }
   CORE_EXIT_CRITICAL();
 
+  if (found && (remaining_ms != NULL)) {
+    uint64_t remaining = (deadline_ms > current_ms) ? (deadline_ms - current_ms) : 0U;
+    *remaining_ms = (remaining > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)remaining;
+  }
+
   return found;
 }
+
+bool app_scheduler_action_get_stats(app_scheduler_action_fn_t action_fn,
+                                    app_scheduler_action_stats_t *stats)
+{
+  uint16_t idx;
+  bool found;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  idx = queue_find_earliest(action_fn);
+  found = (idx != APP_SCHEDULER_NO_ENTRY);
+  if (found && (stats != NULL)) {
+    *stats = g_scheduler_queue[idx].stats;
+  }
+  CORE_EXIT_CRITICAL();
+
+  return found;
+}
+
+char *app_scheduler_statistics_string(char *buf, uint16_t size)
+{
+  uint16_t count;
+  uint16_t max_count;
+  uint32_t scheduled;
+  uint32_t rejected;
+  uint32_t fired;
+  uint32_t max_critical_cycles;
+  uint16_t len;
+  uint16_t i;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  count = g_scheduler_count;
+  max_count = g_scheduler_max_count;
+  scheduled = g_scheduler_scheduled;
+  rejected = g_scheduler_rejected;
+  fired = g_scheduler_fired;
+  max_critical_cycles = g_scheduler_max_critical_cycles;
+  CORE_EXIT_CRITICAL();
+
+  len = (uint16_t)snprintf(buf, size,
+           "{\"capacity\":%u,\"count\":%u,\"max_count\":%u,\"scheduled\":%lu,"
+           "\"rejected\":%lu,\"fired\":%lu,\"max_critical_cycles\":%lu,\"periodic\":[",
+           (unsigned)APP_SCHEDULER_MAX_SLOTS,
+           (unsigned)count,
+           (unsigned)max_count,
+           (unsigned long)scheduled,
+           (unsigned long)rejected,
+           (unsigned long)fired,
+           (unsigned long)max_critical_cycles);
+
+  // One entry at a time, to keep formatting out of the critical section
+  for (i = 0U; len < size; ++i) {
+    app_scheduler_action_state_t entry;
+    bool have_entry;
+
+    CORE_ENTER_CRITICAL();
+    have_entry = (i < g_scheduler_count);
+    if (have_entry) {
+      entry = g_scheduler_queue[i];
+    }
+    CORE_EXIT_CRITICAL();
+
+    if (!have_entry) {
+      break;
+    }
+    if (!entry.periodic) {
+      continue;
+    }
+    len += (uint16_t)snprintf(buf + len, size - len,
+           "%s{\"fn\":\"0x%08lx\",\"period_ms\":%lu,\"mode\":\"%s\",\"runs\":%lu,"
+           "\"overruns\":%lu,\"skipped\":%lu,\"avg_late_ms\":%lu,\"max_late_ms\":%lu}",
+           (buf[len - 1] == '[') ? "" : ",",
+           (unsigned long)(uintptr_t)entry.action_fn,
+           (unsigned long)entry.period_ms,
+           (entry.mode == APP_SCHEDULER_FIXED_RATE_CATCH_UP) ? "catch_up"
+           : (entry.mode == APP_SCHEDULER_FIXED_RATE_SKIP) ? "skip" : "delay",
+           (unsigned long)entry.stats.runs,
+           (unsigned long)entry.stats.overruns,
+           (unsigned long)entry.stats.skipped,
+           (unsigned long)(entry.stats.runs ? entry.stats.total_late_ms / entry.stats.runs : 0U),
+           (unsigned long)entry.stats.max_late_ms);
+  }
+  if (len < size) {
+    snprintf(buf + len, size - len, "]}");
+  }
+  return buf;
+}
+
+void app_scheduler_statistics_reset(void)
+{
+  uint16_t i;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  g_scheduler_max_count = g_scheduler_count;
+  g_scheduler_scheduled = 0U;
+  g_scheduler_rejected = 0U;
+  g_scheduler_fired = 0U;
+  g_scheduler_max_critical_cycles = 0U;
+  for (i = 0U; i < g_scheduler_count; ++i) {
+    memset(&g_scheduler_queue[i].stats, 0, sizeof(g_scheduler_queue[i].stats));
+  }
+  CORE_EXIT_CRITICAL();
+}
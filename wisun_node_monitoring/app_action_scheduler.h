@@ -46,20 +46,64 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define APP_SCHEDULER_MAX_SLOTS 8U
+// Scheduled actions are kept in a binary min-heap ordered by deadline, so scheduling
+//  and firing an action is O(log n) in the critical section, whatever the capacity.
+//  The actions are also linked in hash buckets of their callback: app_scheduler_action_stop()
+//  is O(log n) per stopped action, get_remaining() and get_stats() only look at the
+//  actions of the same bucket (see linux_border_router_wsbrd/host_benchmarks).
+//  Each slot uses sizeof(app_scheduler_action_state_t) (64 bytes) + 6 bytes of RAM.
+#ifndef   APP_SCHEDULER_MAX_SLOTS
+  #define APP_SCHEDULER_MAX_SLOTS 32U   // up to APP_SCHEDULER_SLOTS_LIMIT
+#endif /* APP_SCHEDULER_MAX_SLOTS */
+// Largest capacity: 256 slots are 17.5 KB of RAM (only raised by the host benchmarks)
+#ifndef   APP_SCHEDULER_SLOTS_LIMIT
+  #define APP_SCHEDULER_SLOTS_LIMIT 256U
+#endif /* APP_SCHEDULER_SLOTS_LIMIT */
+
+// Max number of missed periods run back to back by a APP_SCHEDULER_FIXED_RATE_CATCH_UP
+//  action after an overrun, the older ones are skipped
+#ifndef   APP_SCHEDULER_MAX_CATCH_UP
+  #define APP_SCHEDULER_MAX_CATCH_UP 4U
+#endif /* APP_SCHEDULER_MAX_CATCH_UP */
 
 typedef uint32_t (*app_scheduler_action_fn_t)(void *context);
 
+// Rescheduling of periodic actions
+typedef enum {
+  // Next deadline one period after the callback returns (drifts by the callback duration and latency)
+  APP_SCHEDULER_FIXED_DELAY = 0,
+  // Next deadline one period after the previous deadline. After an overrun, the missed
+  //  periods are run back to back (up to APP_SCHEDULER_MAX_CATCH_UP)
+  APP_SCHEDULER_FIXED_RATE_CATCH_UP,
+  // Next deadline one period after the previous deadline. After an overrun, the missed
+  //  periods are skipped, to resume at the next deadline in the future
+  APP_SCHEDULER_FIXED_RATE_SKIP,
+} app_scheduler_mode_t;
+
+// Per action counters, kept while a periodic action is rescheduled
+typedef struct {
+  uint32_t                  runs;           // callback calls
+  uint32_t                  overruns;       // callbacks returning after the next deadline (fixed rate,
+                                            //  catch-up runs not counted)
+  uint32_t                  skipped;        // periods not run after overruns (fixed rate)
+  uint32_t                  max_late_ms;    // max delay between the deadline and the callback call
+  uint64_t                  total_late_ms;  // sum of these delays, for the average jitter
+} app_scheduler_action_stats_t;
+
 // Small state struct, if you ever want to expose more info.
 typedef struct {
   bool                      active;
   bool                      periodic;
+  uint8_t                   mode;       // app_scheduler_mode_t
+  bool                      catching_up; // running missed periods after an overrun (catch up)
   app_scheduler_action_fn_t action_fn;
   uint32_t                  delay_ms;
   uint32_t                  period_ms;
   uint64_t                  start_ms;
   uint64_t                  deadline_ms;
   void                      *context;
+  uint32_t                  sequence;   // scheduling order, for actions with the same deadline
+  app_scheduler_action_stats_t stats;
 } app_scheduler_action_state_t;
 
 void app_scheduler_action_init(void);
@@ -78,8 +122,27 @@ bool app_scheduler_action_schedule(app_scheduler_action_fn_t action_fn,
                                    uint32_t period_ms,
                                    void *context);
 
+/**
+ * Schedule a scheduler action, with the rescheduling mode of periodic actions.
+ *
+ * @param action_fn    Callback to execute when the delay expires.
+ * @param delay_ms     Delay in milliseconds.
+ * @param period_ms    Period for repeated execution, 0 for one-shot scheduling.
+ * @param mode         Fixed delay (as app_scheduler_action_schedule()) or fixed rate,
+ *                     catching up or skipping the missed periods after an overrun.
+ * @param context      Optional user context passed to the action callback.
+ * @return true on success (timer started), false on error.
+ */
+bool app_scheduler_action_schedule_ex(app_scheduler_action_fn_t action_fn,
+                                      uint32_t delay_ms,
+                                      uint32_t period_ms,
+                                      app_scheduler_mode_t mode,
+                                      void *context);
+
 /**
  * Stop all scheduled instances of the given callback.
+ * O(log n) per instance with interrupts disabled: the instances are found in the
+ * hash bucket of the callback, each one is replaced by the last heap entry.
  *
  * @param action_fn Callback to stop.
  * @return true if at least one instance was stopped.
@@ -88,13 +151,43 @@ bool app_scheduler_action_stop(app_scheduler_action_fn_t action_fn);
 
 /**
  * Get remaining time for the earliest scheduled instance of a callback.
+ * Only the actions of the hash bucket of the callback are looked at.
  *
  * @param action_fn    Callback to query.
  * @param remaining_ms [out] remaining time, 0 if already due.
  * @return true if at least one matching callback is scheduled.
  */
-bool app_scheduler_action_get_remaining(app_scheduler_action_fn_t action_fn, 
+bool app_scheduler_action_get_remaining(app_scheduler_action_fn_t action_fn,
                                         uint32_t *remaining_ms);
 
+/**
+ * Get the counters (runs, overruns, skipped periods, jitter) of the earliest
+ * scheduled instance of a callback.
+ * Only the actions of the hash bucket of the callback are looked at.
+ *
+ * @param action_fn    Callback to query.
+ * @param stats        [out] counters of the callback.
+ * @return true if at least one matching callback is scheduled.
+ */
+bool app_scheduler_action_get_stats(app_scheduler_action_fn_t action_fn,
+                                    app_scheduler_action_stats_t *stats);
+
+/**
+ * Scheduler usage counters.
+ *
+ * @param buf  Buffer for the counters.
+ * @param size Size of buf.
+ * @return buf, with the capacity, current/max scheduled actions, actions scheduled,
+ *         rejected (no free slot) and fired, the longest critical section
+ *         (CPU cycles) and the counters of the periodic actions, in json format.
+ */
+char *app_scheduler_statistics_string(char *buf, uint16_t size);
+
+/**
+ * Reset the scheduler usage counters (max scheduled actions set to the current count)
+ * and the counters of the scheduled actions.
+ */
+void app_scheduler_statistics_reset(void);
+
 
 #endif /* APP_ACTION_SCHEDULER_H */
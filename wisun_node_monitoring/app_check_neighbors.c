@@ -41,7 +41,12 @@ extern char json_string[];
 char tag[5];
 
 char * _neighbor_info_str(sl_wisun_neighbor_info_t neighbor_info, uint8_t index, char *tag) {
-  snprintf(json_string, 1024,
+  return _neighbor_info_string(neighbor_info, index, tag, json_string, 1024);
+}
+
+char * _neighbor_info_string(sl_wisun_neighbor_info_t neighbor_info, uint8_t index, char *tag,
+                             char *buf, uint16_t size) {
+  snprintf(buf, size,
   "\"tag\":%s,\n" \
   "\"index\":%d,\n" \
   "\"type\":%ld,\n" \
@@ -69,7 +74,7 @@ char * _neighbor_info_str(sl_wisun_neighbor_info_t neighbor_info, uint8_t index,
   neighbor_info.rsl_out -174,
   neighbor_info.is_lfn
   );
-  return json_string;
+  return buf;
 }
 
 uint8_t app_get_neighbor_info(sl_wisun_neighbor_type_t neighbor_type,
@@ -136,10 +141,15 @@ char * app_child_info_str(uint8_t index) {
 }
 
 char * app_neighbor_info_str(uint8_t index) {
+  return app_neighbor_info_string(index, json_string, 1024);
+}
+
+char * app_neighbor_info_string(uint8_t index, char *buf, uint16_t size) {
   sl_status_t ret;
   uint8_t neighbor_count;
   sl_wisun_neighbor_info_t neighbor_info;
   sl_wisun_mac_address_t *neighbor_mac_addresses = NULL;
+  char neighbor_tag[5];
 
   ret = sl_wisun_get_neighbor_count(&neighbor_count);
   if (ret) printf("[Failed: sl_wisun_get_neighbor_count() returned 0x%04x]\n", (uint16_t)ret);
@@ -153,8 +163,8 @@ char * app_neighbor_info_str(uint8_t index) {
   if (ret) printf("[Failed: sl_wisun_get_neighbors() returned 0x%04x]\n", (uint16_t)ret);
 
   ret = sl_wisun_get_neighbor_info(&neighbor_mac_addresses[index], &neighbor_info);
-  sprintf(tag, "%02x%02x", neighbor_mac_addresses[index].address[6],
-                           neighbor_mac_addresses[index].address[7]);
+  snprintf(neighbor_tag, sizeof(neighbor_tag), "%02x%02x", neighbor_mac_addresses[index].address[6],
+                                                           neighbor_mac_addresses[index].address[7]);
   sl_free(neighbor_mac_addresses);
-  return _neighbor_info_str(neighbor_info, index, tag);
+  return _neighbor_info_string(neighbor_info, index, neighbor_tag, buf, size);
 }
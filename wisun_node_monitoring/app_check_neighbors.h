@@ -44,6 +44,8 @@
 
 
 char *  _neighbor_info_str(sl_wisun_neighbor_info_t neighbor_info, uint8_t index, char *tag);
+char *  _neighbor_info_string(sl_wisun_neighbor_info_t neighbor_info, uint8_t index, char *tag,
+                              char *buf, uint16_t size);
 uint8_t app_get_neighbor_info(sl_wisun_neighbor_type_t neighbor_type,
                                                  uint8_t *index,
                                                  char *tag,
@@ -51,4 +53,6 @@ uint8_t app_get_neighbor_info(sl_wisun_neighbor_type_t neighbor_type,
 char * app_parent_info_str(void);
 char * app_child_info_str(uint8_t index);
 char * app_neighbor_info_str(uint8_t index);
+/* Same as app_neighbor_info_str(), in 'buf' instead of the shared json_string (for CoAP callbacks) */
+char * app_neighbor_info_string(uint8_t index, char *buf, uint16_t size);
 #endif  /* APP_CHECK_NEIGHBORS_H */
@@ -18,12 +18,21 @@
 * "/status/connected"                   How much time the device has been connected for the current connection
 * "/status/all"                         All 'status'
 * "/status/send"                        Trigger a Tx of _status_json_string (ASAP)
+* "/batch"                              Selected status/info/statistics fields in one compact response
 * "/statistics/app/join_state_secs"     How much seconds to jump to each join state
 * "/statistics/app/disconnected_total"  How much time the device has been disconnected since the first connection
 * "/statistics/app/connections"         How many times the device connected
 * "/statistics/app/connected_total"     How much time the device has been connected since the first connection
 * "/statistics/app/availability"        connected_total / (connected_total + disconnected_total) ratio
 * "/statistics/app/all"                 All 'app' statistics
+* "/statistics/app/main_loop"           app_task() wake-ups and duty cycle
+* "/statistics/app/snapshot"            Stack statistics snapshot hits/misses and stack API calls
+* "/statistics/app/notifications"       Notification size and encoding time per format (JSON/TLV)
+* "/statistics/app/send_slot"           Status notification slot, congestion backoff and counters
+* "/statistics/app/observe"             CoAP Observe registrations, observers and notification counters
+* "/statistics/app/coap"                CoAP response buffer pool, /info cache usage and per-resource handler time/size
+* "/statistics/app/traces"              Tokenized traces records, bytes and CPU cycles (with APP_TRACE_TOKENS)
+* "/statistics/app/scheduler"           Action scheduler slots usage, longest critical section and periodic actions jitter/overruns
 * "/statistics/stack/phy"               PHY statistics stored in sl_wisun_statistics_phy_t
 * "/statistics/stack/mac"               MAC statistics stored in sl_wisun_statistics_mac_t
 * "/statistics/stack/fhss"              FHSS statistics stored in sl_wisun_statistics_fhss_t
@@ -36,6 +45,8 @@
 * "/reporter/crash"                     Report info on previous crash (if any)
 * "/reporter/start"                     Start filtering RTT traces for selected strings and reporting then to REPORTER_PORT
 * "/reporter/stop"                      Stop filtering RTT traces
+* "/reporter/compress"                  Compression of the reported traces (on/off/measure/reset) and its counters
+* "/reporter/statistics"                Reporter sequence numbers, retransmit ring and NACK counters
 *
 *******************************************************************************
 * # License
@@ -77,6 +88,8 @@
 #include <string.h>
 #include "sl_string.h"
 #include "sl_memory_manager.h"
+#include "cmsis_os2.h"
+#include "sl_sleeptimer.h"
 
 #include "sl_wisun_api.h"
 #include "sl_wisun_types.h"
@@ -90,6 +103,10 @@
 #include "app_parameters.h"
 #include "app_coap.h"
 #include "app_check_neighbors.h"
+#include "app_tlv.h"
+#include "app_coap_parse.h"
+#include "app_coap_lookup.h"
+#include "app_fnv.h"
 
 #if __has_include("app_rtt_traces.h")
   // app_rtt_traces/c/.h can be added/removed from the project
@@ -103,25 +120,111 @@
 
 #include "app_action_scheduler.h"
 
-// -----------------------------------------------------------------------------
-//                              Macros and Typedefs
-// -----------------------------------------------------------------------------
-
 // -----------------------------------------------------------------------------
 //                          Variables
 //------------------------------------------------------------------------------
-char coap_response[COAP_MAX_RESPONSE_LEN];
 uint8_t coap_response_current_len = 0;
 char* allocated_heap;
 sl_status_t ret;
 uint32_t realloced_bytes = 0;
 void* realloc_ptr;
-sl_wisun_statistics_t statistics;
+
+#define COAP_BLOCK2_URI_MAX_LEN 48
+// Block1 payload being received. The resource handler doesn't give the sender address, and
+//  clients may change the token between blocks (RFC 7959 §2.3), so only one transfer is
+//  accepted at a time: it owns the buffer from its block 0 until its last block, or until
+//  APP_COAP_BLOCK1_TIMEOUT_S without any block. The following blocks must be for the same
+//  URI and block size.
+static uint8_t  coap_block1_payload[APP_COAP_BLOCK1_MAX_LEN];
+static uint16_t coap_block1_len = 0;
+static bool     coap_block1_active = false;
+static uint8_t  coap_block1_szx;
+static uint64_t coap_block1_last_sec;
+static char     coap_block1_uri[COAP_BLOCK2_URI_MAX_LEN];
+
+// Counters of this file (the response pool has its own, see app_coap_response.c)
+static osMutexId_t      coap_response_mutex = NULL;
+
+// Group requests (see APP_COAP_GROUP_DATA_RATE_BPS)
+typedef struct {
+  uint32_t requests;
+  uint32_t suppressed;        // 'if' filter not matching: no response
+  uint32_t deferred;          // sent after a leisure, by app_coap_observe_process()
+  uint32_t capped;            // leisure reduced to APP_COAP_GROUP_MAX_LEISURE_MS
+  uint32_t max_leisure_ms;
+  uint64_t total_leisure_ms;
+} app_coap_group_counters_t;
+
+#define COAP_GROUP_RECORD_MAX_LEN   APP_STATUS_RECORD_MAX_LEN
+#define COAP_GROUP_FILTER_MAX_LEN   64
+#define COAP_GROUP_HEADERS_LEN      24      // compressed IPv6/UDP + CoAP headers of a response
+static uint8_t  coap_group_record[COAP_GROUP_RECORD_MAX_LEN];
+static uint32_t coap_group_random = 0;      // xorshift32 state, seeded on first use
+static app_coap_group_counters_t coap_group_counters;
+
+// /info payloads only change on reboot (or with the device type): they are built once
+//  in coap_info_cache, then served with an ETag and a long Max-Age
+typedef enum {
+  APP_COAP_INFO_ALL = 0,
+  APP_COAP_INFO_DEVICE,
+  APP_COAP_INFO_CHIP,
+  APP_COAP_INFO_BOARD,
+  APP_COAP_INFO_DEVICE_TYPE,
+  APP_COAP_INFO_APPLICATION,
+  APP_COAP_INFO_VERSION,
+  APP_COAP_INFO_COUNT
+} app_coap_info_t;
+
+typedef struct {
+  uint32_t builds;
+  uint32_t content;           // 2.05 responses, with payload
+  uint32_t valid;             // 2.03 responses, without payload (client ETag still valid)
+} app_coap_info_counters_t;
+
+#define COAP_INFO_CACHE_LEN 640
+static char     coap_info_cache[COAP_INFO_CACHE_LEN];
+static uint16_t coap_info_offset[APP_COAP_INFO_COUNT];
+static uint16_t coap_info_len[APP_COAP_INFO_COUNT];
+static uint32_t coap_info_etag[APP_COAP_INFO_COUNT];
+static volatile bool coap_info_valid = false;
+static app_coap_info_counters_t coap_info_counters;
+
+// Heap allocations of the application CoAP code (response options and ETags, freed
+//  with the response packets). Payloads and queries are parsed in place, without any
+//  allocation
+typedef struct {
+  uint32_t allocations;
+  uint32_t bytes;
+  uint32_t failed;
+} app_coap_heap_counters_t;
+
+static app_coap_heap_counters_t coap_heap_counters;
+
+// Requests to the prefix resources (see APP_COAP_PREFIX_DISPATCH, 0 otherwise)
+typedef struct {
+  uint32_t dispatched;
+  uint32_t not_found;
+} app_coap_prefix_counters_t;
+
+static app_coap_prefix_counters_t coap_prefix_counters;
 // -----------------------------------------------------------------------------
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
 static uint32_t app_scheduler_reconnect_cb(void *context);
 static uint32_t app_scheduler_clear_and_reconnect_cb(void *context);
+static sn_coap_options_list_s * _app_coap_options(sl_wisun_coap_packet_t *resp_packet);
+static void _app_coap_block2(sl_wisun_coap_packet_t *resp_packet,
+                             const sl_wisun_coap_packet_t *const req_packet);
+static sl_wisun_coap_packet_t * _app_coap_block1(const sl_wisun_coap_packet_t *const req_packet,
+                                                 sl_wisun_coap_packet_t *full_req_packet);
+static void _app_coap_info_cache_build(void);
+static sl_wisun_coap_packet_t * _app_coap_info_reply(app_coap_info_t info,
+                                                    const sl_wisun_coap_packet_t *const req_packet);
+static void _app_coap_resource_stats_add(const sl_wisun_coap_packet_t *const req_packet,
+                                         uint16_t response_len);
+static void _app_coap_resource_stats_reset(void);
+static bool _app_coap_group_check(const sl_wisun_coap_packet_t *const req_packet);
+static void * _app_coap_malloc(uint16_t size);
 
 static uint32_t app_scheduler_reconnect_cb(void *context)
 {
@@ -159,21 +262,122 @@ void  print_coap_help (char* device_global_ipv6_string, char* border_router_ipv6
   printf("CoAP GET requests:\n");
   printf("  coap-client -m get -N -B 3 -t text/plain coap://[%s]:5683/<resource>, for the following resources:\n", device_global_ipv6_string);
   sl_wisun_coap_rhnd_print_resources();
+  printf("  Responses larger than %u bytes are sent in blocks, use '-b <size>' to select a smaller block size\n",
+         APP_COAP_BLOCK_SIZE(APP_COAP_BLOCK_SZX));
   printf("  '/settings/auto_send'         returns the current notification duration in seconds\n");
   printf("  '/settings/auto_send' -e <d>' changes the notification duration to d seconds\n");
   printf("  '/settings/parameter' -e \"<name>\"' returns application parameter <name> current value\n");
   printf("  '/settings/parameter' -e \"<name> <value>\"' changes application parameter <name> to <value>\n");
   printf("  '/status/neighbor'            returns the neighbor_count\n");
+  printf("  '/batch?f=<key>,<prefix>*'    returns the selected status fields in one response (all by default, '&fmt=tlv' for TLV)\n");
   printf("  '/status/neighbor -e <n>'     returns the neighbor information for neighbor at index n\n");
   printf("  '/statistics/stack/<group> -e reset' clears the Stack statistics for the selected group\n");
   printf("  '/statistics/app/all       -e reset' clears all statistics\n");
+  printf("  '/statistics/app/snapshot  -e \"max_age_ms <ms>\"' changes the stack statistics snapshot max age\n");
+  printf("  '/statistics/app/send_slot -e <on|off>' enables/disables per-device status slots\n");
+  printf("  '/statistics/app/coap      -e <uri_prefix>' returns the handler time/size of the matching resources\n");
+#ifdef    APP_COAP_OBSERVE_H
+  printf("CoAP Observe (any of the above resources, notified on change, at most every pmin and at least every pmax seconds):\n");
+  printf("  coap-client -m get -s 3600 -B 3600 \"coap://[%s]:%d/<resource>?pmin=%d&pmax=%d\"\n",
+         device_global_ipv6_string, APP_COAP_OBSERVE_PORT,
+         APP_COAP_OBSERVE_DEFAULT_PMIN_S, APP_COAP_OBSERVE_DEFAULT_PMAX_S);
+#endif /* APP_COAP_OBSERVE_H */
   printf("\n");
 }
 
+char * app_coap_statistics_string(char *buf, uint16_t size) {
+  #define JSON_COAP_STATISTICS_FORMAT_STR    \
+    "{\n"                                  \
+    "  \"buffers\": \"%d\",\n"              \
+    "  \"buffer_size\": \"%d\",\n"          \
+    "  \"in_use\": \"%u\",\n"               \
+    "  \"peak_in_use\": \"%u\",\n"          \
+    "  \"acquired\": \"%lu\",\n"            \
+    "  \"reused\": \"%lu\",\n"              \
+    "  \"waits\": \"%lu\",\n"               \
+    "  \"exhausted\": \"%lu\",\n"           \
+    "  \"info_builds\": \"%lu\",\n"         \
+    "  \"info_content\": \"%lu\",\n"        \
+    "  \"info_valid\": \"%lu\",\n"          \
+    "  \"group_requests\": \"%lu\",\n"      \
+    "  \"group_suppressed\": \"%lu\",\n"    \
+    "  \"group_deferred\": \"%lu\",\n"      \
+    "  \"group_capped\": \"%lu\",\n"        \
+    "  \"group_avg_leisure_ms\": \"%lu\",\n" \
+    "  \"group_max_leisure_ms\": \"%lu\",\n" \
+    "  \"heap_allocations\": \"%lu\",\n"   \
+    "  \"heap_bytes\": \"%lu\",\n"         \
+    "  \"heap_failed\": \"%lu\",\n"        \
+    "  \"prefix_dispatched\": \"%lu\",\n"  \
+    "  \"prefix_not_found\": \"%lu\",\n"   \
+    "  \"resources\": "
+  app_coap_response_pool_counters_t pool;
+  uint16_t len;
+
+  app_coap_response_pool_counters(&pool);
+  len = (uint16_t)snprintf(buf, size, JSON_COAP_STATISTICS_FORMAT_STR,
+           APP_COAP_RESPONSE_POOL_COUNT,
+           COAP_MAX_RESPONSE_LEN,
+           pool.in_use,
+           pool.peak_in_use,
+           pool.acquired,
+           pool.reused,
+           pool.waits,
+           pool.exhausted,
+           coap_info_counters.builds,
+           coap_info_counters.content,
+           coap_info_counters.valid,
+           coap_group_counters.requests,
+           coap_group_counters.suppressed,
+           coap_group_counters.deferred,
+           coap_group_counters.capped,
+           coap_group_counters.deferred ?
+             (uint32_t)(coap_group_counters.total_leisure_ms / coap_group_counters.deferred) : 0,
+           coap_group_counters.max_leisure_ms,
+           coap_heap_counters.allocations,
+           coap_heap_counters.bytes,
+           coap_heap_counters.failed,
+           coap_prefix_counters.dispatched,
+           coap_prefix_counters.not_found
+  );
+  if (len < size) {
+    app_coap_resource_statistics_string(buf + len, size - len, NULL);
+    len += (uint16_t)sl_strnlen(buf + len, size - len);
+  }
+  if (len + 3 <= size) {
+    snprintf(buf + len, size - len, "}\n");
+  }
+  return buf;
+}
+
+void app_coap_statistics_reset(void) {
+  app_coap_response_pool_reset();
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  memset(&coap_info_counters, 0, sizeof(coap_info_counters));
+  memset(&coap_group_counters, 0, sizeof(coap_group_counters));
+  memset(&coap_heap_counters, 0, sizeof(coap_heap_counters));
+  memset(&coap_prefix_counters, 0, sizeof(coap_prefix_counters));
+  _app_coap_resource_stats_reset();
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+}
+
 sl_wisun_coap_packet_t * app_coap_reply(char *response_string,
                   const sl_wisun_coap_packet_t *const req_packet) {
+  return app_coap_reply_payload((uint8_t *)response_string,
+                                (uint16_t)sl_strnlen(response_string, COAP_MAX_RESPONSE_LEN),
+                                COAP_CT_TEXT_PLAIN, req_packet);
+}
+
+sl_wisun_coap_packet_t * app_coap_reply_payload(uint8_t *payload, uint16_t payload_len,
+                  sn_coap_content_format_e content_format,
+                  const sl_wisun_coap_packet_t *const req_packet) {
 
   sl_wisun_coap_packet_t* resp_packet = NULL;
+  _app_coap_resource_stats_add(req_packet, payload_len);
+  if (!_app_coap_group_check(req_packet)) {
+    // Group request filtered out: no response
+    return NULL;
+  }
   // Prepare CoAP response packet with default response string
   resp_packet = sl_wisun_coap_build_response(req_packet, COAP_MSG_CODE_RESPONSE_BAD_REQUEST);
   if (resp_packet == NULL) {
@@ -181,17 +385,316 @@ sl_wisun_coap_packet_t * app_coap_reply(char *response_string,
   }
 
   resp_packet->msg_code       = COAP_MSG_CODE_RESPONSE_CONTENT;
-  resp_packet->content_format = COAP_CT_TEXT_PLAIN;
-  resp_packet->payload_ptr    = (uint8_t *)response_string;
-  resp_packet->payload_len    = (uint16_t)sl_strnlen(response_string, COAP_MAX_RESPONSE_LEN);
+  resp_packet->content_format = content_format;
+  resp_packet->payload_ptr    = payload;
+  resp_packet->payload_len    = payload_len;
+
+  if ((req_packet->options_list_ptr != NULL)
+      && (req_packet->options_list_ptr->block1 != COAP_OPTION_BLOCK_NONE)
+      && (_app_coap_options(resp_packet) != NULL)) {
+    // Final response to a Block1 request: acknowledge the last block
+    resp_packet->options_list_ptr->block1 = req_packet->options_list_ptr->block1;
+  }
+  // Send large responses in blocks
+  _app_coap_block2(resp_packet, req_packet);
 
   return resp_packet;
 }
 
-// CoAP Callback functions definition (one callback function per URI)
-sl_wisun_coap_packet_t * coap_callback_all_infos (
-      const  sl_wisun_coap_packet_t *const req_packet)  {
-  const char *buf;
+sl_wisun_coap_packet_t * app_coap_reply_unavailable(const sl_wisun_coap_packet_t *const req_packet) {
+  sl_wisun_coap_packet_t *resp_packet;
+  app_coap_token_t group;
+
+  if (app_coap_query_param(req_packet, "g", &group)) {
+    // No error responses to group requests (RFC 7252 §8.2)
+    return NULL;
+  }
+  resp_packet = sl_wisun_coap_build_response(req_packet, COAP_MSG_CODE_RESPONSE_SERVICE_UNAVAILABLE);
+  if ((resp_packet != NULL) && (_app_coap_options(resp_packet) != NULL)) {
+    // Retry once a response buffer is released
+    resp_packet->options_list_ptr->max_age = APP_COAP_RESPONSE_RETRY_S;
+  }
+  return resp_packet;
+}
+
+static uint32_t _app_coap_group_random(void) {
+  if (coap_group_random == 0) {
+    // Different on each device, and on each boot
+    coap_group_random = app_fnv1a(APP_FNV1A_32_OFFSET_BASIS ^ (uint32_t)sl_sleeptimer_get_tick_count64(),
+                                  device_mac_string, (uint32_t)strlen(device_mac_string));
+    if (coap_group_random == 0) {
+      coap_group_random = 1;
+    }
+  }
+  coap_group_random ^= coap_group_random << 13;
+  coap_group_random ^= coap_group_random >> 17;
+  coap_group_random ^= coap_group_random << 5;
+  return coap_group_random;
+}
+
+/* Check the 'if=<key>:<value>' filter against the current status record */
+static bool _app_coap_group_filter(const app_coap_token_t *filter) {
+  char selector[COAP_GROUP_FILTER_MAX_LEN];
+  char expected[COAP_GROUP_FILTER_MAX_LEN + 8];
+  char actual[COAP_GROUP_FILTER_MAX_LEN + 8];
+  const char *colon = memchr(filter->ptr, ':', filter->len);
+  app_coap_token_t key;
+  uint16_t record_len;
+  bool match;
+
+  if (colon == NULL) {
+    return false;
+  }
+  key.ptr = filter->ptr;
+  key.len = (uint16_t)(colon - filter->ptr);
+  if (!app_coap_token_copy(&key, selector, sizeof(selector))) {
+    return false;
+  }
+  // Same format as app_tlv_json() for this field alone
+  snprintf(expected, sizeof(expected), "{\"%s\":\"%.*s\"}",
+           selector, (int)(filter->len - key.len - 1), colon + 1);
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  record_len = app_status_record(coap_group_record, sizeof(coap_group_record));
+  match = (app_tlv_json(coap_group_record, record_len, selector, actual, sizeof(actual)) != 0)
+       && !strcmp(actual, expected);
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+  return match;
+}
+
+/* Count group requests, and filter them ('if'). Returns false if no response shall be sent.
+ *  The leisure is not waited here (in the resource handler thread, for all requests):
+ *  see app_coap_group_leisure_ms() */
+static bool _app_coap_group_check(const sl_wisun_coap_packet_t *const req_packet) {
+  app_coap_token_t param;
+  bool match = true;
+
+  if ((req_packet->msg_type != COAP_MSG_TYPE_NON_CONFIRMABLE)
+      || !app_coap_query_param(req_packet, "g", &param)) {
+    return true;
+  }
+  if (app_coap_query_param(req_packet, "if", &param)) {
+    match = _app_coap_group_filter(&param);
+  }
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  coap_group_counters.requests++;
+  if (!match) {
+    coap_group_counters.suppressed++;
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+  return match;
+}
+
+uint32_t app_coap_group_leisure_ms(const sl_wisun_coap_packet_t *const req_packet,
+                                   uint16_t response_len) {
+  app_coap_token_t param;
+  uint32_t group_size;
+  uint32_t leisure_ms;
+  uint32_t delay_ms;
+  bool     capped = false;
+
+  if ((APP_COAP_GROUP_MAX_LEISURE_MS == 0)
+      || (req_packet->msg_type != COAP_MSG_TYPE_NON_CONFIRMABLE)
+      || !app_coap_query_param(req_packet, "g", &param)) {
+    return 0;
+  }
+  if (app_coap_token_uint(&param, &group_size)) {
+    leisure_ms = (uint32_t)((uint64_t)(response_len + COAP_GROUP_HEADERS_LEN) * group_size * 1000
+                            / APP_COAP_GROUP_DATA_RATE_BPS);
+  } else {
+    leisure_ms = APP_COAP_GROUP_DEFAULT_LEISURE_MS;
+  }
+  if (leisure_ms > APP_COAP_GROUP_MAX_LEISURE_MS) {
+    leisure_ms = APP_COAP_GROUP_MAX_LEISURE_MS;
+    capped = true;
+  }
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  delay_ms = leisure_ms ? _app_coap_group_random() % leisure_ms : 0;
+  coap_group_counters.deferred++;
+  if (capped) {
+    coap_group_counters.capped++;
+  }
+  coap_group_counters.total_leisure_ms += delay_ms;
+  if (delay_ms > coap_group_counters.max_leisure_ms) {
+    coap_group_counters.max_leisure_ms = delay_ms;
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+  return delay_ms;
+}
+
+/* sl_wisun_coap_malloc(), counted in coap_heap_counters */
+static void * _app_coap_malloc(uint16_t size) {
+  void *ptr = sl_wisun_coap_malloc(size);
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  if (ptr == NULL) {
+    coap_heap_counters.failed++;
+  } else {
+    coap_heap_counters.allocations++;
+    coap_heap_counters.bytes += size;
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+  return ptr;
+}
+
+/* Options of a response, allocated with their default values if not present */
+static sn_coap_options_list_s * _app_coap_options(sl_wisun_coap_packet_t *resp_packet) {
+  sn_coap_options_list_s *options;
+
+  if (resp_packet->options_list_ptr == NULL) {
+    // Freed with the response packet
+    options = (sn_coap_options_list_s *)_app_coap_malloc(sizeof(sn_coap_options_list_s));
+    if (options == NULL) {
+      return NULL;
+    }
+    memset(options, 0, sizeof(sn_coap_options_list_s));
+    options->uri_port = COAP_OPTION_URI_PORT_NONE;
+    options->observe  = COAP_OBSERVE_NONE;
+    options->accept   = COAP_CT_NONE;
+    options->max_age  = COAP_OPTION_MAX_AGE_DEFAULT;
+    options->block1   = COAP_OPTION_BLOCK_NONE;
+    options->block2   = COAP_OPTION_BLOCK_NONE;
+    resp_packet->options_list_ptr = options;
+  }
+  return resp_packet->options_list_ptr;
+}
+
+/* Block2 (RFC 7959 §2.4): replace the response payload by the requested block.
+ *  Each block is cut from the content built by the callback for this request, and
+ *  sent with the ETag of the whole content: nothing is shared between requests
+ *  (Observe checks included), and a client getting another ETag for a later block
+ *  knows that the content changed and restarts its transfer (§2.4) */
+static void _app_coap_block2(sl_wisun_coap_packet_t *resp_packet,
+                             const sl_wisun_coap_packet_t *const req_packet) {
+  int32_t  req_block2 = COAP_OPTION_BLOCK_NONE;
+  uint8_t  szx = APP_COAP_BLOCK_SZX;
+  uint32_t num = 0;
+  uint32_t offset;
+  uint32_t etag;
+  uint16_t block_size;
+  uint16_t block_len;
+  sn_coap_options_list_s *options;
+
+  if (req_packet->options_list_ptr != NULL) {
+    req_block2 = req_packet->options_list_ptr->block2;
+  }
+  if (req_block2 != COAP_OPTION_BLOCK_NONE) {
+    num = APP_COAP_BLOCK_NUM(req_block2);
+    // Use the smallest block size between the client and the device
+    if (APP_COAP_BLOCK_SZX_OF(req_block2) < szx) {
+      szx = APP_COAP_BLOCK_SZX_OF(req_block2);
+    }
+  } else if (resp_packet->payload_len <= APP_COAP_BLOCK_SIZE(szx)) {
+    // Fits in a single block
+    return;
+  }
+  block_size = APP_COAP_BLOCK_SIZE(szx);
+
+  offset = num * block_size;
+  if ((offset > 0) && (offset >= resp_packet->payload_len)) {
+    resp_packet->msg_code    = COAP_MSG_CODE_RESPONSE_BAD_OPTION;
+    resp_packet->payload_ptr = NULL;
+    resp_packet->payload_len = 0;
+  } else if ((resp_packet->payload_ptr != NULL) && ((options = _app_coap_options(resp_packet)) != NULL)) {
+    // FNV-1a of the content, sent as ETag to let clients detect content changes
+    etag = app_fnv1a(APP_FNV1A_32_OFFSET_BASIS, resp_packet->payload_ptr, resp_packet->payload_len);
+    block_len = resp_packet->payload_len - offset;
+    if (block_len > block_size) {
+      block_len = block_size;
+    }
+    // Move the block to the start of the response buffer, which is owned by this request
+    memmove(resp_packet->payload_ptr, resp_packet->payload_ptr + offset, block_len);
+    options->block2 = APP_COAP_BLOCK_VALUE(num, (offset + block_len < resp_packet->payload_len) ? 1U : 0U, szx);
+    resp_packet->payload_len = block_len;
+    options->etag_ptr = (uint8_t *)_app_coap_malloc(sizeof(etag));
+    if (options->etag_ptr != NULL) {
+      memcpy(options->etag_ptr, &etag, sizeof(etag));
+      options->etag_len = sizeof(etag);
+    }
+  }
+}
+
+/* Block1 (RFC 7959 §2.5): reassemble the request payload.
+ * Returns the response to send for intermediate (2.31 Continue) or invalid blocks,
+ *  or NULL once full_req_packet holds the complete request */
+static sl_wisun_coap_packet_t * _app_coap_block1(const sl_wisun_coap_packet_t *const req_packet,
+                                                 sl_wisun_coap_packet_t *full_req_packet) {
+  sl_wisun_coap_packet_t *resp_packet;
+  sn_coap_msg_code_e msg_code;
+  int32_t  block1;
+  uint32_t offset;
+  uint64_t now;
+  uint32_t busy_sec = 0;
+  bool     same_transfer;
+
+  *full_req_packet = *req_packet;
+  if ((req_packet->options_list_ptr == NULL)
+      || (req_packet->options_list_ptr->block1 == COAP_OPTION_BLOCK_NONE)) {
+    return NULL;
+  }
+  block1 = req_packet->options_list_ptr->block1;
+  offset = APP_COAP_BLOCK_NUM(block1) * APP_COAP_BLOCK_SIZE(APP_COAP_BLOCK_SZX_OF(block1));
+  now = now_sec();
+  if (coap_block1_active && (now - coap_block1_last_sec > APP_COAP_BLOCK1_TIMEOUT_S)) {
+    // Abandoned transfer
+    coap_block1_active = false;
+    coap_block1_len = 0;
+  }
+  same_transfer = coap_block1_active
+               && (APP_COAP_BLOCK_SZX_OF(block1) == coap_block1_szx)
+               && (req_packet->uri_path_len < COAP_BLOCK2_URI_MAX_LEN)
+               && (sl_strnlen(coap_block1_uri, COAP_BLOCK2_URI_MAX_LEN) == req_packet->uri_path_len)
+               && !strncmp(coap_block1_uri, (char *)req_packet->uri_path_ptr, req_packet->uri_path_len);
+
+  if ((offset == 0) && coap_block1_active) {
+    // Another transfer is running: retry once it's done or abandoned
+    msg_code = COAP_MSG_CODE_RESPONSE_SERVICE_UNAVAILABLE;
+    busy_sec = (uint32_t)(APP_COAP_BLOCK1_TIMEOUT_S - (now - coap_block1_last_sec)) + 1;
+  } else if ((offset != 0) && (!same_transfer || (offset != coap_block1_len))) {
+    msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_INCOMPLETE;
+  } else if (offset + req_packet->payload_len > APP_COAP_BLOCK1_MAX_LEN) {
+    msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE;
+    coap_block1_active = false;
+    coap_block1_len = 0;
+  } else {
+    if (offset == 0) {
+      // New transfer: owns the buffer until its last block
+      coap_block1_active = true;
+      coap_block1_szx = APP_COAP_BLOCK_SZX_OF(block1);
+      memset(coap_block1_uri, 0, COAP_BLOCK2_URI_MAX_LEN);
+      if (req_packet->uri_path_len < COAP_BLOCK2_URI_MAX_LEN) {
+        memcpy(coap_block1_uri, req_packet->uri_path_ptr, req_packet->uri_path_len);
+      }
+      coap_block1_len = 0;
+    }
+    coap_block1_last_sec = now;
+    memcpy(coap_block1_payload + offset, req_packet->payload_ptr, req_packet->payload_len);
+    coap_block1_len += req_packet->payload_len;
+    if (!APP_COAP_BLOCK_MORE(block1)) {
+      // Last block: process the complete payload
+      full_req_packet->payload_ptr = coap_block1_payload;
+      full_req_packet->payload_len = coap_block1_len;
+      coap_block1_active = false;
+      coap_block1_len = 0;
+      return NULL;
+    }
+    msg_code = COAP_MSG_CODE_RESPONSE_CONTINUE;
+  }
+  resp_packet = sl_wisun_coap_build_response(req_packet, msg_code);
+  if ((resp_packet != NULL) && (msg_code == COAP_MSG_CODE_RESPONSE_CONTINUE)
+      && (_app_coap_options(resp_packet) != NULL)) {
+    resp_packet->options_list_ptr->block1 = block1;
+  }
+  if ((resp_packet != NULL) && (msg_code == COAP_MSG_CODE_RESPONSE_SERVICE_UNAVAILABLE)
+      && (_app_coap_options(resp_packet) != NULL)) {
+    resp_packet->options_list_ptr->max_age = busy_sec;
+  }
+  return resp_packet;
+}
+
+/* Build all /info payloads, with their ETag (FNV-1a, as for Block2) */
+static void _app_coap_info_cache_build(void) {
   #define JSON_ALL_INFOS_FORMAT_STR  \
     "{\n"                          \
     "  \"device\": \"%s\",\n"      \
@@ -203,30 +706,124 @@ sl_wisun_coap_packet_t * coap_callback_all_infos (
     "  \"stack_version\": \"%d.%d.%d_b%d\",\n"\
     "  \"MAC\": \"%s\"\n"          \
     "}\n"
-  sl_wisun_mac_address_t device_mac;
   uint8_t major;
   uint8_t minor;
   uint8_t patch;
   uint16_t build;
-  sl_wisun_get_mac_address(&device_mac);
-  buf = app_wisun_mac_addr_to_str(&device_mac);
+  uint16_t offset = 0;
+  uint16_t size;
+  uint8_t info;
+  char *payload;
+
   sl_wisun_get_stack_version(&major, &minor, &patch, &build);
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, JSON_ALL_INFOS_FORMAT_STR,
-            device_tag,
-            chip,
-            SL_BOARD_NAME,
-            device_type_string,
-            application,
-            version,
-            major, minor, patch, build,
-            buf
-  );
-  sl_free((void*)buf);
-  return app_coap_reply(coap_response, req_packet);
+  coap_info_cache[COAP_INFO_CACHE_LEN - 1] = '\0';
+  for (info = 0; info < APP_COAP_INFO_COUNT; info++) {
+    if (offset >= COAP_INFO_CACHE_LEN) {
+      // Cache full (the last info was truncated): the next ones are empty, on the final '\0'
+      coap_info_offset[info] = COAP_INFO_CACHE_LEN - 1;
+      coap_info_len[info] = 0;
+      coap_info_etag[info] = APP_FNV1A_32_OFFSET_BASIS;
+      continue;
+    }
+    payload = coap_info_cache + offset;
+    size = COAP_INFO_CACHE_LEN - offset;
+    switch (info) {
+      case APP_COAP_INFO_ALL:
+        snprintf(payload, size, JSON_ALL_INFOS_FORMAT_STR,
+                 device_tag,
+                 chip,
+                 SL_BOARD_NAME,
+                 device_type_string,
+                 application,
+                 version,
+                 major, minor, patch, build,
+                 device_mac_string
+        );
+        break;
+      case APP_COAP_INFO_DEVICE:      snprintf(payload, size, "%s", device_tag);         break;
+      case APP_COAP_INFO_CHIP:        snprintf(payload, size, "%s", chip);               break;
+      case APP_COAP_INFO_BOARD:       snprintf(payload, size, "%s", SL_BOARD_NAME);      break;
+      case APP_COAP_INFO_DEVICE_TYPE: snprintf(payload, size, "%s", device_type_string); break;
+      case APP_COAP_INFO_APPLICATION: snprintf(payload, size, "%s", application);        break;
+      case APP_COAP_INFO_VERSION:     snprintf(payload, size, "%s", version);            break;
+      default: break;
+    }
+    coap_info_offset[info] = offset;
+    coap_info_len[info] = (uint16_t)sl_strnlen(payload, size);
+    coap_info_etag[info] = app_fnv1a(APP_FNV1A_32_OFFSET_BASIS, payload, coap_info_len[info]);
+    offset += coap_info_len[info] + 1;
+  }
+}
+
+/* Reply from the /info cache. A request with the current ETag gets a 2.03 Valid
+ *  without payload (RFC 7252 §5.10.6.2) */
+static sl_wisun_coap_packet_t * _app_coap_info_reply(app_coap_info_t info,
+                                                    const sl_wisun_coap_packet_t *const req_packet) {
+  char *coap_response = app_coap_response_acquire();
+  const sn_coap_options_list_s *req_options = req_packet->options_list_ptr;
+  sl_wisun_coap_packet_t *resp_packet;
+  sn_coap_options_list_s *options;
+  uint32_t etag;
+  uint16_t len;
+  bool valid;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  if (!coap_info_valid) {
+    _app_coap_info_cache_build();
+    coap_info_valid = true;
+    coap_info_counters.builds++;
+  }
+  etag = coap_info_etag[info];
+  len = coap_info_len[info];
+  memcpy(coap_response, coap_info_cache + coap_info_offset[info], len + 1);
+  valid = (req_options != NULL) && (req_options->etag_ptr != NULL)
+       && (req_options->etag_len == sizeof(etag))
+       && !memcmp(req_options->etag_ptr, &etag, sizeof(etag));
+  if (valid) {
+    coap_info_counters.valid++;
+  } else {
+    coap_info_counters.content++;
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+
+  if (valid) {
+    _app_coap_resource_stats_add(req_packet, 0);
+    resp_packet = sl_wisun_coap_build_response(req_packet, COAP_MSG_CODE_RESPONSE_VALID);
+  } else {
+    resp_packet = app_coap_reply_payload((uint8_t *)coap_response, len, COAP_CT_TEXT_PLAIN, req_packet);
+  }
+  if ((resp_packet == NULL) || ((options = _app_coap_options(resp_packet)) == NULL)) {
+    return resp_packet;
+  }
+  options->max_age = APP_COAP_INFO_MAX_AGE_S;
+  if (options->etag_ptr == NULL) {
+    // Large payloads already have their Block2 ETag, with the same value
+    options->etag_ptr = (uint8_t *)_app_coap_malloc(sizeof(etag));
+    if (options->etag_ptr != NULL) {
+      memcpy(options->etag_ptr, &etag, sizeof(etag));
+      options->etag_len = sizeof(etag);
+    }
+  }
+  return resp_packet;
+}
+
+void app_coap_info_cache_invalidate(void) {
+  coap_info_valid = false;
+}
+
+// CoAP Callback functions definition (one callback function per URI)
+sl_wisun_coap_packet_t * coap_callback_all_infos (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  return _app_coap_info_reply(APP_COAP_INFO_ALL, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_all_statuses (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
   #define JSON_ALL_STATUSES_FORMAT_STR      \
     "{\n"                                 \
     "  \"running\": \"%s\",\n"            \
@@ -238,10 +835,18 @@ sl_wisun_coap_packet_t * coap_callback_all_statuses (
   char running_str[40];
   char connected_str[40];
   uint8_t neighbor_count;
-  sl_wisun_get_neighbor_count(&neighbor_count);
+  const app_stats_snapshot_t *snapshot;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  snapshot = app_stats_snapshot_acquire();
+  neighbor_count = snapshot->neighbor_count;
+  app_stats_snapshot_release();
 
-  snprintf(running_str  , 40, dhms(now_sec()) );
-  snprintf(connected_str, 40, dhms(now_sec() - connection_time_sec) );
+  dhms_r(now_sec(), running_str, 40);
+  dhms_r(now_sec() - connection_time_sec, connected_str, 40);
 
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, JSON_ALL_STATUSES_FORMAT_STR,
             running_str,
@@ -254,13 +859,22 @@ sl_wisun_coap_packet_t * coap_callback_all_statuses (
 
 sl_wisun_coap_packet_t * coap_callback_send_status_msg (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   send_asap = true;
+  app_task_notify(APP_TASK_EVENT_SEND_ASAP);
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "send_asap flag set to true" );
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_crash_report (
     const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   if (strlen(crash_info_string)) {
       snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", crash_info_string);
   } else {
@@ -270,42 +884,32 @@ sl_wisun_coap_packet_t * coap_callback_crash_report (
 
 sl_wisun_coap_packet_t * coap_callback_device (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", device_tag);
-  return app_coap_reply(coap_response, req_packet); }
+  return _app_coap_info_reply(APP_COAP_INFO_DEVICE, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_chip (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", chip);
-  return app_coap_reply(coap_response, req_packet); }
+  return _app_coap_info_reply(APP_COAP_INFO_CHIP, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_board (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", SL_BOARD_NAME);
-  return app_coap_reply(coap_response, req_packet); }
+  return _app_coap_info_reply(APP_COAP_INFO_BOARD, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_device_type (
     const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", device_type_string);
-  return app_coap_reply(coap_response, req_packet); }
+  return _app_coap_info_reply(APP_COAP_INFO_DEVICE_TYPE, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_application (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-#define MAX_APPLI_NAME 40
-  int res = 0;
-  char cmd[MAX_APPLI_NAME];
-  char* payload_str = NULL;
+  char *coap_response = app_coap_response_acquire();
+  app_coap_token_t cmd;
 
-  memset(cmd, 0, MAX_APPLI_NAME);
-  if (req_packet->payload_len) {
-    // Get payload in string format with last char = '\0'
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
-    if (payload_str != NULL){
-        res = sscanf((char *)payload_str, "%39s", cmd);
-        sl_free(payload_str);
-    }
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
 
-    if (res) {
-      if (strcmp(cmd, "clear_and_reconnect") == 0) {
+  if (req_packet->payload_len) {
+    if (app_coap_payload_tokens(req_packet, &cmd, 1)) {
+      if (app_coap_token_is(&cmd, "clear_and_reconnect")) {
         if (app_scheduler_action_schedule(app_scheduler_clear_and_reconnect_cb,
                                           0U,
                                           0U,
@@ -319,7 +923,7 @@ sl_wisun_coap_packet_t * coap_callback_application (
         return app_coap_reply(coap_response, req_packet);
       }
 
-      if (strcmp(cmd, "reconnect") == 0) {
+      if (app_coap_token_is(&cmd, "reconnect")) {
         if (app_scheduler_action_schedule(app_scheduler_reconnect_cb,
                                           0U,
                                           0U,
@@ -332,58 +936,64 @@ sl_wisun_coap_packet_t * coap_callback_application (
         }
         return app_coap_reply(coap_response, req_packet);
       }
-      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Unknown '%s' command", cmd);
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Unknown '%.*s' command", cmd.len, cmd.ptr);
     }
     else{
-      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Bad format command '%s", cmd);
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Bad format command");
     }
   } else {
-    snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", application);
+    return _app_coap_info_reply(APP_COAP_INFO_APPLICATION, req_packet);
   }
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_version (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", version);
-  return app_coap_reply(coap_response, req_packet); }
+  return _app_coap_info_reply(APP_COAP_INFO_VERSION, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_running (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", dhms(now_sec()));
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  dhms_r(now_sec(), coap_response, COAP_MAX_RESPONSE_LEN);
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_parent (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   refresh_parent_tag();
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", parent_tag);
 return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_neighbor (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  char* payload_str = NULL;
-  int index = 0;
-  int res = 0;
+  char *coap_response = app_coap_response_acquire();
+  app_coap_token_t token;
+  int32_t index = 0;
   uint8_t neighbor_count;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   if (req_packet->payload_len) {
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
-    if (payload_str != NULL ){
-      res = sscanf((char *)payload_str, "%d", &index);
-      sl_free(payload_str);
-    }
-    if (res ==1) {
-      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", app_neighbor_info_str(index));
+    if (app_coap_payload_tokens(req_packet, &token, 1) && app_coap_token_int(&token, &index)) {
+      app_neighbor_info_string(index, coap_response, COAP_MAX_RESPONSE_LEN);
       return app_coap_reply(coap_response, req_packet);
     }
   }
-  sl_wisun_get_neighbor_count(&neighbor_count);
+  neighbor_count = app_stats_snapshot_acquire()->neighbor_count;
+  app_stats_snapshot_release();
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "neighbor_count: %d", neighbor_count);
 return app_coap_reply(coap_response, req_packet); }
 
 bool _check_app_statistics_reset  (
                              const  sl_wisun_coap_packet_t *const req_packet) {
   if (req_packet->payload_len) {
-    // We need to check using payload_len since it's not followed by a null
-    if ( !strncmp( (char*)req_packet->payload_ptr, "reset", req_packet->payload_len) ) {
+    if (app_coap_payload_is(req_packet, "reset")) {
       app_reset_statistics();
       return true;
     }
@@ -395,6 +1005,10 @@ bool _check_app_statistics_reset  (
 #ifdef    COAP_APP_STATISTICS
 sl_wisun_coap_packet_t * coap_callback_join_states_sec (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "[%llu,%llu,%llu,%llu,%llu]",
           app_join_state_delay_sec[1],
           app_join_state_delay_sec[2],
@@ -406,30 +1020,50 @@ sl_wisun_coap_packet_t * coap_callback_join_states_sec (
 
 sl_wisun_coap_packet_t * coap_callback_connections (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%d / %d", connection_count, network_connection_count);
   _check_app_statistics_reset(req_packet);
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_connected (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", dhms(now_sec() - connection_time_sec));
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  dhms_r(now_sec() - connection_time_sec, coap_response, COAP_MAX_RESPONSE_LEN);
   _check_app_statistics_reset(req_packet);
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_connected_total (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", dhms(connected_total_sec + now_sec() - connection_time_sec));
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  dhms_r(connected_total_sec + now_sec() - connection_time_sec, coap_response, COAP_MAX_RESPONSE_LEN);
   _check_app_statistics_reset(req_packet);
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_disconnected_total (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", dhms(disconnected_total_sec));
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  dhms_r(disconnected_total_sec, coap_response, COAP_MAX_RESPONSE_LEN);
   _check_app_statistics_reset(req_packet);
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_availability (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%6.2f", 100.0*(connected_total_sec + now_sec() - connection_time_sec)/(connected_total_sec + now_sec() - connection_time_sec + disconnected_total_sec) );
   _check_app_statistics_reset(req_packet);
   return app_coap_reply(coap_response, req_packet); }
@@ -437,33 +1071,34 @@ sl_wisun_coap_packet_t * coap_callback_availability (
 #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
 sl_wisun_coap_packet_t * coap_callback_leds_flash (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
   // default: 30 sec at 2 per sec
   #define DEFAULT_COUNT   30
   #define DEFAULT_DELAY  250
-  char* payload_str = NULL;
-  uint16_t count;
-  uint16_t delay_ms;
-  int res = 0;
-  if (req_packet->payload_len) {
-    // Get payload in string format with last char = '\0'
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
-    if (payload_str != NULL ){
-        res = sscanf((char *)payload_str, "%hd %hd", &count, &delay_ms);
-        sl_free(payload_str);
-    }
+  app_coap_token_t tokens[2];
+  uint32_t count    = DEFAULT_COUNT;
+  uint32_t delay_ms = DEFAULT_DELAY;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
   }
-  if (res != 2) {
+  if ((app_coap_payload_tokens(req_packet, tokens, 2) != 2)
+      || !app_coap_token_uint(&tokens[0], &count) || !app_coap_token_uint(&tokens[1], &delay_ms)) {
       count    = DEFAULT_COUNT;
       delay_ms = DEFAULT_DELAY;
   }
-  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "flashing leds %d times with %d ms delay", count, delay_ms);
-  leds_flash(count, delay_ms);
+  snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "flashing leds %lu times with %lu ms delay", count, delay_ms);
+  leds_flash((uint16_t)count, (uint16_t)delay_ms);
 return app_coap_reply(coap_response, req_packet); }
 #endif /* SL_CATALOG_SIMPLE_LED_PRESENT */
 
 #ifdef    HISTORY
 sl_wisun_coap_packet_t * coap_callback_history (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", history_string );
   return app_coap_reply(coap_response, req_packet); }
 #endif /* HISTORY */
@@ -471,6 +1106,7 @@ sl_wisun_coap_packet_t * coap_callback_history (
 
 sl_wisun_coap_packet_t * coap_callback_all_app_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
   #define JSON_ALL_STATISTICS_FORMAT_STR  \
     "{\n"                                 \
     "  \"join_states_sec\":[%llu,%llu,%llu,%llu,%llu],\n" \
@@ -484,8 +1120,12 @@ sl_wisun_coap_packet_t * coap_callback_all_app_statistics (
   char disconnected_total_str[40];
   float availability;
 
-  snprintf(connected_total_str   , 40, dhms(connected_total_sec + now_sec() - connection_time_sec) );
-  snprintf(disconnected_total_str, 40, dhms(disconnected_total_sec) );
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  dhms_r(connected_total_sec + now_sec() - connection_time_sec, connected_total_str, 40);
+  dhms_r(disconnected_total_sec, disconnected_total_str, 40);
   availability = 100.0*(connected_total_sec + now_sec() - connection_time_sec)/
       (connected_total_sec + now_sec() - connection_time_sec + disconnected_total_sec);
 
@@ -505,9 +1145,219 @@ sl_wisun_coap_packet_t * coap_callback_all_app_statistics (
   return app_coap_reply(coap_response, req_packet);
 }
 
+sl_wisun_coap_packet_t * coap_callback_main_loop_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  app_task_loop_stats_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  if (req_packet->payload_len) {
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_task_loop_stats_reset();
+    }
+  }
+  return app_coap_reply(coap_response, req_packet);
+}
+
+sl_wisun_coap_packet_t * coap_callback_snapshot_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  app_coap_token_t tokens[2];
+  uint32_t max_age_ms = 0;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  if (req_packet->payload_len) {
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_stats_snapshot_counters_reset();
+    } else {
+      if ((app_coap_payload_tokens(req_packet, tokens, 2) == 2)
+          && app_coap_token_is(&tokens[0], "max_age_ms")
+          && app_coap_token_uint(&tokens[1], &max_age_ms)) {
+        app_stats_snapshot_set_max_age_ms(max_age_ms);
+      } else {
+        snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload");
+        return app_coap_reply(coap_response, req_packet);
+      }
+    }
+  }
+  app_stats_snapshot_counters_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+
+// Selected fields of the status record (see APP_TLV_FIELDS for the field keys),
+//  as compact json, or as a TLV record with 'fmt=tlv' or 'Accept: application/octet-stream'
+//   coap-client -m get "coap://[<device>]:5683/batch?f=rpl_rank,etx,mac.*"
+//   coap-client -m get "coap://[<device>]:5683/batch" -e "parent rsl_in rsl_out"
+sl_wisun_coap_packet_t * coap_callback_batch (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  #define BATCH_SELECTORS_MAX_LEN 200
+  uint8_t *record;
+  char selectors[BATCH_SELECTORS_MAX_LEN];
+  const sn_coap_options_list_s *options = req_packet->options_list_ptr;
+  app_coap_token_t param;
+  bool tlv = false;
+  uint16_t record_len;
+  uint16_t len;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  // The record is built at the end of this request's response buffer
+  record = (uint8_t *)coap_response + COAP_MAX_RESPONSE_LEN - APP_STATUS_RECORD_MAX_LEN;
+
+  tlv = (app_coap_query_param(req_packet, "fmt", &param) && app_coap_token_is(&param, "tlv"))
+     || ((options != NULL) && (options->accept == COAP_CT_OCTET_STREAM));
+
+  selectors[0] = '\0';
+  if (req_packet->payload_len) {
+    // Selectors in the payload
+    param.ptr    = (const char *)req_packet->payload_ptr;
+    param.len    = req_packet->payload_len;
+    (void)app_coap_token_copy(&param, selectors, sizeof(selectors));
+  } else if (app_coap_query_param(req_packet, "f", &param)) {
+    // Selectors in the 'f' query parameter
+    (void)app_coap_token_copy(&param, selectors, sizeof(selectors));
+  }
+
+  // All values come from one record, built from the field table,
+  //  then moved to the very end of the buffer: the response uses the rest
+  record_len = app_status_record(record, APP_STATUS_RECORD_MAX_LEN);
+  memmove(record + APP_STATUS_RECORD_MAX_LEN - record_len, record, record_len);
+  record += APP_STATUS_RECORD_MAX_LEN - record_len;
+  if (tlv) {
+    len = app_tlv_select(record, record_len, selectors, (uint8_t *)coap_response,
+                         (uint16_t)(COAP_MAX_RESPONSE_LEN - record_len));
+    return app_coap_reply_payload((uint8_t *)coap_response, len, COAP_CT_OCTET_STREAM, req_packet);
+  }
+  // All the fields only fit in TLV
+  if (app_tlv_json(record, record_len, selectors, coap_response,
+                   (uint16_t)(COAP_MAX_RESPONSE_LEN - record_len)) == 0) {
+    snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "batch response too large: select fewer fields, or use fmt=tlv");
+  }
+  return app_coap_reply(coap_response, req_packet);
+}
+
+sl_wisun_coap_packet_t * coap_callback_notification_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  app_notification_stats_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  if (req_packet->payload_len) {
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_notification_stats_reset();
+    }
+  }
+  return app_coap_reply(coap_response, req_packet);
+}
+
+#ifdef    APP_SEND_SLOT_H
+sl_wisun_coap_packet_t * coap_callback_send_slot_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (req_packet->payload_len) {
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_send_slot_reset();
+    } else if (app_coap_payload_is(req_packet, "on")) {
+      app_send_slot_enable(true);
+    } else if (app_coap_payload_is(req_packet, "off")) {
+      app_send_slot_enable(false);
+    } else {
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload");
+      return app_coap_reply(coap_response, req_packet);
+    }
+  }
+  app_send_slot_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+#endif /* APP_SEND_SLOT_H */
+
+#ifdef    APP_COAP_OBSERVE_H
+sl_wisun_coap_packet_t * coap_callback_observe_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (req_packet->payload_len) {
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_coap_observe_reset();
+    } else {
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload");
+      return app_coap_reply(coap_response, req_packet);
+    }
+  }
+  app_coap_observe_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+#endif /* APP_COAP_OBSERVE_H */
+
+sl_wisun_coap_packet_t * coap_callback_coap_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (req_packet->payload_len) {
+    // We need to check using payload_len since it's not followed by a null
+    app_coap_token_t token;
+    char prefix[COAP_BLOCK2_URI_MAX_LEN];
+    if (app_coap_payload_is(req_packet, "reset")) {
+      app_coap_statistics_reset();
+    } else if ((app_coap_payload_tokens(req_packet, &token, 1) == 1)
+               && app_coap_token_copy(&token, prefix, sizeof(prefix))) {
+      // URI prefix: only the matching resources
+      app_coap_resource_statistics_string(coap_response, COAP_MAX_RESPONSE_LEN, prefix);
+      return app_coap_reply(coap_response, req_packet);
+    } else {
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload");
+      return app_coap_reply(coap_response, req_packet);
+    }
+  }
+  app_coap_statistics_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+sl_wisun_coap_packet_t * coap_callback_trace_tokens_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (app_coap_payload_is(req_packet, "reset")) {
+    app_trace_tokens_reset();
+  }
+  app_trace_tokens_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
+
+sl_wisun_coap_packet_t * coap_callback_scheduler_statistics (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (app_coap_payload_is(req_packet, "reset")) {
+    app_scheduler_statistics_reset();
+  }
+  app_scheduler_statistics_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet);
+}
+
 #define   COAP_STACK_STATISTICS
 #ifdef    COAP_STACK_STATISTICS
-char * phy_statistics_str        (sl_wisun_statistics_t statistics)  {
+char * phy_statistics_str        (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_PHY_STATISTICS_FORMAT_STR  \
   "{\n"                            \
   "  \"crc_fails\": \"%ld\",\n"    \
@@ -523,7 +1373,7 @@ char * phy_statistics_str        (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
-char * mac_statistics_str        (sl_wisun_statistics_t statistics)  {
+char * mac_statistics_str        (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_MAC_STATISTICS_FORMAT_STR    \
     "{\n"                                   \
     "  \"tx_queue_size\": \"%d\",\n"        \
@@ -568,7 +1418,7 @@ char * mac_statistics_str        (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
-char * fhss_statistics_str       (sl_wisun_statistics_t statistics)  {
+char * fhss_statistics_str       (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_FHSS_STATISTICS_FORMAT_STR \
     "{\n"                                 \
     "  \"drift_compensation\": \"%d\",\n" \
@@ -590,7 +1440,7 @@ char * fhss_statistics_str       (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
-char * wisun_statistics_str      (sl_wisun_statistics_t statistics)  {
+char * wisun_statistics_str      (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_WISUN_STATISTICS_FORMAT_STR   \
     "{\n"                                    \
     "  \"pan_control_tx_count\": \"%lu\",\n" \
@@ -604,7 +1454,7 @@ char * wisun_statistics_str      (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
-char * network_statistics_str    (sl_wisun_statistics_t statistics)  {
+char * network_statistics_str    (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_NETWORK_STATISTICS_FORMAT_STR \
     "{\n"                                     \
     "  \"ip_rx_count\": \"%lu\",\n"           \
@@ -670,7 +1520,7 @@ char * network_statistics_str    (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
-char * regulation_statistics_str (sl_wisun_statistics_t statistics)  {
+char * regulation_statistics_str (sl_wisun_statistics_t statistics, char *coap_response)  {
   #define JSON_REGULATION_STATISTICS_FORMAT_STR \
     "{\n"                       \
     "  \"arib.tx_duration_ms\": \"%lu\"" \
@@ -682,12 +1532,30 @@ char * regulation_statistics_str (sl_wisun_statistics_t statistics)  {
   return coap_response;
 }
 
+// Copy the selected statistics type from the shared snapshot
+void _get_snapshot_statistics(sl_wisun_statistics_type_t statistics_type,
+                              sl_wisun_statistics_t *statistics) {
+  const app_stats_snapshot_t *snapshot;
+
+  snapshot = app_stats_snapshot_acquire();
+  switch (statistics_type) {
+    case SL_WISUN_STATISTICS_TYPE_PHY:        *statistics = snapshot->phy;        break;
+    case SL_WISUN_STATISTICS_TYPE_MAC:        *statistics = snapshot->mac;        break;
+    case SL_WISUN_STATISTICS_TYPE_FHSS:       *statistics = snapshot->fhss;       break;
+    case SL_WISUN_STATISTICS_TYPE_WISUN:      *statistics = snapshot->wisun;      break;
+    case SL_WISUN_STATISTICS_TYPE_NETWORK:    *statistics = snapshot->network;    break;
+    case SL_WISUN_STATISTICS_TYPE_REGULATION: *statistics = snapshot->regulation; break;
+    default: memset(statistics, 0, sizeof(*statistics)); break;
+  }
+  app_stats_snapshot_release();
+}
+
 bool _check_stack_statistics_reset(sl_wisun_statistics_type_t statistics_type,
                              const  sl_wisun_coap_packet_t *const req_packet) {
   if (req_packet->payload_len) {
-    // We need to check using payload_len since it's not followed by a null
-    if ( !strncmp( (char*)req_packet->payload_ptr, "reset", req_packet->payload_len) ) {
+    if (app_coap_payload_is(req_packet, "reset")) {
       sl_wisun_reset_statistics(statistics_type);
+      app_stats_snapshot_invalidate();
       return true;
     }
   }
@@ -696,48 +1564,90 @@ bool _check_stack_statistics_reset(sl_wisun_statistics_type_t statistics_type,
 
 sl_wisun_coap_packet_t * coap_callback_phy_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_PHY, &statistics);
-  phy_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_PHY, &statistics);
+  phy_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_PHY, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_mac_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_MAC, &statistics);
-  mac_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_MAC, &statistics);
+  mac_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_MAC, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_fhss_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_FHSS, &statistics);
-  fhss_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_FHSS, &statistics);
+  fhss_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_FHSS, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_wisun_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_WISUN, &statistics);
-  wisun_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_WISUN, &statistics);
+  wisun_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_WISUN, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_network_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_NETWORK, &statistics);
-  network_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_NETWORK, &statistics);
+  network_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_NETWORK, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
 
 sl_wisun_coap_packet_t * coap_callback_regulation_statistics (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  ret = sl_wisun_get_statistics (SL_WISUN_STATISTICS_TYPE_REGULATION, &statistics);
-  regulation_statistics_str(statistics);
+  char *coap_response = app_coap_response_acquire();
+  sl_wisun_statistics_t statistics;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+
+  _get_snapshot_statistics(SL_WISUN_STATISTICS_TYPE_REGULATION, &statistics);
+  regulation_statistics_str(statistics, coap_response);
   _check_stack_statistics_reset(SL_WISUN_STATISTICS_TYPE_REGULATION, req_packet);
   return app_coap_reply(coap_response, req_packet);
 }
@@ -745,17 +1655,15 @@ sl_wisun_coap_packet_t * coap_callback_regulation_statistics (
 
 sl_wisun_coap_packet_t * coap_callback_auto_send (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  char* payload_str = NULL;
-  int sec = 0;
-  int res = 0;
+  char *coap_response = app_coap_response_acquire();
+  app_coap_token_t token;
+  uint32_t sec = 0;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
   if (req_packet->payload_len) {
-    // Get payload in string format with last char = '\0'
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
-    if (payload_str != NULL ){
-        res = sscanf((char *)payload_str, "%d", &sec);
-        sl_free(payload_str);
-    }
-    if (res == 1) {
+    if ((app_coap_payload_tokens(req_packet, &token, 1) == 1) && app_coap_token_uint(&token, &sec)) {
         network[app_parameters.network_index].auto_send_sec = (uint16_t)sec;
     } else {
         snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload");
@@ -768,34 +1676,29 @@ return app_coap_reply(coap_response, req_packet); }
 #ifdef    APP_RTT_TRACES_H
 sl_wisun_coap_packet_t * coap_callback_trace_level (
       const  sl_wisun_coap_packet_t *const req_packet)  {
-  char* payload_str = NULL;
-  int level = 0;
-  int group = 0;
-  int res = 0;
+  char *coap_response = app_coap_response_acquire();
+  app_coap_token_t tokens[2];
+  int32_t level = 0;
+  int32_t group = 0;
+  uint8_t count;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
 
   ret = 1;
 
   if (req_packet->payload_len) {
-    // Get payload in string format with last char = '\0'
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
-    if (payload_str != NULL ){
-        res = sscanf((char *)payload_str, "%d %d", &group, &level);
-    }
-    if (res == 2) {
+    count = app_coap_payload_tokens(req_packet, tokens, 2);
+    if ((count == 2) && app_coap_token_int(&tokens[0], &group) && app_coap_token_int(&tokens[1], &level)) {
       // Process /settings/trace_level -e "<group> <level>"
       trace_level = (uint8_t)level;
       ret = app_set_trace(group, level, true);
-    } else {
+    } else if ((count >= 1) && app_coap_token_int(&tokens[0], &level)) {
       // Process /settings/trace_level -e "<level>" (all groups)
-      if (payload_str != NULL ){
-        res = sscanf((char *)payload_str, "%d", &level);
-      }
-      if (res == 1) {
-        trace_level = (uint8_t)level;
-        ret = app_set_all_traces(level, true);
-      }
+      trace_level = (uint8_t)level;
+      ret = app_set_all_traces(level, true);
     }
-    sl_free(payload_str);
   }
   if (ret == SL_STATUS_OK){
       snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%u", trace_level);
@@ -807,41 +1710,68 @@ return app_coap_reply(coap_response, req_packet); }
 #endif /* APP_RTT_TRACES_H */
 
 #ifdef    APP_PARAMETERS_H
+sl_wisun_coap_packet_t * _coap_callback_application_parameter (
+      const  sl_wisun_coap_packet_t *const req_packet);
+
 sl_wisun_coap_packet_t * coap_callback_application_parameter (
       const  sl_wisun_coap_packet_t *const req_packet)  {
+  sl_wisun_coap_packet_t full_req_packet;
+  sl_wisun_coap_packet_t *resp_packet;
+
+  // Large payloads may be received in several blocks
+  resp_packet = _app_coap_block1(req_packet, &full_req_packet);
+  if (resp_packet != NULL) {
+    return resp_packet;
+  }
+  return _coap_callback_application_parameter(&full_req_packet);
+}
+
+sl_wisun_coap_packet_t * _coap_callback_application_parameter (
+      const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
   #define MAX_PARAMETER_NAME 40
   char parameter_name[MAX_PARAMETER_NAME];
-  char* payload_str = NULL;
+  char *payload_str;
+  app_coap_token_t tokens[2];
+  app_coap_token_t payload;
   char  value_str[1000];
   uint32_t value = 0;
+  int32_t index32;
   int index = 10;
   int done  = 0;
 
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  // Payload as a string, at the end of this request's response buffer
+  payload_str = coap_response + COAP_MAX_RESPONSE_LEN - APP_COAP_BLOCK1_MAX_LEN - 1;
+
   // Reset parameter_name tab
   memset(parameter_name, 0, MAX_PARAMETER_NAME);
 
   if (req_packet->payload_len) {
-    // Get payload in string format with last char = '\0'
-    payload_str = sl_wisun_coap_get_payload_str(req_packet);
+    payload.ptr = (const char *)req_packet->payload_ptr;
+    payload.len = req_packet->payload_len;
+    if (!app_coap_token_copy(&payload, payload_str, APP_COAP_BLOCK1_MAX_LEN + 1)) {
+      payload_str = NULL;
+    }
     sprintf(value_str, "%s", "(no_value_str)");
-    printfBothTime("coap_request code %d, payload %s\n", req_packet->msg_code, payload_str);
+    printfBothTime("coap_request code %d, payload %.*s\n", req_packet->msg_code,
+                   req_packet->payload_len, (const char *)req_packet->payload_ptr);
     if (payload_str != NULL ) {
 
-        if (req_packet->msg_code == COAP_MSG_CODE_REQUEST_PUT) {
-          if (done == 0) { // PUT <parameter> <int> <int>
-            if (3 == sscanf((char *)payload_str, "%s %d %ld", parameter_name, &index, &value)) { done++; }
-          }
-          if (done == 0) { // PUT <parameter> <int> <str>
-            if (3 == sscanf((char *)payload_str, "%s %d %s", parameter_name, &index, value_str)) { done++; }
-          }
-          if (done == 0) { // PUT <parameter> <int>
-            if  (2 == sscanf((char *)payload_str, "%s %ld", parameter_name, &value)) { done++; }
-          }
-          if (done == 0) { // PUT <parameter>
-            if  (1 == sscanf((char *)payload_str, "%s", parameter_name)) { done++; }
-          }
+        if ((req_packet->msg_code == COAP_MSG_CODE_REQUEST_PUT) && (find_app_parameters_separator(payload_str) != NULL)) {
+          // PUT <assignment>;<assignment>;... : all applied and saved once, or none
+          set_app_parameters_transaction(payload_str, value_str, sizeof(value_str));
+          snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", value_str);
+          done = -1;
+        }
+
+        if ((req_packet->msg_code == COAP_MSG_CODE_REQUEST_PUT) && (done == 0)) {
+          // PUT <parameter> [<int>] [<int>|<str>]
+          if (scan_app_parameter(payload_str, parameter_name, &index, &value, value_str)) { done++; }
           if (done) {
-            set_app_parameter(parameter_name, index, value, value_str);
+            set_app_parameter(parameter_name, index, value, value_str, false);
             snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "%s", value_str);
           } else {
             snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Can not PUT app_parameter %s", parameter_name);
@@ -849,11 +1779,16 @@ sl_wisun_coap_packet_t * coap_callback_application_parameter (
         }
 
         if (req_packet->msg_code == COAP_MSG_CODE_REQUEST_GET) {
-          if (done == 0) { // GET <parameter> <int> <str>
-            if (2 == sscanf((char *)payload_str, "%s %d", parameter_name, &index)) { done++; }
-          }
-          if (done == 0) { // GET <parameter>
-            if (1 == sscanf((char *)payload_str, "%s", parameter_name)) { done++; }
+          // GET <parameter> [<int>]
+          switch (app_coap_payload_tokens(req_packet, tokens, 2)) {
+            case 2:
+              if (app_coap_token_int(&tokens[1], &index32)) { index = (int)index32; }
+              // fall through
+            case 1:
+              if (app_coap_token_copy(&tokens[0], parameter_name, MAX_PARAMETER_NAME)) { done++; }
+              break;
+            default:
+              break;
           }
           // Conclusion
           if (done) {
@@ -864,8 +1799,8 @@ sl_wisun_coap_packet_t * coap_callback_application_parameter (
           }
 
         }
-      // Free payload_str
-      sl_free(payload_str);
+    } else {
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Payload longer than %d bytes", APP_COAP_BLOCK1_MAX_LEN);
     }
   } else {
       snprintf(coap_response, COAP_MAX_RESPONSE_LEN,
@@ -878,14 +1813,20 @@ return app_coap_reply(coap_response, req_packet); }
 #ifdef    __APP_REPORTER_H__
 sl_wisun_coap_packet_t * coap_callback_reporter_start (
     const  sl_wisun_coap_packet_t *const req_packet)  {
-  char* payload_str = NULL;
+  char *coap_response = app_coap_response_acquire();
+  char *filter;
+  app_coap_token_t token;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  // Filter as a string (split in place by app_start_reporter()), at the end of this request's response buffer
+  filter = coap_response + COAP_MAX_RESPONSE_LEN - MAX_MATCH_STRING_LEN;
   if (req_packet->payload_len) {
-      // Get payload in string format with last char = '\0'
-      payload_str = sl_wisun_coap_get_payload_str(req_packet);
-      if (payload_str != NULL ){
-          app_start_reporter(network[app_parameters.network_index].udp_notification_dest, 1000, (char *)payload_str);
-          sl_free(payload_str);
-      }
+      token.ptr = (const char *)req_packet->payload_ptr;
+      token.len = req_packet->payload_len;
+      (void)app_coap_token_copy(&token, filter, MAX_MATCH_STRING_LEN);
+      app_start_reporter(network[app_parameters.network_index].udp_notification_dest, 1000, filter);
     } else {
         // if no payload, accept all lines
       app_start_reporter(network[app_parameters.network_index].udp_notification_dest, 1000, (char *)"*");
@@ -895,25 +1836,82 @@ sl_wisun_coap_packet_t * coap_callback_reporter_start (
 
 sl_wisun_coap_packet_t * coap_callback_reporter_stop (
     const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
     app_stop_reporter();
     snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "stopped");
   return app_coap_reply(coap_response, req_packet); }
+
+sl_wisun_coap_packet_t * coap_callback_reporter_compress (
+    const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  bool res = true;
+
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (req_packet->payload_len) {
+    if        (app_coap_payload_is(req_packet, "on")) {
+      res = app_reporter_set_compress(APP_REPORTER_COMPRESS_ON);
+    } else if (app_coap_payload_is(req_packet, "off")) {
+      res = app_reporter_set_compress(APP_REPORTER_COMPRESS_OFF);
+    } else if (app_coap_payload_is(req_packet, "measure")) {
+      res = app_reporter_set_compress(APP_REPORTER_COMPRESS_MEASURE);
+    } else if (app_coap_payload_is(req_packet, "reset")) {
+      app_reporter_compress_reset();
+    } else {
+      snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "invalid payload: use on|off|measure|reset");
+      return app_coap_reply(coap_response, req_packet);
+    }
+  }
+  if (res) {
+    app_reporter_compress_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  } else {
+    snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "Could not allocate compression buffers");
+  }
+  return app_coap_reply(coap_response, req_packet); }
+
+sl_wisun_coap_packet_t * coap_callback_reporter_statistics (
+    const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
+  if (app_coap_payload_is(req_packet, "reset")) {
+    app_reporter_statistics_reset();
+  }
+  app_reporter_statistics_string(coap_response, COAP_MAX_RESPONSE_LEN);
+  return app_coap_reply(coap_response, req_packet); }
   #endif /* __APP_REPORTER_H__ */
 
 #ifdef    APP_WISUN_MULTICAST_OTA_H
 #ifdef    SL_CATALOG_WISUN_OTA_DFU_PRESENT
 sl_wisun_coap_packet_t * coap_callback_multicast_ota (
     const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
     snprintf(coap_response, COAP_MAX_RESPONSE_LEN, missed_chunks());
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_multicast_ota_rx (
     const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
     snprintf(coap_response, COAP_MAX_RESPONSE_LEN, rx_chunks());
   return app_coap_reply(coap_response, req_packet); }
 
 sl_wisun_coap_packet_t * coap_callback_multicast_ota_info (
     const  sl_wisun_coap_packet_t *const req_packet)  {
+  char *coap_response = app_coap_response_acquire();
+  if (coap_response == NULL) {
+    return app_coap_reply_unavailable(req_packet);
+  }
     snprintf(coap_response, COAP_MAX_RESPONSE_LEN, ota_multicast_info());
   return app_coap_reply(coap_response, req_packet); }
 
@@ -922,26 +1920,26 @@ sl_wisun_coap_packet_t * coap_callback_multicast_ota_info (
 
 sl_wisun_coap_packet_t * coap_callback_realloc (
     const  sl_wisun_coap_packet_t *const req_packet)  {
-char* payload_str = NULL;
+  char *coap_response = app_coap_response_acquire();
+app_coap_token_t token;
 uint32_t previously_malloced;
-int nb_bytes = 0;
-int res;
+int32_t nb_bytes = 0;
 previously_malloced = realloced_bytes;
 sl_memory_heap_info_t app_heap_info_before;
 sl_memory_heap_info_t app_heap_info_after;
+if (coap_response == NULL) {
+  return app_coap_reply_unavailable(req_packet);
+}
 sl_memory_get_heap_info(&app_heap_info_before);
 
 if (req_packet->payload_len) {
-  // Get payload in string format with last char = '\0'
-  payload_str = sl_wisun_coap_get_payload_str(req_packet);
-  if (payload_str != NULL ){
-      res = sscanf((char *)payload_str, "%d", &nb_bytes);
-      if (res == 1) {
+  if (app_coap_payload_tokens(req_packet, &token, 1) == 1) {
+      if (app_coap_token_int(&token, &nb_bytes)) {
         // Process /malloc -e "<nb_bytes>"
           if (nb_bytes == 0) {
               realloc_ptr = sl_realloc(realloc_ptr, 0);
               realloced_bytes = 0;
-              snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "nb_bytes %d. deallocated %ld bytes (at %p). Heap used %d -> %d (%.2f -> %.2f %%) free %d",
+              snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "nb_bytes %ld. deallocated %ld bytes (at %p). Heap used %d -> %d (%.2f -> %.2f %%) free %d",
                        nb_bytes,
                        previously_malloced,
                        realloc_ptr,
@@ -956,7 +1954,7 @@ if (req_packet->payload_len) {
             if (realloc_ptr != NULL) {
               realloced_bytes += nb_bytes;
               sl_memory_get_heap_info(&app_heap_info_after);
-              snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "nb_bytes %d. allocated %ld bytes %ld -> %ld (at %p). Heap used %d -> %d (%.2f -> %.2f %%)",
+              snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "nb_bytes %ld. allocated %ld bytes %ld -> %ld (at %p). Heap used %d -> %d (%.2f -> %.2f %%)",
                        nb_bytes,
                        realloced_bytes - previously_malloced,
                        previously_malloced,
@@ -968,15 +1966,14 @@ if (req_packet->payload_len) {
                        1.0*app_heap_info_after.used_size /(app_heap_info_after.total_size /100.0)
                        );
             } else {
-                snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "error allocating %d bytes. Currently allocated %ld",
+                snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "error allocating %ld bytes. Currently allocated %ld",
                          nb_bytes,
                          previously_malloced);
             }
         }
       } else {
-          snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "incorrect 'malloc <int>' format in '%s'", payload_str);
+          snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "incorrect 'malloc <int>' format in '%.*s'", token.len, token.ptr);
       }
-      sl_free(payload_str);
   } else {
     // Process /malloc" (checking already allocated nb_bytes)
     snprintf(coap_response, COAP_MAX_RESPONSE_LEN, "allocated %ld heap bytes. Heap used %d",
@@ -987,333 +1984,325 @@ if (req_packet->payload_len) {
 }
 return app_coap_reply(coap_response, req_packet); }
 
-// CoAP resources init in resource handler (one block per URI)
-uint8_t app_coap_resources_init() {
-  sl_wisun_coap_rhnd_resource_t coap_resource = { 0 };
-  uint8_t count = 0;
-
-  // Add CoAP resources (one per item)
-
-  coap_resource.data.uri_path = "/info/all";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_all_infos;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/device";
-  coap_resource.data.resource_type = "tag";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_device;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/chip";
-  coap_resource.data.resource_type = "tag";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_chip;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/board";
-  coap_resource.data.resource_type = "txt";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_board;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/device_type";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_device_type;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/application";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_application;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/info/version";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_version;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/status/all";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_all_statuses;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/status/send";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_send_status_msg;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/status/running";
-  coap_resource.data.resource_type = "dhms";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_running;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/status/parent";
-  coap_resource.data.resource_type = "tag";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_parent;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/status/neighbor";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_neighbor;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
+#if APP_COAP_PREFIX_DISPATCH
+// Forward declaration: callback of the prefix resources
+static sl_wisun_coap_packet_t * coap_callback_prefix_dispatch(const sl_wisun_coap_packet_t *const req_packet);
+#endif /* APP_COAP_PREFIX_DISPATCH */
+
+// CoAP resources registered one by one in the resource handler by app_coap_resources_init()
+static const app_coap_resource_t app_coap_resources[] = {
+  { "/info/all",                          "json",  "node",          coap_callback_all_infos,               true  },
+  { "/info/device",                       "tag",   "node",          coap_callback_device,                  false },
+  { "/info/chip",                         "tag",   "node",          coap_callback_chip,                    false },
+  { "/info/board",                        "txt",   "node",          coap_callback_board,                   false },
+  { "/info/device_type",                  "text",  "node",          coap_callback_device_type,             false },
+  { "/info/application",                  "text",  "node",          coap_callback_application,             false },
+  { "/info/version",                      "text",  "node",          coap_callback_version,                 false },
+  { "/status/all",                        "json",  "node",          coap_callback_all_statuses,            true  },
+  { "/status/send",                       "text",  "node",          coap_callback_send_status_msg,         false },
+  { "/status/running",                    "dhms",  "node",          coap_callback_running,                 false },
+  { "/status/parent",                     "tag",   "node",          coap_callback_parent,                  false },
+  { "/status/neighbor",                   "json",  "node",          coap_callback_neighbor,                false },
 #ifdef    COAP_APP_STATISTICS
-  coap_resource.data.uri_path = "/status/connected";
-  coap_resource.data.resource_type = "dhms";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_connected;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/join_states_sec";
-  coap_resource.data.resource_type = "array";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_join_states_sec;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/disconnected_total";
-  coap_resource.data.resource_type = "dhms";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_disconnected_total;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/connections";
-  coap_resource.data.resource_type = "int";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_connections;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/connected_total";
-  coap_resource.data.resource_type = "dhms";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_connected_total;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/availability";
-  coap_resource.data.resource_type = "ratio";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_availability;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/app/all";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_all_app_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
+  { "/status/connected",                  "dhms",  "node",          coap_callback_connected,               false },
+  { "/batch",                             "json",  "node",          coap_callback_batch,                   true  },
 #ifdef    SL_CATALOG_SIMPLE_LED_PRESENT
-  coap_resource.data.uri_path = "/leds/flash";
-  coap_resource.data.resource_type = "leds";
-  coap_resource.data.interface = "leds";
-  coap_resource.auto_response = coap_callback_leds_flash;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/leds/flash",                        "leds",  "leds",          coap_callback_leds_flash,              true  },
 #endif /* SL_CATALOG_SIMPLE_LED_PRESENT */
-
 #ifdef    HISTORY
-  coap_resource.data.uri_path = "/history";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "node";
-  coap_resource.auto_response = coap_callback_history;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/history",                           "text",  "node",          coap_callback_history,                 true  },
 #endif /* HISTORY */
-
 #endif /* COAP_APP_STATISTICS */
-
 #ifdef    COAP_STACK_STATISTICS
-  coap_resource.data.uri_path = "/statistics/stack/phy";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "phy";
-  coap_resource.auto_response = coap_callback_phy_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/stack/mac";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "mac";
-  coap_resource.auto_response = coap_callback_mac_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/stack/fhss";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "fhss";
-  coap_resource.auto_response = coap_callback_fhss_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/stack/wisun";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "wisun";
-  coap_resource.auto_response = coap_callback_wisun_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/stack/network";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "network";
-  coap_resource.auto_response = coap_callback_network_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/statistics/stack/regulation";
-  coap_resource.data.resource_type = "json";
-  coap_resource.data.interface = "regulation";
-  coap_resource.auto_response = coap_callback_regulation_statistics;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/statistics/stack/phy",              "json",  "phy",           coap_callback_phy_statistics,          true  },
+  { "/statistics/stack/mac",              "json",  "mac",           coap_callback_mac_statistics,          true  },
+  { "/statistics/stack/fhss",             "json",  "fhss",          coap_callback_fhss_statistics,         true  },
+  { "/statistics/stack/wisun",            "json",  "wisun",         coap_callback_wisun_statistics,        true  },
+  { "/statistics/stack/network",          "json",  "network",       coap_callback_network_statistics,      true  },
+  { "/statistics/stack/regulation",       "json",  "regulation",    coap_callback_regulation_statistics,   true  },
 #endif /* COAP_STACK_STATISTICS */
-
-  coap_resource.data.uri_path = "/settings/auto_send";
-  coap_resource.data.resource_type = "sec";
-  coap_resource.data.interface = "settings";
-  coap_resource.auto_response = coap_callback_auto_send;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  #ifdef    APP_RTT_TRACES_H
-  coap_resource.data.uri_path = "/settings/trace_level";
-  coap_resource.data.resource_type = "level";
-  coap_resource.data.interface = "settings";
-  coap_resource.auto_response = coap_callback_trace_level;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/settings/auto_send",                "sec",   "settings",      coap_callback_auto_send,               true  },
+#ifdef    APP_RTT_TRACES_H
+  { "/settings/trace_level",              "level", "settings",      coap_callback_trace_level,             true  },
 #endif /* APP_RTT_TRACES_H */
-
 #ifdef    APP_PARAMETERS_H
-  coap_resource.data.uri_path = "/settings/parameter";
-  coap_resource.data.resource_type = "int";
-  coap_resource.data.interface = "settings";
-  coap_resource.auto_response = coap_callback_application_parameter;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/settings/parameter",                "int",   "settings",      coap_callback_application_parameter,   true  },
 #endif /* APP_PARAMETERS_H */
+#ifdef    APP_WISUN_MULTICAST_OTA_H
+#ifdef    SL_CATALOG_WISUN_OTA_DFU_PRESENT
+  { "/multicast_ota/missed",              "text",  "multicast_ota", coap_callback_multicast_ota,           true  },
+  { "/multicast_ota/rx",                  "text",  "multicast_ota", coap_callback_multicast_ota_rx,        true  },
+  { "/multicast_ota/info",                "text",  "multicast_ota", coap_callback_multicast_ota_info,      true  },
+#endif /* SL_CATALOG_WISUN_OTA_DFU_PRESENT */
+#endif /* APP_WISUN_MULTICAST_OTA_H */
+  { "/realloc",                           "mem",   "test",          coap_callback_realloc,                 false },
+};
+#define APP_COAP_REGISTERED_COUNT (sizeof(app_coap_resources) / sizeof(app_coap_resources[0]))
 
+// CoAP resources under '/statistics/app/' and '/reporter/', registered one by one (or dispatched
+//  by coap_callback_prefix_dispatch() if APP_COAP_PREFIX_DISPATCH is 1)
+static const app_coap_resource_t app_coap_sub_resources[] = {
+#ifdef    COAP_APP_STATISTICS
+  { "/statistics/app/join_states_sec",    "array", "node",          coap_callback_join_states_sec,         false },
+  { "/statistics/app/disconnected_total", "dhms",  "node",          coap_callback_disconnected_total,      false },
+  { "/statistics/app/connections",        "int",   "node",          coap_callback_connections,             false },
+  { "/statistics/app/connected_total",    "dhms",  "node",          coap_callback_connected_total,         false },
+  { "/statistics/app/availability",       "ratio", "node",          coap_callback_availability,            false },
+  { "/statistics/app/all",                "json",  "node",          coap_callback_all_app_statistics,      true  },
+  { "/statistics/app/main_loop",          "json",  "node",          coap_callback_main_loop_statistics,    true  },
+  { "/statistics/app/snapshot",           "json",  "node",          coap_callback_snapshot_statistics,     true  },
+  { "/statistics/app/notifications",      "json",  "node",          coap_callback_notification_statistics, true  },
+#ifdef    APP_SEND_SLOT_H
+  { "/statistics/app/send_slot",          "json",  "node",          coap_callback_send_slot_statistics,    true  },
+#endif /* APP_SEND_SLOT_H */
+#ifdef    APP_COAP_OBSERVE_H
+  { "/statistics/app/observe",            "json",  "node",          coap_callback_observe_statistics,      true  },
+#endif /* APP_COAP_OBSERVE_H */
+  { "/statistics/app/coap",               "json",  "node",          coap_callback_coap_statistics,         true  },
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+  { "/statistics/app/traces",             "json",  "node",          coap_callback_trace_tokens_statistics, true  },
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
+  { "/statistics/app/scheduler",          "json",  "node",          coap_callback_scheduler_statistics,    true  },
+#endif /* COAP_APP_STATISTICS */
 #ifdef    __APP_REPORTER_H__
-  coap_resource.data.uri_path = "/reporter/crash";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "reporter";
-  coap_resource.auto_response = coap_callback_crash_report;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/reporter/start";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "test";
-  coap_resource.auto_response = coap_callback_reporter_start;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/reporter/stop";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "test";
-  coap_resource.auto_response = coap_callback_reporter_stop;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
+  { "/reporter/crash",                    "text",  "reporter",      coap_callback_crash_report,            true  },
+  { "/reporter/start",                    "text",  "test",          coap_callback_reporter_start,          true  },
+  { "/reporter/stop",                     "text",  "test",          coap_callback_reporter_stop,           true  },
+  { "/reporter/compress",                 "json",  "test",          coap_callback_reporter_compress,       true  },
+  { "/reporter/statistics",               "json",  "test",          coap_callback_reporter_statistics,     true  },
 #endif /* __APP_REPORTER_H__ */
+};
+#define APP_COAP_SUB_RESOURCE_COUNT (sizeof(app_coap_sub_resources) / sizeof(app_coap_sub_resources[0]))
+#define APP_COAP_RESOURCE_COUNT     (APP_COAP_REGISTERED_COUNT + APP_COAP_SUB_RESOURCE_COUNT)
 
+#if APP_COAP_PREFIX_DISPATCH
+// Prefix resources, registered instead of the app_coap_sub_resources[] URIs
+static const app_coap_resource_t app_coap_prefixes[] = {
+#ifdef    COAP_APP_STATISTICS
+  { "/statistics/app/",                   "json",  "node",          coap_callback_prefix_dispatch,         true  },
+#endif /* COAP_APP_STATISTICS */
+#ifdef    __APP_REPORTER_H__
+  { "/reporter/",                         "text",  "reporter",      coap_callback_prefix_dispatch,         true  },
+#endif /* __APP_REPORTER_H__ */
+};
+  #define APP_COAP_HANDLER_RESOURCE_COUNT \
+    (APP_COAP_REGISTERED_COUNT + sizeof(app_coap_prefixes) / sizeof(app_coap_prefixes[0]))
+#else  /* APP_COAP_PREFIX_DISPATCH */
+  #define APP_COAP_HANDLER_RESOURCE_COUNT APP_COAP_RESOURCE_COUNT
+#endif /* APP_COAP_PREFIX_DISPATCH */
+
+// Each registered URI uses one resource of the resource handler: keep room for new URIs
+_Static_assert(APP_COAP_HANDLER_RESOURCE_COUNT + APP_COAP_RESOURCE_HEADROOM
+               <= SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES,
+               "Less than APP_COAP_RESOURCE_HEADROOM free SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES");
+_Static_assert(APP_COAP_RESOURCE_COUNT * 2 <= APP_COAP_LOOKUP_SIZE,
+               "APP_COAP_LOOKUP_SIZE less than twice the number of CoAP URIs");
+
+// All URIs, built by app_coap_resources_init()
+static app_coap_lookup_t coap_lookup;
+
+// Resource 'index' of both tables: registered ones first
+static const app_coap_resource_t * _app_coap_resource_at(uint16_t index) {
+  if (index < APP_COAP_REGISTERED_COUNT) {
+    return &app_coap_resources[index];
+  }
+  return &app_coap_sub_resources[index - APP_COAP_REGISTERED_COUNT];
+}
 
-#ifdef    APP_WISUN_MULTICAST_OTA_H
-#ifdef    SL_CATALOG_WISUN_OTA_DFU_PRESENT
-  coap_resource.data.uri_path = "/multicast_ota/missed";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "multicast_ota";
-  coap_resource.auto_response = coap_callback_multicast_ota;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/multicast_ota/rx";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "multicast_ota";
-  coap_resource.auto_response = coap_callback_multicast_ota_rx;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  coap_resource.data.uri_path = "/multicast_ota/info";
-  coap_resource.data.resource_type = "text";
-  coap_resource.data.interface = "multicast_ota";
-  coap_resource.auto_response = coap_callback_multicast_ota_info;
-  coap_resource.discoverable = true;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-#endif /* SL_CATALOG_WISUN_OTA_DFU_PRESENT */
-#endif /* APP_WISUN_MULTICAST_OTA_H */
+static const char * _app_coap_resource_uri_at(uint16_t index) {
+  return _app_coap_resource_at(index)->uri_path;
+}
+
+// Index of a resource of both tables, for coap_resource_stats[]
+static uint16_t _app_coap_resource_index(const app_coap_resource_t *resource) {
+  if ((resource >= app_coap_resources) && (resource < app_coap_resources + APP_COAP_REGISTERED_COUNT)) {
+    return (uint16_t)(resource - app_coap_resources);
+  }
+  return (uint16_t)(APP_COAP_REGISTERED_COUNT + (resource - app_coap_sub_resources));
+}
+
+// One hash of the path and usually one string compare, whatever the number of URIs
+const app_coap_resource_t * app_coap_resource_find(const char *uri_path, uint16_t uri_path_len) {
+  int16_t index = app_coap_lookup_find(&coap_lookup, _app_coap_resource_uri_at, uri_path, uri_path_len);
+
+  return (index == APP_COAP_LOOKUP_NONE) ? NULL : _app_coap_resource_at((uint16_t)index);
+}
+
+uint8_t app_coap_resource_count(void) {
+  return (uint8_t)APP_COAP_RESOURCE_COUNT;
+}
+
+#if APP_COAP_PREFIX_DISPATCH
+// Called by the resource handler for all the URIs starting with a prefix of app_coap_prefixes[]
+static sl_wisun_coap_packet_t * coap_callback_prefix_dispatch(const sl_wisun_coap_packet_t *const req_packet) {
+  const app_coap_resource_t *resource;
+  app_coap_token_t group;
+
+  resource = app_coap_resource_find((const char *)req_packet->uri_path_ptr, req_packet->uri_path_len);
+  if ((resource == NULL) || (resource->auto_response == coap_callback_prefix_dispatch)) {
+    coap_prefix_counters.not_found++;
+    if (app_coap_query_param(req_packet, "g", &group)) {
+      // No error responses to group requests (RFC 7252 §8.2)
+      return NULL;
+    }
+    return sl_wisun_coap_build_response(req_packet, COAP_MSG_CODE_RESPONSE_NOT_FOUND);
+  }
+  coap_prefix_counters.dispatched++;
+  return resource->auto_response(req_packet);
+}
+#endif /* APP_COAP_PREFIX_DISPATCH */
+
+// Handler statistics, per resource (same index as _app_coap_resource_at()).
+//  Handler time is from app_coap_response_acquire() to the reply, in sleeptimer ticks
+typedef struct {
+  uint32_t calls;
+  uint32_t min_ticks;
+  uint32_t max_ticks;
+  uint64_t total_ticks;
+  uint32_t total_bytes;
+  uint16_t max_bytes;
+} app_coap_resource_stats_t;
+
+static app_coap_resource_stats_t coap_resource_stats[APP_COAP_RESOURCE_COUNT];
+
+static void _app_coap_resource_stats_add(const sl_wisun_coap_packet_t *const req_packet,
+                                         uint16_t response_len) {
+  const app_coap_resource_t *resource;
+  app_coap_resource_stats_t *stats;
+  uint32_t ticks;
+
+  resource = app_coap_resource_find((const char *)req_packet->uri_path_ptr, req_packet->uri_path_len);
+  if (resource == NULL) {
+    return;
+  }
+  stats = &coap_resource_stats[_app_coap_resource_index(resource)];
+  ticks = (uint32_t)(sl_sleeptimer_get_tick_count64() - app_coap_response_start_tick());
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  if ((stats->calls == 0) || (ticks < stats->min_ticks)) {
+    stats->min_ticks = ticks;
+  }
+  if (ticks > stats->max_ticks) {
+    stats->max_ticks = ticks;
+  }
+  if (response_len > stats->max_bytes) {
+    stats->max_bytes = response_len;
+  }
+  stats->total_ticks += ticks;
+  stats->total_bytes += response_len;
+  stats->calls++;
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+}
+
+// Called with coap_response_mutex acquired
+static void _app_coap_resource_stats_reset(void) {
+  memset(coap_resource_stats, 0, sizeof(coap_resource_stats));
+}
+
+char * app_coap_resource_statistics_string(char *buf, uint16_t size, const char *prefix) {
+  app_coap_resource_stats_t stats;
+  uint32_t frequency = sl_sleeptimer_get_timer_frequency();
+  uint16_t prefix_len = 0;
+  uint16_t len = 0;
+  uint16_t skipped = 0;
+  uint16_t path_len;
+  const char *path;
+  int written;
+  uint8_t i;
+
+  if (prefix != NULL) {
+    prefix_len = (uint16_t)sl_strnlen((char *)prefix, COAP_BLOCK2_URI_MAX_LEN);
+    prefix = app_coap_lookup_skip_slash(prefix, &prefix_len);
+  }
+  written = snprintf(buf, size, "{\n    \"fields\": \"calls,min_us,avg_us,max_us,avg_bytes,max_bytes\"");
+  if ((written < 0) || (written >= size)) {
+    return buf;
+  }
+  len = (uint16_t)written;
+  for (i = 0; i < APP_COAP_RESOURCE_COUNT; i++) {
+    path_len = (uint16_t)sl_strnlen((char *)_app_coap_resource_uri_at(i), COAP_MAX_RESPONSE_LEN);
+    path = app_coap_lookup_skip_slash(_app_coap_resource_uri_at(i), &path_len);
+    if ((prefix_len > path_len) || strncmp(path, prefix, prefix_len)) {
+      continue;
+    }
+    assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+    stats = coap_resource_stats[i];
+    assert(osMutexRelease(coap_response_mutex) == osOK);
+    if (stats.calls == 0) {
+      continue;
+    }
+    // Keep room for the closing lines
+    written = snprintf(buf + len, size - len,
+                       ",\n    \"%s\": [%lu,%lu,%lu,%lu,%lu,%u]",
+                       _app_coap_resource_uri_at(i),
+                       stats.calls,
+                       (uint32_t)((uint64_t)stats.min_ticks * 1000000 / frequency),
+                       (uint32_t)(stats.total_ticks * 1000000 / frequency / stats.calls),
+                       (uint32_t)((uint64_t)stats.max_ticks * 1000000 / frequency),
+                       stats.total_bytes / stats.calls,
+                       stats.max_bytes);
+    if ((written < 0) || (len + written + 32 >= size)) {
+      buf[len] = '\0';
+      skipped++;
+      continue;
+    }
+    len += (uint16_t)written;
+  }
+  if (skipped) {
+    len += (uint16_t)snprintf(buf + len, size - len, ",\n    \"skipped\": %u", skipped);
+  }
+  snprintf(buf + len, size - len, "\n  }\n");
+  return buf;
+}
+
+// Register one resource in the resource handler
+static bool _app_coap_resource_register(const app_coap_resource_t *resource) {
+  sl_wisun_coap_rhnd_resource_t coap_resource = { 0 };
+
+  coap_resource.data.uri_path      = resource->uri_path;
+  coap_resource.data.resource_type = resource->resource_type;
+  coap_resource.data.interface     = resource->interface;
+  coap_resource.auto_response      = resource->auto_response;
+  coap_resource.discoverable       = resource->discoverable;
+  if (sl_wisun_coap_rhnd_resource_add(&coap_resource) != SL_STATUS_OK) {
+    printf("  [Failed to add CoAP resource %s]\n", resource->uri_path);
+    return false;
+  }
+  return true;
+}
+
+// CoAP resources init: lookup of all URIs, and registration in the resource handler of
+//  app_coap_resources[] and of the prefixes (or of app_coap_sub_resources[])
+uint8_t app_coap_resources_init() {
+  uint8_t count = 0;
+  uint8_t i;
+
+  coap_response_mutex = osMutexNew(NULL);
+  assert(coap_response_mutex != NULL);
+  app_coap_response_pool_init();
+
+  app_coap_lookup_init(&coap_lookup);
+  for (i = 0; i < APP_COAP_RESOURCE_COUNT; i++) {
+    if (!app_coap_lookup_add(&coap_lookup, i, _app_coap_resource_uri_at(i))) {
+      printf("  [Failed to add CoAP resource %s to the lookup]\n", _app_coap_resource_uri_at(i));
+    }
+  }
+
+  for (i = 0; i < APP_COAP_REGISTERED_COUNT; i++) {
+    count += _app_coap_resource_register(&app_coap_resources[i]);
+  }
+#if APP_COAP_PREFIX_DISPATCH
+  for (i = 0; i < sizeof(app_coap_prefixes) / sizeof(app_coap_prefixes[0]); i++) {
+    count += _app_coap_resource_register(&app_coap_prefixes[i]);
+  }
+#else  /* APP_COAP_PREFIX_DISPATCH */
+  for (i = 0; i < APP_COAP_SUB_RESOURCE_COUNT; i++) {
+    count += _app_coap_resource_register(&app_coap_sub_resources[i]);
+  }
+#endif /* APP_COAP_PREFIX_DISPATCH */
 
-  coap_resource.data.uri_path = "/realloc";
-  coap_resource.data.resource_type = "mem";
-  coap_resource.data.interface = "test";
-  coap_resource.auto_response = coap_callback_realloc;
-  coap_resource.discoverable = false;
-  assert(sl_wisun_coap_rhnd_resource_add(&coap_resource) == SL_STATUS_OK);
-  count++;
-
-  printf("  %d/%d CoAP resources added to CoAP Resource handler\n", count, SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES);
-  #if SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES < 20
-    #pragma message("Increase SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES to avoid an assert")
-  #endif
+  printf("  %d/%d CoAP resources added to CoAP Resource handler (%d URIs)\n",
+         count, SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES, (int)APP_COAP_RESOURCE_COUNT);
   return count;
 }
 #endif /* SL_CATALOG_WISUN_COAP_PRESENT */
@@ -45,6 +45,7 @@
 // -----------------------------------------------------------------------------
 #include "sl_wisun_coap_rhnd.h"
 #include "app_timestamp.h"
+#include "app_coap_response.h"
 
 extern uint16_t connection_count;           // number of connections (moving to Join State 5)
 extern uint16_t network_connection_count;   // number of network connections (moving to Join State 5 from min Join State 3)
@@ -65,14 +66,132 @@ extern char device_tag[];
 extern char parent_tag[];
 extern char history_string[];
 extern char device_type_string[];
+extern char device_mac_string[];
 extern sl_wisun_mac_address_t parent_mac;
 
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
 // -----------------------------------------------------------------------------
-#define COAP_MAX_RESPONSE_LEN 1000
+/*
+ * Block-wise transfers (RFC 7959)
+ * Responses larger than one block are sent in blocks of APP_COAP_BLOCK_SIZE(APP_COAP_BLOCK_SZX)
+ *  bytes, or less if the client asks for smaller blocks. A 256 bytes block fits in one or
+ *  two 6LoWPAN fragments, so losing a frame doesn't require re-sending the whole content.
+ * Large /settings/parameter payloads can be sent in blocks (Block1), up to APP_COAP_BLOCK1_MAX_LEN bytes.
+ *  One Block1 transfer at a time: a new one is answered with 5.03 (Max-Age: seconds before
+ *  retrying) until the running one ends, or stops for APP_COAP_BLOCK1_TIMEOUT_S
+ *
+ *   coap-client -m get -b 256 coap://[<device>]:5683/history
+ */
+#ifndef   APP_COAP_BLOCK_SZX
+  #define APP_COAP_BLOCK_SZX        4   // 2^(4+4) = 256 bytes
+#endif /* APP_COAP_BLOCK_SZX */
+#define APP_COAP_BLOCK1_MAX_LEN     512
+#ifndef   APP_COAP_BLOCK1_TIMEOUT_S
+  #define APP_COAP_BLOCK1_TIMEOUT_S   30
+#endif /* APP_COAP_BLOCK1_TIMEOUT_S */
+
+// Block1/Block2 option value: [NUM][M][SZX]
+#define APP_COAP_BLOCK_SIZE(szx)              (1U << ((szx) + 4))
+#define APP_COAP_BLOCK_NUM(value)             ((uint32_t)(value) >> 4)
+#define APP_COAP_BLOCK_MORE(value)            (((uint32_t)(value) >> 3) & 0x01)
+#define APP_COAP_BLOCK_SZX_OF(value)          ((uint8_t)((value) & 0x07))
+#define APP_COAP_BLOCK_VALUE(num, more, szx)  ((int32_t)(((num) << 4) | ((more) << 3) | (szx)))
+
+/*
+ * CoAP resources are listed in const tables, registered in the CoAP resource handler
+ *  by app_coap_resources_init(). Each registered URI uses one resource of the handler
+ *  (out of SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES), which matches them one by one.
+ * The resource handler (sl_wisun_coap_rhnd) matches full URIs, so all URIs are registered
+ *  by default. APP_COAP_PREFIX_DISPATCH 1 is only for a resource handler which calls a
+ *  prefix resource for its sub-paths: the URIs under '/statistics/app/' and '/reporter/'
+ *  are then not registered, these prefixes are registered instead, and their callback
+ *  dispatches each request to the callback of its full URI, found with
+ *  app_coap_resource_find(). With sl_wisun_coap_rhnd, these URIs would return 4.04.
+ * app_coap_resource_find() is a hash lookup of all URIs (app_coap_lookup.c): one hash
+ *  and usually one string compare, whatever the number of URIs (see the coap_lookup
+ *  host benchmark in linux_border_router_wsbrd/host_benchmarks).
+ * APP_COAP_RESOURCE_HEADROOM resources must remain free in the resource handler
+ */
+#ifndef   APP_COAP_PREFIX_DISPATCH
+  #define APP_COAP_PREFIX_DISPATCH    0   // 1: register prefixes (needs a handler routing sub-paths)
+#endif /* APP_COAP_PREFIX_DISPATCH */
+#define APP_COAP_RESOURCE_HEADROOM    8
+
+typedef sl_wisun_coap_packet_t * (*app_coap_callback_t)(const sl_wisun_coap_packet_t *const req_packet);
+
+typedef struct {
+  const char          *uri_path;
+  const char          *resource_type;
+  const char          *interface;
+  app_coap_callback_t  auto_response;
+  bool                 discoverable;
+} app_coap_resource_t;
+
+// Max-Age of the /info resources, which only change on reboot. Clients revalidate
+//  with the ETag option, and get a 2.03 Valid without payload if it's unchanged
+#ifndef   APP_COAP_INFO_MAX_AGE_S
+  #define APP_COAP_INFO_MAX_AGE_S           86400
+#endif /* APP_COAP_INFO_MAX_AGE_S */
+
+/*
+ * Group requests (RFC 7252 §8.2)
+ * The resource handler doesn't give the destination address of requests, so
+ *  requests sent to a multicast group are marked by the client with a 'g' query
+ *  parameter, set to the estimated group size:
+ *
+ *   coap-client -m get -N "coap://[ff03::1]:5683/status/parent?g=200"
+ *
+ * The resource handler doesn't give the source address of requests either, so its
+ *  responses can't be deferred: they are sent at once. Group requests sent to
+ *  APP_COAP_OBSERVE_PORT, where the application has the source address, are answered
+ *  after a random leisure, without blocking any thread: the response is built at once,
+ *  kept and sent from app_task() by app_coap_observe_process():
+ *
+ *   coap-client -m get -N "coap://[ff03::1]:5686/status/parent?g=200"
+ *
+ *  The leisure is up to S * G / R (S: response size, G: group size, R:
+ *  APP_COAP_GROUP_DATA_RATE_BPS), or up to APP_COAP_GROUP_DEFAULT_LEISURE_MS if 'g' has
+ *  no value, capped to APP_COAP_GROUP_MAX_LEISURE_MS (0: no leisure). See the
+ *  group_leisure model of linux_border_router_wsbrd/app_models.py for the cap.
+ * With 'if=<key>:<value>' (a status field key from APP_TLV_FIELDS), only the devices
+ *  with this value answer, the others don't send any response:
+ *
+ *   coap-client -m get -N "coap://[ff03::1]:5683/status/all?g=200&if=parent:a1b2"
+ */
+#ifndef   APP_COAP_GROUP_DATA_RATE_BPS
+  #define APP_COAP_GROUP_DATA_RATE_BPS      1000    // bytes/sec, for all responses near the Border Router
+#endif /* APP_COAP_GROUP_DATA_RATE_BPS */
+#define APP_COAP_GROUP_DEFAULT_LEISURE_MS   5000    // RFC 7252 DEFAULT_LEISURE (capped)
+#ifndef   APP_COAP_GROUP_MAX_LEISURE_MS
+  #define APP_COAP_GROUP_MAX_LEISURE_MS     60000   // longest deferral of a group response (0: no leisure)
+#endif /* APP_COAP_GROUP_MAX_LEISURE_MS */
 
 uint8_t app_coap_resources_init();
+/* Resource matching 'uri_path' (with or without leading '/'), NULL if none */
+const app_coap_resource_t * app_coap_resource_find(const char *uri_path, uint16_t uri_path_len);
+uint8_t app_coap_resource_count(void);
+/* Response pool and /info cache counters, and handler statistics of all resources, in json format */
+char * app_coap_statistics_string(char *buf, uint16_t size);
+/* Handler statistics (calls, handler time, response size) of the resources called since the last
+ *  reset, with URIs starting with 'prefix' (all if NULL), in json format */
+char * app_coap_resource_statistics_string(char *buf, uint16_t size, const char *prefix);
+void   app_coap_statistics_reset(void);
+/* Rebuild the /info payloads on next request (if the device type changed) */
+void   app_coap_info_cache_invalidate(void);
+/* Random leisure (ms) before answering a NON group request ('g'), 0 if not a group request.
+ *  Counted as a deferred response: only call it if the response is deferred */
+uint32_t app_coap_group_leisure_ms(const sl_wisun_coap_packet_t *const req_packet,
+                                   uint16_t response_len);
+/* 'response_string'/'payload' must be a buffer from app_coap_response_acquire() */
+sl_wisun_coap_packet_t * app_coap_reply(char *response_string,
+                  const sl_wisun_coap_packet_t *const req_packet);
+sl_wisun_coap_packet_t * app_coap_reply_payload(uint8_t *payload, uint16_t payload_len,
+                  sn_coap_content_format_e content_format,
+                  const sl_wisun_coap_packet_t *const req_packet);
+/* 5.03 Service Unavailable (Max-Age APP_COAP_RESPONSE_RETRY_S), when app_coap_response_acquire()
+ *  returned NULL. No response to group requests */
+sl_wisun_coap_packet_t * app_coap_reply_unavailable(const sl_wisun_coap_packet_t *const req_packet);
 void  print_coap_help (char* device_global_ipv6_string, char* border_router_ipv6_string);
 
 #endif /* APP_COAP_H */
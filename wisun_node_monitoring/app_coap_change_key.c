@@ -0,0 +1,101 @@
+/***************************************************************************//**
+* @file app_coap_change_key.c
+* @brief Change key of CoAP JSON contents
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "app_coap_change_key.h"
+#include "app_fnv.h"
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool app_coap_change_key_is_volatile(const char *volatile_fields, const uint8_t *name, uint16_t name_len) {
+  const char *field = volatile_fields;
+  const char *separator;
+  size_t len;
+
+  while (field != NULL) {
+    separator = strchr(field, '|');
+    len = (separator != NULL) ? (size_t)(separator - field) : strlen(field);
+    if ((len == name_len) && (memcmp(field, name, len) == 0)) {
+      return true;
+    }
+    field = (separator != NULL) ? separator + 1 : NULL;
+  }
+  return false;
+}
+
+uint32_t app_coap_change_key(const uint8_t *payload, uint16_t len, const char *volatile_fields) {
+  uint32_t hash = APP_FNV1A_32_OFFSET_BASIS;
+  const uint8_t *c;
+  const uint8_t *end = payload + len;
+  const uint8_t *name = NULL;   // last string, a field name if followed by ':'
+  uint16_t name_len = 0;
+  bool in_string = false;
+  bool skip = false;            // in the value of a volatile field
+
+  if ((volatile_fields != NULL) && (strcmp(volatile_fields, "*") == 0)) {
+    return hash;
+  }
+  for (c = payload; (payload != NULL) && (c < end); c++) {
+    if (volatile_fields != NULL) {
+      if (in_string) {
+        if (*c == '"') {
+          in_string = false;
+          name_len = (uint16_t)(c - name);
+        }
+      } else if (*c == '"') {
+        in_string = true;
+        name = c + 1;
+      } else if ((*c == ':') && (name != NULL)) {
+        skip = app_coap_change_key_is_volatile(volatile_fields, name, name_len);
+        name = NULL;
+      } else if ((*c == ',') || (*c == '}') || (*c == ']') || (*c == '\n')) {
+        skip = false;
+        name = NULL;
+      } else if (*c != ' ') {
+        name = NULL;
+      }
+      if (skip) {
+        continue;
+      }
+    }
+    hash = app_fnv1a_byte(hash, *c);
+  }
+  return hash;
+}
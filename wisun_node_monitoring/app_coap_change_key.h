@@ -0,0 +1,65 @@
+/***************************************************************************//**
+* @file app_coap_change_key.h
+* @brief Change key of CoAP JSON contents Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_COAP_CHANGE_KEY_H
+#define APP_COAP_CHANGE_KEY_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * FNV-1a of a JSON content without the values of its volatile fields (elapsed
+ *  times, counters changing at each read), to detect the other changes of
+ *  observed resources. 'volatile_fields' are '|' separated field names:
+ *  NULL hashes the whole content, "*" none of it (the whole content is volatile).
+ */
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+/* Change key of 'len' bytes of 'payload', without the values of 'volatile_fields' */
+uint32_t app_coap_change_key(const uint8_t *payload, uint16_t len, const char *volatile_fields);
+/* Whether field 'name' ('name_len' bytes) is one of 'volatile_fields' */
+bool     app_coap_change_key_is_volatile(const char *volatile_fields, const uint8_t *name, uint16_t name_len);
+
+#endif /* APP_COAP_CHANGE_KEY_H */
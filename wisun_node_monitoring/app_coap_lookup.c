@@ -0,0 +1,121 @@
+/***************************************************************************//**
+* @file app_coap_lookup.c
+* @brief Hash lookup of CoAP URI paths
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "sl_string.h"
+
+#include "app_coap_lookup.h"
+#include "app_fnv.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+#if (APP_COAP_LOOKUP_SIZE & (APP_COAP_LOOKUP_SIZE - 1)) != 0
+  #error "APP_COAP_LOOKUP_SIZE must be a power of 2"
+#endif
+#define APP_COAP_LOOKUP_URI_MAX_LEN  255
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint16_t _app_coap_lookup_slot(const char *path, uint16_t len) {
+  return (uint16_t)(app_fnv1a(APP_FNV1A_32_OFFSET_BASIS, path, len) & (APP_COAP_LOOKUP_SIZE - 1));
+}
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+// Registered URIs start with '/', parsed ones don't
+const char * app_coap_lookup_skip_slash(const char *path, uint16_t *len) {
+  if ((*len > 0) && (*path == '/')) {
+    path++;
+    (*len)--;
+  }
+  return path;
+}
+
+void app_coap_lookup_init(app_coap_lookup_t *lookup) {
+  memset(lookup->slots, 0, sizeof(lookup->slots));
+}
+
+bool app_coap_lookup_add(app_coap_lookup_t *lookup, uint16_t index, const char *uri_path) {
+  uint16_t len = (uint16_t)sl_strnlen((char *)uri_path, APP_COAP_LOOKUP_URI_MAX_LEN);
+  const char *path = app_coap_lookup_skip_slash(uri_path, &len);
+  uint16_t slot = _app_coap_lookup_slot(path, len);
+  uint16_t probes;
+
+  if (index > APP_COAP_LOOKUP_MAX_INDEX) {
+    return false;
+  }
+  for (probes = 0; probes < APP_COAP_LOOKUP_SIZE; probes++) {
+    if (lookup->slots[slot] == 0) {
+      lookup->slots[slot] = (uint8_t)(index + 1);
+      return true;
+    }
+    slot = (slot + 1) & (APP_COAP_LOOKUP_SIZE - 1);
+  }
+  return false;
+}
+
+int16_t app_coap_lookup_find(const app_coap_lookup_t *lookup, app_coap_lookup_uri_fn_t uri_at,
+                             const char *path, uint16_t len) {
+  const char *candidate;
+  uint16_t candidate_len;
+  uint16_t slot;
+  uint16_t probes;
+  uint8_t  index;
+
+  if (path == NULL) {
+    return APP_COAP_LOOKUP_NONE;
+  }
+  path = app_coap_lookup_skip_slash(path, &len);
+  slot = _app_coap_lookup_slot(path, len);
+  // Until a free slot: the entry would have been added there
+  for (probes = 0; (probes < APP_COAP_LOOKUP_SIZE) && (lookup->slots[slot] != 0); probes++) {
+    index = (uint8_t)(lookup->slots[slot] - 1);
+    candidate = uri_at(index);
+    candidate_len = (uint16_t)sl_strnlen((char *)candidate, APP_COAP_LOOKUP_URI_MAX_LEN);
+    candidate = app_coap_lookup_skip_slash(candidate, &candidate_len);
+    if ((candidate_len == len) && !memcmp(candidate, path, len)) {
+      return (int16_t)index;
+    }
+    slot = (slot + 1) & (APP_COAP_LOOKUP_SIZE - 1);
+  }
+  return APP_COAP_LOOKUP_NONE;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************//**
+* @file app_coap_lookup.h
+* @brief Hash lookup of CoAP URI paths Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_COAP_LOOKUP_H
+#define APP_COAP_LOOKUP_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * URI paths of a const table, found with one FNV-1a hash of the path and usually
+ *  one string compare, whatever the number of URIs:
+ *
+ *   app_coap_lookup_init(&lookup);
+ *   for (i = 0; i < count; i++) { app_coap_lookup_add(&lookup, i, table[i].uri_path); }
+ *   index = app_coap_lookup_find(&lookup, _uri_at, path, path_len);
+ *
+ * The lookup only stores table indexes (open addressing, linear probing), built
+ *  at init: the table content depends on build options, and C can't hash strings
+ *  at compile time, so a compile-time (perfect) hash would need a generated table
+ *  per configuration. Building it takes one hash per URI, once. Paths are compared
+ *  without their leading '/'.
+ * APP_COAP_LOOKUP_SIZE (a power of 2) must be at least twice the number of URIs,
+ *  to keep probe sequences short. Indexes are up to APP_COAP_LOOKUP_MAX_INDEX.
+ */
+#ifndef   APP_COAP_LOOKUP_SIZE
+  #define APP_COAP_LOOKUP_SIZE        128
+#endif /* APP_COAP_LOOKUP_SIZE */
+#define APP_COAP_LOOKUP_MAX_INDEX     0xFE
+#define APP_COAP_LOOKUP_NONE          (-1)
+
+typedef struct {
+  uint8_t slots[APP_COAP_LOOKUP_SIZE];  // table index + 1, 0 if free
+} app_coap_lookup_t;
+
+/* URI path of table entry 'index' */
+typedef const char * (*app_coap_lookup_uri_fn_t)(uint16_t index);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* 'path' without its leading '/' if any, 'len' updated */
+const char * app_coap_lookup_skip_slash(const char *path, uint16_t *len);
+/* Empty the lookup */
+void     app_coap_lookup_init(app_coap_lookup_t *lookup);
+/* Add table entry 'index', with 'uri_path'. Returns false if the lookup is full */
+bool     app_coap_lookup_add(app_coap_lookup_t *lookup, uint16_t index, const char *uri_path);
+/* Index of the entry with 'path' ('len' bytes, with or without leading '/'), APP_COAP_LOOKUP_NONE if none */
+int16_t  app_coap_lookup_find(const app_coap_lookup_t *lookup, app_coap_lookup_uri_fn_t uri_at,
+                              const char *path, uint16_t len);
+
+#endif /* APP_COAP_LOOKUP_H */
@@ -0,0 +1,718 @@
+/***************************************************************************//**
+* @file app_coap_observe.c
+* @brief CoAP Observe (RFC 7641) for the resources registered in app_coap.c
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "sl_component_catalog.h"
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cmsis_os2.h"
+#include "sl_string.h"
+#include "sl_wisun_api.h"
+#include "sl_wisun_coap.h"
+#include "sl_wisun_app_core_util.h"
+#include "sl_wisun_trace_util.h"
+
+#include "app.h"
+#include "app_coap.h"
+#include "app_coap_change_key.h"
+#include "app_coap_observe.h"
+#include "app_coap_parse.h"
+#include "app_fnv.h"
+#include "app_timestamp.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+// Observe option values (RFC 7641 §2)
+#define COAP_OBSERVE_REGISTER   0
+#define COAP_OBSERVE_DEREGISTER 1
+#define COAP_OBSERVE_SEQ_MASK   0xFFFFFFUL
+
+// Notifications are confirmable every APP_COAP_OBSERVE_CON_INTERVAL_S, and the
+//  observer is removed after APP_COAP_OBSERVE_MAX_UNACKED unacknowledged ones
+//  (RFC 7641 §4.5: 'at least every 24 hours')
+#ifndef   APP_COAP_OBSERVE_CON_INTERVAL_S
+  #define APP_COAP_OBSERVE_CON_INTERVAL_S 3600
+#endif /* APP_COAP_OBSERVE_CON_INTERVAL_S */
+#define APP_COAP_OBSERVE_MAX_UNACKED    2
+
+#define APP_COAP_OBSERVE_MAX_TOKEN_LEN  8
+#define APP_COAP_OBSERVE_RX_LEN         256
+// Large resources are notified by their first block (RFC 7959 §3.4)
+#define APP_COAP_OBSERVE_TX_LEN         (APP_COAP_BLOCK_SIZE(APP_COAP_BLOCK_SZX) + 64)
+
+// Change key of the observed resources: the values of the fields changing at each
+//  check (elapsed times, counters of the checks and notifications themselves) are
+//  left out, so that these resources are notified on other changes, or every 'pmax'.
+//  "*": the whole content is an elapsed time
+typedef struct {
+  const char *uri_path;
+  const char *volatile_fields;      // '|' separated JSON field names
+} app_coap_observe_change_key_t;
+
+typedef struct {
+  bool           in_use;
+  sockaddr_in6_t addr;
+  uint8_t        token[APP_COAP_OBSERVE_MAX_TOKEN_LEN];
+  uint8_t        token_len;
+  const app_coap_resource_t *resource;
+  uint16_t       pmin_sec;
+  uint16_t       pmax_sec;
+  uint64_t       next_check_msec;   // next time the resource content is checked
+  uint64_t       last_notify_msec;
+  uint64_t       last_con_msec;     // last confirmable notification
+  const char    *volatile_fields;   // left out of the change key, NULL if none
+  uint32_t       hash;              // FNV-1a change key of the last notified payload
+  uint32_t       seq;               // Observe option value of the last notification
+  uint32_t       notifications;
+  uint16_t       msg_id;            // msg_id of the last notification, for ACK/RST matching
+  uint8_t        unacked;           // consecutive unacknowledged confirmable notifications
+} app_coap_observer_t;
+
+// Group response (see APP_COAP_GROUP_MAX_LEISURE_MS), built at once and sent after its leisure
+typedef struct {
+  bool           in_use;
+  sockaddr_in6_t addr;
+  uint64_t       send_msec;
+  uint16_t       len;
+  uint8_t        buf[APP_COAP_OBSERVE_TX_LEN];
+} app_coap_observe_deferred_t;
+
+typedef struct {
+  uint32_t registrations;
+  uint32_t deregistrations;
+  uint32_t rejected;          // registrations while the observer table is full
+  uint32_t removed;           // observers removed on RST or missing ACKs
+  uint32_t requests;          // all requests received on APP_COAP_OBSERVE_PORT
+  uint32_t checks;            // resource evaluations
+  uint32_t notifications;
+  uint32_t suppressed;        // evaluations without content change
+  uint32_t send_errors;
+  uint32_t rx_drops;          // datagrams received while the previous one was not processed
+  uint32_t deferred;          // group responses sent after their leisure
+  uint32_t deferred_full;     // group responses sent at once, all deferred slots in use
+} app_coap_observe_counters_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static void     _app_coap_observe_rx_cb(sl_wisun_evt_t *evt);
+static void     _app_coap_observe_handle_request(void);
+static app_coap_observer_t *_app_coap_observe_find(const sockaddr_in6_t *addr,
+                                                   const sl_wisun_coap_packet_t *req);
+static void     _app_coap_observe_query(const sl_wisun_coap_packet_t *req,
+                                        uint16_t *pmin_sec, uint16_t *pmax_sec);
+static void     _app_coap_observe_check(app_coap_observer_t *observer, uint64_t msec);
+static int16_t  _app_coap_observe_build(uint8_t *buf, uint16_t size,
+                                        sl_wisun_coap_packet_t *resp,
+                                        sn_coap_msg_type_e msg_type,
+                                        uint16_t msg_id,
+                                        const uint8_t *token, uint8_t token_len,
+                                        int32_t observe);
+static sl_status_t _app_coap_observe_send(const sockaddr_in6_t *addr,
+                                          sl_wisun_coap_packet_t *resp,
+                                          sn_coap_msg_type_e msg_type,
+                                          uint16_t msg_id,
+                                          const uint8_t *token, uint8_t token_len,
+                                          int32_t observe);
+static bool     _app_coap_observe_defer(const sockaddr_in6_t *addr,
+                                        const sl_wisun_coap_packet_t *req,
+                                        sl_wisun_coap_packet_t *resp);
+static void     _app_coap_observe_send_deferred(uint64_t msec);
+static const char *_app_coap_observe_volatile_fields(const app_coap_resource_t *resource);
+static uint32_t _app_coap_observe_hash(const sl_wisun_coap_packet_t *resp,
+                                       const char *volatile_fields);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+static int32_t _sockid = SOCKET_INVALID_ID;
+static app_coap_observer_t _observers[APP_COAP_OBSERVE_MAX_OBSERVERS];
+static app_coap_observe_counters_t _counters;
+static uint16_t _msg_id;
+
+// Single rx slot, filled by the socket callback and emptied by app_task()
+static uint8_t          _rx_buf[APP_COAP_OBSERVE_RX_LEN];
+static sockaddr_in6_t   _rx_addr;
+static volatile int32_t _rx_len;
+
+static uint8_t _tx_buf[APP_COAP_OBSERVE_TX_LEN];
+
+static app_coap_observe_deferred_t _deferred[APP_COAP_OBSERVE_MAX_DEFERRED];
+
+static const app_coap_observe_change_key_t _change_keys[] = {
+  { "/status/all",                        "running|connected" },
+  { "/status/running",                    "*" },
+  { "/status/connected",                  "*" },
+  { "/statistics/app/connected_total",    "*" },
+  { "/statistics/app/disconnected_total", "*" },
+  { "/statistics/app/main_loop",          "wakeups|deadlines|elapsed|wakeups_per_sec|duty_cycle_percent" },
+  { "/statistics/app/observe",            "requests|checks|notifications|suppressed|seq" },
+};
+
+// Request used to evaluate observed resources (as a plain GET)
+static sl_wisun_coap_packet_t _check_req = {
+  .msg_code = COAP_MSG_CODE_REQUEST_GET,
+  .msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE,
+};
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_coap_observe_init(void) {
+  sockaddr_in6_t addr = { 0 };
+
+  if (_sockid != SOCKET_INVALID_ID) {
+    return;
+  }
+  _sockid = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+  if (_sockid == SOCKET_INVALID_ID) {
+    printfBothTime("[Failed: unable to open the CoAP observe socket]\n");
+    return;
+  }
+  addr.sin6_family = AF_INET6;
+  addr.sin6_addr = in6addr_any;
+  addr.sin6_port = htons(APP_COAP_OBSERVE_PORT);
+  if (bind(_sockid, (const struct sockaddr *)&addr, sizeof(addr)) == SOCKET_RETVAL_ERROR) {
+    printfBothTime("[Failed: unable to bind the CoAP observe socket to port %d]\n", APP_COAP_OBSERVE_PORT);
+    close(_sockid);
+    _sockid = SOCKET_INVALID_ID;
+    return;
+  }
+  app_wisun_em_custom_callback_register(SL_WISUN_MSG_SOCKET_DATA_AVAILABLE_IND_ID,
+                                        _app_coap_observe_rx_cb);
+  _msg_id = (uint16_t)osKernelGetTickCount();
+  printfBoth("Waiting for CoAP observe requests on port %d (socket id %ld)\n",
+             APP_COAP_OBSERVE_PORT, _sockid);
+}
+
+void app_coap_observe_process(void) {
+  uint64_t msec;
+  uint8_t i;
+
+  if (_sockid == SOCKET_INVALID_ID) {
+    return;
+  }
+  if (_rx_len > 0) {
+    _app_coap_observe_handle_request();
+    _rx_len = 0;
+  }
+  msec = now_msec();
+  _app_coap_observe_send_deferred(msec);
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_OBSERVERS; i++) {
+    if (_observers[i].in_use && (_observers[i].next_check_msec <= msec)) {
+      _app_coap_observe_check(&_observers[i], msec);
+    }
+  }
+  // Notifications are sent synchronously: the response buffer can go back to the pool
+  app_coap_response_release();
+}
+
+uint32_t app_coap_observe_msec_to_next(void) {
+  uint64_t msec;
+  uint64_t next_msec = UINT64_MAX;
+  uint8_t i;
+
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_OBSERVERS; i++) {
+    if (_observers[i].in_use && (_observers[i].next_check_msec < next_msec)) {
+      next_msec = _observers[i].next_check_msec;
+    }
+  }
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_DEFERRED; i++) {
+    if (_deferred[i].in_use && (_deferred[i].send_msec < next_msec)) {
+      next_msec = _deferred[i].send_msec;
+    }
+  }
+  if (next_msec == UINT64_MAX) {
+    return UINT32_MAX;
+  }
+  msec = now_msec();
+  return (next_msec > msec) ? (uint32_t)(next_msec - msec) : 0;
+}
+
+char* app_coap_observe_string(char *buf, uint16_t size) {
+  #define OBSERVE_JSON_FORMAT_STR           \
+    "{\n"                                   \
+    "  \"port\": \"%d\",\n"                 \
+    "  \"resources\": \"%d\",\n"            \
+    "  \"registrations\": \"%lu\",\n"       \
+    "  \"deregistrations\": \"%lu\",\n"     \
+    "  \"rejected\": \"%lu\",\n"            \
+    "  \"removed\": \"%lu\",\n"             \
+    "  \"requests\": \"%lu\",\n"            \
+    "  \"checks\": \"%lu\",\n"              \
+    "  \"notifications\": \"%lu\",\n"       \
+    "  \"suppressed\": \"%lu\",\n"          \
+    "  \"send_errors\": \"%lu\",\n"         \
+    "  \"rx_drops\": \"%lu\",\n"            \
+    "  \"deferred\": \"%lu\",\n"            \
+    "  \"deferred_full\": \"%lu\",\n"       \
+    "  \"observers\": ["
+  #define OBSERVER_JSON_FORMAT_STR          \
+    "%s\n    {\"ipv6\": \"%s\", \"uri\": \"%s\", \"pmin\": \"%u\", \"pmax\": \"%u\", \"seq\": \"%lu\", \"notifications\": \"%lu\"}"
+  char ipv6_string[40];
+  uint16_t len;
+  uint8_t i;
+  bool first = true;
+
+  len = (uint16_t)snprintf(buf, size, OBSERVE_JSON_FORMAT_STR,
+    APP_COAP_OBSERVE_PORT,
+    app_coap_resource_count(),
+    _counters.registrations,
+    _counters.deregistrations,
+    _counters.rejected,
+    _counters.removed,
+    _counters.requests,
+    _counters.checks,
+    _counters.notifications,
+    _counters.suppressed,
+    _counters.send_errors,
+    _counters.rx_drops,
+    _counters.deferred,
+    _counters.deferred_full
+  );
+  for (i = 0; (i < APP_COAP_OBSERVE_MAX_OBSERVERS) && (len < size); i++) {
+    if (!_observers[i].in_use) {
+      continue;
+    }
+    sl_wisun_ip6tos(_observers[i].addr.sin6_addr.address, ipv6_string);
+    len += (uint16_t)snprintf(buf + len, size - len, OBSERVER_JSON_FORMAT_STR,
+      first ? "" : ",",
+      ipv6_string,
+      _observers[i].resource->uri_path,
+      _observers[i].pmin_sec,
+      _observers[i].pmax_sec,
+      _observers[i].seq,
+      _observers[i].notifications
+    );
+    first = false;
+  }
+  if (len < size) {
+    snprintf(buf + len, size - len, "\n  ]\n}\n");
+  }
+  return buf;
+}
+
+void app_coap_observe_reset(void) {
+  memset(&_counters, 0, sizeof(_counters));
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void _app_coap_observe_rx_cb(sl_wisun_evt_t *evt) {
+  socklen_t addr_len = sizeof(_rx_addr);
+  uint8_t drop;
+  int32_t len;
+
+  if ((evt == NULL)
+      || (evt->header.id != SL_WISUN_MSG_SOCKET_DATA_AVAILABLE_IND_ID)
+      || (evt->evt.socket_data_available.socket_id != _sockid)) {
+    return;
+  }
+  if (_rx_len > 0) {
+    // Previous request not processed yet: read and drop this one
+    (void)recvfrom(_sockid, &drop, sizeof(drop), 0, NULL, NULL);
+    _counters.rx_drops++;
+    return;
+  }
+  len = recvfrom(_sockid, _rx_buf, sizeof(_rx_buf), 0,
+                 (struct sockaddr *)&_rx_addr, &addr_len);
+  if (len > 0) {
+    _rx_len = len;
+    app_task_notify(APP_TASK_EVENT_SOCKET);
+  }
+}
+
+static void _app_coap_observe_handle_request(void) {
+  sl_wisun_coap_packet_t *req;
+  sl_wisun_coap_packet_t *resp;
+  app_coap_observer_t *observer;
+  int32_t observe = COAP_OBSERVE_NONE;
+  const app_coap_resource_t *resource;
+  app_coap_token_t group;
+  uint8_t i;
+
+  req = sl_wisun_coap_parser((uint16_t)_rx_len, _rx_buf);
+  if (req == NULL) {
+    return;
+  }
+  _counters.requests++;
+
+  // ACK or RST to a notification
+  if ((req->msg_type == COAP_MSG_TYPE_ACKNOWLEDGEMENT) || (req->msg_type == COAP_MSG_TYPE_RESET)) {
+    for (i = 0; i < APP_COAP_OBSERVE_MAX_OBSERVERS; i++) {
+      if (!_observers[i].in_use
+          || (_observers[i].msg_id != req->msg_id)
+          || memcmp(&_observers[i].addr.sin6_addr, &_rx_addr.sin6_addr, sizeof(_rx_addr.sin6_addr))) {
+        continue;
+      }
+      if (req->msg_type == COAP_MSG_TYPE_RESET) {
+        // The observer is not interested anymore (RFC 7641 §3.6)
+        _observers[i].in_use = false;
+        _counters.removed++;
+      } else {
+        _observers[i].unacked = 0;
+      }
+    }
+    sl_wisun_coap_destroy_packet(req);
+    return;
+  }
+
+  resource = app_coap_resource_find((const char *)req->uri_path_ptr, req->uri_path_len);
+  if (resource == NULL) {
+    // No error responses to group requests (RFC 7252 §8.2)
+    resp = app_coap_query_param(req, "g", &group) ?
+           NULL : sl_wisun_coap_build_response(req, COAP_MSG_CODE_RESPONSE_NOT_FOUND);
+    if (resp != NULL) {
+      (void)_app_coap_observe_send(&_rx_addr, resp, resp->msg_type, req->msg_id,
+                                   req->token_ptr, req->token_len, COAP_OBSERVE_NONE);
+      sl_wisun_coap_destroy_packet(resp);
+    }
+    sl_wisun_coap_destroy_packet(req);
+    return;
+  }
+
+  observer = _app_coap_observe_find(&_rx_addr, req);
+  if ((req->msg_code == COAP_MSG_CODE_REQUEST_GET) && (req->options_list_ptr != NULL)) {
+    observe = req->options_list_ptr->observe;
+  }
+  if (observe == COAP_OBSERVE_DEREGISTER) {
+    if (observer != NULL) {
+      observer->in_use = false;
+      _counters.deregistrations++;
+    }
+    observe = COAP_OBSERVE_NONE;
+  } else if (observe == COAP_OBSERVE_REGISTER) {
+    if (observer == NULL) {
+      for (i = 0; i < APP_COAP_OBSERVE_MAX_OBSERVERS; i++) {
+        if (!_observers[i].in_use) {
+          observer = &_observers[i];
+          break;
+        }
+      }
+    }
+    if ((observer == NULL) || (req->token_len > APP_COAP_OBSERVE_MAX_TOKEN_LEN)) {
+      // Answered without Observe option: the client knows it's not registered
+      _counters.rejected++;
+      observe = COAP_OBSERVE_NONE;
+    } else {
+      memset(observer, 0, sizeof(*observer));
+      observer->in_use = true;
+      observer->addr = _rx_addr;
+      memcpy(observer->token, req->token_ptr, req->token_len);
+      observer->token_len = req->token_len;
+      observer->resource = resource;
+      observer->volatile_fields = _app_coap_observe_volatile_fields(resource);
+      _app_coap_observe_query(req, &observer->pmin_sec, &observer->pmax_sec);
+      observer->last_notify_msec = observer->last_con_msec = now_msec();
+      observer->next_check_msec = observer->last_notify_msec + observer->pmin_sec * 1000ULL;
+      _counters.registrations++;
+    }
+  }
+
+  resp = resource->auto_response(req);
+  if (resp != NULL) {
+    if (observe == COAP_OBSERVE_REGISTER) {
+      observer->hash = _app_coap_observe_hash(resp, observer->volatile_fields);
+      observe = (int32_t)observer->seq;
+    }
+    if ((observe != COAP_OBSERVE_NONE) || !_app_coap_observe_defer(&_rx_addr, req, resp)) {
+      (void)_app_coap_observe_send(&_rx_addr, resp, resp->msg_type, req->msg_id,
+                                   req->token_ptr, req->token_len, observe);
+    }
+    sl_wisun_coap_destroy_packet(resp);
+  }
+  sl_wisun_coap_destroy_packet(req);
+}
+
+static app_coap_observer_t *_app_coap_observe_find(const sockaddr_in6_t *addr,
+                                                   const sl_wisun_coap_packet_t *req) {
+  uint8_t i;
+
+  // Observers are identified by their address and token (RFC 7641 §3.1)
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_OBSERVERS; i++) {
+    if (_observers[i].in_use
+        && !memcmp(&_observers[i].addr.sin6_addr, &addr->sin6_addr, sizeof(addr->sin6_addr))
+        && (_observers[i].addr.sin6_port == addr->sin6_port)
+        && (_observers[i].token_len == req->token_len)
+        && !memcmp(_observers[i].token, req->token_ptr, req->token_len)) {
+      return &_observers[i];
+    }
+  }
+  return NULL;
+}
+
+static void _app_coap_observe_query(const sl_wisun_coap_packet_t *req,
+                                    uint16_t *pmin_sec, uint16_t *pmax_sec) {
+  app_coap_token_t param;
+  uint32_t value;
+
+  *pmin_sec = APP_COAP_OBSERVE_DEFAULT_PMIN_S;
+  *pmax_sec = APP_COAP_OBSERVE_DEFAULT_PMAX_S;
+  if (app_coap_query_param(req, "pmin", &param) && app_coap_token_uint(&param, &value)) {
+    *pmin_sec = (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+  }
+  if (app_coap_query_param(req, "pmax", &param) && app_coap_token_uint(&param, &value)) {
+    *pmax_sec = (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+  }
+  if (*pmin_sec == 0) {
+    *pmin_sec = 1;
+  }
+  if (*pmax_sec < *pmin_sec) {
+    *pmax_sec = *pmin_sec;
+  }
+}
+
+static void _app_coap_observe_check(app_coap_observer_t *observer, uint64_t msec) {
+  sl_wisun_coap_packet_t *resp;
+  sn_coap_msg_type_e msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+  uint64_t max_age_msec;
+  uint32_t hash;
+
+  max_age_msec = observer->last_notify_msec + observer->pmax_sec * 1000ULL;
+  observer->next_check_msec = msec + observer->pmin_sec * 1000ULL;
+  if (observer->next_check_msec > max_age_msec) {
+    observer->next_check_msec = max_age_msec;
+  }
+
+  _counters.checks++;
+  resp = observer->resource->auto_response(&_check_req);
+  if (resp == NULL) {
+    return;
+  }
+  if (resp->msg_code == COAP_MSG_CODE_RESPONSE_SERVICE_UNAVAILABLE) {
+    // No response buffer: not a content change, checked again at next_check_msec
+    sl_wisun_coap_destroy_packet(resp);
+    return;
+  }
+  hash = _app_coap_observe_hash(resp, observer->volatile_fields);
+  if ((hash == observer->hash) && (msec < max_age_msec)) {
+    _counters.suppressed++;
+    sl_wisun_coap_destroy_packet(resp);
+    return;
+  }
+
+  if (msec - observer->last_con_msec >= APP_COAP_OBSERVE_CON_INTERVAL_S * 1000ULL) {
+    if (observer->unacked >= APP_COAP_OBSERVE_MAX_UNACKED) {
+      // The observer doesn't answer anymore
+      observer->in_use = false;
+      _counters.removed++;
+      sl_wisun_coap_destroy_packet(resp);
+      return;
+    }
+    msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    observer->last_con_msec = msec;
+    observer->unacked++;
+  }
+
+  observer->seq = (observer->seq + 1) & COAP_OBSERVE_SEQ_MASK;
+  observer->msg_id = _msg_id++;
+  if (_app_coap_observe_send(&observer->addr, resp, msg_type, observer->msg_id,
+                             observer->token, observer->token_len,
+                             (int32_t)observer->seq) == SL_STATUS_OK) {
+    observer->hash = hash;
+    observer->last_notify_msec = msec;
+    observer->next_check_msec = msec + observer->pmin_sec * 1000ULL;
+    observer->notifications++;
+    _counters.notifications++;
+  }
+  sl_wisun_coap_destroy_packet(resp);
+}
+
+// CoAP datagram of 'resp' in 'buf', with our header and options. Returns its length, -1 if it doesn't fit
+static int16_t _app_coap_observe_build(uint8_t *buf, uint16_t size,
+                                       sl_wisun_coap_packet_t *resp,
+                                       sn_coap_msg_type_e msg_type,
+                                       uint16_t msg_id,
+                                       const uint8_t *token, uint8_t token_len,
+                                       int32_t observe) {
+  sn_coap_options_list_s options = {
+    .uri_port = COAP_OPTION_URI_PORT_NONE,
+    .observe  = observe,
+    .accept   = COAP_CT_NONE,
+    .max_age  = COAP_OPTION_MAX_AGE_DEFAULT,
+    .block1   = COAP_OPTION_BLOCK_NONE,
+    .block2   = COAP_OPTION_BLOCK_NONE,
+  };
+  sn_coap_options_list_s *resp_options;
+  int32_t resp_observe = COAP_OBSERVE_NONE;
+  uint8_t *resp_token;
+  uint8_t resp_token_len;
+  int16_t len;
+
+  // The response built by the resource callback is sent with our header and options
+  resp_options = resp->options_list_ptr;
+  resp_token = resp->token_ptr;
+  resp_token_len = resp->token_len;
+  resp->msg_type = msg_type;
+  resp->msg_id = msg_id;
+  resp->token_ptr = (uint8_t *)token;
+  resp->token_len = token_len;
+  if (resp_options != NULL) {
+    // Keep the response options (Block2, ETag)
+    resp_observe = resp_options->observe;
+    resp_options->observe = observe;
+  } else if (observe != COAP_OBSERVE_NONE) {
+    resp->options_list_ptr = &options;
+  }
+
+  len = (int16_t)sl_wisun_coap_builder_calc_size(resp);
+  if ((len > 0) && ((uint16_t)len <= size)) {
+    len = sl_wisun_coap_builder(buf, resp);
+  } else {
+    len = -1;
+  }
+  // Restore what will be freed with the response
+  if (resp_options != NULL) {
+    resp_options->observe = resp_observe;
+  }
+  resp->options_list_ptr = resp_options;
+  resp->token_ptr = resp_token;
+  resp->token_len = resp_token_len;
+  return len;
+}
+
+static sl_status_t _app_coap_observe_send(const sockaddr_in6_t *addr,
+                                          sl_wisun_coap_packet_t *resp,
+                                          sn_coap_msg_type_e msg_type,
+                                          uint16_t msg_id,
+                                          const uint8_t *token, uint8_t token_len,
+                                          int32_t observe) {
+  int16_t len;
+
+  len = _app_coap_observe_build(_tx_buf, sizeof(_tx_buf), resp, msg_type, msg_id,
+                                token, token_len, observe);
+  if ((len < 0)
+      || (sendto(_sockid, _tx_buf, (uint32_t)len, 0,
+                 (const struct sockaddr *)addr, sizeof(*addr)) == SOCKET_RETVAL_ERROR)) {
+    _counters.send_errors++;
+    return SL_STATUS_TRANSMIT;
+  }
+  return SL_STATUS_OK;
+}
+
+// Keep the response to a NON group request ('g'), to send it after its leisure.
+//  Returns false if it shall be sent at once
+static bool _app_coap_observe_defer(const sockaddr_in6_t *addr,
+                                    const sl_wisun_coap_packet_t *req,
+                                    sl_wisun_coap_packet_t *resp) {
+  app_coap_observe_deferred_t *deferred = NULL;
+  app_coap_token_t param;
+  uint32_t leisure_ms;
+  int16_t len;
+  uint8_t i;
+
+  if ((req->msg_type != COAP_MSG_TYPE_NON_CONFIRMABLE)
+      || !app_coap_query_param(req, "g", &param)) {
+    return false;
+  }
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_DEFERRED; i++) {
+    if (!_deferred[i].in_use) {
+      deferred = &_deferred[i];
+      break;
+    }
+  }
+  if (deferred == NULL) {
+    _counters.deferred_full++;
+    return false;
+  }
+  leisure_ms = app_coap_group_leisure_ms(req, resp->payload_len);
+  if (leisure_ms == 0) {
+    return false;
+  }
+  len = _app_coap_observe_build(deferred->buf, sizeof(deferred->buf), resp, resp->msg_type,
+                                req->msg_id, req->token_ptr, req->token_len, COAP_OBSERVE_NONE);
+  if (len < 0) {
+    return false;
+  }
+  deferred->in_use = true;
+  deferred->addr = *addr;
+  deferred->len = (uint16_t)len;
+  deferred->send_msec = now_msec() + leisure_ms;
+  return true;
+}
+
+// Group responses at the end of their leisure, from app_task()
+static void _app_coap_observe_send_deferred(uint64_t msec) {
+  uint8_t i;
+
+  for (i = 0; i < APP_COAP_OBSERVE_MAX_DEFERRED; i++) {
+    if (!_deferred[i].in_use || (_deferred[i].send_msec > msec)) {
+      continue;
+    }
+    if (sendto(_sockid, _deferred[i].buf, _deferred[i].len, 0,
+               (const struct sockaddr *)&_deferred[i].addr,
+               sizeof(_deferred[i].addr)) == SOCKET_RETVAL_ERROR) {
+      _counters.send_errors++;
+    } else {
+      _counters.deferred++;
+    }
+    _deferred[i].in_use = false;
+  }
+}
+
+static const char *_app_coap_observe_volatile_fields(const app_coap_resource_t *resource) {
+  uint8_t i;
+
+  for (i = 0; i < sizeof(_change_keys) / sizeof(_change_keys[0]); i++) {
+    if (strcmp(resource->uri_path, _change_keys[i].uri_path) == 0) {
+      return _change_keys[i].volatile_fields;
+    }
+  }
+  return NULL;
+}
+
+static uint32_t _app_coap_observe_hash(const sl_wisun_coap_packet_t *resp,
+                                       const char *volatile_fields) {
+  uint32_t hash = app_coap_change_key(resp->payload_ptr, resp->payload_len, volatile_fields);
+
+  // For content sent in blocks, the ETag covers the blocks not in the notification
+  //  (it also covers the volatile fields: not used for the resources having some)
+  if ((volatile_fields == NULL)
+      && (resp->options_list_ptr != NULL) && (resp->options_list_ptr->etag_ptr != NULL)) {
+    hash = app_fnv1a(hash, resp->options_list_ptr->etag_ptr, resp->options_list_ptr->etag_len);
+  }
+  return hash;
+}
+
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
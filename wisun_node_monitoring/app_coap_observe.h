@@ -0,0 +1,103 @@
+/***************************************************************************//**
+* @file app_coap_observe.h
+* @brief CoAP Observe (RFC 7641) for the resources registered in app_coap.c
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+#include "sl_component_catalog.h"
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+
+#ifndef APP_COAP_OBSERVE_H
+#define APP_COAP_OBSERVE_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sl_wisun_coap_rhnd.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * The CoAP resource handler does not give access to the requester address,
+ *  so observers register on a separate port, with the same URIs:
+ *
+ *   coap-client -m get -s 3600 "coap://[<device>]:5686/status/all?pmin=10&pmax=300"
+ *
+ * The resource is checked every 'pmin' seconds, and a notification is sent
+ *  if its content changed, or if none has been sent for 'pmax' seconds.
+ * Observers are removed on deregistration (Observe: 1) or when they reject
+ *  a notification with a RST.
+ * Group requests ('g', see app_coap.h) received on this port are answered after
+ *  their leisure, from app_task().
+ */
+#define APP_COAP_OBSERVE_PORT           5686
+
+// Observer table size. When full, registrations are answered without Observe
+#ifndef   APP_COAP_OBSERVE_MAX_OBSERVERS
+  #define APP_COAP_OBSERVE_MAX_OBSERVERS  4
+#endif /* APP_COAP_OBSERVE_MAX_OBSERVERS */
+
+// Group responses kept until the end of their leisure (see APP_COAP_GROUP_MAX_LEISURE_MS).
+//  When all are in use, group responses are sent at once
+#ifndef   APP_COAP_OBSERVE_MAX_DEFERRED
+  #define APP_COAP_OBSERVE_MAX_DEFERRED   2
+#endif /* APP_COAP_OBSERVE_MAX_DEFERRED */
+
+// Defaults if 'pmin'/'pmax' are not in the URI query
+#define APP_COAP_OBSERVE_DEFAULT_PMIN_S 10
+#define APP_COAP_OBSERVE_DEFAULT_PMAX_S 300
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Open the observe socket, to be called once connected */
+void app_coap_observe_init(void);
+
+/* Process received requests and send due notifications, from app_task() */
+void app_coap_observe_process(void);
+
+/* Delay (in ms) until the next observer check, UINT32_MAX if no observer */
+uint32_t app_coap_observe_msec_to_next(void);
+
+/* Observers and counters, in json format */
+char* app_coap_observe_string(char *buf, uint16_t size);
+void app_coap_observe_reset(void);
+
+#endif /* APP_COAP_OBSERVE_H */
+
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
@@ -0,0 +1,209 @@
+/***************************************************************************//**
+* @file app_coap_parse.c
+* @brief In-place parsing of CoAP payloads and URI queries
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "sl_wisun_ip6string.h"
+
+#include "app_coap_parse.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+// Longest IPv6 address string ('xxxx:' * 7 + 'xxxx' or with an IPv4 suffix)
+#define IPV6_STRING_MAX_LEN 45
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_coap_tokenizer_init(app_coap_tokenizer_t *tokenizer, const uint8_t *data, uint16_t len) {
+  tokenizer->next = (const char *)data;
+  tokenizer->end  = (data != NULL) ? (const char *)data + len : NULL;
+}
+
+bool app_coap_token_next(app_coap_tokenizer_t *tokenizer, const char *separators,
+                         app_coap_token_t *token) {
+  const char *c = tokenizer->next;
+  char quote;
+
+  // The payload is not NUL-terminated: check 'end' before strchr(), which would match '\0'
+  while ((c < tokenizer->end) && (*c != '\0') && strchr(separators, *c)) {
+    c++;
+  }
+  if (c >= tokenizer->end) {
+    tokenizer->next = tokenizer->end;
+    return false;
+  }
+  token->quoted = (*c == '"') || (*c == '\'');
+  if (token->quoted) {
+    quote = *c++;
+    token->ptr = c;
+    while ((c < tokenizer->end) && (*c != quote)) {
+      c++;
+    }
+    token->len = (uint16_t)(c - token->ptr);
+    if (c < tokenizer->end) {
+      c++;                    // closing quote
+    }
+  } else {
+    token->ptr = c;
+    while ((c < tokenizer->end) && ((*c == '\0') || !strchr(separators, *c))) {
+      c++;
+    }
+    token->len = (uint16_t)(c - token->ptr);
+  }
+  tokenizer->next = c;
+  return true;
+}
+
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+uint8_t app_coap_payload_tokens(const sl_wisun_coap_packet_t *const req_packet,
+                                app_coap_token_t *tokens, uint8_t max) {
+  app_coap_tokenizer_t tokenizer;
+  uint8_t count = 0;
+
+  app_coap_tokenizer_init(&tokenizer, req_packet->payload_ptr, req_packet->payload_len);
+  while ((count < max) && app_coap_token_next(&tokenizer, APP_COAP_PAYLOAD_SEPARATORS, &tokens[count])) {
+    count++;
+  }
+  return count;
+}
+
+bool app_coap_payload_is(const sl_wisun_coap_packet_t *const req_packet, const char *str) {
+  app_coap_token_t tokens[2];
+
+  // One token only
+  return (app_coap_payload_tokens(req_packet, tokens, 2) == 1)
+      && app_coap_token_is(&tokens[0], str);
+}
+
+bool app_coap_query_param(const sl_wisun_coap_packet_t *const req_packet, const char *key,
+                          app_coap_token_t *value) {
+  const sn_coap_options_list_s *options = req_packet->options_list_ptr;
+  app_coap_tokenizer_t tokenizer;
+  app_coap_token_t param;
+  uint16_t key_len = (uint16_t)strlen(key);
+
+  if ((options == NULL) || (options->uri_query_ptr == NULL)) {
+    return false;
+  }
+  app_coap_tokenizer_init(&tokenizer, options->uri_query_ptr, options->uri_query_len);
+  while (app_coap_token_next(&tokenizer, APP_COAP_QUERY_SEPARATORS, &param)) {
+    if ((param.len < key_len) || strncmp(param.ptr, key, key_len)) {
+      continue;
+    }
+    if (param.len == key_len) {
+      value->ptr = param.ptr + key_len;
+      value->len = 0;
+      value->quoted = false;
+      return true;
+    }
+    if (param.ptr[key_len] == '=') {
+      value->ptr = param.ptr + key_len + 1;
+      value->len = param.len - key_len - 1;
+      value->quoted = false;
+      return true;
+    }
+  }
+  return false;
+}
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
+
+bool app_coap_token_is(const app_coap_token_t *token, const char *str) {
+  return (strlen(str) == token->len) && !strncmp(token->ptr, str, token->len);
+}
+
+bool app_coap_token_uint(const app_coap_token_t *token, uint32_t *value) {
+  uint32_t result = 0;
+  uint16_t i;
+
+  if ((token->len == 0) || (token->len > 10)) {
+    return false;
+  }
+  for (i = 0; i < token->len; i++) {
+    if ((token->ptr[i] < '0') || (token->ptr[i] > '9')) {
+      return false;
+    }
+    if (result > (UINT32_MAX - (uint32_t)(token->ptr[i] - '0')) / 10) {
+      return false;           // overflow
+    }
+    result = result * 10 + (uint32_t)(token->ptr[i] - '0');
+  }
+  *value = result;
+  return true;
+}
+
+bool app_coap_token_int(const app_coap_token_t *token, int32_t *value) {
+  app_coap_token_t digits = *token;
+  uint32_t magnitude;
+  bool negative = false;
+
+  if ((digits.len > 0) && ((digits.ptr[0] == '-') || (digits.ptr[0] == '+'))) {
+    negative = (digits.ptr[0] == '-');
+    digits.ptr++;
+    digits.len--;
+  }
+  if (!app_coap_token_uint(&digits, &magnitude)
+      || (magnitude > (negative ? (uint32_t)INT32_MAX + 1 : (uint32_t)INT32_MAX))) {
+    return false;
+  }
+  *value = negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+  return true;
+}
+
+bool app_coap_token_ipv6(const app_coap_token_t *token, in6_addr_t *address) {
+  if ((token->len == 0) || (token->len > IPV6_STRING_MAX_LEN)) {
+    return false;
+  }
+  return sl_wisun_stoip6(token->ptr, token->len, address);
+}
+
+bool app_coap_token_copy(const app_coap_token_t *token, char *buf, uint16_t size) {
+  uint16_t len = token->len;
+
+  if (size == 0) {
+    return false;
+  }
+  if (len >= size) {
+    len = size - 1;
+  }
+  memcpy(buf, token->ptr, len);
+  buf[len] = '\0';
+  return (len == token->len);
+}
@@ -0,0 +1,113 @@
+/***************************************************************************//**
+* @file app_coap_parse.h
+* @brief In-place parsing of CoAP payloads and URI queries Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+#ifndef APP_COAP_PARSE_H
+#define APP_COAP_PARSE_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sl_component_catalog.h"
+#include "sl_wisun_types.h"
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+  #include "sl_wisun_coap.h"
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * Payloads and URI queries are parsed where they are, in the request packet:
+ *  tokens point into the request, so that handlers don't need a NUL-terminated
+ *  copy of the payload (sl_wisun_coap_get_payload_str() allocates one on the heap).
+ *
+ *   app_coap_token_t tokens[2];
+ *   uint8_t count = app_coap_payload_tokens(req_packet, tokens, 2);
+ *   if ((count == 2) && app_coap_token_is(&tokens[0], "max_age_ms")
+ *       && app_coap_token_uint(&tokens[1], &max_age_ms)) { ... }
+ *
+ * Tokens are valid as long as the request packet.
+ * The tokenizer and typed helpers don't depend on CoAP: they also parse the
+ *  application parameter assignments (scan_app_parameter()).
+ */
+#define APP_COAP_PAYLOAD_SEPARATORS " \t\r\n"
+#define APP_COAP_QUERY_SEPARATORS   "&"
+
+typedef struct {
+  const char *ptr;            // not NUL-terminated
+  uint16_t    len;
+  bool        quoted;         // was between '"' or '\'' (quotes not included)
+} app_coap_token_t;
+
+typedef struct {
+  const char *next;
+  const char *end;
+} app_coap_tokenizer_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Start tokenizing 'len' bytes at 'data' */
+void     app_coap_tokenizer_init(app_coap_tokenizer_t *tokenizer, const uint8_t *data, uint16_t len);
+/* Next token, delimited by any of 'separators' (repeated separators are skipped).
+ *  A token starting with a quote ends with the same quote, and may contain separators */
+bool     app_coap_token_next(app_coap_tokenizer_t *tokenizer, const char *separators,
+                             app_coap_token_t *token);
+
+#ifdef    SL_CATALOG_WISUN_COAP_PRESENT
+/* Tokens of the request payload, separated by spaces or new lines. Returns the token count (up to 'max') */
+uint8_t  app_coap_payload_tokens(const sl_wisun_coap_packet_t *const req_packet,
+                                 app_coap_token_t *tokens, uint8_t max);
+/* true if the payload is 'str' (surrounding spaces ignored) */
+bool     app_coap_payload_is(const sl_wisun_coap_packet_t *const req_packet, const char *str);
+/* Value of 'key' in the URI query ('key=value&...'). A key without '=' has an empty value */
+bool     app_coap_query_param(const sl_wisun_coap_packet_t *const req_packet, const char *key,
+                              app_coap_token_t *value);
+#endif /* SL_CATALOG_WISUN_COAP_PRESENT */
+
+/* Typed token values. Return false (and leave 'value' unchanged) if the token doesn't match */
+bool     app_coap_token_is(const app_coap_token_t *token, const char *str);
+bool     app_coap_token_int(const app_coap_token_t *token, int32_t *value);
+bool     app_coap_token_uint(const app_coap_token_t *token, uint32_t *value);
+bool     app_coap_token_ipv6(const app_coap_token_t *token, in6_addr_t *address);
+/* Copy a token as a NUL-terminated string, for APIs which need one. Returns false if truncated */
+bool     app_coap_token_copy(const app_coap_token_t *token, char *buf, uint16_t size);
+
+#endif /* APP_COAP_PARSE_H */
@@ -0,0 +1,173 @@
+/***************************************************************************//**
+* @file app_coap_response.c
+* @brief CoAP response buffer pool
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <assert.h>
+#include <string.h>
+
+#include "cmsis_os2.h"
+#include "sl_sleeptimer.h"
+
+#include "app_coap_response.h"
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+static osMemoryPoolId_t coap_response_pool = NULL;
+static osMutexId_t      coap_response_mutex = NULL;
+static osThreadId_t     coap_response_owner[APP_COAP_RESPONSE_POOL_COUNT];
+static char            *coap_response_buffer[APP_COAP_RESPONSE_POOL_COUNT];
+static app_coap_response_pool_counters_t coap_response_counters;
+// Handler start, set by app_coap_response_acquire(), per buffer owner
+static uint64_t         coap_response_start_tick[APP_COAP_RESPONSE_POOL_COUNT];
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_coap_response_pool_init(void) {
+  if (coap_response_mutex != NULL) {
+    return;
+  }
+  coap_response_mutex = osMutexNew(NULL);
+  assert(coap_response_mutex != NULL);
+  coap_response_pool = osMemoryPoolNew(APP_COAP_RESPONSE_POOL_COUNT, COAP_MAX_RESPONSE_LEN, NULL);
+  assert(coap_response_pool != NULL);
+}
+
+char * app_coap_response_acquire(void) {
+  osThreadId_t thread = osThreadGetId();
+  uint64_t start_tick = sl_sleeptimer_get_tick_count64();
+  char *buf = NULL;
+  bool waited = false;
+  uint8_t i;
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  coap_response_counters.acquired++;
+  for (i = 0; i < APP_COAP_RESPONSE_POOL_COUNT; i++) {
+    if (coap_response_buffer[i] && (coap_response_owner[i] == thread)) {
+      // The previous response of this thread has been sent: reuse its buffer
+      buf = coap_response_buffer[i];
+      coap_response_start_tick[i] = start_tick;
+      coap_response_counters.reused++;
+      break;
+    }
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+
+  if (buf == NULL) {
+    buf = (char *)osMemoryPoolAlloc(coap_response_pool, 0U);
+    if (buf == NULL) {
+      // Another thread may release its buffer (see app_coap_response_release())
+      waited = true;
+      buf = (char *)osMemoryPoolAlloc(coap_response_pool, APP_COAP_RESPONSE_POOL_TIMEOUT_MS);
+    }
+    assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+    if (waited) {
+      coap_response_counters.waits++;
+    }
+    if (buf == NULL) {
+      // No buffer to write a response to: the caller answers 5.03
+      coap_response_counters.exhausted++;
+    } else {
+      for (i = 0; i < APP_COAP_RESPONSE_POOL_COUNT; i++) {
+        if (coap_response_buffer[i] == NULL) {
+          coap_response_buffer[i] = buf;
+          coap_response_owner[i] = thread;
+          coap_response_start_tick[i] = start_tick;
+          break;
+        }
+      }
+      coap_response_counters.in_use++;
+      if (coap_response_counters.in_use > coap_response_counters.peak_in_use) {
+        coap_response_counters.peak_in_use = coap_response_counters.in_use;
+      }
+    }
+    assert(osMutexRelease(coap_response_mutex) == osOK);
+  }
+  if (buf != NULL) {
+    buf[0] = '\0';
+  }
+  return buf;
+}
+
+void app_coap_response_release(void) {
+  osThreadId_t thread = osThreadGetId();
+  uint8_t i;
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  for (i = 0; i < APP_COAP_RESPONSE_POOL_COUNT; i++) {
+    if (coap_response_buffer[i] && (coap_response_owner[i] == thread)) {
+      (void)osMemoryPoolFree(coap_response_pool, coap_response_buffer[i]);
+      coap_response_buffer[i] = NULL;
+      coap_response_owner[i] = NULL;
+      coap_response_counters.in_use--;
+    }
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+}
+
+uint64_t app_coap_response_start_tick(void) {
+  osThreadId_t thread = osThreadGetId();
+  uint64_t start_tick = sl_sleeptimer_get_tick_count64();
+  uint8_t i;
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  for (i = 0; i < APP_COAP_RESPONSE_POOL_COUNT; i++) {
+    if (coap_response_buffer[i] && (coap_response_owner[i] == thread)) {
+      start_tick = coap_response_start_tick[i];
+      break;
+    }
+  }
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+  return start_tick;
+}
+
+void app_coap_response_pool_counters(app_coap_response_pool_counters_t *counters) {
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  *counters = coap_response_counters;
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+}
+
+void app_coap_response_pool_reset(void) {
+  uint8_t in_use;
+
+  assert(osMutexAcquire(coap_response_mutex, osWaitForever) == osOK);
+  in_use = coap_response_counters.in_use;
+  memset(&coap_response_counters, 0, sizeof(coap_response_counters));
+  coap_response_counters.in_use = coap_response_counters.peak_in_use = in_use;
+  assert(osMutexRelease(coap_response_mutex) == osOK);
+}
@@ -0,0 +1,97 @@
+/***************************************************************************//**
+* @file app_coap_response.h
+* @brief CoAP response buffer pool Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_COAP_RESPONSE_H
+#define APP_COAP_RESPONSE_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+#define COAP_MAX_RESPONSE_LEN 1000
+
+/*
+ * Response buffers
+ * Callbacks are called by the CoAP resource handler thread, and by app_task() for
+ *  Observe. Each callback writes its response in a buffer of its own, from a pool
+ *  of APP_COAP_RESPONSE_POOL_COUNT buffers of COAP_MAX_RESPONSE_LEN bytes.
+ * The response is sent after the callback returns, so the buffer remains owned by
+ *  the calling thread until its next app_coap_response_acquire() (its previous
+ *  response has then been sent) or app_coap_response_release().
+ * If no buffer is released within APP_COAP_RESPONSE_POOL_TIMEOUT_MS, there is no
+ *  buffer to write the response to: the request is answered with 5.03 Service
+ *  Unavailable, with Max-Age APP_COAP_RESPONSE_RETRY_S (app_coap_reply_unavailable()).
+ * See the coap_pool host benchmark in linux_border_router_wsbrd/host_benchmarks for
+ *  concurrent callers.
+ */
+#ifndef   APP_COAP_RESPONSE_POOL_COUNT
+  #define APP_COAP_RESPONSE_POOL_COUNT      3   // one per thread calling callbacks, + 1 spare
+#endif /* APP_COAP_RESPONSE_POOL_COUNT */
+#define APP_COAP_RESPONSE_POOL_TIMEOUT_MS   100
+#define APP_COAP_RESPONSE_RETRY_S           1   // Max-Age of the 5.03 responses, pool empty
+
+typedef struct {
+  uint32_t acquired;
+  uint32_t reused;            // acquired by a thread already owning a buffer
+  uint32_t waits;             // pool empty, waiting for a buffer
+  uint32_t exhausted;         // no buffer after APP_COAP_RESPONSE_POOL_TIMEOUT_MS, 5.03 sent
+  uint8_t  in_use;
+  uint8_t  peak_in_use;
+} app_coap_response_pool_counters_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Create the pool, once */
+void     app_coap_response_pool_init(void);
+/* Response buffer of the calling thread (COAP_MAX_RESPONSE_LEN bytes, empty string),
+ *  NULL if the pool remained empty for APP_COAP_RESPONSE_POOL_TIMEOUT_MS */
+char *   app_coap_response_acquire(void);
+/* Release the calling thread's response buffer, once its response has been sent */
+void     app_coap_response_release(void);
+/* Sleeptimer tick of the last app_coap_response_acquire() of the calling thread (handler start) */
+uint64_t app_coap_response_start_tick(void);
+void     app_coap_response_pool_counters(app_coap_response_pool_counters_t *counters);
+void     app_coap_response_pool_reset(void);
+
+#endif /* APP_COAP_RESPONSE_H */
@@ -0,0 +1,75 @@
+/***************************************************************************//**
+* @file app_fnv.h
+* @brief FNV-1a 32 bits hash, shared by the application modules Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+#ifndef APP_FNV_H
+#define APP_FNV_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * FNV-1a 32 bits (not cryptographic): ETags of CoAP contents, observe change
+ *  detection, reporter line templates, send slot and group request seeds.
+ *  Hashes start from APP_FNV1A_32_OFFSET_BASIS and can be extended byte by
+ *  byte (app_fnv1a_byte()) when the bytes are selected while parsing.
+ */
+#define APP_FNV1A_32_OFFSET_BASIS 2166136261UL
+#define APP_FNV1A_32_PRIME        16777619UL
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+/* 'hash' extended with one byte */
+static inline uint32_t app_fnv1a_byte(uint32_t hash, uint8_t byte) {
+  return (hash ^ byte) * APP_FNV1A_32_PRIME;
+}
+
+/* 'hash' extended with 'len' bytes of 'data' */
+static inline uint32_t app_fnv1a(uint32_t hash, const void *data, uint32_t len) {
+  const uint8_t *c = (const uint8_t *)data;
+
+  while (len--) {
+    hash = app_fnv1a_byte(hash, *c++);
+  }
+  return hash;
+}
+
+#endif /* APP_FNV_H */
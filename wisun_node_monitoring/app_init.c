@@ -128,10 +128,12 @@ void app_init(void)
   sl_wisun_crash_handler_init();
 #endif /* SL_WISUN_CRASH_HANDLER_H */
 
+  app_stats_snapshot_init();
+
 #ifdef    SL_CATALOG_WISUN_COAP_PRESENT
   #ifdef APP_COAP_H
     #if SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES < 20
-      #pragma message("SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES needs to be increased to avoid an assert during app_coap_resources_init(); Count the number of calls to sl_wisun_coap_rhnd_resource_add)( in app_coap.c to get an idea of the required value)")
+      #pragma message("SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES needs to be at least the number of registered CoAP URIs and prefixes (checked when compiling app_coap.c)")
     #endif
     app_coap_resources_init();
   #endif /* APP_COAP_H */
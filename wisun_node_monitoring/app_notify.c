@@ -0,0 +1,159 @@
+/***************************************************************************//**
+* @file app_notify.c
+* @brief Notification sends to the UDP and CoAP destinations
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include "sl_memory_manager.h"
+#include "sl_wisun_coap.h"
+
+#include "app_notify.h"
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static bool _app_notify_udp(const uint8_t *msg, uint16_t msg_len);
+static bool _app_notify_coap(const uint8_t *msg, uint16_t msg_len, bool binary);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+static int32_t _udp_sockid = SOCKET_INVALID_ID;
+static sockaddr_in6_t _udp_addr;
+static int32_t _coap_sockid = SOCKET_INVALID_ID;
+static sockaddr_in6_t _coap_addr;
+static sl_wisun_coap_packet_t _coap_pkt;
+// Built CoAP messages, with room for the largest payload: no allocation
+static uint8_t _coap_buf[APP_NOTIFY_MAX_LEN + APP_NOTIFY_COAP_HEADER_MAX_LEN];
+static app_notify_counters_t _counters;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_notify_set_udp(int32_t sockid, const sockaddr_in6_t *addr) {
+  _udp_sockid = sockid;
+  _udp_addr = *addr;
+}
+
+void app_notify_set_coap(int32_t sockid, const sockaddr_in6_t *addr, const char *uri_path) {
+  _coap_sockid = sockid;
+  _coap_addr = *addr;
+  memset(&_coap_pkt, 0, sizeof(_coap_pkt));
+  _coap_pkt.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+  _coap_pkt.msg_id = 9002U;
+  _coap_pkt.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+  _coap_pkt.content_format = COAP_CT_JSON;
+  _coap_pkt.uri_path_ptr = (uint8_t *)uri_path;
+  _coap_pkt.uri_path_len = (uint16_t)strlen(uri_path);
+  _coap_pkt.token_ptr = NULL;
+  _coap_pkt.token_len = 0U;
+  _coap_pkt.options_list_ptr = NULL;
+}
+
+uint8_t app_notify_send(const uint8_t *msg, uint16_t msg_len, bool binary, bool to_udp, bool to_coap) {
+  uint8_t messages_processed = 0;
+
+  if (to_udp && _app_notify_udp(msg, msg_len)) {
+    messages_processed++;
+  }
+  if (to_coap && _app_notify_coap(msg, msg_len, binary)) {
+    messages_processed++;
+  }
+  return messages_processed;
+}
+
+void app_notify_counters(app_notify_counters_t *counters) {
+  *counters = _counters;
+}
+
+void app_notify_reset(void) {
+  memset(&_counters, 0, sizeof(_counters));
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool _app_notify_udp(const uint8_t *msg, uint16_t msg_len) {
+  // The message is passed as is: no copy, no allocation
+  _counters.sends++;
+  if (sendto(_udp_sockid, msg, msg_len, 0L,
+             (const struct sockaddr *)&_udp_addr, sizeof(sockaddr_in6_t)) == -1) {
+    printf("[Failed: unable to send to the UDP notification socket (%d)] msg_len %d\n",
+           (int)_udp_sockid, msg_len);
+    return false;
+  }
+  return true;
+}
+
+static bool _app_notify_coap(const uint8_t *msg, uint16_t msg_len, bool binary) {
+  uint16_t req_buff_size;
+  uint8_t *buff = _coap_buf;
+  bool sent = false;
+
+  _coap_pkt.content_format = binary ? COAP_CT_OCTET_STREAM : COAP_CT_JSON;
+  _coap_pkt.payload_ptr = (uint8_t *)msg;
+  _coap_pkt.payload_len = msg_len;
+
+  req_buff_size = sl_wisun_coap_builder_calc_size(&_coap_pkt);
+
+  _counters.sends++;
+  // The builder copies the payload after the CoAP header
+  _counters.bytes_copied += msg_len;
+  if (req_buff_size > sizeof(_coap_buf)) {
+    // Only for payloads longer than APP_NOTIFY_MAX_LEN
+    _counters.allocs++;
+    buff = (uint8_t *)sl_malloc(req_buff_size);
+    if (buff == NULL) {
+      printf("[Failed: unable to allocate %d bytes for a CoAP notification]\n", req_buff_size);
+      return false;
+    }
+  }
+  if (sl_wisun_coap_builder(buff, &_coap_pkt) < 0) {
+    printf("[Failed: unable to build a CoAP notification of %d bytes]\n", msg_len);
+  } else if (sendto(_coap_sockid, buff, req_buff_size, 0,
+                    (const struct sockaddr *)&_coap_addr, sizeof(sockaddr_in6_t)) == -1) {
+    printf("[Failed: unable to send to the CoAP notification socket (%d)] msg_len %d\n",
+           (int)_coap_sockid, msg_len);
+  } else {
+    sent = true;
+  }
+  if (buff != _coap_buf) {
+    sl_free(buff);
+  }
+  return sent;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************//**
+* @file app_notify.h
+* @brief Notification sends to the UDP and CoAP destinations Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_NOTIFY_H
+#define APP_NOTIFY_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "socket/socket.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * Notification sends
+ * A notification is formatted once by the caller and handed as is to both
+ *  transports: UDP sends it in place, CoAP copies it once behind its header, in
+ *  a static buffer sized for APP_NOTIFY_MAX_LEN bytes of payload. The heap is
+ *  only used for longer payloads.
+ * See the notify host benchmark in linux_border_router_wsbrd/host_benchmarks for
+ *  the bytes copied and allocations per notification.
+ */
+#ifndef   APP_NOTIFY_MAX_LEN
+  #define APP_NOTIFY_MAX_LEN            512   // SL_WISUN_STATUS_JSON_STR_MAX_LEN of app.c
+#endif /* APP_NOTIFY_MAX_LEN */
+// Room in front of the payload for the CoAP header and options
+#define APP_NOTIFY_COAP_HEADER_MAX_LEN  64
+
+typedef struct {
+  uint32_t sends;               // UDP and CoAP notification sends
+  uint32_t bytes_copied;        // payload bytes copied on the way to the sockets
+  uint32_t allocs;              // heap allocations on the way to the sockets
+} app_notify_counters_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Destination of the UDP notifications, once its socket is open */
+void    app_notify_set_udp(int32_t sockid, const sockaddr_in6_t *addr);
+/* Destination and URI path of the CoAP notifications (PUT, non confirmable), once its socket is open */
+void    app_notify_set_coap(int32_t sockid, const sockaddr_in6_t *addr, const char *uri_path);
+/* Send 'msg' to the UDP and/or CoAP destinations, as JSON or binary (CoAP content format).
+ *  Returns the number of messages sent */
+uint8_t app_notify_send(const uint8_t *msg, uint16_t msg_len, bool binary, bool to_udp, bool to_coap);
+void    app_notify_counters(app_notify_counters_t *counters);
+void    app_notify_reset(void);
+
+#endif /* APP_NOTIFY_H */
@@ -71,6 +71,16 @@
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
 // -----------------------------------------------------------------------------
+typedef struct {
+  uint32_t transactions;
+  uint32_t committed;
+  uint32_t rejected;          // syntax error or action: nothing applied
+  uint32_t rolled_back;       // one assignment failed: all parameters restored
+  uint32_t assignments;       // assignments of committed transactions
+  uint32_t nvm_writes;        // nvm3 objects written by save_app_parameters()
+  uint32_t last_latency_ms;
+  uint32_t max_latency_ms;
+} app_parameters_transaction_counters_t;
 
 // -----------------------------------------------------------------------------
 //                          Static Function Declarations
@@ -89,6 +99,12 @@ char res_string[1000];
 // -----------------------------------------------------------------------------
 //                                Static Variables
 // -----------------------------------------------------------------------------
+// Parameters before the current transaction, restored if one assignment fails
+static app_wisun_parameters_t _transaction_app_parameters;
+static app_settings_wisun_t   _transaction_network[MAX_NETWORK_CONFIGS];
+// Set during a transaction: save_app_parameters() calls are deferred to its commit
+static bool _save_deferred = false;
+static app_parameters_transaction_counters_t _transaction_counters;
 
 // -----------------------------------------------------------------------------
 //                          Public Function Definitions
@@ -240,6 +256,11 @@ void print_app_parameters() {
   printfBoth("app_parameters.network_count               %d\n", app_parameters.network_count);
   printfBoth("app_parameters.network_index               %d\n", app_parameters.network_index);
   printfBoth("app_parameters.network_struct_size         %d\n", app_parameters.network_struct_size);
+  printfBoth("app_parameters.notification_format         %d\n", app_parameters.notification_format);
+  printfBoth("app_parameters.keyframe_interval           %d\n", app_parameters.keyframe_interval);
+  printfBoth("app_parameters.batch_count                 %d\n", app_parameters.batch_count);
+  printfBoth("app_parameters.batch_max_bytes             %d\n", app_parameters.batch_max_bytes);
+  printfBoth("app_parameters.batch_max_age_sec           %d\n", app_parameters.batch_max_age_sec);
   printf("\n");
   printf("network parameters (from app_parameters.h)\n");
   for (i=0; i<MAX_NETWORK_CONFIGS; i++) {
@@ -255,7 +276,12 @@ char* app_parameters_string() {
   "\"nb_crashes\": \"%d\",\n" \
   "\"network_count\": \"%d\",\n" \
   "\"network_index\": \"%d\", \n" \
-  "\"network_struct_size\": \"%d\"" \
+  "\"network_struct_size\": \"%d\",\n" \
+  "\"notification_format\": \"%d\",\n" \
+  "\"keyframe_interval\": \"%d\",\n" \
+  "\"batch_count\": \"%d\",\n" \
+  "\"batch_max_bytes\": \"%d\",\n" \
+  "\"batch_max_age_sec\": \"%d\"" \
 
   snprintf(res_string, 1000, PARAMETERS_FORMAT_STR,
           app_parameters.app_params_version,
@@ -263,7 +289,12 @@ char* app_parameters_string() {
           app_parameters.nb_crashes,
           app_parameters.network_count,
           app_parameters.network_index,
-          app_parameters.network_struct_size);
+          app_parameters.network_struct_size,
+          app_parameters.notification_format,
+          app_parameters.keyframe_interval,
+          app_parameters.batch_count,
+          app_parameters.batch_max_bytes,
+          app_parameters.batch_max_age_sec);
   printf("[%d]%s\n", __LINE__, res_string);
   return res_string;
 }
@@ -296,6 +327,11 @@ void set_app_parameters_defaults(int network_indexes) {
   app_parameters.network_count      = MAX_NETWORK_CONFIGS;
   app_parameters.network_index      = DEFAULT_NETWORK_INDEX;
   app_parameters.network_struct_size = sizeof(app_settings_wisun_t);
+  app_parameters.notification_format = NOTIFICATION_FORMAT;
+  app_parameters.keyframe_interval   = KEYFRAME_INTERVAL;
+  app_parameters.batch_count         = BATCH_COUNT;
+  app_parameters.batch_max_bytes     = BATCH_MAX_BYTES;
+  app_parameters.batch_max_age_sec   = BATCH_MAX_AGE_SEC;
 
   printfBoth("sizeof(app_wisun_parameters_t) %d\n", sizeof(app_wisun_parameters_t));
 
@@ -420,19 +456,38 @@ sl_status_t init_app_parameters() {
   return status;
 }
 
-sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, char* value_str) {
+sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, char* value_str, bool dry_run) {
   bool match = false;
+  char ipv6[41];
 
-  printfBothTime("set_app_parameter(%s, index %d, value %ld, %s)\n", parameter_name, index, value, value_str);
+  if (!dry_run) { printfBothTime("set_app_parameter(%s, index %d, value %ld, %s)\n", parameter_name, index, value, value_str); }
 
   if  (!match) { match = (sl_strcasecmp(parameter_name, "network_index") == 0);
-    if (match) {
+    if (match && !dry_run) {
         app_parameters.network_index = (uint16_t)value;
         save_app_parameters();
         printfBothTime("Prepared to reboot on network %ld\n", value);
     }
   }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "notification_format") == 0);
+    if (match && !dry_run) { app_parameters.notification_format = (uint8_t)value; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "keyframe_interval") == 0);
+    if (match && !dry_run) { app_parameters.keyframe_interval = (uint16_t)value; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_count") == 0);
+    if (match && !dry_run) { app_parameters.batch_count = (uint8_t)value; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_max_bytes") == 0);
+    if (match && !dry_run) { app_parameters.batch_max_bytes = (uint16_t)value; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_max_age_sec") == 0);
+    if (match && !dry_run) { app_parameters.batch_max_age_sec = (uint16_t)value; }
+  }
   if  (!match) { match = (sl_strcasecmp(parameter_name, "defaults") == 0);
+    if (match && dry_run) {
+        return SL_STATUS_OK;
+    }
     if (match) {
         // Set all defaults
         set_app_parameters_defaults(value);
@@ -448,6 +503,9 @@ sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, c
     }
   }
   if  (!match) { match = (sl_strcasecmp(parameter_name, "save") == 0);
+    if (match && dry_run) {
+      return SL_STATUS_OK;
+    }
     if (match) {
       value = (uint16_t)save_app_parameters();
       if (value == SL_STATUS_OK) {
@@ -462,7 +520,7 @@ sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, c
   #ifdef    APP_ACTION_SCHEDULER_H
   // reboot options
   if  (!match) { match = (sl_strcasecmp(parameter_name, "reboot") == 0);
-    if (match) {
+    if (match && !dry_run) {
       if (app_scheduler_action_schedule(app_scheduler_reboot_cb,
                                         value,
                                         0U,
@@ -481,7 +539,7 @@ sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, c
   #endif /* APP_ACTION_SCHEDULER_H */
   #ifdef    APP_ACTION_SCHEDULER_H
   if  (!match) { match = (sl_strcasecmp(parameter_name, "clear_credential_cache_and_reboot") == 0);
-    if (match) { // This is useful to test a full network restart, with credentials cleared on both ends
+    if (match && !dry_run) { // This is useful to test a full network restart, with credentials cleared on both ends
       if (app_scheduler_action_schedule(app_scheduler_clear_credential_cache_and_reboot_cb,
                                         value,
                                         0U,
@@ -501,8 +559,11 @@ sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, c
   #endif /* APP_ACTION_SCHEDULER_H */
   if  (!match) {
     // Network settings (require the network_index, provide as 'index')
-    if (index < MAX_NETWORK_CONFIGS) {
+    if ((index >= 0) && (index < MAX_NETWORK_CONFIGS)) {
         if  (!match) { match = (sl_strcasecmp(parameter_name, "network_name") == 0);
+          if (match && dry_run) {
+              return SL_STATUS_OK;
+          }
           if (match) {
               snprintf(network[index].network_name, SL_WISUN_NETWORK_NAME_SIZE, "%s", value_str);
               sprintf(value_str, "\"network[%d].%s\": \"%s\"", index, parameter_name, network[index].network_name);
@@ -511,102 +572,114 @@ sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t value, c
           }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "auto_send_sec") == 0);
-          if (match) { network[index].auto_send_sec = (uint16_t)value; }
+          if (match && !dry_run) { network[index].auto_send_sec = (uint16_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "udp_notif_dest") == 0);
           if (match) {
-              if (unquote_ipv6(value_str, network[index].udp_notification_dest, 41) == 0) {
+              if (unquote_ipv6(value_str, dry_run ? ipv6 : network[index].udp_notification_dest, 41) == 0) {
+                  if (dry_run) {
+                      return SL_STATUS_OK;
+                  }
                   sprintf(value_str, "\"network[%d].%s\": \"%s\"", index, parameter_name, network[index].udp_notification_dest);
                   printfBothTime("%s\n", value_str);
                   return SL_STATUS_OK;
               } else {
                   sprintf(value_str, "ERROR, Use quote around  IPV6: \"udp_notif_dest 0 'ff02::1'\"\n");
-                  printfBothTime("ERROR setting '%s': invalid IPv6 string '%s'! Use quotes\n", parameter_name, value_str);
+                  if (!dry_run) { printfBothTime("ERROR setting '%s': invalid IPv6 string '%s'! Use quotes\n", parameter_name, value_str); }
                   return SL_STATUS_INVALID_PARAMETER;
               }
           }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "coap_notif_dest") == 0);
           if (match) {
-              if (unquote_ipv6(value_str, network[index].coap_notification_dest, 41) == 0) {
+              if (unquote_ipv6(value_str, dry_run ? ipv6 : network[index].coap_notification_dest, 41) == 0) {
+                  if (dry_run) {
+                      return SL_STATUS_OK;
+                  }
                   sprintf(value_str, "\"network[%d].%s\": \"%s\"", index, parameter_name, network[index].coap_notification_dest);
                   printfBothTime("%s\n", value_str);
                   return SL_STATUS_OK;
               } else {
                   sprintf(value_str, "ERROR, Use quote around  IPV6: \"coap_notif_dest 0 'ff02::1'\"\n");
-                  printfBothTime("ERROR setting '%s': invalid IPv6 string '%s'! Use quotes\n", parameter_name, value_str);
+                  if (!dry_run) { printfBothTime("ERROR setting '%s': invalid IPv6 string '%s'! Use quotes\n", parameter_name, value_str); }
                   return SL_STATUS_INVALID_PARAMETER;
               }
           }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "use_special_connect_param") == 0);
-          if (match) { network[index].use_special_connect_param = (uint8_t)value; }
+          if (match && !dry_run) { network[index].use_special_connect_param = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "network_size") == 0);
-          if (match) { network[index].network_size = (uint8_t)value; }
+          if (match && !dry_run) { network[index].network_size = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "tx_power_ddbm") == 0);
-          if (match) { network[index].tx_power_ddbm = (uint16_t)value; }
+          if (match && !dry_run) { network[index].tx_power_ddbm = (uint16_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "device_type") == 0);
-          if (match) { network[index].device_type = (sl_wisun_device_type_t)value; }
+          if (match && !dry_run) { network[index].device_type = (sl_wisun_device_type_t)value; }
         }
   #ifdef    SL_CATALOG_WISUN_LFN_DEVICE_SUPPORT_PRESENT
         if  (!match) { match = (sl_strcasecmp(parameter_name, "lfn_profile") == 0);
-          if (match) { network[index].lfn_profile = (sl_wisun_lfn_profile_t)value; }
+          if (match && !dry_run) { network[index].lfn_profile = (sl_wisun_lfn_profile_t)value; }
         }
   #endif /* SL_CATALOG_WISUN_LFN_DEVICE_SUPPORT_PRESENT */
         if  (!match) { match = (sl_strcasecmp(parameter_name, "fan_version") == 0);
-          if (match) { network[index].fan_version = (sl_wisun_fan_version_t)value; }
+          if (match && !dry_run) { network[index].fan_version = (sl_wisun_fan_version_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "preferred_pan_id") == 0);
-          if (match) { network[index].preferred_pan_id = (uint16_t)value; }
+          if (match && !dry_run) { network[index].preferred_pan_id = (uint16_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "max_hop_count") == 0);
-          if (match) { network[index].max_hop_count = (uint8_t)value; }
+          if (match && !dry_run) { network[index].max_hop_count = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "set_leaf") == 0);
-          if (match) { network[index].set_leaf = (uint8_t)value; }
+          if (match && !dry_run) { network[index].set_leaf = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "type") == 0);
-          if (match) { network[index].phy.type = (uint8_t)value; }
+          if (match && !dry_run) { network[index].phy.type = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "reg_domain") == 0);
-          if (match) { network[index].phy.config.fan11.reg_domain = (uint8_t)value; }
+          if (match && !dry_run) { network[index].phy.config.fan11.reg_domain = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "phy_mode_id") == 0);
-          if (match) { network[index].phy.config.fan11.phy_mode_id = (uint8_t)value; }
+          if (match && !dry_run) { network[index].phy.config.fan11.phy_mode_id = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "chan_plan_id") == 0);
-          if (match) { network[index].phy.config.fan11.chan_plan_id = (uint8_t)value; }
+          if (match && !dry_run) { network[index].phy.config.fan11.chan_plan_id = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "max_child_count") == 0);
-          if (match) { network[index].max_child_count = (uint8_t)value; }
+          if (match && !dry_run) { network[index].max_child_count = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "max_neighbor_count") == 0);
-          if (match) { network[index].max_neighbor_count = (uint8_t)value; }
+          if (match && !dry_run) { network[index].max_neighbor_count = (uint8_t)value; }
         }
         if  (!match) { match = (sl_strcasecmp(parameter_name, "max_security_neighbor_count") == 0);
-          if (match) { network[index].max_security_neighbor_count = (uint16_t)value; }
+          if (match && !dry_run) { network[index].max_security_neighbor_count = (uint16_t)value; }
         }
         // Conclusion
         if (match) {
+            if (dry_run) {
+                return SL_STATUS_OK;
+            }
             sprintf(value_str, "\"network[%d].%s\": \"%ld\"", index, parameter_name, value);
             printfBothTime("%s\n", value_str);
             return SL_STATUS_OK;
-        } else {
+        } else if (!dry_run) {
             printfBothTime("Unknown network parameter '%s' for network %d\n", parameter_name, index);
         }
     } else {
-        printfBothTime("ERROR setting '%s': incorrect index %d (above %d)!\n", parameter_name, index, MAX_NETWORK_CONFIGS);
+        sprintf(value_str, "ERROR setting '%s': incorrect index %d (0 to %d)", parameter_name, index, MAX_NETWORK_CONFIGS - 1);
+        if (!dry_run) { printfBothTime("%s\n", value_str); }
         return SL_STATUS_NOT_SUPPORTED;
     }
   }
   // completion
   if  (!match) {
       sprintf(value_str, "ERROR setting '%s': unknown application parameter!\n", parameter_name);
-      printfBothTime("%s\n", value_str);
+      if (!dry_run) { printfBothTime("%s\n", value_str); }
       return SL_STATUS_NOT_SUPPORTED;
+  } else if (dry_run) {
+      return SL_STATUS_OK;
   } else {
       sprintf(value_str, "\"%s\": \"%ld\"", parameter_name, value);
       printfBothTime("%s\n", value_str);
@@ -633,6 +706,21 @@ sl_status_t get_app_parameter(char* parameter_name, int index, uint32_t* value,
   if  (!match) { match = (sl_strcasecmp(parameter_name, "network_index") == 0);
     if (match) { *value = (uint32_t)app_parameters.network_index; }
   }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "notification_format") == 0);
+    if (match) { *value = (uint32_t)app_parameters.notification_format; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "keyframe_interval") == 0);
+    if (match) { *value = (uint32_t)app_parameters.keyframe_interval; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_count") == 0);
+    if (match) { *value = (uint32_t)app_parameters.batch_count; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_max_bytes") == 0);
+    if (match) { *value = (uint32_t)app_parameters.batch_max_bytes; }
+  }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "batch_max_age_sec") == 0);
+    if (match) { *value = (uint32_t)app_parameters.batch_max_age_sec; }
+  }
   if  (!match) { match = (sl_strcasecmp(parameter_name, "app_parameters") == 0);
     if (match) {
         sprintf(value_str, "%s", app_parameters_string());
@@ -641,6 +729,14 @@ sl_status_t get_app_parameter(char* parameter_name, int index, uint32_t* value,
         return SL_STATUS_OK;
     }
   }
+  if  (!match) { match = (sl_strcasecmp(parameter_name, "transactions") == 0);
+    if (match) {
+        app_parameters_transaction_string(value_str, APP_PARAMETER_VALUE_STR_MIN_LEN);
+        *value = _transaction_counters.transactions;
+        printfBothTime("%s\n", value_str);
+        return SL_STATUS_OK;
+    }
+  }
   if  (!match) { match = (sl_strcasecmp(parameter_name, "network") == 0);
     if (match) {
         sprintf(value_str, "%s", network_string(index));
@@ -765,6 +861,156 @@ sl_status_t get_app_parameter(char* parameter_name, int index, uint32_t* value,
   }
 }
 
+// Dry run of set_app_parameter(): name, index and value checks, without changing anything
+static sl_status_t _check_transaction_assignment(char *parameter_name, int index, uint32_t value,
+                                                 char *value_str, const char **reason) {
+  sl_status_t status;
+
+  if ((sl_strcasecmp(parameter_name, "reboot") == 0)
+      || (sl_strcasecmp(parameter_name, "clear_credential_cache_and_reboot") == 0)) {
+    // Scheduled actions can't be rolled back
+    *reason = "not allowed in a transaction";
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  if ((sl_strcasecmp(parameter_name, "save") == 0)
+      || (sl_strcasecmp(parameter_name, "defaults") == 0)) {
+    // The transaction is saved once, when committed
+    *reason = "not allowed in a transaction (saved on commit)";
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  status = set_app_parameter(parameter_name, index, value, value_str, true);
+  if (status != SL_STATUS_OK) {
+    // The error set by set_app_parameter()
+    value_str[strcspn(value_str, "\n")] = '\0';
+    *reason = value_str;
+  }
+  return status;
+}
+
+sl_status_t set_app_parameters_transaction(char* assignments, char* result_str, uint16_t result_size) {
+  char    *assignment[APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS];
+  char     parameter_name[APP_PARAMETER_NAME_MAX_LEN];
+  char     value_str[APP_PARAMETER_VALUE_STR_MIN_LEN];
+  uint32_t value;
+  int      index;
+  uint16_t count = 0;
+  uint16_t i;
+  uint32_t nvm_writes;
+  uint32_t latency_ms;
+  uint64_t start_msec = now_msec();
+  sl_status_t status = SL_STATUS_OK;
+  char    *c;
+  char    *next;
+
+  app_parameter_mutex_acquire();
+  _transaction_counters.transactions++;
+
+  // Split in assignments (in place), skipping empty ones
+  for (c = assignments; (c != NULL) && (status == SL_STATUS_OK); c = next) {
+    next = find_app_parameters_separator(c);
+    if (next != NULL) {
+      *next++ = '\0';
+    }
+    while ((*c == ' ') || (*c == '\t')) { c++; }
+    if (*c == '\0') {
+      continue;
+    }
+    if (count == APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS) {
+      snprintf(result_str, result_size, "ERROR: more than %d assignments", APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS);
+      status = SL_STATUS_INVALID_PARAMETER;
+    } else {
+      assignment[count++] = c;
+    }
+  }
+
+  // Check all assignments before changing anything (same defaults as the apply loop)
+  for (i = 0; (i < count) && (status == SL_STATUS_OK); i++) {
+    const char *reason = NULL;
+
+    index = 10;
+    value = 0;
+    sprintf(value_str, "%s", "(no_value_str)");
+    if (scan_app_parameter(assignment[i], parameter_name, &index, &value, value_str) == 0) {
+      snprintf(result_str, result_size, "ERROR: assignment %d '%s': bad format", i, assignment[i]);
+      status = SL_STATUS_INVALID_PARAMETER;
+    } else if ((status = _check_transaction_assignment(parameter_name, index, value, value_str, &reason)) != SL_STATUS_OK) {
+      snprintf(result_str, result_size, "ERROR: assignment %d '%s': %s", i, assignment[i], reason);
+    }
+  }
+  if (status != SL_STATUS_OK) {
+    _transaction_counters.rejected++;
+    app_parameter_mutex_release();
+    return status;
+  }
+
+  // Apply all assignments, or restore all parameters if one fails
+  memcpy(&_transaction_app_parameters, &app_parameters, sizeof(app_parameters));
+  memcpy(_transaction_network, network, sizeof(network));
+  _save_deferred = true;
+  for (i = 0; i < count; i++) {
+    index = 10;
+    value = 0;
+    sprintf(value_str, "%s", "(no_value_str)");
+    scan_app_parameter(assignment[i], parameter_name, &index, &value, value_str);
+    status = set_app_parameter(parameter_name, index, value, value_str, false);
+    if (status != SL_STATUS_OK) {
+      snprintf(result_str, result_size, "ERROR: assignment %d '%s' failed (%s), no parameter changed", i, assignment[i], value_str);
+      break;
+    }
+  }
+  _save_deferred = false;
+  if (status != SL_STATUS_OK) {
+    memcpy(&app_parameters, &_transaction_app_parameters, sizeof(app_parameters));
+    memcpy(network, _transaction_network, sizeof(network));
+    _transaction_counters.rolled_back++;
+    app_parameter_mutex_release();
+    return status;
+  }
+
+  // Commit: a single nvm3 save
+  nvm_writes = _transaction_counters.nvm_writes;
+  status = save_app_parameters();
+  nvm_writes = _transaction_counters.nvm_writes - nvm_writes;
+  latency_ms = (uint32_t)(now_msec() - start_msec);
+  _transaction_counters.committed++;
+  _transaction_counters.assignments += count;
+  _transaction_counters.last_latency_ms = latency_ms;
+  if (latency_ms > _transaction_counters.max_latency_ms) {
+    _transaction_counters.max_latency_ms = latency_ms;
+  }
+  snprintf(result_str, result_size,
+           "{\"assignments\": \"%d\", \"saved\": \"%s\", \"nvm_writes\": \"%ld\", \"latency_ms\": \"%ld\"}",
+           count, (status == SL_STATUS_OK) ? "yes" : "no", nvm_writes, latency_ms);
+  printfBothTime("%s\n", result_str);
+  app_parameter_mutex_release();
+  return status;
+}
+
+char* app_parameters_transaction_string(char* buf, uint16_t size) {
+  #define TRANSACTION_JSON_FORMAT_STR       \
+    "{\n"                                   \
+    "  \"transactions\": \"%ld\",\n"         \
+    "  \"committed\": \"%ld\",\n"            \
+    "  \"rejected\": \"%ld\",\n"             \
+    "  \"rolled_back\": \"%ld\",\n"          \
+    "  \"assignments\": \"%ld\",\n"          \
+    "  \"nvm_writes\": \"%ld\",\n"           \
+    "  \"last_latency_ms\": \"%ld\",\n"      \
+    "  \"max_latency_ms\": \"%ld\"\n"        \
+    "}\n"
+  snprintf(buf, size, TRANSACTION_JSON_FORMAT_STR,
+           _transaction_counters.transactions,
+           _transaction_counters.committed,
+           _transaction_counters.rejected,
+           _transaction_counters.rolled_back,
+           _transaction_counters.assignments,
+           _transaction_counters.nvm_writes,
+           _transaction_counters.last_latency_ms,
+           _transaction_counters.max_latency_ms
+  );
+  return buf;
+}
+
 sl_status_t read_app_parameters()   {
   sl_status_t status;
   int i;
@@ -825,6 +1071,10 @@ sl_status_t read_app_parameters()   {
 sl_status_t save_app_parameters()   {
   sl_status_t status;
   int i;
+  if (_save_deferred) {
+    return SL_STATUS_OK;
+  }
+  _transaction_counters.nvm_writes++;
   status = nvm3_writeData(nvm3_defaultHandle, NVM3_APP_KEY, &app_parameters, sizeof(app_parameters));
   if (status != SL_STATUS_OK) {
       // What to do here? Assert?
@@ -832,6 +1082,7 @@ sl_status_t save_app_parameters()   {
                      NVM3_APP_KEY, sizeof(app_parameters), status);
   } else {
       for (i=0; i<MAX_NETWORK_CONFIGS; i++) {
+          _transaction_counters.nvm_writes++;
           status = nvm3_writeData(nvm3_defaultHandle, NVM3_APP_KEY+1+i, &network[i], sizeof(app_settings_wisun_t));
           if (status != SL_STATUS_OK) {
               printfBoth("nvm3_writeData(nvm3_defaultHandle, 0x%04x, app_parameters, %d) returned 0x%04lX\n",
@@ -47,6 +47,8 @@
 #include "sl_wisun_types.h"
 #include "sl_wisun_connection_params_api.h"
 
+#include "app_parameters_scan.h"
+
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
 // -----------------------------------------------------------------------------
@@ -74,13 +76,21 @@
   /* For example: adding a new parameter or changing the order of parameters in app_settings_wisun_t or app_wisun_parameters_t. */
   /* After updating the application with a new NVM3_APP_PARAMS_VERSION,                                                         */
   /*    the parameters will be reset to the new default values (when the code detects a change in NVM3_APP_PARAMS_VERSION)      */
-  #define NVM3_APP_PARAMS_VERSION   10011
+  #define NVM3_APP_PARAMS_VERSION   10014
 #endif /* NVM3_APP_PARAMS_VERSION */
 
 #ifndef   MAX_NETWORK_CONFIGS
   #define MAX_NETWORK_CONFIGS 3
 #endif /* MAX_NETWORK_CONFIGS*/
 
+// Parameter transactions: several "<name> [index] [value]" assignments in one payload,
+//  separated by ';' or new lines (outside quoted values). All are checked (format, parameter
+//  name, network index, IPv6 strings), then applied (or none of them) and saved to
+//  nvm3 once. 'save', 'defaults' and the reboot commands are rejected
+#ifndef   APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS
+  #define APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS 32
+#endif /* APP_PARAMETERS_TRANSACTION_MAX_ASSIGNMENTS */
+
 #ifndef   DEFAULT_NETWORK_INDEX
   #define DEFAULT_NETWORK_INDEX 0
 #endif /* DEFAULT_NETWORK_INDEX */
@@ -93,6 +103,32 @@
 #define   SET_LEAF 0
 #endif /* SET_LEAF */
 
+#ifndef   NOTIFICATION_FORMAT
+  /* 0: JSON, 1: TLV (see app_tlv.h) for status and connection notifications */
+  #define NOTIFICATION_FORMAT 0
+#endif /* NOTIFICATION_FORMAT */
+
+#ifndef   KEYFRAME_INTERVAL
+  /* TLV status notifications: 1 full record (keyframe) every KEYFRAME_INTERVAL messages,  */
+  /*  only the fields changed since the keyframe in between. 0: always send full records   */
+  #define KEYFRAME_INTERVAL 0
+#endif /* KEYFRAME_INTERVAL */
+
+/* TLV status batching (mostly for LFNs): status samples are sent together in one   */
+/*  datagram once BATCH_COUNT samples, BATCH_MAX_BYTES bytes or BATCH_MAX_AGE_SEC   */
+/*  seconds since the oldest sample are reached. BATCH_COUNT 0 or 1: no batching    */
+#ifndef   BATCH_COUNT
+  #define BATCH_COUNT 0
+#endif /* BATCH_COUNT */
+
+#ifndef   BATCH_MAX_BYTES
+  #define BATCH_MAX_BYTES 512
+#endif /* BATCH_MAX_BYTES */
+
+#ifndef   BATCH_MAX_AGE_SEC
+  #define BATCH_MAX_AGE_SEC 900
+#endif /* BATCH_MAX_AGE_SEC */
+
 
 /* network */
 #ifndef   NETWORK_NAMEs
@@ -402,6 +438,11 @@ typedef struct {
                                  // Read at boot, set all parameters to defaults if
                                  //   sizeof(app_wisun_network_settings_t) != network_struct_size
                                  //    This is to avoid missmatching after application update
+  uint8_t  notification_format;  // APP_NOTIFICATION_FORMAT_JSON or APP_NOTIFICATION_FORMAT_TLV
+  uint16_t keyframe_interval;    // TLV status messages per keyframe (0: no delta messages)
+  uint8_t  batch_count;          // TLV status samples per datagram (0 or 1: no batching)
+  uint16_t batch_max_bytes;      // Batch datagram size flush threshold
+  uint16_t batch_max_age_sec;    // Oldest batched sample age flush threshold
 } app_wisun_parameters_t;
 
 extern app_settings_wisun_t network[MAX_NETWORK_CONFIGS];
@@ -430,7 +471,12 @@ char*       network_string(int i);
 void        print_app_parameters();
 char*       app_parameters_string();
 void        set_app_parameters_defaults(int network_indexes);
-sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t  value, char* value_str);
+// dry_run: only check the name, index and value (errors in value_str), without changing anything
+sl_status_t set_app_parameter(char* parameter_name, int index, uint32_t  value, char* value_str, bool dry_run);
 sl_status_t get_app_parameter(char* parameter_name, int index, uint32_t* value, char* value_str);
 
+// Apply all assignments (modified in place) or none, then save once. Result in json format in result_str
+sl_status_t set_app_parameters_transaction(char* assignments, char* result_str, uint16_t result_size);
+char*       app_parameters_transaction_string(char* buf, uint16_t size);
+
 #endif  // APP_PARAMETERS_H
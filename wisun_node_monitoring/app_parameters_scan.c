@@ -0,0 +1,122 @@
+/***************************************************************************//**
+* @file app_parameters_scan.c
+* @brief Application parameter assignments parsing
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <string.h>
+
+#include "app_coap_parse.h"
+#include "app_parameters_scan.h"
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+// Integer value token: unsigned, or negative (stored as its 2's complement)
+static bool _scan_value_token(const app_coap_token_t *token, uint32_t *value) {
+  int32_t signed_value;
+
+  if (app_coap_token_uint(token, value)) {
+    return true;
+  }
+  if (app_coap_token_int(token, &signed_value)) {
+    *value = (uint32_t)signed_value;
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+int scan_app_parameter(const char* assignment, char* parameter_name, int* index, uint32_t* value, char* value_str) {
+  app_coap_tokenizer_t tokenizer;
+  app_coap_token_t tokens[3];
+  app_coap_token_t str;
+  const char *str_end = NULL;
+  uint8_t  count = 0;
+  int32_t  scanned_index;
+
+  // Tokens of the assignment, in place. 'str' keeps the quotes of a quoted <str>
+  app_coap_tokenizer_init(&tokenizer, (const uint8_t *)assignment, (uint16_t)strlen(assignment));
+  while ((count < 3) && app_coap_token_next(&tokenizer, APP_COAP_PAYLOAD_SEPARATORS, &tokens[count])) {
+    count++;
+    str_end = tokenizer.next;
+  }
+  if ((count == 0) || !app_coap_token_copy(&tokens[0], parameter_name, APP_PARAMETER_NAME_MAX_LEN)) {
+    return 0;
+  }
+  // <parameter> <int> <int>, or <parameter> <int> <str>
+  if ((count == 3) && app_coap_token_int(&tokens[1], &scanned_index)) {
+    *index = (int)scanned_index;
+    if (!_scan_value_token(&tokens[2], value)) {
+      str.ptr    = tokens[2].quoted ? tokens[2].ptr - 1 : tokens[2].ptr;
+      str.len    = (uint16_t)(str_end - str.ptr);
+      str.quoted = false;
+      (void)app_coap_token_copy(&str, value_str, APP_PARAMETER_VALUE_STR_MIN_LEN);
+    }
+    return 3;
+  }
+  // <parameter> <int>
+  if ((count >= 2) && _scan_value_token(&tokens[1], value)) {
+    return 2;
+  }
+  // <parameter>
+  return 1;
+}
+
+char* find_app_parameters_separator(const char* assignments) {
+  const char *c;
+  char quote = '\0';
+  bool token_start = true;
+
+  for (c = assignments; *c != '\0'; c++) {
+    if (quote != '\0') {
+      // Inside a quoted value, as tokenized by app_coap_token_next()
+      if (*c == quote) {
+        quote = '\0';
+      }
+      token_start = false;
+    } else if (strchr(APP_PARAMETERS_SEPARATORS, *c) != NULL) {
+      return (char *)c;
+    } else if (token_start && ((*c == '"') || (*c == '\''))) {
+      quote = *c;
+    } else {
+      token_start = (strchr(APP_COAP_PAYLOAD_SEPARATORS, *c) != NULL);
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,69 @@
+/***************************************************************************//**
+* @file app_parameters_scan.h
+* @brief Application parameter assignments parsing Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_PARAMETERS_SCAN_H
+#define APP_PARAMETERS_SCAN_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * Application parameter assignments: "<name> [index] [value]", tokenized in place
+ *  (app_coap_parse.h), for the CoAP /settings/parameter PUTs and the parameter
+ *  transactions. Kept apart from app_parameters.c (nvm3, Wi-SUN API) so that it
+ *  only depends on the tokenizer.
+ * Transaction assignments are separated by APP_PARAMETERS_SEPARATORS, except inside
+ *  a quoted value: "network_name 0 'a;b'" is a single assignment.
+ */
+#define APP_PARAMETER_NAME_MAX_LEN       40
+#define APP_PARAMETER_VALUE_STR_MIN_LEN  256   // value_str size for scan_app_parameter()
+#define APP_PARAMETERS_SEPARATORS        ";\r\n"
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+// Parse "<name> [index] [value]", returns the number of items found (0 if none)
+int         scan_app_parameter(const char* assignment, char* parameter_name, int* index, uint32_t* value, char* value_str);
+// First APP_PARAMETERS_SEPARATORS character of 'assignments' outside quoted values, NULL if none
+char*       find_app_parameters_separator(const char* assignments);
+
+#endif /* APP_PARAMETERS_SCAN_H */
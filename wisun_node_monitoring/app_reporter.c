@@ -46,6 +46,7 @@
 #include "sl_wisun_common.h"
 #include "sl_wisun_ip6string.h"
 #include "app_reporter.h"
+#include "app_fnv.h"
 
 
 #if defined(SL_CATALOG_MICRIUMOS_KERNEL_PRESENT)
@@ -68,9 +69,89 @@ uint32_t reporter_started = 0;
 #define RTT_REPORT_TASK_FLAG_STOP       (1 << 1)
 #define RTT_REPORT_TASK_FLAG_ALL    (1 << 2) - 1
 
+#define REPORTER_MAX_MATCHES                 10
+// Aho-Corasick automaton of the match strings: one node per match string character + root
+#define REPORTER_AC_MAX_NODES                (MAX_MATCH_STRING_LEN + 1)
+#define REPORTER_AC_ROOT                     0
+
+// Match strings ending with '@<N>' are limited to N lines/sec (token bucket, bursts of N lines)
+#define REPORTER_RATE_SEPARATOR              '@'
+// Match strings ending with '~' (before '@<N>') also collapse lines only differing by their numbers
+#define REPORTER_SIMILAR_SEPARATOR           '~'
+#define REPORTER_REPEAT_SUMMARY_LEN          40
+// Longer lines are never collapsed
+#define REPORTER_LAST_LINE_LEN               200
+
+// Batches are at most the RTT up buffer content, after the device MAC
+#define REPORTER_LINES_SIZE                  (BUFFER_SIZE_UP*2)
+
+// LZSS compression of the batches, with the window primed by reporter_lz_dictionary
+//  Compressed batch: [REPORTER_LZ_MAGIC][flags][raw length (2 bytes, big endian)][items]
+//  items are in groups of 8, after a control byte (LSB first): 1 for a literal byte,
+//  0 for a 2 bytes back reference [distance-1 (12 bits)][length-3 (4 bits)]
+//  Uncompressed batches start with the device MAC, so never with REPORTER_LZ_MAGIC
+#define REPORTER_LZ_MAGIC                    0xA5
+#define REPORTER_LZ_FLAG_DICTIONARY          (REPORTER_LZ_DICTIONARY_VERSION << 4)
+#define REPORTER_LZ_HEADER_LEN               4
+#define REPORTER_LZ_MIN_MATCH                3
+#define REPORTER_LZ_MAX_MATCH                (REPORTER_LZ_MIN_MATCH + 15)
+#define REPORTER_LZ_MAX_DISTANCE             4096
+#define REPORTER_LZ_HASH_BITS                9
+#define REPORTER_LZ_HASH_SIZE                (1 << REPORTER_LZ_HASH_BITS)
+#define REPORTER_LZ_MAX_CHAIN                16
+#define REPORTER_LZ_NONE                     0xFFFF
+#define REPORTER_LZ_DICTIONARY_LEN           ((uint16_t)(sizeof(reporter_lz_dictionary) - 1))
+#define REPORTER_LZ_WINDOW_SIZE              (REPORTER_LZ_DICTIONARY_LEN + REPORTER_LINES_SIZE)
+
+// Sequenced batches: [REPORTER_SEQ_MAGIC][flags][sequence number (4 bytes, big endian)][batch]
+//  The last batches are kept in a ring of REPORTER_RING_SIZE bytes, and sent again
+//  when the receiver asks for them with a NACK on REPORTER_PORT:
+//   [REPORTER_NACK_MAGIC][count][first (4 bytes)][last (4 bytes)]...  (count ranges, big endian)
+//  Batches no longer in the ring are answered with REPORTER_SEQ_FLAG_GONE, the 'batch'
+//  being the last sequence number (4 bytes) of the range of gone batches.
+//  The 4 high bits of the flags are the session, drawn when the reporter starts, so the
+//  receiver tells a restart (sequence numbers from 0 again) from duplicated or late batches
+#define REPORTER_SEQ_MAGIC                   0xA6
+#define REPORTER_SEQ_HEADER_LEN              6
+#define REPORTER_SEQ_FLAG_RETRANSMIT         (1 << 0)
+#define REPORTER_SEQ_FLAG_GONE               (1 << 1)
+#define REPORTER_SEQ_SESSION_SHIFT           4
+#define REPORTER_NACK_MAGIC                  0xAE
+#define REPORTER_NACK_MAX_RANGES             8
+#define REPORTER_NACK_LEN                    (2 + REPORTER_NACK_MAX_RANGES * 8)
+#define REPORTER_NACK_MAX_RESENDS            8     // per period, to leave airtime for new batches
+#ifndef   REPORTER_RING_SIZE
+  #define REPORTER_RING_SIZE                 4096  // at least REPORTER_SEQ_HEADER_LEN + REPORTER_LINES_SIZE
+#endif /* REPORTER_RING_SIZE */
+// Any batch must fit in the ring, or reporter_ring_add() could not store (and send) it
+_Static_assert(REPORTER_RING_SIZE >= REPORTER_SEQ_HEADER_LEN + REPORTER_LINES_SIZE,
+               "REPORTER_RING_SIZE less than REPORTER_SEQ_HEADER_LEN + REPORTER_LINES_SIZE");
+#define REPORTER_RING_ENTRIES                16
+
+// Adaptive period: after each drain of the RTT up buffer, the fill rate since the previous drain
+//  (bytes written / elapsed time) gives the next one:
+//  - when the buffer will reach REPORTER_HIGH_WATER_PCT at this rate, if sooner than the requested
+//    period (down to REPORTER_MIN_PERIOD_MS)
+//  - later (period doubled, up to REPORTER_MAX_PERIOD_FACTOR times the requested period) if it was empty
+//  - after the requested period otherwise
+// The rate follows increases at once (bursts) and decays over a few drains. There is no timer
+//  polling the buffer between drains, to let LFNs sleep
+#define REPORTER_MIN_PERIOD_MS               20
+#define REPORTER_MAX_PERIOD_FACTOR           16
+#define REPORTER_HIGH_WATER_PCT              50
+// Less free space than a trace line when drained: writes have probably been skipped.
+//  SEGGER RTT doesn't count skipped writes: the next drain is after REPORTER_MIN_PERIOD_MS,
+//  and the lost bytes are estimated from the fill rate it measures, times the time the
+//  buffer was full (exact for a steady rate, bursts shorter than a period are not seen)
+#define REPORTER_NEAR_FULL_MARGIN            128
+#ifndef   MAX
+  #define MAX(a, b)                          (((a) > (b)) ? (a) : (b))
+#endif /* MAX */
+
 // -----------------------------------------------------------------------------
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
+static unsigned reporter_rtt_fill(void);
 
 // -----------------------------------------------------------------------------
 //                                Global Variables
@@ -80,11 +161,15 @@ uint32_t reporter_started = 0;
 //                                Static Variables
 // -----------------------------------------------------------------------------
 sl_sleeptimer_timer_handle_t app_reporter_timer;
+static uint64_t              reporter_last_drain_ms; // time of the last drain
+static unsigned              reporter_left_bytes;    // RTT up buffer bytes left by the last drain
+static uint32_t              reporter_fill_rate;     // RTT up buffer fill rate, bytes/sec
+static uint64_t              reporter_overflow_ms;   // time between near full drains, not estimated yet
+static uint32_t              reporter_overflow_space;// free space at the start of this time
 static uint32_t              rtt_report_task_flags;
 static osEventFlagsId_t      rtt_report_task_flag_group;
 static sl_wisun_socket_id_t  app_logs_socket_id = SOCKET_INVALID_ID;
 static char                  reporter_match_string[MAX_MATCH_STRING_LEN];
-static char                  lines_to_send[BUFFER_SIZE_UP*2];
 static in6_addr_t            ipv6_dest;
 static char                  ipv6_dest_string[40];
 
@@ -92,11 +177,95 @@ typedef struct reporter_match_struct reporter_match_struct_t;
 
 struct reporter_match_struct {
   uint8_t nb_matches;                   ///< Number of match strings
-   char match[10][MAX_MATCH_STRING_LEN];  ///< match strings array
+   char match[REPORTER_MAX_MATCHES][MAX_MATCH_STRING_LEN];  ///< match strings array
 };
 
 reporter_match_struct_t reporter_matches;
 
+// Trie of the match strings, with failure links (Aho-Corasick), so that lines
+//  are checked for all match strings in a single pass.
+//  Children of a node are a list (child, then sibling): nodes are indexes, 0 (root) meaning 'none'
+typedef struct {
+  char    c;                            ///< character leading to this node
+  uint8_t child;                        ///< first child
+  uint8_t sibling;                      ///< next child of the same parent
+  uint8_t fail;                         ///< node of the longest suffix also in the trie
+  uint8_t match;                        ///< index + 1 of a match string ending here, or at one of its suffixes (0: none)
+} reporter_ac_node_t;
+
+static reporter_ac_node_t reporter_ac[REPORTER_AC_MAX_NODES];
+static uint8_t            reporter_ac_count = 1;
+static uint8_t            reporter_match_all = 0;   // index + 1 of the '*' match string (0: none)
+// First characters of the match strings (bitmap): other characters stay at the root
+static uint8_t            reporter_ac_first[32];
+
+// Rate limit of each match string
+typedef struct {
+  uint16_t rate;                        ///< lines/sec, 0 for no limit
+  uint32_t tokens;                      ///< available lines, in 1/1000 line
+  uint64_t last_ms;                     ///< last refill
+} reporter_bucket_t;
+
+static reporter_bucket_t  reporter_buckets[REPORTER_MAX_MATCHES];
+// Match strings collapsing similar lines ('~'), and whether any does (line templates needed)
+static bool               reporter_similar[REPORTER_MAX_MATCHES];
+static bool               reporter_any_similar;
+// Last line sent or collapsed, template (FNV-1a, numbers excluded) of the last line sent,
+//  and lines collapsed since (some only similar to the last line sent if reporter_repeats_similar)
+static char               reporter_last_line[REPORTER_LAST_LINE_LEN];
+static uint16_t           reporter_last_line_len;
+static uint32_t           reporter_last_template;
+static uint32_t           reporter_repeats;
+static bool               reporter_repeats_similar;
+
+// Wi-SUN trace vocabulary, preceding each batch in the compression window.
+//  Must match the dictionary of the receiver (linux_border_router_wsbrd/direct_connect_receiver.py),
+//  change REPORTER_LZ_DICTIONARY_VERSION with it
+static const char reporter_lz_dictionary[] =
+  "[INFO][DBG ][WARN][ERR ][TRAC]"
+  "[mac ]: [ws  ]: [wsbr]: [rpl ]: [mpl ]: [6lo ]: [nwk ]: [eap ]: [dhcp]: [fhss]: [ipv6]: [sock]: "
+  "Tx PA Tx PAS Tx PC Tx PCS Rx PA Rx PAS Rx PC Rx PCS Tx DIO Rx DIO Tx DAO Rx DAO-ACK Tx DIS "
+  "Tx EAPOL Rx EAPOL Tx NS Rx NA Tx ACK Rx ACK "
+  "src: dst: fe80::fd12:3456::ff02::1a ff03::1 "
+  "channel: rssi: lqi: rsl: etx: pan_id: pan_size: routing_cost: parent: neighbor "
+  "status: success failed timeout state: join_state seq: len: "
+  "fragment frame buffer \n";
+// Window: dictionary, then the batch (lines_to_send)
+static char                  reporter_window[REPORTER_LZ_WINDOW_SIZE];
+static char * const          lines_to_send = reporter_window + REPORTER_LZ_DICTIONARY_LEN;
+
+// Match finder (hash chains) and output buffer, allocated when compression is enabled
+typedef struct {
+  uint16_t head[REPORTER_LZ_HASH_SIZE];       ///< last window position of each hash
+  uint16_t prev[REPORTER_LZ_WINDOW_SIZE];     ///< previous window position with the same hash
+  uint8_t  out[REPORTER_LINES_SIZE];          ///< compressed batch
+} reporter_lz_workspace_t;
+
+static reporter_lz_workspace_t     *reporter_lz = NULL;
+static app_reporter_compress_t      reporter_compress = APP_REPORTER_COMPRESS_OFF;
+static app_reporter_compress_counters_t reporter_compress_counters;
+
+// Retransmit ring: frames of consecutive sequence numbers, oldest first.
+//  Each frame is contiguous, the next one restarting at offset 0 if it doesn't fit at the end
+typedef struct {
+  uint16_t offset;                      ///< frame offset in reporter_ring
+  uint16_t len;                         ///< frame length
+} reporter_ring_entry_t;
+
+static uint8_t              *reporter_ring = NULL;   // allocated by the reporter task
+static reporter_ring_entry_t reporter_ring_entries[REPORTER_RING_ENTRIES];
+static uint8_t               reporter_ring_oldest;
+static uint8_t               reporter_ring_count;
+static uint32_t              reporter_ring_oldest_seq;
+static uint32_t              reporter_seq;           // sequence number of the next batch
+static uint8_t               reporter_session;       // REPORTER_SEQ_SESSION_SHIFT flags bits
+static app_reporter_counters_t reporter_counters;
+
+static bool                  reporter_running = false;
+static volatile bool         reporter_drain_pending = false;
+static uint32_t              reporter_requested_period_ms = 1000;
+static uint32_t              reporter_period_ms = 1000;
+
 // -----------------------------------------------------------------------------
 //                          Static Function Definitions
 // -----------------------------------------------------------------------------
@@ -237,51 +406,574 @@ static void reporter_timer_cb(sl_sleeptimer_timer_handle_t *handle, void *data)
 {
   (void)handle;
   (void)data;
+  reporter_drain_pending = true;
   assert((osEventFlagsSet(rtt_report_task_flag_group,
                           RTT_REPORT_TASK_FLAG_SEND) & CMSIS_RTOS_ERROR_MASK) == 0);
 }
 
-uint8_t filter_log_lines(char* log_lines, char* lines_to_send) {
-  const char crlf[] = "\n";
-  char *line;
-  char *match_in_line;
-  uint8_t matches;
+/* Child of 'node' for character 'c', REPORTER_AC_ROOT if none */
+static uint8_t reporter_ac_child(uint8_t node, char c) {
+  uint8_t child;
+
+  for (child = reporter_ac[node].child; child != REPORTER_AC_ROOT; child = reporter_ac[child].sibling) {
+    if (reporter_ac[child].c == c) {
+      break;
+    }
+  }
+  return child;
+}
+
+/* Rate limit of match string 'index', from its '@<N>' suffix, then similar lines
+ *  collapsing from its '~' suffix (both removed) */
+static void reporter_match_options(uint8_t index) {
+  char *match = reporter_matches.match[index];
+  char *separator = strrchr(match, REPORTER_RATE_SEPARATOR);
+  char *c;
+  uint32_t rate = 0;
+  size_t len;
+
+  reporter_buckets[index].rate = 0;
+  if ((separator != NULL) && (separator[1] != '\0')) {
+    for (c = separator + 1; *c; c++) {
+      if ((*c < '0') || (*c > '9') || (rate > UINT16_MAX / 10)) {
+        // Not a rate, part of the match string
+        break;
+      }
+      rate = rate * 10 + (uint32_t)(*c - '0');
+    }
+    if (*c == '\0') {
+      *separator = '\0';
+      reporter_buckets[index].rate = (uint16_t)MIN(rate, UINT16_MAX);
+      reporter_buckets[index].tokens = (uint32_t)reporter_buckets[index].rate * 1000;
+      reporter_buckets[index].last_ms = sl_sleeptimer_get_tick_count64() * 1000 / sl_sleeptimer_get_timer_frequency();
+    }
+  }
+  len = strlen(match);
+  reporter_similar[index] = (len > 1) && (match[len - 1] == REPORTER_SIMILAR_SEPARATOR);
+  if (reporter_similar[index]) {
+    match[len - 1] = '\0';
+  }
+}
+
+/* Build the automaton from reporter_matches */
+static void reporter_ac_build(void) {
+  uint8_t queue[REPORTER_AC_MAX_NODES];
+  uint8_t head = 0;
+  uint8_t tail = 0;
+  uint8_t node;
+  uint8_t child;
+  uint8_t fail;
+  uint8_t next;
+  const char *c;
   uint8_t i;
-  uint8_t line_count = 0;
-
-  // Clear the lines to send after filtering
-  sprintf(lines_to_send, "%s ", device_mac_string);
-
-  // Get the first line
-  line = strtok(log_lines, crlf);
-
-  // Walk through other tokens
-  while (line != NULL) {
-      matches = 0;
-      if (strcmp(reporter_matches.match[0], "*") == 0) {
-          matches++;
-      } else {
-      for (i = 0; i < reporter_matches.nb_matches ; i++) {
-          if (strlen(reporter_matches.match[i]) > 1) {
-              match_in_line = strstr(line, reporter_matches.match[i]);
-              if (match_in_line != NULL) {
-                  matches++;
-              }
+
+  memset(reporter_ac, 0, sizeof(reporter_ac));
+  memset(reporter_ac_first, 0, sizeof(reporter_ac_first));
+  reporter_ac_count = 1;
+  reporter_match_all = 0;
+  reporter_any_similar = false;
+  for (i = 0; i < reporter_matches.nb_matches; i++) {
+    if (strcmp(reporter_matches.match[i], "*") == 0) {
+      reporter_match_all = i + 1;
+    }
+    reporter_any_similar |= reporter_similar[i];
+    // Single characters would match almost all lines
+    if (strlen(reporter_matches.match[i]) <= 1) {
+      continue;
+    }
+    reporter_ac_first[(uint8_t)reporter_matches.match[i][0] >> 3] |= (uint8_t)(1 << (reporter_matches.match[i][0] & 7));
+    node = REPORTER_AC_ROOT;
+    for (c = reporter_matches.match[i]; *c; c++) {
+      next = reporter_ac_child(node, *c);
+      if (next == REPORTER_AC_ROOT) {
+        if (reporter_ac_count == REPORTER_AC_MAX_NODES) {
+          break;
+        }
+        next = reporter_ac_count++;
+        reporter_ac[next].c = *c;
+        reporter_ac[next].sibling = reporter_ac[node].child;
+        reporter_ac[node].child = next;
+      }
+      node = next;
+    }
+    if ((*c == '\0') && (reporter_ac[node].match == 0)) {
+      reporter_ac[node].match = i + 1;
+    }
+  }
+
+  // Failure links, breadth first (a node's suffixes are closer to the root)
+  for (child = reporter_ac[REPORTER_AC_ROOT].child; child != REPORTER_AC_ROOT; child = reporter_ac[child].sibling) {
+    reporter_ac[child].fail = REPORTER_AC_ROOT;
+    queue[tail++] = child;
+  }
+  while (head < tail) {
+    node = queue[head++];
+    for (child = reporter_ac[node].child; child != REPORTER_AC_ROOT; child = reporter_ac[child].sibling) {
+      fail = reporter_ac[node].fail;
+      while ((fail != REPORTER_AC_ROOT) && (reporter_ac_child(fail, reporter_ac[child].c) == REPORTER_AC_ROOT)) {
+        fail = reporter_ac[fail].fail;
+      }
+      reporter_ac[child].fail = reporter_ac_child(fail, reporter_ac[child].c);
+      if (reporter_ac[child].match == 0) {
+        reporter_ac[child].match = reporter_ac[reporter_ac[child].fail].match;
+      }
+      queue[tail++] = child;
+    }
+  }
+}
+
+/* Hash of the REPORTER_LZ_MIN_MATCH bytes at 'p' */
+static uint16_t reporter_lz_hash(const uint8_t *p) {
+  uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+
+  return (uint16_t)((v * 2654435761u) >> (32 - REPORTER_LZ_HASH_BITS));
+}
+
+/* Compress the 'raw_len' bytes of lines_to_send in reporter_lz->out.
+ *  Returns the compressed length, 0 if not shorter than raw_len */
+static uint16_t reporter_lz_compress(uint16_t raw_len) {
+  const uint8_t *window = (const uint8_t *)reporter_window;
+  uint8_t *out = reporter_lz->out;
+  uint16_t end = (uint16_t)(REPORTER_LZ_DICTIONARY_LEN + raw_len);
+  uint16_t p;
+  uint16_t o = REPORTER_LZ_HEADER_LEN;
+  uint16_t control = 0;
+  uint8_t  bit = 8;
+  uint16_t candidate;
+  uint16_t h;
+  uint16_t len;
+  uint16_t max_len;
+  uint16_t best_len;
+  uint16_t best_distance = 0;
+  uint8_t  chain;
+
+  out[0] = REPORTER_LZ_MAGIC;
+  out[1] = REPORTER_LZ_FLAG_DICTIONARY;
+  out[2] = (uint8_t)(raw_len >> 8);
+  out[3] = (uint8_t)(raw_len & 0xFF);
+
+  // Positions of the dictionary
+  memset(reporter_lz->head, 0xFF, sizeof(reporter_lz->head));
+  for (p = 0; p + REPORTER_LZ_MIN_MATCH <= REPORTER_LZ_DICTIONARY_LEN; p++) {
+    h = reporter_lz_hash(window + p);
+    reporter_lz->prev[p] = reporter_lz->head[h];
+    reporter_lz->head[h] = p;
+  }
+
+  p = REPORTER_LZ_DICTIONARY_LEN;
+  while (p < end) {
+    if (bit == 8) {
+      // Room for the control byte and a back reference, and shorter than raw
+      if (o + 3 >= raw_len) {
+        return 0;
+      }
+      control = o++;
+      out[control] = 0;
+      bit = 0;
+    }
+    best_len = 0;
+    max_len = MIN(REPORTER_LZ_MAX_MATCH, end - p);
+    if (max_len >= REPORTER_LZ_MIN_MATCH) {
+      candidate = reporter_lz->head[reporter_lz_hash(window + p)];
+      for (chain = 0; (chain < REPORTER_LZ_MAX_CHAIN) && (candidate != REPORTER_LZ_NONE)
+                      && (p - candidate <= REPORTER_LZ_MAX_DISTANCE); chain++) {
+        for (len = 0; (len < max_len) && (window[candidate + len] == window[p + len]); len++);
+        if (len > best_len) {
+          best_len = len;
+          best_distance = p - candidate;
+          if (len == max_len) {
+            break;
           }
         }
+        candidate = reporter_lz->prev[candidate];
       }
-      if (matches) {
-          line_count++;
-          if (line_count > 1) {
-              strcat(lines_to_send, "\n");
+    }
+    if (best_len >= REPORTER_LZ_MIN_MATCH) {
+      out[o++] = (uint8_t)((best_distance - 1) >> 4);
+      out[o++] = (uint8_t)((((best_distance - 1) & 0x0F) << 4) | (best_len - REPORTER_LZ_MIN_MATCH));
+    } else {
+      out[control] |= (uint8_t)(1 << bit);
+      out[o++] = window[p];
+      best_len = 1;
+    }
+    bit++;
+    // Index all positions of the literal/match
+    for (len = 0; len < best_len; len++, p++) {
+      if (p + REPORTER_LZ_MIN_MATCH <= end) {
+        h = reporter_lz_hash(window + p);
+        reporter_lz->prev[p] = reporter_lz->head[h];
+        reporter_lz->head[h] = p;
+      }
+    }
+  }
+  return (o < raw_len) ? o : 0;
+}
+
+/* Append 'line' to the lines to send, after a '\n' if not the first one */
+static char * reporter_append_line(char *out, char *out_end, const char *first, const char *line, uint16_t line_len) {
+  if (out + 1 >= out_end) {
+    return out;
+  }
+  if (out > first) {
+    *out++ = '\n';
+  }
+  if (line_len > out_end - out) {
+    line_len = (uint16_t)(out_end - out);
+  }
+  memcpy(out, line, line_len);
+  return out + line_len;
+}
+
+/* Summary of the lines collapsed since the last line sent.
+ *  Similar lines are summarized with the last one, to keep its values */
+static char * reporter_flush_repeats(char *out, char *out_end, const char *first) {
+  char summary[REPORTER_REPEAT_SUMMARY_LEN + REPORTER_LAST_LINE_LEN];
+  uint16_t len;
+
+  if (reporter_repeats == 0) {
+    return out;
+  }
+  if (reporter_repeats_similar) {
+    len = (uint16_t)snprintf(summary, REPORTER_REPEAT_SUMMARY_LEN, "[%lu similar line%s, last:] ", (unsigned long)reporter_repeats, (reporter_repeats > 1) ? "s" : "");
+    memcpy(summary + len, reporter_last_line, reporter_last_line_len);
+    len += reporter_last_line_len;
+  } else {
+    len = (uint16_t)snprintf(summary, sizeof(summary), "[last line repeated %lu time%s]", (unsigned long)reporter_repeats, (reporter_repeats > 1) ? "s" : "");
+  }
+  out = reporter_append_line(out, out_end, first, summary, len);
+  reporter_counters.saved_bytes -= MIN(reporter_counters.saved_bytes, (uint32_t)len + 1);
+  reporter_repeats = 0;
+  reporter_repeats_similar = false;
+  return out;
+}
+
+/* Keep a copy of the last line sent or collapsed, none if too long to be collapsed */
+static void reporter_keep_line(const char *line, uint16_t line_len) {
+  reporter_last_line_len = (line_len <= REPORTER_LAST_LINE_LEN) ? line_len : 0;
+  memcpy(reporter_last_line, line, reporter_last_line_len);
+}
+
+/* Take a token from the bucket of match string 'index', false if none left */
+static bool reporter_rate_allow(uint8_t index) {
+  reporter_bucket_t *bucket = &reporter_buckets[index];
+  uint64_t now_ms;
+
+  if (bucket->rate == 0) {
+    return true;
+  }
+  now_ms = sl_sleeptimer_get_tick_count64() * 1000 / sl_sleeptimer_get_timer_frequency();
+  bucket->tokens += (uint32_t)MIN((now_ms - bucket->last_ms) * bucket->rate, (uint64_t)bucket->rate * 1000);
+  bucket->tokens = MIN(bucket->tokens, (uint32_t)bucket->rate * 1000);
+  bucket->last_ms = now_ms;
+  if (bucket->tokens < 1000) {
+    return false;
+  }
+  bucket->tokens -= 1000;
+  return true;
+}
+
+/* Copy the lines of log_lines matching any match string into lines_to_send,
+ *  in one pass over log_lines. Returns the number of bytes of matching lines
+ *  Lines identical to the last line sent are only counted, then summarized in a
+ *  '[last line repeated N times]' line. With a '~' match string, lines with the same
+ *  template (same text except numbers) are also collapsed, in a
+ *  '[N similar lines, last:] <last line>' line.
+ *  Lines exceeding the rate of their match string are dropped */
+uint16_t filter_log_lines(const char* log_lines, uint16_t log_len, char* lines_to_send, uint16_t size) {
+  const char *line = log_lines;
+  const char *c;
+  const char *end = log_lines + log_len;
+  char *out = lines_to_send;
+  char *out_end = lines_to_send + size - 1;
+  char *first;
+  uint16_t line_len;
+  uint16_t header_len;
+  uint8_t state = REPORTER_AC_ROOT;
+  uint8_t next;
+  uint8_t matched = reporter_match_all;
+  uint32_t template = APP_FNV1A_32_OFFSET_BASIS;
+  bool in_number = false;
+  bool identical;
+
+  // Lines to send start with the device MAC
+  header_len = (uint16_t)snprintf(lines_to_send, size, "%s ", device_mac_string);
+  out += header_len;
+  first = out;
+
+  for (c = log_lines; c <= end; c++) {
+    if ((c == end) || (*c == '\n') || (*c == '\0')) {
+      // End of line: copy it if it matched (empty lines are skipped)
+      line_len = (uint16_t)(c - line);
+      if (matched && line_len) {
+        reporter_counters.lines++;
+        identical = (line_len == reporter_last_line_len) && (memcmp(line, reporter_last_line, line_len) == 0);
+        if (identical
+            || (reporter_similar[matched - 1] && reporter_last_line_len && (line_len <= REPORTER_LAST_LINE_LEN)
+                && (template == reporter_last_template))) {
+          if (!identical) {
+            reporter_keep_line(line, line_len);
+            reporter_repeats_similar = true;
           }
-          strcat(lines_to_send, line);
+          reporter_repeats++;
+          reporter_counters.collapsed_lines++;
+          reporter_counters.saved_bytes += line_len + 1;
+        } else if (!reporter_rate_allow(matched - 1)) {
+          reporter_counters.rate_limited_lines++;
+          reporter_counters.saved_bytes += line_len + 1;
+        } else {
+          out = reporter_flush_repeats(out, out_end, first);
+          out = reporter_append_line(out, out_end, first, line, line_len);
+          reporter_keep_line(line, line_len);
+          reporter_last_template = template;
+        }
+      }
+      if ((c == end) || (*c == '\0')) {
+        break;
+      }
+      line = c + 1;
+      state = REPORTER_AC_ROOT;
+      matched = reporter_match_all;
+      template = APP_FNV1A_32_OFFSET_BASIS;
+      in_number = false;
+      continue;
+    }
+    // Template: numbers (counters, timestamps, RSSI...) replaced by '#'
+    if (!reporter_any_similar) {
+      // No '~' match string: templates not used
+    } else if ((*c >= '0') && (*c <= '9')) {
+      if (!in_number) {
+        template = app_fnv1a_byte(template, '#');
       }
-      // Get the next line
-      line = strtok(NULL, crlf);
+      in_number = true;
+    } else {
+      template = app_fnv1a_byte(template, (uint8_t)*c);
+      in_number = false;
+    }
+    if (matched) {
+      // No need to check the rest of this line
+      continue;
+    }
+    if ((state == REPORTER_AC_ROOT) && !(reporter_ac_first[(uint8_t)*c >> 3] & (1 << (*c & 7)))) {
+      // Most characters: no match string starts with it
+      continue;
+    }
+    while (((next = reporter_ac_child(state, *c)) == REPORTER_AC_ROOT) && (state != REPORTER_AC_ROOT)) {
+      state = reporter_ac[state].fail;
+    }
+    state = next;
+    matched = reporter_ac[state].match;
+  }
+  // Repeats are summarized at least once per batch
+  out = reporter_flush_repeats(out, out_end, first);
+  *out = '\0';
+
+  return (uint16_t)(out - lines_to_send - header_len);
+}
+
+/* Bytes in the RTT up buffer 0 (stack traces), read without lock (estimate) */
+static unsigned reporter_rtt_fill(void) {
+  SEGGER_RTT_BUFFER_UP *pRing = &_SEGGER_RTT.aUp[0];
+  unsigned RdOff = pRing->RdOff;
+  unsigned WrOff = pRing->WrOff;
+
+  return (WrOff >= RdOff) ? (WrOff - RdOff) : (pRing->SizeOfBuffer - RdOff + WrOff);
+}
+
+/* Period until the next drain, from the RTT up buffer fill level before ('fill') and
+ *  after ('left') this drain, and the time since the previous one */
+static void reporter_adapt_period(unsigned fill, unsigned left, unsigned size) {
+  uint64_t now_ms = sl_sleeptimer_get_tick_count64() * 1000 / sl_sleeptimer_get_timer_frequency();
+  uint64_t elapsed_ms = now_ms - reporter_last_drain_ms;
+  unsigned high_water = size * REPORTER_HIGH_WATER_PCT / 100;
+  uint32_t rate = 0;
+  uint64_t written;
+  bool     near_full = (fill + REPORTER_NEAR_FULL_MARGIN >= size);
+
+  if (elapsed_ms && (fill > reporter_left_bytes)) {
+    rate = (uint32_t)((uint64_t)(fill - reporter_left_bytes) * 1000 / elapsed_ms);
+  }
+  if (near_full) {
+    // The rate measured now is capped by the buffer size: the bytes skipped since the
+    //  buffer was full are estimated at the next drain, with the rate measured then
+    reporter_counters.near_full_drains++;
+    reporter_overflow_ms += elapsed_ms;
+    reporter_overflow_space += size - MIN(size, reporter_left_bytes);
+  } else if (reporter_overflow_ms) {
+    // Bytes written at the observed rate while the buffer was full
+    written = reporter_overflow_ms * rate / 1000;
+    if (written > reporter_overflow_space) {
+      reporter_counters.lost_bytes_bound += (uint32_t)(written - reporter_overflow_space);
+    }
+    reporter_overflow_ms = 0;
+    reporter_overflow_space = 0;
+  }
+  reporter_fill_rate = (rate >= reporter_fill_rate) ? rate : (reporter_fill_rate * 3 + rate) / 4;
+  reporter_last_drain_ms = now_ms;
+  reporter_left_bytes = left;
+
+  if (fill == 0) {
+    reporter_counters.empty_wakeups++;
+    reporter_period_ms = MIN(reporter_period_ms * 2, reporter_requested_period_ms * REPORTER_MAX_PERIOD_FACTOR);
+  } else if (near_full || (left >= high_water)) {
+    // Traces probably lost, or not drained below the high-water mark (more than BUFFER_SIZE_UP
+    //  bytes): drain again soon, which also measures the fill rate below the buffer size
+    reporter_period_ms = REPORTER_MIN_PERIOD_MS;
+  } else if (reporter_fill_rate == 0) {
+    reporter_period_ms = reporter_requested_period_ms;
+  } else {
+    // Time to reach the high-water mark at the current rate
+    reporter_period_ms = (uint32_t)MIN((uint64_t)(high_water - left) * 1000 / reporter_fill_rate,
+                                       reporter_requested_period_ms);
+    reporter_period_ms = MAX(reporter_period_ms, REPORTER_MIN_PERIOD_MS);
+  }
+  if (reporter_period_ms < reporter_requested_period_ms) {
+    reporter_counters.early_wakeups++;
+  }
+  if (fill * 100 / size > reporter_counters.max_fill_pct) {
+    reporter_counters.max_fill_pct = fill * 100 / size;
+  }
+}
+
+/* Big endian 32 bits */
+static void reporter_put_u32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 24);
+  p[1] = (uint8_t)(value >> 16);
+  p[2] = (uint8_t)(value >> 8);
+  p[3] = (uint8_t)value;
+}
+
+static uint32_t reporter_get_u32(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/* Send 'len' bytes to the reporter destination */
+static bool reporter_send(const void *frame, uint16_t len) {
+  sockaddr_in6_t dest_ipv6_addr = {
+    .sin6_family = AF_INET6,
+    .sin6_port = htons(REPORTER_PORT),
+    .sin6_flowinfo = 0,
+    .sin6_addr = ipv6_dest,
+    .sin6_scope_id = 0,
+  };
+
+  if (sendto(app_logs_socket_id, frame, len, 0,
+             (const struct sockaddr *)&dest_ipv6_addr, sizeof(dest_ipv6_addr)) == SOCKET_RETVAL_ERROR) {
+    reporter_counters.send_errors++;
+    return false;
+  }
+  reporter_compress_counters.sent_bytes += len;
+  return true;
+}
+
+/* Store 'batch' in the ring, after its header with the next sequence number.
+ *  Returns the frame, NULL if it can't fit in the ring */
+static uint8_t * reporter_ring_add(const void *batch, uint16_t batch_len, uint16_t *frame_len) {
+  reporter_ring_entry_t *entry;
+  reporter_ring_entry_t *oldest;
+  uint16_t len = REPORTER_SEQ_HEADER_LEN + batch_len;
+  uint16_t offset = 0;
+  uint16_t wrap_offset = REPORTER_RING_SIZE;
+  uint8_t *frame;
+
+  if (len > REPORTER_RING_SIZE) {
+    return NULL;
+  }
+  if (reporter_ring_count) {
+    entry = &reporter_ring_entries[(reporter_ring_oldest + reporter_ring_count - 1) % REPORTER_RING_ENTRIES];
+    offset = entry->offset + entry->len;
+    if (offset + len > REPORTER_RING_SIZE) {
+      // The end of the ring is skipped
+      wrap_offset = offset;
+      offset = 0;
+    }
+  }
+  // Evict the oldest frames, which follow the newest one
+  while (reporter_ring_count) {
+    oldest = &reporter_ring_entries[reporter_ring_oldest];
+    if ((reporter_ring_count < REPORTER_RING_ENTRIES)
+        && (oldest->offset < wrap_offset)
+        && ((oldest->offset >= offset + len) || (oldest->offset + oldest->len <= offset))) {
+      break;
+    }
+    reporter_ring_oldest = (reporter_ring_oldest + 1) % REPORTER_RING_ENTRIES;
+    reporter_ring_oldest_seq++;
+    reporter_ring_count--;
+  }
+  if (reporter_ring_count == 0) {
+    reporter_ring_oldest_seq = reporter_seq;
   }
+  entry = &reporter_ring_entries[(reporter_ring_oldest + reporter_ring_count) % REPORTER_RING_ENTRIES];
+  entry->offset = offset;
+  entry->len = len;
+  reporter_ring_count++;
 
-  return strlen(lines_to_send) - strlen(device_mac_string) -1;
+  frame = reporter_ring + offset;
+  frame[0] = REPORTER_SEQ_MAGIC;
+  frame[1] = reporter_session;
+  reporter_put_u32(frame + 2, reporter_seq++);
+  memcpy(frame + REPORTER_SEQ_HEADER_LEN, batch, batch_len);
+  *frame_len = len;
+  return frame;
+}
+
+/* Send again the batches requested by the NACKs received since the last period */
+static void reporter_handle_nacks(void) {
+  uint8_t  nack[REPORTER_NACK_LEN];
+  uint8_t  gone[REPORTER_SEQ_HEADER_LEN + 4];
+  sockaddr_in6_t from;
+  socklen_t from_len;
+  int32_t  len;
+  uint8_t  resends = 0;
+  uint8_t  i;
+  uint32_t seq;
+  uint32_t first;
+  uint32_t last;
+  reporter_ring_entry_t *entry;
+
+  while (1) {
+    from_len = sizeof(from);
+    len = recvfrom(app_logs_socket_id, nack, sizeof(nack), 0, (struct sockaddr *)&from, &from_len);
+    if (len <= 0) {
+      break;
+    }
+    if ((len < 2) || (nack[0] != REPORTER_NACK_MAGIC) || (len < 2 + nack[1] * 8)) {
+      continue;
+    }
+    reporter_counters.nacks++;
+    for (i = 0; i < nack[1]; i++) {
+      first = reporter_get_u32(nack + 2 + i * 8);
+      last  = reporter_get_u32(nack + 2 + i * 8 + 4);
+      if (last >= reporter_seq) {
+        last = reporter_seq - 1;
+      }
+      if ((reporter_seq == 0) || (first > last)) {
+        continue;
+      }
+      if (first < reporter_ring_oldest_seq) {
+        // Not in the ring anymore
+        seq = MIN(last, reporter_ring_oldest_seq - 1);
+        gone[0] = REPORTER_SEQ_MAGIC;
+        gone[1] = reporter_session | REPORTER_SEQ_FLAG_GONE;
+        reporter_put_u32(gone + 2, first);
+        reporter_put_u32(gone + REPORTER_SEQ_HEADER_LEN, seq);
+        (void)reporter_send(gone, sizeof(gone));
+        reporter_counters.gone += seq - first + 1;
+        first = seq + 1;
+      }
+      for (seq = first; (seq <= last) && (seq - reporter_ring_oldest_seq < reporter_ring_count); seq++) {
+        if (resends == REPORTER_NACK_MAX_RESENDS) {
+          // The receiver will ask again
+          return;
+        }
+        entry = &reporter_ring_entries[(reporter_ring_oldest + seq - reporter_ring_oldest_seq) % REPORTER_RING_ENTRIES];
+        reporter_ring[entry->offset + 1] |= REPORTER_SEQ_FLAG_RETRANSMIT;
+        if (reporter_send(reporter_ring + entry->offset, entry->len)) {
+          reporter_counters.retransmitted++;
+        }
+        resends++;
+      }
+    }
+  }
 }
 
 static void check_and_send_reporter_logs(char *log_buffer)
@@ -293,14 +985,26 @@ static void check_and_send_reporter_logs(char *log_buffer)
    * The stack writes logs in the up buffer 0.
    * We need to lock RTT logs writing and read data inside the stack's RTT up buffer.
    */
-  int32_t socket_retval = SOCKET_RETVAL_ERROR;
   uint16_t read_bytes;
   uint16_t filtered_bytes;
+  uint16_t raw_len;
+  uint16_t compressed_len = 0;
+  const void *batch;
+  uint16_t batch_len;
+  uint8_t *frame;
+  uint16_t frame_len;
+  uint64_t start_tick;
+  unsigned fill;
 
   memset(log_buffer, 0x00, BUFFER_SIZE_UP);
   _app_reporter_mutex_acquire();
+  reporter_handle_nacks();
+  reporter_counters.wakeups++;
+  reporter_drain_pending = false;
   SEGGER_RTT_LOCK();
+  fill = reporter_rtt_fill();
   read_bytes = read_segger_up_buffer(0, log_buffer, BUFFER_SIZE_UP);
+  reporter_adapt_period(fill, reporter_rtt_fill(), _SEGGER_RTT.aUp[0].SizeOfBuffer);
   SEGGER_RTT_UNLOCK();
 
   if (read_bytes == 0) {
@@ -308,29 +1012,37 @@ static void check_and_send_reporter_logs(char *log_buffer)
       return;
   }
 
-  filtered_bytes = filter_log_lines(log_buffer, lines_to_send);
+  filtered_bytes = filter_log_lines(log_buffer, read_bytes, lines_to_send, REPORTER_LINES_SIZE);
 
   if (filtered_bytes > 0) {
-    /* Send on socket to the destination */
-    sockaddr_in6_t dest_ipv6_addr = {
-      .sin6_family = AF_INET6,
-      .sin6_port = htons(REPORTER_PORT),
-      .sin6_flowinfo = 0,
-      .sin6_addr = ipv6_dest,
-      .sin6_scope_id = 0,
-    };
-    // sendto() needs to be outside of the RTT lock to be able to send data
-    socket_retval = sendto(app_logs_socket_id,
-                           (const void *)lines_to_send,
-                           strlen(lines_to_send),
-                           0,
-                           (const struct sockaddr *)&dest_ipv6_addr,
-                            sizeof(dest_ipv6_addr));
-
-    if (socket_retval == SOCKET_RETVAL_ERROR) {
-      printf("Could not send log\n");
+    raw_len = (uint16_t)strlen(lines_to_send);
+    batch = lines_to_send;
+    batch_len = raw_len;
+    if ((reporter_compress != APP_REPORTER_COMPRESS_OFF) && (reporter_lz != NULL)) {
+      start_tick = sl_sleeptimer_get_tick_count64();
+      compressed_len = reporter_lz_compress(raw_len);
+      reporter_compress_counters.ticks += sl_sleeptimer_get_tick_count64() - start_tick;
+      reporter_compress_counters.batches++;
+      reporter_compress_counters.raw_bytes += raw_len;
+      reporter_compress_counters.compressed_bytes += compressed_len ? compressed_len : raw_len;
+      if (compressed_len) {
+        reporter_compress_counters.compressed_batches++;
+        if (reporter_compress == APP_REPORTER_COMPRESS_ON) {
+          batch = reporter_lz->out;
+          batch_len = compressed_len;
+        }
+      }
+    }
+    // Kept in the ring until the receiver can't ask for it anymore
+    frame = reporter_ring_add(batch, batch_len, &frame_len);
+    if (frame == NULL) {
+      printf("Could not store log\n");
     } else {
-      // printf("%s\n", lines_to_send );
+      reporter_counters.batches++;
+      // sendto() needs to be outside of the RTT lock to be able to send data
+      if (!reporter_send(frame, frame_len)) {
+        printf("Could not send log\n");
+      }
     }
   }
   _app_reporter_mutex_release();
@@ -346,6 +1058,10 @@ void app_reporter_task(void *args)
   if (!log_buffer) {
     goto cleanup;
   }
+  reporter_ring = (uint8_t *)sl_malloc(REPORTER_RING_SIZE);
+  if (!reporter_ring) {
+    goto cleanup;
+  }
 
   //setup the socket
   uint32_t flags = SL_WISUN_SOCKET_EVENT_MODE_INDICATION;
@@ -394,6 +1110,17 @@ void app_reporter_task(void *args)
     assert((rtt_report_task_flags & CMSIS_RTOS_ERROR_MASK) == 0);
     if (rtt_report_task_flags & RTT_REPORT_TASK_FLAG_SEND) {
       check_and_send_reporter_logs(log_buffer);
+      // Next drain, unless stopped meanwhile
+      _app_reporter_mutex_acquire();
+      if (reporter_running) {
+        sl_sleeptimer_restart_timer_ms(&app_reporter_timer,
+                                       reporter_period_ms,
+                                       reporter_timer_cb,
+                                       NULL,
+                                       0,
+                                       0);
+      }
+      _app_reporter_mutex_release();
     } else if (rtt_report_task_flags & RTT_REPORT_TASK_FLAG_STOP) {
       goto cleanup;
     }
@@ -412,6 +1139,11 @@ cleanup:
   if (log_buffer){
     free(log_buffer);
   }
+  if (reporter_ring) {
+    free(reporter_ring);
+    reporter_ring = NULL;
+    reporter_ring_count = 0;
+  }
   osThreadExit();
 }
 
@@ -433,6 +1165,11 @@ void app_start_reporter_thread()
       .tz_module = 0,
     };
 
+    // Started on request, at any time since the boot: the tick count is random enough
+    //  to tell this session from the one before a reboot
+    uint32_t ticks = sl_sleeptimer_get_tick_count();
+    reporter_session = (uint8_t)(((ticks ^ (ticks >> 4) ^ (ticks >> 8)) & 0x0F) << REPORTER_SEQ_SESSION_SHIFT);
+
     osThreadId_t rtt_thr_id = osThreadNew(app_reporter_task, NULL, &rtt_report_attr);
     assert(rtt_thr_id != NULL);
 
@@ -452,8 +1189,10 @@ void app_start_reporter(char *report__dest_ipv6_str,
     sprintf(ipv6_dest_string, report__dest_ipv6_str);
     sl_wisun_stoip6(report__dest_ipv6_str, strlen(report__dest_ipv6_str), &ipv6_dest);
 
-  strncpy((char*)reporter_match_string, match_string, MAX_MATCH_STRING_LEN);
+  strncpy((char*)reporter_match_string, match_string, MAX_MATCH_STRING_LEN - 1);
+  reporter_match_string[MAX_MATCH_STRING_LEN - 1] = '\0';
 
+  _app_reporter_mutex_acquire();
   reporter_matches.nb_matches = 0;
   const char pipe[] = "|";
   char *match;
@@ -464,29 +1203,165 @@ void app_start_reporter(char *report__dest_ipv6_str,
     strncpy(reporter_matches.match[reporter_matches.nb_matches], match_string, MAX_MATCH_STRING_LEN);
   }
   // Walk through other matches
-  while (match != NULL) {
+  while ((match != NULL) && (reporter_matches.nb_matches < REPORTER_MAX_MATCHES)) {
       strncpy(reporter_matches.match[reporter_matches.nb_matches], match, MAX_MATCH_STRING_LEN);
+      reporter_match_options(reporter_matches.nb_matches);
       reporter_matches.nb_matches++;
       // get next match
       match = strtok(NULL, pipe);
   }
+  reporter_ac_build();
+  reporter_last_line_len = 0;
+  reporter_last_template = 0;
+  reporter_repeats = 0;
+  reporter_repeats_similar = false;
+  _app_reporter_mutex_release();
   printf("Reporting RTT lines matching %d patterns to UDP port %d on %s\n",
          reporter_matches.nb_matches, REPORTER_PORT, report__dest_ipv6_str);
 
   for (i=0; i<reporter_matches.nb_matches ; i++) {
-      printf("reporter_matches.match[%d] %s\n", i, reporter_matches.match[i]);
+      printf("reporter_matches.match[%d] %s", i, reporter_matches.match[i]);
+      if (reporter_similar[i]) {
+        printf(" (similar lines collapsed)");
+      }
+      if (reporter_buckets[i].rate) {
+        printf(" (max %u lines/sec)", reporter_buckets[i].rate);
+      }
+      printf("\n");
   }
 
-  sl_sleeptimer_start_periodic_timer_ms(&app_reporter_timer,
-                                        report_period_ms,
-                                        reporter_timer_cb,
-                                        NULL,
-                                        0,
-                                        0);
-
+  _app_reporter_mutex_acquire();
+  reporter_requested_period_ms = MAX(report_period_ms, REPORTER_MIN_PERIOD_MS);
+  reporter_period_ms = reporter_requested_period_ms;
+  // Traces already in the RTT up buffer don't count in the fill rate
+  reporter_last_drain_ms = sl_sleeptimer_get_tick_count64() * 1000 / sl_sleeptimer_get_timer_frequency();
+  reporter_left_bytes = reporter_rtt_fill();
+  reporter_fill_rate = 0;
+  reporter_overflow_ms = 0;
+  reporter_overflow_space = 0;
+  reporter_running = true;
+  // Re-armed by the reporter task after each drain, with the adapted period
+  sl_sleeptimer_restart_timer_ms(&app_reporter_timer,
+                                 reporter_period_ms,
+                                 reporter_timer_cb,
+                                 NULL,
+                                 0,
+                                 0);
+  _app_reporter_mutex_release();
 }
 
 void app_stop_reporter(void)
 {
+  if (reporter_started) { _app_reporter_mutex_acquire(); }
+  reporter_running = false;
   sl_sleeptimer_stop_timer(&app_reporter_timer);
+  if (reporter_started) { _app_reporter_mutex_release(); }
+}
+
+bool app_reporter_set_compress(app_reporter_compress_t mode)
+{
+  bool res = true;
+
+  if (reporter_started == 0) {
+    app_start_reporter_thread();
+  }
+  _app_reporter_mutex_acquire();
+  if ((mode != APP_REPORTER_COMPRESS_OFF) && (reporter_lz == NULL)) {
+    reporter_lz = (reporter_lz_workspace_t *)sl_malloc(sizeof(reporter_lz_workspace_t));
+    if (reporter_lz == NULL) {
+      printf("Could not allocate %d bytes for reporter compression\n", (int)sizeof(reporter_lz_workspace_t));
+      mode = APP_REPORTER_COMPRESS_OFF;
+      res = false;
+    }
+  }
+  if ((mode == APP_REPORTER_COMPRESS_OFF) && (reporter_lz != NULL)) {
+    sl_free(reporter_lz);
+    reporter_lz = NULL;
+  }
+  if (mode != APP_REPORTER_COMPRESS_OFF) {
+    memcpy(reporter_window, reporter_lz_dictionary, REPORTER_LZ_DICTIONARY_LEN);
+  }
+  reporter_compress = mode;
+  _app_reporter_mutex_release();
+  return res;
+}
+
+void app_reporter_compress_reset(void)
+{
+  if (reporter_started) { _app_reporter_mutex_acquire(); }
+  memset(&reporter_compress_counters, 0, sizeof(reporter_compress_counters));
+  if (reporter_started) { _app_reporter_mutex_release(); }
+}
+
+char * app_reporter_statistics_string(char *buf, uint16_t size)
+{
+  app_reporter_counters_t c;
+  uint32_t next_seq;
+  uint32_t oldest_seq;
+  uint8_t  ring_count;
+  uint32_t fill_rate;
+
+  if (reporter_started) { _app_reporter_mutex_acquire(); }
+  c = reporter_counters;
+  fill_rate = reporter_fill_rate;
+  next_seq = reporter_seq;
+  oldest_seq = reporter_ring_oldest_seq;
+  ring_count = reporter_ring_count;
+  if (reporter_started) { _app_reporter_mutex_release(); }
+
+  snprintf(buf, size,
+           "{\"next_seq\":%lu,\"ring_first_seq\":%lu,\"ring_batches\":%u,\"ring_size\":%u,"
+           "\"batches\":%lu,\"send_errors\":%lu,\"nacks\":%lu,\"retransmitted\":%lu,\"gone\":%lu,"
+           "\"requested_period_ms\":%lu,\"period_ms\":%lu,\"wakeups\":%lu,\"early_wakeups\":%lu,"
+           "\"empty_wakeups\":%lu,\"near_full_drains\":%lu,\"max_fill_pct\":%lu,"
+           "\"fill_rate_bps\":%lu,\"lost_bytes_bound\":%lu,"
+           "\"lines\":%lu,\"collapsed_lines\":%lu,\"rate_limited_lines\":%lu,\"saved_bytes\":%lu}",
+           (unsigned long)next_seq, (unsigned long)oldest_seq, ring_count, REPORTER_RING_SIZE,
+           (unsigned long)c.batches, (unsigned long)c.send_errors, (unsigned long)c.nacks,
+           (unsigned long)c.retransmitted, (unsigned long)c.gone,
+           (unsigned long)reporter_requested_period_ms, (unsigned long)reporter_period_ms,
+           (unsigned long)c.wakeups, (unsigned long)c.early_wakeups,
+           (unsigned long)c.empty_wakeups, (unsigned long)c.near_full_drains, (unsigned long)c.max_fill_pct,
+           (unsigned long)fill_rate, (unsigned long)c.lost_bytes_bound,
+           (unsigned long)c.lines, (unsigned long)c.collapsed_lines, (unsigned long)c.rate_limited_lines,
+           (unsigned long)c.saved_bytes);
+  return buf;
+}
+
+void app_reporter_statistics_reset(void)
+{
+  if (reporter_started) { _app_reporter_mutex_acquire(); }
+  memset(&reporter_counters, 0, sizeof(reporter_counters));
+  if (reporter_started) { _app_reporter_mutex_release(); }
+}
+
+char * app_reporter_compress_string(char *buf, uint16_t size)
+{
+  app_reporter_compress_counters_t c;
+  static const char *modes[] = { "off", "on", "measure" };
+  uint32_t ratio_pct = 0;
+  uint32_t us_per_kb = 0;
+  uint32_t frequency = sl_sleeptimer_get_timer_frequency();
+
+  if (reporter_started) { _app_reporter_mutex_acquire(); }
+  c = reporter_compress_counters;
+  if (reporter_started) { _app_reporter_mutex_release(); }
+
+  if (c.raw_bytes) {
+    ratio_pct = (uint32_t)(c.compressed_bytes * 100 / c.raw_bytes);
+    if (frequency) {
+      us_per_kb = (uint32_t)(c.ticks * 1000000 / frequency * 1024 / c.raw_bytes);
+    }
+  }
+  snprintf(buf, size,
+           "{\"mode\":\"%s\",\"batches\":%lu,\"compressed_batches\":%lu,"
+           "\"raw_bytes\":%llu,\"compressed_bytes\":%llu,\"sent_bytes\":%llu,"
+           "\"ratio_pct\":%lu,\"us_per_kb\":%lu,\"workspace_bytes\":%u}",
+           modes[reporter_compress],
+           (unsigned long)c.batches, (unsigned long)c.compressed_batches,
+           (unsigned long long)c.raw_bytes, (unsigned long long)c.compressed_bytes,
+           (unsigned long long)c.sent_bytes,
+           (unsigned long)ratio_pct, (unsigned long)us_per_kb,
+           (unsigned int)sizeof(reporter_lz_workspace_t));
+  return buf;
 }
@@ -38,12 +38,57 @@
 
 #define MAX_MATCH_STRING_LEN 100
 extern char        device_mac_string[40];
+
+// Version of the compression dictionary, sent in the compressed batches flags
+#define REPORTER_LZ_DICTIONARY_VERSION 1
+
+typedef enum {
+  APP_REPORTER_COMPRESS_OFF = 0,    ///< batches sent as text
+  APP_REPORTER_COMPRESS_ON,         ///< batches sent compressed, if shorter
+  APP_REPORTER_COMPRESS_MEASURE,    ///< batches compressed for the counters only, sent as text
+} app_reporter_compress_t;
+
+typedef struct {
+  uint32_t batches;                 ///< batches compressed
+  uint32_t compressed_batches;      ///< batches shorter once compressed
+  uint64_t raw_bytes;               ///< text bytes of the compressed batches
+  uint64_t compressed_bytes;        ///< bytes of the compressed batches (text length if not shorter)
+  uint64_t sent_bytes;              ///< bytes sent, compressed or not
+  uint64_t ticks;                   ///< sleeptimer ticks spent compressing
+} app_reporter_compress_counters_t;
+
+typedef struct {
+  uint32_t batches;                 ///< batches sent (first transmission)
+  uint32_t send_errors;             ///< sendto() failures
+  uint32_t nacks;                   ///< NACKs received
+  uint32_t retransmitted;           ///< batches sent again on NACK
+  uint32_t gone;                    ///< batches requested but no longer in the retransmit ring
+  uint32_t wakeups;                 ///< RTT up buffer drains
+  uint32_t early_wakeups;           ///< drains scheduled before the requested period, from the fill rate
+  uint32_t empty_wakeups;           ///< drains finding the RTT up buffer empty
+  uint32_t near_full_drains;        ///< drains finding less than a trace line free: traces probably lost (not counted by RTT)
+  uint32_t max_fill_pct;            ///< highest RTT up buffer fill level at drain
+  uint32_t lost_bytes_bound;        ///< estimated trace bytes skipped while full: fill rate measured after x time full
+  uint32_t lines;                   ///< lines matching a match string
+  uint32_t collapsed_lines;         ///< lines identical to the previous one (similar with '~'), not sent
+  uint32_t rate_limited_lines;      ///< lines above the rate of their match string, not sent
+  uint32_t saved_bytes;             ///< bytes of the lines not sent, minus their summaries
+} app_reporter_counters_t;
 // -----------------------------------------------------------------------------
 //                          Public Function Definitions
 // -----------------------------------------------------------------------------
+/* 'match_string': <str>[~][@<lines/sec>]|<str>[~][@<lines/sec>]|...  ('*' for all lines, '~' to collapse similar lines) */
 void app_start_reporter(char *report__dest_ipv6,
                                uint32_t report_period_ms,
                                char *match_string);
 void app_stop_reporter(void);
+/* Set the compression mode of the batches, false if the compression buffers can't be allocated */
+bool app_reporter_set_compress(app_reporter_compress_t mode);
+void app_reporter_compress_reset(void);
+/* Sequence numbers, retransmit ring usage and NACK counters, in json format */
+char * app_reporter_statistics_string(char *buf, uint16_t size);
+void app_reporter_statistics_reset(void);
+/* Compression mode and counters (ratio, time per KB), in json format */
+char * app_reporter_compress_string(char *buf, uint16_t size);
 
 #endif /* End app_reporter.h */
@@ -0,0 +1,222 @@
+/***************************************************************************//**
+* @file app_send_slot.c
+* @brief Status notification slots, spread per device and widened on congestion
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include "app_send_slot.h"
+#include "app_fnv.h"
+#include "app_stats_snapshot.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+typedef struct {
+  uint32_t slot_sends;        // status messages sent in their slot
+  uint32_t asap_sends;        // status messages sent out of their slot
+  uint32_t congested_periods; // periods with failures above APP_SEND_SLOT_CONGESTION_PCT
+  uint32_t max_backoff_sec;
+  uint32_t last_fail_pct;     // failure rate over the last period
+} app_send_slot_counters_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static uint32_t _app_send_slot_random(void);
+static void _app_send_slot_mac_counters(uint32_t *tx_delta, uint32_t *fail_delta);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+static bool     _enabled = true;
+static uint32_t _hash;              // FNV-1a of the device MAC
+static uint32_t _random;            // xorshift32 state, seeded by _hash
+static uint32_t _backoff_sec;
+static uint32_t _period_sec;        // last period used, for reporting
+static app_send_slot_counters_t _counters;
+
+// MAC counters at the previous status (at the connection for the first one)
+static uint32_t _tx_count;
+static uint32_t _tx_failed_count;
+static uint32_t _failed_cca_count;
+static bool     _first_period;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_send_slot_init(const sl_wisun_mac_address_t *mac) {
+  _hash = app_fnv1a(APP_FNV1A_32_OFFSET_BASIS, mac->address, SL_WISUN_MAC_ADDRESS_SIZE);
+  // xorshift32 must not start from 0
+  _random = _hash ? _hash : 1;
+}
+
+void app_send_slot_enable(bool enable) {
+  _enabled = enable;
+  _backoff_sec = 0;
+}
+
+uint64_t app_send_slot_first_sec(uint64_t elapsed_sec, uint32_t period_sec) {
+  uint32_t tx_delta;
+  uint32_t fail_delta;
+
+  _period_sec = period_sec;
+  // Start counting failures at the connection, not at the boot
+  _app_send_slot_mac_counters(&tx_delta, &fail_delta);
+  _first_period = true;
+  if (!_enabled || (period_sec == 0)) {
+    return elapsed_sec;
+  }
+  // First slot at or after elapsed_sec
+  return app_send_slot_next_sec(elapsed_sec + period_sec - 1, period_sec) - period_sec;
+}
+
+uint64_t app_send_slot_next_sec(uint64_t elapsed_sec, uint32_t period_sec) {
+  uint32_t offset;
+  uint64_t slot_sec;
+
+  _period_sec = period_sec;
+  if (!_enabled || (period_sec == 0)) {
+    return elapsed_sec + period_sec;
+  }
+  offset = _hash % period_sec;
+  // First slot strictly after elapsed_sec. The previous status may have been
+  //  sent up to 'backoff' after its slot, always less than a period
+  if (elapsed_sec < offset) {
+    slot_sec = offset;
+  } else {
+    slot_sec = ((elapsed_sec - offset) / period_sec + 1) * period_sec + offset;
+  }
+  if (_backoff_sec) {
+    slot_sec += _app_send_slot_random() % (_backoff_sec + 1);
+  }
+  return slot_sec;
+}
+
+void app_send_slot_sent(bool asap) {
+  uint32_t tx_delta;
+  uint32_t fail_delta;
+
+  if (asap) {
+    _counters.asap_sends++;
+  } else {
+    _counters.slot_sends++;
+  }
+
+  _app_send_slot_mac_counters(&tx_delta, &fail_delta);
+
+  // The first period follows the connection, with the routes still settling: not evaluated.
+  //  Counters going backwards have been reset: skip this period
+  if (_first_period || (tx_delta > _tx_count) || (tx_delta + fail_delta == 0)) {
+    _first_period = false;
+    return;
+  }
+  _counters.last_fail_pct = (uint32_t)((100ULL * fail_delta) / (tx_delta + fail_delta));
+
+  if (_counters.last_fail_pct >= APP_SEND_SLOT_CONGESTION_PCT) {
+    _counters.congested_periods++;
+    _backoff_sec = _backoff_sec ? 2 * _backoff_sec : APP_SEND_SLOT_MIN_BACKOFF_S;
+    if (_backoff_sec > _period_sec / 2) {
+      _backoff_sec = _period_sec / 2;
+    }
+  } else {
+    _backoff_sec /= 2;
+  }
+  if (_backoff_sec > _counters.max_backoff_sec) {
+    _counters.max_backoff_sec = _backoff_sec;
+  }
+}
+
+void app_send_slot_reset(void) {
+  memset(&_counters, 0, sizeof(_counters));
+}
+
+char* app_send_slot_string(char *buf, uint16_t size) {
+  #define SEND_SLOT_JSON_FORMAT_STR          \
+    "{\n"                                    \
+    "  \"enabled\": \"%d\",\n"               \
+    "  \"period_sec\": \"%lu\",\n"           \
+    "  \"slot_offset_sec\": \"%lu\",\n"      \
+    "  \"backoff_sec\": \"%lu\",\n"          \
+    "  \"max_backoff_sec\": \"%lu\",\n"      \
+    "  \"fail_pct\": \"%lu\",\n"             \
+    "  \"congested_periods\": \"%lu\",\n"    \
+    "  \"slot_sends\": \"%lu\",\n"           \
+    "  \"asap_sends\": \"%lu\"\n"            \
+    "}\n"
+
+  snprintf(buf, size, SEND_SLOT_JSON_FORMAT_STR,
+    _enabled,
+    (unsigned long)_period_sec,
+    (unsigned long)(_period_sec ? _hash % _period_sec : 0),
+    (unsigned long)_backoff_sec,
+    (unsigned long)_counters.max_backoff_sec,
+    (unsigned long)_counters.last_fail_pct,
+    (unsigned long)_counters.congested_periods,
+    (unsigned long)_counters.slot_sends,
+    (unsigned long)_counters.asap_sends
+  );
+  return buf;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+// xorshift32: devices with the same backoff pick different delays
+static uint32_t _app_send_slot_random(void) {
+  _random ^= _random << 13;
+  _random ^= _random >> 17;
+  _random ^= _random << 5;
+  return _random;
+}
+
+// MAC tx and failures (tx failures + CCA failures) since the previous call
+static void _app_send_slot_mac_counters(uint32_t *tx_delta, uint32_t *fail_delta) {
+  const app_stats_snapshot_t *snapshot;
+
+  snapshot = app_stats_snapshot_acquire();
+  *tx_delta   = snapshot->mac.mac.tx_count - _tx_count;
+  *fail_delta = (snapshot->mac.mac.tx_failed_count  - _tx_failed_count)
+              + (snapshot->mac.mac.failed_cca_count - _failed_cca_count);
+  _tx_count         = snapshot->mac.mac.tx_count;
+  _tx_failed_count  = snapshot->mac.mac.tx_failed_count;
+  _failed_cca_count = snapshot->mac.mac.failed_cca_count;
+  app_stats_snapshot_release();
+}
@@ -0,0 +1,106 @@
+/***************************************************************************//**
+* @file app_send_slot.h
+* @brief Status notification slots, spread per device and widened on congestion
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_SEND_SLOT_H
+#define APP_SEND_SLOT_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sl_wisun_types.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * Status messages are sent in a per-device slot of the status period:
+ *  at times 'offset + n * period' (counted from the connection time),
+ *  with 'offset' a hash of the device MAC modulo the period.
+ *  Devices powered on or reconnected at the same time thus spread their
+ *  status messages over the whole period instead of all sending at once.
+ *
+ * When the MAC tx failures and CCA failures since the previous status
+ *  show channel congestion, a pseudo-random delay of up to 'backoff' seconds
+ *  is added after the slot. 'backoff' doubles while congestion lasts
+ *  (up to half the period) and halves once it clears.
+ */
+
+// Congestion threshold: (tx failures + CCA failures) / tx attempts, in %
+#ifndef   APP_SEND_SLOT_CONGESTION_PCT
+  #define APP_SEND_SLOT_CONGESTION_PCT 10
+#endif /* APP_SEND_SLOT_CONGESTION_PCT */
+
+// First backoff value on congestion
+#ifndef   APP_SEND_SLOT_MIN_BACKOFF_S
+  #define APP_SEND_SLOT_MIN_BACKOFF_S  2
+#endif /* APP_SEND_SLOT_MIN_BACKOFF_S */
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Compute the device hash, to be called once the device MAC is known */
+void app_send_slot_init(const sl_wisun_mac_address_t *mac);
+
+/* Enable/disable slots. When disabled, the first status is sent immediately
+ *  and the next ones every period, as before */
+void app_send_slot_enable(bool enable);
+
+/**
+ * Time of the first status, after connection.
+ *
+ * @param elapsed_sec  current time, counted from the connection time
+ * @param period_sec   status period
+ * @return the first status time, in the same reference as elapsed_sec
+ */
+uint64_t app_send_slot_first_sec(uint64_t elapsed_sec, uint32_t period_sec);
+
+/* Time of the next status, once one has been sent at elapsed_sec */
+uint64_t app_send_slot_next_sec(uint64_t elapsed_sec, uint32_t period_sec);
+
+/* To be called after each status sent while connected, to adapt the backoff.
+ *  'asap' is true for messages sent out of their slot (send_asap) */
+void app_send_slot_sent(bool asap);
+
+/* Slot, backoff and congestion counters, in json format */
+char* app_send_slot_string(char *buf, uint16_t size);
+void app_send_slot_reset(void);
+
+#endif /* APP_SEND_SLOT_H */
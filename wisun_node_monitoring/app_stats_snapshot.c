@@ -0,0 +1,239 @@
+/***************************************************************************//**
+* @file app_stats_snapshot.c
+* @brief Shared snapshot of the Wi-SUN stack statistics
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <assert.h>
+#include <string.h>
+
+#include "cmsis_os2.h"
+#include "sl_cmsis_os2_common.h"
+#include "sl_memory_manager.h"
+#include "sl_wisun_api.h"
+
+#include "app.h"
+#include "app_stats_snapshot.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+typedef struct {
+  uint32_t hits;          // acquires served from the current snapshot
+  uint32_t misses;        // acquires which refreshed the snapshot
+  uint32_t invalidations; // calls to app_stats_snapshot_invalidate()
+  uint32_t stack_calls;   // sl_wisun_get_*() calls made by the refreshes
+  uint64_t start_msec;    // reference for the per-minute rates
+} app_stats_snapshot_counters_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static void _app_stats_snapshot_refresh(void);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+static app_stats_snapshot_t          _snapshot;
+static app_stats_snapshot_counters_t _counters;
+static bool                          _snapshot_valid = false;
+static uint32_t                      _max_age_ms = APP_STATS_SNAPSHOT_MAX_AGE_MS;
+
+// Snapshot mutex
+static osMutexId_t _app_stats_snapshot_mutex = NULL;
+
+static const osMutexAttr_t _app_stats_snapshot_mutex_attr = {
+  .name      = "AppStatsSnapshotMutex",
+  .attr_bits = osMutexRecursive,
+  .cb_mem    = NULL,
+  .cb_size   = 0U
+};
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_stats_snapshot_init(void) {
+  _app_stats_snapshot_mutex = osMutexNew(&_app_stats_snapshot_mutex_attr);
+  assert(_app_stats_snapshot_mutex != NULL);
+  app_stats_snapshot_counters_reset();
+}
+
+const app_stats_snapshot_t *app_stats_snapshot_acquire(void) {
+  osStatus_t status;
+
+  status = osMutexAcquire(_app_stats_snapshot_mutex, osWaitForever);
+  assert(status == osOK);
+  (void)status;
+
+  if ((_snapshot_valid == false)
+      || (now_msec() - _snapshot.refresh_msec >= _max_age_ms)) {
+    _counters.misses++;
+    _app_stats_snapshot_refresh();
+  } else {
+    _counters.hits++;
+  }
+  return &_snapshot;
+}
+
+void app_stats_snapshot_release(void) {
+  osStatus_t status;
+
+  status = osMutexRelease(_app_stats_snapshot_mutex);
+  assert(status == osOK);
+  (void)status;
+}
+
+void app_stats_snapshot_invalidate(void) {
+  // A single bool write, no need to wait for a reader to release the snapshot
+  _snapshot_valid = false;
+  _counters.invalidations++;
+}
+
+uint32_t app_stats_snapshot_get_max_age_ms(void) {
+  return _max_age_ms;
+}
+
+void app_stats_snapshot_set_max_age_ms(uint32_t max_age_ms) {
+  _max_age_ms = max_age_ms;
+}
+
+void app_stats_snapshot_counters_reset(void) {
+  memset(&_counters, 0, sizeof(_counters));
+  _counters.start_msec = now_msec();
+}
+
+char* app_stats_snapshot_counters_string(char *buf, uint16_t size) {
+  #define SNAPSHOT_COUNTERS_JSON_FORMAT_STR      \
+    "{\n"                                        \
+    "  \"max_age_ms\": \"%lu\",\n"               \
+    "  \"generation\": \"%lu\",\n"               \
+    "  \"hits\": \"%lu\",\n"                     \
+    "  \"misses\": \"%lu\",\n"                   \
+    "  \"invalidations\": \"%lu\",\n"            \
+    "  \"stack_calls\": \"%lu\",\n"              \
+    "  \"stack_calls_per_min\": \"%.2f\",\n"     \
+    "  \"stack_calls_saved_per_min\": \"%.2f\"\n"\
+    "}\n"
+  float elapsed_min;
+  float calls_per_refresh = 0.0;
+
+  elapsed_min = (now_msec() - _counters.start_msec) / 60000.0;
+  if (_counters.misses) {
+    calls_per_refresh = (float)_counters.stack_calls / _counters.misses;
+  }
+  snprintf(buf, size, SNAPSHOT_COUNTERS_JSON_FORMAT_STR,
+    _max_age_ms,
+    _snapshot.generation,
+    _counters.hits,
+    _counters.misses,
+    _counters.invalidations,
+    _counters.stack_calls,
+    (elapsed_min > 0) ? _counters.stack_calls / elapsed_min : 0.0,
+    // Each hit saved the average number of calls of a refresh
+    (elapsed_min > 0) ? _counters.hits * calls_per_refresh / elapsed_min : 0.0
+  );
+  return buf;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+// Called with the mutex held
+static void _app_stats_snapshot_refresh(void) {
+  sl_status_t ret;
+  uint8_t neighbor_count = 0;
+  uint8_t i;
+  sl_wisun_neighbor_info_t neighbor_info;
+  sl_wisun_mac_address_t *neighbor_mac_addresses = NULL;
+
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_PHY       , &_snapshot.phy);
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_MAC       , &_snapshot.mac);
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_FHSS      , &_snapshot.fhss);
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_WISUN     , &_snapshot.wisun);
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_NETWORK   , &_snapshot.network);
+  sl_wisun_get_statistics(SL_WISUN_STATISTICS_TYPE_REGULATION, &_snapshot.regulation);
+  sl_wisun_get_network_info(&_snapshot.network_info);
+  _counters.stack_calls += 7;
+
+  // No stale parent values if no parent is found below
+  memset(&_snapshot.parent_mac    , 0, sizeof(_snapshot.parent_mac));
+  memset(&_snapshot.parent_info   , 0, sizeof(_snapshot.parent_info));
+  memset(&_snapshot.secondary_mac , 0, sizeof(_snapshot.secondary_mac));
+  memset(&_snapshot.secondary_info, 0, sizeof(_snapshot.secondary_info));
+
+  ret = sl_wisun_get_neighbor_count(&neighbor_count);
+  _counters.stack_calls++;
+  if (ret) {
+    printfBothTime("[Failed: sl_wisun_get_neighbor_count() returned 0x%04x]\n", (uint16_t)ret);
+    neighbor_count = 0;
+  }
+
+  if (neighbor_count) {
+    neighbor_mac_addresses = sl_malloc(sizeof(sl_wisun_mac_address_t) * neighbor_count);
+    if (neighbor_mac_addresses == NULL) {
+      printfBothTime("[Failed: memory allocation for %d sl_wisun_mac_address_t in neighbor_mac_addresses returned NULL]\n", (uint16_t)neighbor_count);
+    } else {
+      ret = sl_wisun_get_neighbors(&neighbor_count, neighbor_mac_addresses);
+      _counters.stack_calls++;
+      if (ret) {
+        // The addresses are not valid: no parent found, neighbor_count kept
+        printfBothTime("[Failed: sl_wisun_get_neighbors() returned 0x%04x]\n", (uint16_t)ret);
+      } else {
+        for (i = 0 ; i < neighbor_count; i++) {
+          ret = sl_wisun_get_neighbor_info(&neighbor_mac_addresses[i], &neighbor_info);
+          _counters.stack_calls++;
+          if (ret) {
+            continue;
+          }
+          if (neighbor_info.type == SL_WISUN_NEIGHBOR_TYPE_PRIMARY_PARENT) {
+            _snapshot.parent_info = neighbor_info;
+            _snapshot.parent_mac  = neighbor_mac_addresses[i];
+          }
+          if (neighbor_info.type == SL_WISUN_NEIGHBOR_TYPE_SECONDARY_PARENT) {
+            _snapshot.secondary_info = neighbor_info;
+            _snapshot.secondary_mac  = neighbor_mac_addresses[i];
+          }
+        }
+      }
+      sl_free(neighbor_mac_addresses);
+    }
+  }
+  _snapshot.neighbor_count = neighbor_count;
+
+  _snapshot.generation++;
+  _snapshot.refresh_msec = now_msec();
+  _snapshot_valid = true;
+}
@@ -0,0 +1,105 @@
+/***************************************************************************//**
+* @file app_stats_snapshot.h
+* @brief Shared snapshot of the Wi-SUN stack statistics Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+#ifndef APP_STATS_SNAPSHOT_H
+#define APP_STATS_SNAPSHOT_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sl_wisun_types.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Default snapshot validity, can be changed at runtime
+#ifndef   APP_STATS_SNAPSHOT_MAX_AGE_MS
+  #define APP_STATS_SNAPSHOT_MAX_AGE_MS 2000U
+#endif /* APP_STATS_SNAPSHOT_MAX_AGE_MS */
+
+// One coherent copy of everything the status messages and CoAP handlers read from the stack
+typedef struct {
+  uint32_t                 generation;      // incremented on each refresh from the stack
+  uint64_t                 refresh_msec;    // now_msec() at refresh time
+  // sl_wisun_statistics_t is a union, so we need one per statistics type
+  sl_wisun_statistics_t    phy;
+  sl_wisun_statistics_t    mac;
+  sl_wisun_statistics_t    fhss;
+  sl_wisun_statistics_t    wisun;
+  sl_wisun_statistics_t    network;
+  sl_wisun_statistics_t    regulation;
+  sl_wisun_network_info_t  network_info;
+  uint8_t                  neighbor_count;
+  sl_wisun_mac_address_t   parent_mac;      // all zeros if no primary parent
+  sl_wisun_neighbor_info_t parent_info;
+  sl_wisun_mac_address_t   secondary_mac;   // all zeros if no secondary parent
+  sl_wisun_neighbor_info_t secondary_info;
+} app_stats_snapshot_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Create the snapshot mutex, to be called once before any other function */
+void app_stats_snapshot_init(void);
+
+/**
+ * Lock the snapshot, refreshing it from the stack if older than the max age.
+ * Every call must be followed by app_stats_snapshot_release().
+ *
+ * @return pointer to the snapshot, valid until app_stats_snapshot_release()
+ */
+const app_stats_snapshot_t *app_stats_snapshot_acquire(void);
+
+/* Unlock the snapshot locked by app_stats_snapshot_acquire() */
+void app_stats_snapshot_release(void);
+
+/* Force a refresh on the next acquire (join state change, statistics reset) */
+void app_stats_snapshot_invalidate(void);
+
+/* Get/Set the snapshot max age in ms. 0 refreshes on every acquire */
+uint32_t app_stats_snapshot_get_max_age_ms(void);
+void app_stats_snapshot_set_max_age_ms(uint32_t max_age_ms);
+
+/* Hits/misses and stack API call counters, in json format */
+char* app_stats_snapshot_counters_string(char *buf, uint16_t size);
+void app_stats_snapshot_counters_reset(void);
+
+#endif /* APP_STATS_SNAPSHOT_H */
@@ -0,0 +1,61 @@
+/***************************************************************************//**
+* @file app_task_deadline.c
+* @brief Delay to the next app_task() deadline
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_task_deadline.h"
+#include "app_timestamp.h"
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+uint32_t app_task_deadline_msec(const uint64_t *deadlines_sec, uint8_t count,
+                                uint64_t connection_sec, uint32_t max_msec) {
+  uint64_t next_sec = UINT64_MAX;
+  uint64_t elapsed_msec;
+  uint64_t delay_msec;
+  uint8_t i;
+
+  for (i = 0; i < count; i++) {
+    if (deadlines_sec[i] < next_sec) { next_sec = deadlines_sec[i]; }
+  }
+  if (next_sec == UINT64_MAX) {
+    return max_msec;
+  }
+  elapsed_msec = now_msec() - connection_sec * 1000;
+  delay_msec = (next_sec * 1000 > elapsed_msec) ? next_sec * 1000 - elapsed_msec : 0;
+  return (delay_msec < max_msec) ? (uint32_t)delay_msec : max_msec;
+}
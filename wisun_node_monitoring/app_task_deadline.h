@@ -0,0 +1,64 @@
+/***************************************************************************//**
+* @file app_task_deadline.h
+* @brief Delay to the next app_task() deadline Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_TASK_DEADLINE_H
+#define APP_TASK_DEADLINE_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * app_task() waits for its events until its earliest deadline (status, heap
+ *  sample, button check, LED change), instead of polling. Deadlines are in
+ *  seconds since the connection (like connected_delay_sec), the delay is in
+ *  msec from now_msec().
+ */
+#define APP_TASK_DEADLINE_MAX_COUNT   4
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+/* Delay (msec) until the earliest of 'count' 'deadlines_sec' since 'connection_sec', 0 if passed, capped to 'max_msec' */
+uint32_t app_task_deadline_msec(const uint64_t *deadlines_sec, uint8_t count,
+                                uint64_t connection_sec, uint32_t max_msec);
+
+#endif /* APP_TASK_DEADLINE_H */
@@ -203,6 +203,10 @@ void _tcp_custom_callback(sl_wisun_evt_t *evt) {
       if (tcp_client_sockid == tcp_received_sockid) {
         tcp_data_length = recv(tcp_client_sockid, tcp_buff, SL_WISUN_TCP_SERVER_BUFF_SIZE - 1, 0);
         tcp_socket_data_received = (tcp_data_length > 0);
+        if (tcp_socket_data_received) {
+          // Let app_task() print the message without waiting for its next deadline
+          app_task_notify(APP_TASK_EVENT_SOCKET);
+        }
         if (tcp_data_length == 0) {
           tcp_r = close(tcp_client_sockid);
         }
@@ -36,8 +36,14 @@
 // -----------------------------------------------------------------------------
 //                                   Includes
 // -----------------------------------------------------------------------------
+#include "sl_component_catalog.h"
 #include "app_timestamp.h"
 #include "cmsis_os2.h"
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+  #include <stdarg.h>
+  #include <string.h>
+  #include "em_device.h"
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
 
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
@@ -61,6 +67,16 @@ char time_str[TIME_STRING_LEN];
 static uint64_t app_start_tick;
 static uint32_t app_tick_frequency_hz;
 
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+// Tokenized traces RTT buffer and counters
+static char     app_trace_tokens_rtt_buffer[APP_TRACE_TOKENS_RTT_BUFFER_SIZE];
+static bool     app_trace_tokens_configured = false;
+static uint32_t app_trace_tokens_records;
+static uint32_t app_trace_tokens_dropped;
+static uint64_t app_trace_tokens_bytes;
+static uint64_t app_trace_tokens_cycles;
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
+
 // Application timestamp mutex
 static osMutexId_t _app_timestamp_mutex = NULL;
 
@@ -162,14 +178,18 @@ sl_status_t  d_h_m_s      (sl_sleeptimer_timestamp_64_t timestamp_secs,
 }
 
 char*        dhms         (sl_sleeptimer_timestamp_64_t timestamp_secs) {
+  return dhms_r(timestamp_secs, time_str, TIME_STRING_LEN);
+}
+
+char*        dhms_r       (sl_sleeptimer_timestamp_64_t timestamp_secs, char *buf, uint16_t size) {
   uint16_t days;
   uint8_t  hours, mins, secs;
 
   d_h_m_s(timestamp_secs, &days, &hours, &mins, &secs);
 
-  snprintf(time_str, TIME_STRING_LEN, "%d-%02d:%02d:%02d", days, hours, mins, secs);
+  snprintf(buf, size, "%d-%02d:%02d:%02d", days, hours, mins, secs);
 
-  return time_str;
+  return buf;
 }
 
 uint64_t     now_sec      (void) {
@@ -192,6 +212,215 @@ uint64_t     now_sec      (void) {
   return (uint64_t)current_sec;
 }
 
+uint64_t     now_msec     (void) {
+  uint64_t current_tick;
+
+  if (app_tick_frequency_hz == 0U) {
+    app_tick_frequency_hz = sl_sleeptimer_get_timer_frequency();
+  }
+  if (app_tick_frequency_hz == 0U) {
+    return (uint64_t)app_timestamp * 1000ULL;
+  }
+  current_tick = sl_sleeptimer_get_tick_count64();
+  return ((current_tick - app_start_tick) * 1000ULL) / app_tick_frequency_hz;
+}
+
 char*        now_str     (void) {
   return dhms(now_sec());
 }
+
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+/* Append 'size' bytes to the record, false if it doesn't fit */
+static bool  _app_trace_token_append(uint8_t *record, uint16_t *len, const void *data, uint16_t size) {
+  if (*len + size > TIMESTAMP_MSG_LEN) {
+    return false;
+  }
+  memcpy(record + *len, data, size);
+  *len += size;
+  return true;
+}
+
+/* Append the arguments of 'format' to the record, in their binary form.
+ *  Returns false if they don't all fit */
+static bool  _app_trace_token_args(uint8_t *record, uint16_t *len, const char *format, va_list args) {
+  const char *f;
+  const char *s;
+  int32_t  i32;
+  uint32_t u32;
+  uint64_t u64;
+  double   d;
+  int32_t  precision;
+  bool     long_long;
+  uint16_t s_len;
+  bool     ok = true;
+
+  for (f = format; *f && ok; f++) {
+    if (*f != '%') {
+      continue;
+    }
+    f++;
+    if (*f == '%') {
+      continue;
+    }
+    // flags, width, precision
+    while (*f && strchr("-+ #0", *f)) { f++; }
+    if (*f == '*') {
+      i32 = va_arg(args, int);
+      ok &= _app_trace_token_append(record, len, &i32, sizeof(i32));
+      f++;
+    } else {
+      while ((*f >= '0') && (*f <= '9')) { f++; }
+    }
+    precision = -1;
+    if (*f == '.') {
+      f++;
+      if (*f == '*') {
+        precision = i32 = va_arg(args, int);
+        ok &= _app_trace_token_append(record, len, &i32, sizeof(i32));
+        f++;
+      } else {
+        for (precision = 0; (*f >= '0') && (*f <= '9'); f++) {
+          precision = precision * 10 + (*f - '0');
+        }
+      }
+    }
+    // length
+    long_long = false;
+    if (*f == 'h') {
+      f++;
+      if (*f == 'h') { f++; }
+    } else if (*f == 'l') {
+      f++;
+      if (*f == 'l') { long_long = true; f++; }
+    } else if (*f == 'j') {
+      long_long = true; f++;
+    } else if ((*f == 'z') || (*f == 't') || (*f == 'L')) {
+      f++;
+    }
+    switch (*f) {
+      case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+        if (long_long) {
+          u64 = va_arg(args, unsigned long long);
+          ok &= _app_trace_token_append(record, len, &u64, sizeof(u64));
+        } else {
+          u32 = va_arg(args, unsigned int);
+          ok &= _app_trace_token_append(record, len, &u32, sizeof(u32));
+        }
+        break;
+      case 'p':
+        u32 = (uint32_t)(uintptr_t)va_arg(args, void *);
+        ok &= _app_trace_token_append(record, len, &u32, sizeof(u32));
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        d = va_arg(args, double);
+        ok &= _app_trace_token_append(record, len, &d, sizeof(d));
+        break;
+      case 's':
+        s = va_arg(args, const char *);
+        if (s == NULL) { s = "(null)"; }
+        if (*len >= TIMESTAMP_MSG_LEN) {
+          return false;
+        }
+        s_len = (uint16_t)((precision >= 0) ? strnlen(s, (size_t)precision) : strlen(s));
+        if (*len + s_len + 1 > TIMESTAMP_MSG_LEN) {
+          // Keep what fits of the string
+          s_len = TIMESTAMP_MSG_LEN - 1 - *len;
+          ok = false;
+        }
+        memcpy(record + *len, s, s_len);
+        *len += s_len;
+        record[(*len)++] = '\0';
+        break;
+      case 'n':
+        (void)va_arg(args, void *);
+        break;
+      default:
+        // Unsupported conversion, or end of format
+        return false;
+    }
+  }
+  return ok;
+}
+
+void         app_trace_token(uint8_t flags, const char *format, ...) {
+  uint8_t *record = (uint8_t *)timestamped_msg_buffer;
+  uint16_t len = APP_TRACE_TOKEN_HEADER_LEN;
+  uint32_t address = (uint32_t)(uintptr_t)format;
+  uint32_t msec;
+  uint32_t start_cycles;
+  int      text_len;
+  va_list  args;
+
+  _app_timestamp_mutex_acquire();
+  if (!app_trace_tokens_configured) {
+    SEGGER_RTT_ConfigUpBuffer(APP_TRACE_TOKENS_RTT_CHANNEL, "AppTraceTokens",
+                              app_trace_tokens_rtt_buffer, APP_TRACE_TOKENS_RTT_BUFFER_SIZE,
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    // Cycle counter, for the cost of each record
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    app_trace_tokens_configured = true;
+  }
+  start_cycles = DWT->CYCCNT;
+  msec = (uint32_t)now_msec();
+
+  va_start(args, format);
+  if (address >= SRAM_BASE) {
+    // Format built at run time: the decoder can't find it in the application file
+    flags |= APP_TRACE_TOKEN_FLAG_TEXT;
+    text_len = vsnprintf((char *)record + len, TIMESTAMP_MSG_LEN - len, format, args);
+    if (text_len >= TIMESTAMP_MSG_LEN - len) {
+      flags |= APP_TRACE_TOKEN_FLAG_TRUNCATED;
+      text_len = TIMESTAMP_MSG_LEN - len - 1;
+    }
+    if (text_len > 0) {
+      len += (uint16_t)text_len;
+    }
+  } else {
+    _app_trace_token_append(record, &len, &address, sizeof(address));
+    if (!_app_trace_token_args(record, &len, format, args)) {
+      flags |= APP_TRACE_TOKEN_FLAG_TRUNCATED;
+    }
+  }
+  va_end(args);
+
+  record[0] = APP_TRACE_TOKEN_SYNC;
+  record[1] = (uint8_t)((len - 3) & 0xFF);
+  record[2] = (uint8_t)((len - 3) >> 8);
+  record[3] = flags;
+  memcpy(record + 4, &msec, sizeof(msec));
+  if (SEGGER_RTT_Write(APP_TRACE_TOKENS_RTT_CHANNEL, record, len) == len) {
+    app_trace_tokens_records++;
+    app_trace_tokens_bytes += len;
+  } else {
+    app_trace_tokens_dropped++;
+  }
+  app_trace_tokens_cycles += DWT->CYCCNT - start_cycles;
+  _app_timestamp_mutex_release();
+}
+
+char*        app_trace_tokens_string(char *buf, uint16_t size) {
+  uint32_t calls;
+
+  _app_timestamp_mutex_acquire();
+  calls = app_trace_tokens_records + app_trace_tokens_dropped;
+  snprintf(buf, size,
+           "{\"records\":%lu,\"dropped\":%lu,\"bytes\":%llu,\"avg_bytes\":%lu,\"avg_cycles\":%lu}",
+           (unsigned long)app_trace_tokens_records,
+           (unsigned long)app_trace_tokens_dropped,
+           (unsigned long long)app_trace_tokens_bytes,
+           (unsigned long)(app_trace_tokens_records ? app_trace_tokens_bytes / app_trace_tokens_records : 0),
+           (unsigned long)(calls ? app_trace_tokens_cycles / calls : 0));
+  _app_timestamp_mutex_release();
+  return buf;
+}
+
+void         app_trace_tokens_reset (void) {
+  _app_timestamp_mutex_acquire();
+  app_trace_tokens_records = 0;
+  app_trace_tokens_dropped = 0;
+  app_trace_tokens_bytes   = 0;
+  app_trace_tokens_cycles  = 0;
+  _app_timestamp_mutex_release();
+}
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
@@ -76,15 +76,45 @@
 extern char timestamped_msg_buffer[TIMESTAMP_MSG_LEN];
 extern char *timestamped_msg;
 
+/*
+ * Tokenized traces
+ * With APP_TRACE_TOKENS, printfRTT()/printfTimeRTT()/printfBoth()/printfBothTime() don't
+ *  format their message: they write a binary record on RTT up channel APP_TRACE_TOKENS_RTT_CHANNEL,
+ *  with the format string address, the timestamp and the raw arguments.
+ * linux_border_router_wsbrd/trace_token_decoder.py reads the format strings from the
+ *  application .axf/.out file and rebuilds the text. Messages are not copied to the console.
+ *
+ * Record: [APP_TRACE_TOKEN_SYNC][length (2 bytes)][flags][msec (4 bytes)][format address (4 bytes)][arguments]
+ *  (little endian, 'length' counts the bytes after itself)
+ *  arguments, in format order: '*' width/precision and integers on 4 bytes ('ll'/'j': 8 bytes),
+ *  floating point on 8 bytes, strings with their ending '\0'
+ *  With APP_TRACE_TOKEN_FLAG_TEXT (format not in flash), the formatted text replaces address and arguments
+ */
+// #define APP_TRACE_TOKENS
+#define APP_TRACE_TOKENS_RTT_CHANNEL      1
+#define APP_TRACE_TOKENS_RTT_BUFFER_SIZE  2048
+#define APP_TRACE_TOKEN_SYNC              0xA7
+#define APP_TRACE_TOKEN_HEADER_LEN        8   // up to msec
+#define APP_TRACE_TOKEN_FLAG_TIME         (1 << 0)  // printfTimeRTT()/printfBothTime()
+#define APP_TRACE_TOKEN_FLAG_TEXT         (1 << 1)  // formatted text instead of address and arguments
+#define APP_TRACE_TOKEN_FLAG_TRUNCATED    (1 << 2)  // arguments not fitting in TIMESTAMP_MSG_LEN are missing
+
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
 // -----------------------------------------------------------------------------
 #define printfTime(...)     printf("[%s] ", now_str()); printf(__VA_ARGS__)
 #ifdef    SL_CATALOG_SEGGER_RTT_PRESENT
+#ifdef    APP_TRACE_TOKENS
+ #define printfRTT(...)      app_trace_token(0, __VA_ARGS__)
+ #define printfTimeRTT(...)  app_trace_token(APP_TRACE_TOKEN_FLAG_TIME, __VA_ARGS__)
+ #define printfBoth(...)     app_trace_token(0, __VA_ARGS__)
+ #define printfBothTime(...) app_trace_token(APP_TRACE_TOKEN_FLAG_TIME, __VA_ARGS__)
+#else  /* APP_TRACE_TOKENS */
  #define printfRTT(...)      snprintf(timestamped_msg, TIMESTAMP_MSG_LEN, __VA_ARGS__); SEGGER_RTT_printf(0, timestamped_msg)
  #define printfTimeRTT(...)  snprintf(timestamped_msg, TIMESTAMP_MSG_LEN, __VA_ARGS__); SEGGER_RTT_printf(0, "[%s] %s", now_str(), timestamped_msg)
  #define printfBoth(...)     snprintf(timestamped_msg, TIMESTAMP_MSG_LEN, __VA_ARGS__); SEGGER_RTT_printf(0, timestamped_msg); printf(timestamped_msg)
  #define printfBothTime(...) snprintf(timestamped_msg, TIMESTAMP_MSG_LEN, __VA_ARGS__); SEGGER_RTT_printf(0, "[%s] %s", now_str(), timestamped_msg); printf("[%s] %s", now_str(), timestamped_msg)
+#endif /* APP_TRACE_TOKENS */
 #else  /* SL_CATALOG_SEGGER_RTT_PRESENT */
  #define printfRTT(...)      /* */
  #define printfTimeRTT(...)  /* */
@@ -166,6 +196,19 @@ sl_status_t d_h_m_s(sl_sleeptimer_timestamp_64_t timestamp_secs,
  *****************************************************************************/
 char* dhms(sl_sleeptimer_timestamp_64_t timestamp_secs);
 
+/**************************************************************************//**
+ * Sleep Timer seconds timestamp formatted to a caller-provided string
+ *
+ * @param timestamp_secs The timestamp value in seconds.
+ * @param buf The output string
+ * @param size The output string size
+ *
+ * @return buf
+ *
+ * Same as dhms(), without the shared static string, for use from any thread
+ *****************************************************************************/
+char* dhms_r(sl_sleeptimer_timestamp_64_t timestamp_secs, char *buf, uint16_t size);
+
 /**************************************************************************//**
  * Sleep Timer seconds timestamp formatted to string
  *
@@ -184,4 +227,37 @@ char*        now_str     (void);
  *****************************************************************************/
 uint64_t     now_sec      (void);
 
+/**************************************************************************//**
+ * Sleep Timer milliseconds timestamp
+ *
+ * @return The application timestamp in milliseconds
+ *
+ * Same reference as now_sec(), used when waiting for sub-second deadlines
+ *****************************************************************************/
+uint64_t     now_msec     (void);
+
+#if defined(SL_CATALOG_SEGGER_RTT_PRESENT) && defined(APP_TRACE_TOKENS)
+/**************************************************************************//**
+ * Tokenized trace record
+ *
+ * @param flags APP_TRACE_TOKEN_FLAG_TIME to show the timestamp
+ * @param format The printf format string
+ *
+ * Writes the record of a printfBoth()/printfBothTime() call on RTT channel
+ *  APP_TRACE_TOKENS_RTT_CHANNEL, without formatting the message
+ *****************************************************************************/
+void         app_trace_token(uint8_t flags, const char *format, ...);
+
+/**************************************************************************//**
+ * Tokenized traces counters
+ *
+ * @param buf The output string
+ * @param size The output string size
+ *
+ * @return buf, with the records count, average bytes and CPU cycles per record in json format
+ *****************************************************************************/
+char*        app_trace_tokens_string(char *buf, uint16_t size);
+void         app_trace_tokens_reset (void);
+#endif /* SL_CATALOG_SEGGER_RTT_PRESENT && APP_TRACE_TOKENS */
+
 #endif /* APP_TIMESTAMP_H */
@@ -0,0 +1,486 @@
+/***************************************************************************//**
+* @file app_tlv.c
+* @brief Compact TLV encoding of the notification messages
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include "app_tlv.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+// A 64-bit varint uses at most 10 bytes
+#define APP_TLV_VARINT_MAX_LEN  10
+
+// Longest json value, except strings (UINT_LIST of 5 64-bit values)
+#define APP_TLV_JSON_VALUE_MAX_LEN 128
+
+typedef struct {
+  uint8_t        id;
+  app_tlv_type_t type;
+  const char    *key;
+} app_tlv_field_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static uint8_t _app_tlv_varint(uint8_t *out, uint64_t value);
+static void    _app_tlv_put(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                            const uint8_t *value, uint16_t len);
+static uint16_t _app_tlv_field_len(const uint8_t *buf, uint16_t len, uint16_t offset);
+static const app_tlv_field_t *_app_tlv_field(uint8_t id);
+static uint8_t _app_tlv_read_varint(const uint8_t *in, uint8_t len, uint64_t *value);
+static void    _app_tlv_json_value(const app_tlv_field_t *field, const uint8_t *value,
+                                   uint8_t len, char *out, uint16_t size);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+#define APP_TLV_FIELD_ENTRY(name, id, type, key) { id, APP_TLV_TYPE_##type, key },
+static const app_tlv_field_t _app_tlv_fields[] = {
+  APP_TLV_FIELDS(APP_TLV_FIELD_ENTRY)
+};
+#undef  APP_TLV_FIELD_ENTRY
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_tlv_begin(app_tlv_writer_t *writer, uint8_t *buf, uint16_t size, uint8_t msg_type) {
+  writer->buf      = buf;
+  writer->size     = size;
+  writer->len      = 0;
+  writer->overflow = (size < APP_TLV_HEADER_LEN);
+  if (!writer->overflow) {
+    buf[writer->len++] = APP_TLV_MAGIC;
+    buf[writer->len++] = APP_TLV_VERSION;
+    buf[writer->len++] = msg_type;
+  }
+}
+
+void app_tlv_put_uint(app_tlv_writer_t *writer, app_tlv_field_id_t id, uint64_t value) {
+  uint8_t varint[APP_TLV_VARINT_MAX_LEN];
+
+  _app_tlv_put(writer, id, varint, _app_tlv_varint(varint, value));
+}
+
+void app_tlv_put_int(app_tlv_writer_t *writer, app_tlv_field_id_t id, int64_t value) {
+  uint8_t varint[APP_TLV_VARINT_MAX_LEN];
+
+  // Zigzag: small negative values stay short
+  _app_tlv_put(writer, id, varint, _app_tlv_varint(varint, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63)));
+}
+
+void app_tlv_put_uint_list(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                           const uint64_t *values, uint8_t count) {
+  uint8_t varints[255];
+  uint16_t len = 0;
+  uint8_t i;
+
+  for (i = 0; i < count; i++) {
+    if (len + APP_TLV_VARINT_MAX_LEN > (int)sizeof(varints)) {
+      writer->overflow = true;
+      return;
+    }
+    len += _app_tlv_varint(&varints[len], values[i]);
+  }
+  _app_tlv_put(writer, id, varints, len);
+}
+
+void app_tlv_put_str(app_tlv_writer_t *writer, app_tlv_field_id_t id, const char *str) {
+  _app_tlv_put(writer, id, (const uint8_t *)str, (uint16_t)strlen(str));
+}
+
+void app_tlv_put_bytes(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                       const uint8_t *bytes, uint8_t len) {
+  _app_tlv_put(writer, id, bytes, len);
+}
+
+uint16_t app_tlv_end(app_tlv_writer_t *writer) {
+  return writer->overflow ? 0 : writer->len;
+}
+
+void app_tlv_delta_reset(app_tlv_delta_t *delta) {
+  delta->keyframe_len = 0;
+}
+
+uint16_t app_tlv_delta_encode(app_tlv_delta_t *delta, uint16_t keyframe_interval,
+                              const uint8_t *record, uint16_t record_len,
+                              uint8_t *buf, uint16_t size) {
+  app_tlv_writer_t writer;
+  uint16_t i, k;
+  uint16_t record_field_len;
+  uint16_t keyframe_field_len;
+  bool keyframe;
+
+  if (record_len < APP_TLV_HEADER_LEN) {
+    return 0;
+  }
+  delta->seq++;
+  keyframe = (delta->keyframe_len == 0)
+          || (delta->seq - delta->keyframe_seq >= keyframe_interval)
+          || (record_len > sizeof(delta->keyframe))
+          || (record[2] != delta->keyframe[2]);
+
+  if (!keyframe) {
+    app_tlv_begin(&writer, buf, size, APP_TLV_MSG_STATUS_DELTA);
+    app_tlv_put_uint(&writer, APP_TLV_ID_SEQ, delta->seq);
+    app_tlv_put_uint(&writer, APP_TLV_ID_KEYFRAME_SEQ, delta->keyframe_seq);
+    // Records are built in a fixed field order: walk both side by side
+    i = k = APP_TLV_HEADER_LEN;
+    while ((i < record_len) && (k < delta->keyframe_len)) {
+      record_field_len   = _app_tlv_field_len(record, record_len, i);
+      keyframe_field_len = _app_tlv_field_len(delta->keyframe, delta->keyframe_len, k);
+      if ((record_field_len == 0) || (keyframe_field_len == 0) || (record[i] != delta->keyframe[k])) {
+        break;
+      }
+      if ((record_field_len != keyframe_field_len)
+       || memcmp(&record[i], &delta->keyframe[k], record_field_len)) {
+        _app_tlv_put(&writer, (app_tlv_field_id_t)record[i], &record[i + 2], record[i + 1]);
+      }
+      i += record_field_len;
+      k += keyframe_field_len;
+    }
+    // Different field list, or no gain compared to a keyframe
+    keyframe = (i != record_len) || (k != delta->keyframe_len)
+            || writer.overflow || (writer.len >= record_len);
+  }
+
+  if (keyframe) {
+    app_tlv_begin(&writer, buf, size, record[2]);
+    app_tlv_put_uint(&writer, APP_TLV_ID_SEQ, delta->seq);
+    if (writer.overflow || (writer.len + record_len - APP_TLV_HEADER_LEN > size)) {
+      delta->keyframe_len = 0;
+      return 0;
+    }
+    memcpy(&buf[writer.len], &record[APP_TLV_HEADER_LEN], record_len - APP_TLV_HEADER_LEN);
+    writer.len += record_len - APP_TLV_HEADER_LEN;
+    memcpy(delta->keyframe, record, record_len);
+    delta->keyframe_len = record_len;
+    delta->keyframe_seq = delta->seq;
+  }
+  return app_tlv_end(&writer);
+}
+
+app_tlv_batch_result_t app_tlv_batch_add(app_tlv_batch_t *batch, uint8_t *buf, uint16_t max_bytes,
+                                         uint8_t max_count, uint32_t max_age_sec, uint64_t now_sec,
+                                         const uint8_t *record, uint16_t record_len) {
+  uint16_t sample_len;
+
+  if (record_len < APP_TLV_HEADER_LEN) {
+    return APP_TLV_BATCH_TOO_LONG;
+  }
+  sample_len = record_len - APP_TLV_HEADER_LEN;
+  // Room for the sample and the final RUNNING field
+  if ((sample_len > 255) || (APP_TLV_HEADER_LEN + 2 + sample_len + APP_TLV_BATCH_TAIL_LEN > max_bytes)) {
+    return APP_TLV_BATCH_TOO_LONG;
+  }
+  if (batch->count && (batch->writer.len + 2 + sample_len + APP_TLV_BATCH_TAIL_LEN > batch->writer.size)) {
+    return APP_TLV_BATCH_FULL;
+  }
+  if (batch->count == 0) {
+    app_tlv_begin(&batch->writer, buf, max_bytes, APP_TLV_MSG_BATCH);
+    batch->first_sample_sec = now_sec;
+  }
+  app_tlv_put_bytes(&batch->writer, APP_TLV_ID_SAMPLE, &record[APP_TLV_HEADER_LEN], (uint8_t)sample_len);
+  batch->count++;
+
+  // Also ready when a next sample of the same size would not fit, rather than one period later
+  if ((batch->count >= max_count)
+   || (now_sec - batch->first_sample_sec >= max_age_sec)
+   || (batch->writer.len + 2 + sample_len + APP_TLV_BATCH_TAIL_LEN > batch->writer.size)) {
+    return APP_TLV_BATCH_READY;
+  }
+  return APP_TLV_BATCH_ADDED;
+}
+
+uint16_t app_tlv_batch_end(app_tlv_batch_t *batch, uint64_t now_sec) {
+  if (batch->count == 0) {
+    return 0;
+  }
+  app_tlv_put_uint(&batch->writer, APP_TLV_ID_RUNNING, now_sec);
+  batch->count = 0;
+  return app_tlv_end(&batch->writer);
+}
+
+bool app_tlv_selected(const char *key, const char *selectors) {
+  const char *selector = selectors;
+  size_t len;
+
+  if ((selectors == NULL) || (*selectors == '\0')) {
+    return true;
+  }
+  while (*selector) {
+    len = strcspn(selector, ",; ");
+    if (len) {
+      if (selector[len - 1] == '*') {
+        if (!strncmp(key, selector, len - 1)) {
+          return true;
+        }
+      } else if ((strlen(key) == len) && !strncmp(key, selector, len)) {
+        return true;
+      }
+      selector += len;
+    } else {
+      selector++;
+    }
+  }
+  return false;
+}
+
+uint16_t app_tlv_select(const uint8_t *record, uint16_t record_len, const char *selectors,
+                        uint8_t *buf, uint16_t size) {
+  const app_tlv_field_t *field;
+  uint16_t offset;
+  uint16_t field_len;
+  uint16_t len;
+
+  if ((record_len < APP_TLV_HEADER_LEN) || (size < APP_TLV_HEADER_LEN)) {
+    return 0;
+  }
+  memcpy(buf, record, APP_TLV_HEADER_LEN);
+  len = APP_TLV_HEADER_LEN;
+  for (offset = APP_TLV_HEADER_LEN;
+       (field_len = _app_tlv_field_len(record, record_len, offset)) != 0;
+       offset += field_len) {
+    field = _app_tlv_field(record[offset]);
+    if ((field == NULL) || !app_tlv_selected(field->key, selectors)) {
+      continue;
+    }
+    if (len + field_len > size) {
+      return 0;
+    }
+    memcpy(buf + len, record + offset, field_len);
+    len += field_len;
+  }
+  return len;
+}
+
+uint16_t app_tlv_json(const uint8_t *record, uint16_t record_len, const char *selectors,
+                      char *buf, uint16_t size) {
+  const app_tlv_field_t *field;
+  char value[APP_TLV_JSON_VALUE_MAX_LEN];
+  uint16_t offset;
+  uint16_t field_len;
+  uint16_t len;
+  int n;
+
+  if (size < 3) {
+    return 0;
+  }
+  buf[0] = '{';
+  len = 1;
+  for (offset = APP_TLV_HEADER_LEN;
+       (field_len = _app_tlv_field_len(record, record_len, offset)) != 0;
+       offset += field_len) {
+    field = _app_tlv_field(record[offset]);
+    if ((field == NULL) || !app_tlv_selected(field->key, selectors)) {
+      continue;
+    }
+    if (field->type == APP_TLV_TYPE_STR) {
+      n = snprintf(buf + len, size - len, "%s\"%s\":\"%.*s\"", (len > 1) ? "," : "",
+                   field->key, record[offset + 1], (const char *)&record[offset + 2]);
+    } else {
+      _app_tlv_json_value(field, &record[offset + 2], record[offset + 1], value, sizeof(value));
+      n = snprintf(buf + len, size - len, "%s\"%s\":\"%s\"", (len > 1) ? "," : "",
+                   field->key, value);
+    }
+    if ((n < 0) || (n >= size - len)) {
+      return 0;
+    }
+    len += n;
+  }
+  if (len + 2 > size) {
+    return 0;
+  }
+  buf[len++] = '}';
+  buf[len] = '\0';
+  return len;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+// Unsigned LEB128: 7 bits per byte, MSB set on all bytes but the last
+static uint8_t _app_tlv_varint(uint8_t *out, uint64_t value) {
+  uint8_t len = 0;
+
+  do {
+    out[len] = (uint8_t)(value & 0x7F);
+    value >>= 7;
+    if (value) {
+      out[len] |= 0x80;
+    }
+    len++;
+  } while (value);
+  return len;
+}
+
+// Length of the field at offset (id, len and value), 0 if truncated
+static uint16_t _app_tlv_field_len(const uint8_t *buf, uint16_t len, uint16_t offset) {
+  if ((offset + 2 > len) || (offset + 2 + buf[offset + 1] > len)) {
+    return 0;
+  }
+  return 2 + buf[offset + 1];
+}
+
+static void _app_tlv_put(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                         const uint8_t *value, uint16_t len) {
+  if (writer->overflow) {
+    return;
+  }
+  // Values are limited to 255 bytes, longer strings are truncated
+  if (len > 255) {
+    len = 255;
+  }
+  if (writer->len + 2 + len > writer->size) {
+    writer->overflow = true;
+    return;
+  }
+  writer->buf[writer->len++] = (uint8_t)id;
+  writer->buf[writer->len++] = (uint8_t)len;
+  memcpy(&writer->buf[writer->len], value, len);
+  writer->len += len;
+}
+
+static const app_tlv_field_t *_app_tlv_field(uint8_t id) {
+  uint8_t i;
+
+  // IDs are mostly consecutive, starting at 1
+  if ((id > 0) && (id <= sizeof(_app_tlv_fields) / sizeof(_app_tlv_fields[0]))
+      && (_app_tlv_fields[id - 1].id == id)) {
+    return &_app_tlv_fields[id - 1];
+  }
+  for (i = 0; i < sizeof(_app_tlv_fields) / sizeof(_app_tlv_fields[0]); i++) {
+    if (_app_tlv_fields[i].id == id) {
+      return &_app_tlv_fields[i];
+    }
+  }
+  return NULL;
+}
+
+static uint8_t _app_tlv_read_varint(const uint8_t *in, uint8_t len, uint64_t *value) {
+  uint8_t i;
+  uint8_t shift = 0;
+
+  *value = 0;
+  for (i = 0; (i < len) && (i < APP_TLV_VARINT_MAX_LEN); i++) {
+    *value |= (uint64_t)(in[i] & 0x7F) << shift;
+    shift += 7;
+    if (!(in[i] & 0x80)) {
+      return i + 1;
+    }
+  }
+  return i;
+}
+
+static void _app_tlv_json_value(const app_tlv_field_t *field, const uint8_t *value,
+                                uint8_t len, char *out, uint16_t size) {
+  uint64_t number = 0;
+  uint16_t words[8];
+  uint16_t out_len = 0;
+  uint8_t  offset = 0;
+  uint8_t  used;
+  int8_t   zeros = -1;
+  uint8_t  zeros_len = 0;
+  uint8_t  i;
+  uint8_t  j;
+
+  out[0] = '\0';
+  switch (field->type) {
+    case APP_TLV_TYPE_UINT_LIST:
+      while (offset < len) {
+        used = _app_tlv_read_varint(value + offset, len - offset, &number);
+        offset += used;
+        out_len += snprintf(out + out_len, size - out_len, "%s%llu", out_len ? " " : "",
+                            (unsigned long long)number);
+        if ((used == 0) || (out_len >= size)) {
+          break;
+        }
+      }
+      break;
+    case APP_TLV_TYPE_IPV6:
+      if (len != 16) {
+        break;
+      }
+      // Compressed form: the longest run of zero words is replaced by "::"
+      for (i = 0; i < 8; i++) {
+        words[i] = (uint16_t)((value[2 * i] << 8) | value[2 * i + 1]);
+      }
+      for (i = 0; i < 8; i = j + 1) {
+        for (j = i; (j < 8) && (words[j] == 0); j++) ;
+        if ((j - i > 1) && (j - i > zeros_len)) {
+          zeros = (int8_t)i;
+          zeros_len = j - i;
+        }
+      }
+      for (i = 0; (i < 8) && (out_len < size); i++) {
+        if (i == zeros) {
+          out_len += snprintf(out + out_len, size - out_len, "::");
+          i += zeros_len - 1;
+          continue;
+        }
+        out_len += snprintf(out + out_len, size - out_len, "%s%x",
+                            ((i > 0) && (i != zeros + zeros_len)) ? ":" : "", words[i]);
+      }
+      break;
+    case APP_TLV_TYPE_MAC:
+    case APP_TLV_TYPE_RECORD:
+      for (i = 0; (i < len) && (out_len < size); i++) {
+        out_len += snprintf(out + out_len, size - out_len,
+                            ((field->type == APP_TLV_TYPE_MAC) && i) ? ":%02x" : "%02x", value[i]);
+      }
+      break;
+    default:
+      (void)_app_tlv_read_varint(value, len, &number);
+      if (field->type == APP_TLV_TYPE_HEX16) {
+        snprintf(out, size, "0x%04x (%u)", (uint16_t)number, (uint16_t)number);
+      } else if (field->type == APP_TLV_TYPE_CENTI) {
+        snprintf(out, size, "%llu.%02u", (unsigned long long)(number / 100), (uint8_t)(number % 100));
+      } else if (field->type == APP_TLV_TYPE_SINT) {
+        snprintf(out, size, "%lld", (long long)((number >> 1) ^ (~(number & 1) + 1)));
+      } else if (field->type == APP_TLV_TYPE_DHMS) {
+        snprintf(out, size, "%llu-%02u:%02u:%02u", (unsigned long long)(number / 86400),
+                 (uint8_t)((number / 3600) % 24), (uint8_t)((number / 60) % 60), (uint8_t)(number % 60));
+      } else {
+        snprintf(out, size, "%llu", (unsigned long long)number);
+      }
+      break;
+  }
+}
@@ -0,0 +1,307 @@
+/***************************************************************************//**
+* @file app_tlv.h
+* @brief Compact TLV encoding of the notification messages Header file
+*******************************************************************************
+* # License
+* <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+******************************************************************************
+*
+* EXPERIMENTAL QUALITY
+* This code has not been formally tested and is provided as-is.  It is not suitable for production environments.
+* This code will not be maintained.
+*
+******************************************************************************/
+
+
+#ifndef APP_TLV_H
+#define APP_TLV_H
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/*
+ * Message layout (all multi-byte integers are unsigned LEB128 varints):
+ *   [APP_TLV_MAGIC][APP_TLV_VERSION][msg_type] { [field_id][len][value] }*
+ * Field IDs and value types are mirrored in
+ *  linux_border_router_wsbrd/udp_notification_receiver.py: never reuse an ID.
+ * A JSON text message always starts with '{', so both formats can share a port.
+ *
+ * Delta status messages (see app_tlv_delta_encode()):
+ *  keyframe: [header: APP_TLV_MSG_STATUS][SEQ] { all status fields }*
+ *  delta:    [header: APP_TLV_MSG_STATUS_DELTA][SEQ][KEYFRAME_SEQ] { changed fields }*
+ *  The receiver rebuilds a delta from the keyframe with sequence number KEYFRAME_SEQ,
+ *  and drops deltas until the next keyframe if this keyframe was lost.
+ *
+ * Batched status messages:
+ *  [header: APP_TLV_MSG_BATCH] { [SAMPLE] }* [RUNNING]
+ *  Each SAMPLE value holds the fields of one status record (without header).
+ *  The receiver time-stamps each sample from its own RUNNING value,
+ *  relative to the RUNNING value of the batch (when it was sent).
+ */
+#define APP_TLV_MAGIC           0xB5
+#define APP_TLV_VERSION         1
+#define APP_TLV_HEADER_LEN      3
+
+// Notification formats, selected by app_parameters.notification_format
+#define APP_NOTIFICATION_FORMAT_JSON  0
+#define APP_NOTIFICATION_FORMAT_TLV   1
+
+// Message types
+#define APP_TLV_MSG_STATUS      1
+#define APP_TLV_MSG_CONNECTION  2
+#define APP_TLV_MSG_STATUS_DELTA 3
+#define APP_TLV_MSG_BATCH       4
+
+// Largest status record kept as a keyframe
+#define APP_TLV_KEYFRAME_MAX_LEN 256
+
+// Room kept at the end of a batch for its final RUNNING field
+#define APP_TLV_BATCH_TAIL_LEN  12
+
+// Value types (how the receiver displays a field)
+//  UINT:      varint
+//  SINT:      zigzag varint (0, -1, 1, -2...)
+//  UINT_LIST: concatenated varints, displayed space-separated
+//  HEX16:     varint, displayed as "0x%04x (%d)"
+//  CENTI:     varint in 1/100 units, displayed as "%6.2f"
+//  DHMS:      varint seconds, displayed as "d-hh:mm:ss"
+//  STR:       raw characters
+//  IPV6:      16 bytes, displayed as a compressed IPv6 string
+//  MAC:       8 bytes, displayed as "xx:xx:xx:xx:xx:xx:xx:xx"
+//  RECORD:    nested fields, without header
+//
+//           name                             , id, type     , json key
+#define APP_TLV_FIELDS(X) \
+  X(IPV6                                      ,  1, IPV6     , "ipv6")                            \
+  X(DEVICE                                    ,  2, STR      , "device")                          \
+  X(CHIP                                      ,  3, STR      , "chip")                            \
+  X(TYPE                                      ,  4, STR      , "type")                            \
+  X(MAC                                       ,  5, MAC      , "MAC")                             \
+  X(PARENT                                    ,  6, STR      , "parent")                          \
+  X(RPL_RANK                                  ,  7, UINT     , "rpl_rank")                        \
+  X(ETX                                       ,  8, UINT     , "etx")                             \
+  X(ROUTING_COST                              ,  9, UINT     , "routing_cost")                    \
+  X(RSL_IN                                    , 10, UINT     , "rsl_in")                          \
+  X(RSL_OUT                                   , 11, UINT     , "rsl_out")                         \
+  X(RUNNING                                   , 12, DHMS     , "running")                         \
+  X(MSG_COUNT                                 , 13, UINT     , "msg_count")                       \
+  X(HEAP_USED                                 , 14, CENTI    , "heap_used")                       \
+  X(JOIN_STATE                                , 15, UINT     , "join_state")                      \
+  X(CONNECTED                                 , 16, DHMS     , "connected")                       \
+  X(DISCONNECTED                              , 17, DHMS     , "disconnected")                    \
+  X(CONNECTIONS                               , 18, UINT     , "connections")                     \
+  X(NETWORK_CONNECTIONS                       , 19, UINT     , "network_connections")             \
+  X(AVAILABILITY                              , 20, CENTI    , "availability")                    \
+  X(CONNECTED_TOTAL                           , 21, DHMS     , "connected_total")                 \
+  X(DISCONNECTED_TOTAL                        , 22, DHMS     , "disconnected_total")              \
+  X(HOP_COUNT                                 , 23, UINT     , "hop_count")                       \
+  X(PHY_CRC_FAILS                             , 24, UINT     , "phy.crc_fails")                   \
+  X(PHY_TX_TIMEOUTS                           , 25, UINT     , "phy.tx_timeouts")                 \
+  X(PHY_RX_TIMEOUTS                           , 26, UINT     , "phy.rx_timeouts")                 \
+  X(MAC_FAILED_CCA_COUNT                      , 27, UINT     , "mac.failed_cca_count")            \
+  X(MAC_TX_COUNT                              , 28, UINT     , "mac.tx_count")                    \
+  X(MAC_TX_FAILED_COUNT                       , 29, UINT     , "mac.tx_failed_count")             \
+  X(MAC_RX_COUNT                              , 30, UINT     , "mac.rx_count")                    \
+  X(MAC_RX_AVAILABILITY_PERCENTAGE            , 31, UINT     , "mac.rx_availability_percentage")  \
+  X(NETWORK_IP_NO_ROUTE                       , 32, UINT     , "network.ip_no_route")             \
+  X(NETWORK_IP_ROUTELOOP_DETECT               , 33, UINT     , "network.ip_routeloop_detect")     \
+  X(PAN_ID                                    , 34, HEX16    , "PAN_ID")                          \
+  X(PREFERRED_PAN_ID                          , 35, HEX16    , "preferred_pan_id")                \
+  X(JOIN_STATES_SEC                           , 36, UINT_LIST, "join_states_sec")                 \
+  X(APPLICATION                               , 37, STR      , "application")                     \
+  X(SEQ                                       , 38, UINT     , "seq")                             \
+  X(KEYFRAME_SEQ                              , 39, UINT     , "keyframe_seq")                    \
+  X(SAMPLE                                    , 40, RECORD   , "sample")                          \
+  X(VERSION                                   , 41, STR      , "version")                         \
+  X(BOARD                                     , 42, STR      , "board")                           \
+  X(NEIGHBOR_COUNT                            , 43, UINT     , "neighbor_count")                  \
+  X(PARENT_MAC_TX_COUNT                       , 44, UINT     , "parent.mac_tx_count")             \
+  X(PARENT_MAC_TX_FAILED_COUNT                , 45, UINT     , "parent.mac_tx_failed_count")      \
+  X(SECONDARY                                 , 46, STR      , "secondary")                       \
+  X(SECONDARY_RPL_RANK                        , 47, UINT     , "secondary.rpl_rank")              \
+  X(SECONDARY_ETX                             , 48, UINT     , "secondary.etx")                   \
+  X(SECONDARY_RSL_IN                          , 49, UINT     , "secondary.rsl_in")                \
+  X(SECONDARY_RSL_OUT                         , 50, UINT     , "secondary.rsl_out")               \
+  X(SECONDARY_MAC_TX_COUNT                    , 51, UINT     , "secondary.mac_tx_count")          \
+  X(SECONDARY_MAC_TX_FAILED_COUNT             , 52, UINT     , "secondary.mac_tx_failed_count")   \
+  X(FHSS_DRIFT_COMPENSATION                   , 53, SINT     , "fhss.drift_compensation")         \
+  X(FHSS_HOP_COUNT                            , 54, UINT     , "fhss.hop_count")                  \
+  X(FHSS_SYNCH_INTERVAL                       , 55, UINT     , "fhss.synch_interval")             \
+  X(FHSS_PREV_AVG_SYNCH_FIX                   , 56, SINT     , "fhss.prev_avg_synch_fix")         \
+  X(FHSS_SYNCH_LOST                           , 57, UINT     , "fhss.synch_lost")                 \
+  X(FHSS_UNKNOWN_NEIGHBOR                     , 58, UINT     , "fhss.unknown_neighbor")           \
+  X(WISUN_PAN_CONTROL_TX_COUNT                , 59, UINT     , "wisun.pan_control_tx_count")      \
+  X(WISUN_PAN_CONTROL_RX_COUNT                , 60, UINT     , "wisun.pan_control_rx_count")      \
+  X(REGULATION_ARIB_TX_DURATION_MS            , 61, UINT     , "regulation.arib.tx_duration_ms")
+
+#define APP_TLV_FIELD_ID(name, id, type, key) APP_TLV_ID_##name = id,
+typedef enum {
+  APP_TLV_FIELDS(APP_TLV_FIELD_ID)
+} app_tlv_field_id_t;
+#undef  APP_TLV_FIELD_ID
+
+typedef enum {
+  APP_TLV_TYPE_UINT,
+  APP_TLV_TYPE_SINT,
+  APP_TLV_TYPE_UINT_LIST,
+  APP_TLV_TYPE_HEX16,
+  APP_TLV_TYPE_CENTI,
+  APP_TLV_TYPE_DHMS,
+  APP_TLV_TYPE_STR,
+  APP_TLV_TYPE_IPV6,
+  APP_TLV_TYPE_MAC,
+  APP_TLV_TYPE_RECORD,
+} app_tlv_type_t;
+
+// Encoding context, all writes are bounds-checked against size
+typedef struct {
+  uint8_t  *buf;
+  uint16_t size;
+  uint16_t len;
+  bool     overflow;
+} app_tlv_writer_t;
+
+// Delta encoding context, one per message stream
+typedef struct {
+  uint8_t  keyframe[APP_TLV_KEYFRAME_MAX_LEN]; // last record sent in full, without SEQ
+  uint16_t keyframe_len;                       // 0: next message is a keyframe
+  uint32_t keyframe_seq;
+  uint32_t seq;                                // last sequence number sent
+} app_tlv_delta_t;
+
+// Batch of status samples, one per message stream
+typedef struct {
+  app_tlv_writer_t writer;
+  uint8_t  count;                              // samples in the batch, 0: no batch started
+  uint64_t first_sample_sec;
+} app_tlv_batch_t;
+
+// Result of app_tlv_batch_add()
+typedef enum {
+  APP_TLV_BATCH_ADDED,                         // added, more samples can be added
+  APP_TLV_BATCH_READY,                         // added, the batch must be sent now
+  APP_TLV_BATCH_FULL,                          // not added: send the batch, then add again
+  APP_TLV_BATCH_TOO_LONG,                      // not added: never fits, send the record alone
+} app_tlv_batch_result_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/* Start a message of msg_type in buf */
+void app_tlv_begin(app_tlv_writer_t *writer, uint8_t *buf, uint16_t size, uint8_t msg_type);
+
+/* Append one field */
+void app_tlv_put_uint(app_tlv_writer_t *writer, app_tlv_field_id_t id, uint64_t value);
+void app_tlv_put_int(app_tlv_writer_t *writer, app_tlv_field_id_t id, int64_t value);
+void app_tlv_put_uint_list(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                           const uint64_t *values, uint8_t count);
+void app_tlv_put_str(app_tlv_writer_t *writer, app_tlv_field_id_t id, const char *str);
+void app_tlv_put_bytes(app_tlv_writer_t *writer, app_tlv_field_id_t id,
+                       const uint8_t *bytes, uint8_t len);
+
+/**
+ * Complete the message.
+ *
+ * @return the message length, 0 if the buffer was too small
+ */
+uint16_t app_tlv_end(app_tlv_writer_t *writer);
+
+/* Force a keyframe for the next app_tlv_delta_encode() call */
+void app_tlv_delta_reset(app_tlv_delta_t *delta);
+
+/**
+ * Encode a complete record as a keyframe or as a delta against the last keyframe.
+ *
+ * A keyframe is sent every keyframe_interval messages, or earlier when the
+ *  record fields are not the same as in the keyframe (such as 'connected'
+ *  replaced by 'disconnected') or when the delta would not be shorter.
+ *
+ * @param record, record_len  full record, as built with app_tlv_begin()/app_tlv_end()
+ * @param buf, size           output buffer
+ * @return the message length, 0 if the buffer was too small
+ */
+uint16_t app_tlv_delta_encode(app_tlv_delta_t *delta, uint16_t keyframe_interval,
+                              const uint8_t *record, uint16_t record_len,
+                              uint8_t *buf, uint16_t size);
+
+/**
+ * Add a status record to a batch, as a SAMPLE field (without the record header).
+ *
+ * A batch is started in buf on the first sample. It is ready once it holds max_count
+ *  samples, once its first sample is max_age_sec old, or once a next sample of the
+ *  same size would not fit in max_bytes.
+ *
+ * @param buf, max_bytes  batch message buffer, used from the first sample until
+ *                        app_tlv_batch_end()
+ * @param now_sec         current time, in seconds
+ */
+app_tlv_batch_result_t app_tlv_batch_add(app_tlv_batch_t *batch, uint8_t *buf, uint16_t max_bytes,
+                                         uint8_t max_count, uint32_t max_age_sec, uint64_t now_sec,
+                                         const uint8_t *record, uint16_t record_len);
+
+/**
+ * Complete a batch with its RUNNING field (the receiver time-stamps the samples
+ *  relative to it), and start a new one on the next sample.
+ *
+ * @return the message length, 0 if the batch was empty
+ */
+uint16_t app_tlv_batch_end(app_tlv_batch_t *batch, uint64_t now_sec);
+
+/**
+ * Check if a field is selected.
+ *
+ * @param key        field json key, from APP_TLV_FIELDS
+ * @param selectors  list of keys separated by ',', ' ' or ';'. A key ending
+ *                   with '*' selects all keys with this prefix ("mac.*"),
+ *                   "*" or an empty list selects all fields
+ */
+bool app_tlv_selected(const char *key, const char *selectors);
+
+/**
+ * Copy the selected fields of a record.
+ *
+ * @param record, record_len  full record, as built with app_tlv_begin()/app_tlv_end()
+ * @return the message length, 0 if the buffer was too small
+ */
+uint16_t app_tlv_select(const uint8_t *record, uint16_t record_len, const char *selectors,
+                        uint8_t *buf, uint16_t size);
+
+/**
+ * Compact (single line) json text of the selected fields of a record,
+ *  with the same value formats as udp_notification_receiver.py
+ *
+ * @return the text length, 0 if the buffer was too small
+ */
+uint16_t app_tlv_json(const uint8_t *record, uint16_t record_len, const char *selectors,
+                      char *buf, uint16_t size);
+
+#endif /* APP_TLV_H */
@@ -58,7 +58,7 @@
 #endif /* APP_VERSION_STRING */
 
 #ifndef   NVM3_APP_PARAMS_VERSION
-  #define NVM3_APP_PARAMS_VERSION   10011
+  #define NVM3_APP_PARAMS_VERSION   10014
 #endif /* NVM3_APP_PARAMS_VERSION */
 
 #ifndef   MAX_NETWORK_CONFIGS
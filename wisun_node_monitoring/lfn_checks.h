@@ -70,8 +70,8 @@
 #endif
 
 #include "sl_wisun_coap_config.h"
-#if (SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES  !=  50U)
-  #pragma message("SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES  !=  50U")
+#if (SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES  !=  64U)
+  #pragma message("SL_WISUN_COAP_RESOURCE_HND_MAX_RESOURCES  !=  64U")
 #endif
 
 #if (SL_WISUN_COAP_RESOURCE_HND_STACK_SIZE_WORD  !=  1024)
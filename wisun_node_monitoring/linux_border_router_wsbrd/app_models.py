@@ -0,0 +1,204 @@
+#!/usr/bin/env python
+# Host models of Wi-SUN Node Monitoring application algorithms, to check their
+#  behavior and size their parameters without a network
+# Call with
+# app_models.py <model> [arguments]
+
+import random
+import sys
+
+help_text = """
+# The models mirror the application code: keep them in sync when changing it
+#  app_models.py group_leisure [group_size] [response_bytes] [rate_bps] [buffer_bytes]
+#   Responses of a group to a 'g=<group_size>' CoAP request, queued near the Border Router,
+#   for several leisure caps (app_coap.c app_coap_group_leisure_ms())
+#  app_models.py rtt_fill [period_ms] [lines_per_sec] [burst_lines] [burst_every_sec] [rtt_size] [duration_sec]
+#   RTT up buffer fill and drains of the reporter (app_reporter.c), with a fixed period,
+#   a period adapted to the fill level (previous), and a period from the fill rate (current),
+#   with the lost bytes and their estimate by the reporter
+# All models use a fixed random seed, set another one with '-s <seed>'
+"""
+
+# -----------------------------------------------------------------------------
+# Common
+# -----------------------------------------------------------------------------
+def int_arg(args, i, default):
+  return int(args[i]) if len(args) > i else default
+
+# -----------------------------------------------------------------------------
+# group_leisure: app_coap.c app_coap_group_leisure_ms()
+# -----------------------------------------------------------------------------
+APP_COAP_GROUP_DATA_RATE_BPS  = 1000
+APP_COAP_GROUP_MAX_LEISURE_MS = 60000
+COAP_GROUP_HEADERS_LEN        = 24
+
+def group_leisure_ms(response_len, group_size, max_leisure_ms):
+  leisure_ms = (response_len + COAP_GROUP_HEADERS_LEN) * group_size * 1000 // APP_COAP_GROUP_DATA_RATE_BPS
+  if max_leisure_ms is not None:
+    leisure_ms = min(leisure_ms, max_leisure_ms)
+  return leisure_ms
+
+def group_leisure_run(rng, group_size, response_len, rate_bps, buffer_bytes, leisure_ms):
+  """ Responses sent after a random delay in [0, leisure_ms[, drained at rate_bps
+       from a buffer_bytes queue (dropped when full) """
+  size = response_len + COAP_GROUP_HEADERS_LEN
+  delays = sorted(rng.randrange(leisure_ms) if leisure_ms else 0 for _ in range(group_size))
+  backlog = 0.0
+  max_backlog = 0.0
+  dropped = 0
+  last_ms = 0
+  for delay in delays:
+    backlog = max(0.0, backlog - (delay - last_ms) * rate_bps / 1000)
+    last_ms = delay
+    if backlog + size > buffer_bytes:
+      dropped += 1
+    else:
+      backlog += size
+      max_backlog = max(max_backlog, backlog)
+  return {
+    "avg_wait_ms": sum(delays) // len(delays) if delays else 0,
+    "max_wait_ms": delays[-1] if delays else 0,
+    "max_backlog": int(max_backlog),
+    "dropped_pct": 100.0 * dropped / group_size if group_size else 0,
+    "done_ms": int(last_ms + backlog * 1000 / rate_bps),
+  }
+
+def group_leisure(rng, args):
+  group_size   = int_arg(args, 0, 200)
+  response_len = int_arg(args, 1, 100)
+  rate_bps     = int_arg(args, 2, APP_COAP_GROUP_DATA_RATE_BPS)
+  buffer_bytes = int_arg(args, 3, 4096)
+  print(f"{group_size} devices answering {response_len} bytes, {rate_bps} bytes/s near the Border Router, "
+        f"{buffer_bytes} bytes queued at most")
+  print(f"'wait' is the deferral of each response, sent by app_task() (no thread waits)")
+  print(f"{'cap':18} {'leisure':>9} {'avg_wait':>9} {'max_wait':>9} {'max_queue':>10} {'dropped':>8} {'all_done':>9}")
+  caps = (("none (RFC 7252)", None),
+          (f"{APP_COAP_GROUP_MAX_LEISURE_MS} ms (default)", APP_COAP_GROUP_MAX_LEISURE_MS),
+          ("2000 ms", 2000),
+          ("0 ms (port 5683)", 0))
+  for name, cap in caps:
+    leisure_ms = group_leisure_ms(response_len, group_size, cap)
+    r = group_leisure_run(rng, group_size, response_len, rate_bps, buffer_bytes, leisure_ms)
+    print(f"{name:18} {leisure_ms:7} ms {r['avg_wait_ms']:6} ms {r['max_wait_ms']:6} ms "
+          f"{r['max_backlog']:10} {r['dropped_pct']:7.1f}% {r['done_ms']:6} ms")
+
+# -----------------------------------------------------------------------------
+# rtt_fill: app_reporter.c reporter_adapt_period()
+# -----------------------------------------------------------------------------
+REPORTER_MIN_PERIOD_MS     = 20
+REPORTER_MAX_PERIOD_FACTOR = 16
+REPORTER_HIGH_WATER_PCT    = 50
+REPORTER_LOW_WATER_PCT     = 10
+REPORTER_NEAR_FULL_MARGIN  = 128
+
+def rtt_fill_lines(rng, lines_per_sec, burst_lines, burst_every_sec, duration_sec):
+  """ (time_ms, length) of the trace lines: random background lines, plus bursts
+       of burst_lines within 100 ms every burst_every_sec """
+  lines = []
+  for _ in range(lines_per_sec * duration_sec):
+    lines.append((rng.randrange(duration_sec * 1000), rng.randrange(40, 121)))
+  if burst_every_sec:
+    for start in range(burst_every_sec * 1000, duration_sec * 1000, burst_every_sec * 1000):
+      for _ in range(burst_lines):
+        lines.append((start + rng.randrange(100), rng.randrange(40, 121)))
+  return sorted(lines)
+
+def rtt_fill_run(lines, requested_ms, size, duration_sec, mode):
+  """ mode: 'fixed' period, 'level' (period halved/doubled from the fill level, previous
+       version) or 'rate' (next drain before the high-water mark at the measured fill rate) """
+  fill = 0
+  period_ms = requested_ms
+  next_drain = requested_ms
+  last_drain = 0
+  fill_rate = 0
+  overflow_ms = 0
+  overflow_space = 0
+  high_water = size * REPORTER_HIGH_WATER_PCT // 100
+  r = {"drains": 0, "lost": 0, "lost_bytes": 0, "lost_bytes_bound": 0, "near_full": 0, "max_fill": 0}
+  i = 0
+  for now in range(duration_sec * 1000):
+    # RTT skips the lines that don't fit (SEGGER_RTT_MODE_NO_BLOCK_SKIP)
+    while i < len(lines) and lines[i][0] == now:
+      if fill + lines[i][1] <= size:
+        fill += lines[i][1]
+      else:
+        r["lost"] += 1
+        r["lost_bytes"] += lines[i][1]
+      i += 1
+    if now < next_drain:
+      continue
+    r["drains"] += 1
+    r["max_fill"] = max(r["max_fill"], fill * 100 // size)
+    elapsed_ms = now - last_drain
+    rate = fill * 1000 // elapsed_ms if elapsed_ms else 0
+    near_full = fill + REPORTER_NEAR_FULL_MARGIN >= size
+    if near_full:
+      r["near_full"] += 1
+      overflow_ms += elapsed_ms
+      overflow_space += size
+    elif overflow_ms:
+      # Estimated with the rate measured at the next drain (below the buffer size)
+      r["lost_bytes_bound"] += max(overflow_ms * rate // 1000 - overflow_space, 0)
+      overflow_ms = 0
+      overflow_space = 0
+    fill_rate = rate if rate >= fill_rate else (fill_rate * 3 + rate) // 4
+    last_drain = now
+    if mode == "rate":
+      if fill == 0:
+        period_ms = min(period_ms * 2, requested_ms * REPORTER_MAX_PERIOD_FACTOR)
+      elif near_full:
+        period_ms = REPORTER_MIN_PERIOD_MS
+      elif fill_rate == 0:
+        period_ms = requested_ms
+      else:
+        period_ms = max(min(high_water * 1000 // fill_rate, requested_ms), REPORTER_MIN_PERIOD_MS)
+    elif mode == "level":
+      if fill == 0:
+        period_ms = min(period_ms * 2, requested_ms * REPORTER_MAX_PERIOD_FACTOR)
+      elif fill * 100 >= size * REPORTER_HIGH_WATER_PCT:
+        period_ms = max(period_ms // 2, REPORTER_MIN_PERIOD_MS)
+      elif fill * 100 < size * REPORTER_LOW_WATER_PCT and period_ms < requested_ms:
+        period_ms = min(period_ms * 2, requested_ms)
+      elif period_ms > requested_ms:
+        period_ms = requested_ms
+    fill = 0
+    next_drain = now + period_ms
+  r["lost_pct"] = 100.0 * r["lost"] / len(lines) if lines else 0
+  return r
+
+def rtt_fill(rng, args):
+  requested_ms    = int_arg(args, 0, 1000)
+  lines_per_sec   = int_arg(args, 1, 2)
+  burst_lines     = int_arg(args, 2, 40)
+  burst_every_sec = int_arg(args, 3, 30)
+  size            = int_arg(args, 4, 1024)
+  duration_sec    = int_arg(args, 5, 300)
+  lines = rtt_fill_lines(rng, lines_per_sec, burst_lines, burst_every_sec, duration_sec)
+  print(f"{len(lines)} lines in {duration_sec} s ({lines_per_sec}/s, bursts of {burst_lines} in 100 ms "
+        f"every {burst_every_sec} s), {size} bytes RTT up buffer, {requested_ms} ms period")
+  print(f"{'reporter':16} {'drains':>7} {'lost':>7} {'lost bytes':>11} {'bound':>8} {'near_full':>10} {'max_fill':>9}")
+  for name, mode in (("fixed period", "fixed"),
+                     ("fill level", "level"),
+                     ("fill rate", "rate")):
+    r = rtt_fill_run(lines, requested_ms, size, duration_sec, mode)
+    print(f"{name:16} {r['drains']:7} {r['lost_pct']:6.1f}% {r['lost_bytes']:11} {r['lost_bytes_bound']:8} "
+          f"{r['near_full']:10} {r['max_fill']:8}%")
+
+# -----------------------------------------------------------------------------
+models = {
+  "group_leisure": group_leisure,
+  "rtt_fill": rtt_fill,
+}
+
+args = sys.argv[1:]
+seed = 1
+if "-s" in args:
+  i = args.index("-s")
+  seed = int(args[i + 1])
+  del args[i:i + 2]
+
+if not args or args[0] not in models:
+  print(help_text)
+  sys.exit(1)
+
+models[args[0]](random.Random(seed), args[1:])
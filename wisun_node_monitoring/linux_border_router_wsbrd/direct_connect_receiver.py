@@ -8,9 +8,149 @@ import os
 import sys
 import datetime
 import traceback
+import time
+import struct
 
 HOST_IP = "::" # Host own address (tun0 IPv6 address)
 
+# Compressed batches (app_reporter.c): [LZ_MAGIC][flags][raw length (2 bytes)][items]
+#  The dictionary must match reporter_lz_dictionary for the version in the flags
+LZ_MAGIC = 0xA5
+LZ_DICTIONARY_VERSION = 1
+LZ_DICTIONARY = (
+  b"[INFO][DBG ][WARN][ERR ][TRAC]"
+  b"[mac ]: [ws  ]: [wsbr]: [rpl ]: [mpl ]: [6lo ]: [nwk ]: [eap ]: [dhcp]: [fhss]: [ipv6]: [sock]: "
+  b"Tx PA Tx PAS Tx PC Tx PCS Rx PA Rx PAS Rx PC Rx PCS Tx DIO Rx DIO Tx DAO Rx DAO-ACK Tx DIS "
+  b"Tx EAPOL Rx EAPOL Tx NS Rx NA Tx ACK Rx ACK "
+  b"src: dst: fe80::fd12:3456::ff02::1a ff03::1 "
+  b"channel: rssi: lqi: rsl: etx: pan_id: pan_size: routing_cost: parent: neighbor "
+  b"status: success failed timeout state: join_state seq: len: "
+  b"fragment frame buffer \n"
+)
+
+# Sequenced batches (app_reporter.c): [SEQ_MAGIC][flags][sequence number (4 bytes)][batch]
+#  Missing batches are requested with [NACK_MAGIC][count][first (4 bytes)][last (4 bytes)]...
+#  The 4 high bits of the flags are the session, drawn when the reporter starts
+SEQ_MAGIC = 0xA6
+SEQ_HEADER_LEN = 6
+SEQ_FLAG_RETRANSMIT = 1 << 0
+SEQ_FLAG_GONE = 1 << 1
+SEQ_SESSION_SHIFT = 4
+NACK_MAGIC = 0xAE
+NACK_MAX_RANGES = 8
+NACK_INTERVAL_S = 1.0   # NACKs sent again for batches still missing
+NACK_MAX_TRIES = 10     # then the batch is counted as lost
+MAX_MISSING = 256
+RESTART_GAP = 4 * MAX_MISSING  # older batches of the same session are duplicates
+
+class ReporterStream:
+  """ Sequence numbers of the batches of a device, missing batches and recovery counters """
+  def __init__(self):
+    self.expected = None      # next sequence number
+    self.session = None
+    self.missing = {}         # sequence number: [time detected, time of last NACK, NACKs sent]
+    self.start = time.monotonic()
+    self.batches = 0
+    self.text_bytes = 0
+    self.recovered = 0
+    self.recovery_s = []
+    self.lost = 0
+    self.duplicates = 0
+    self.restarts = 0
+
+  def receive(self, seq, flags, now):
+    """ Returns True if the batch is new, False if already received """
+    session = flags >> SEQ_SESSION_SHIFT
+    if self.expected is not None and (session != self.session or seq + RESTART_GAP < self.expected):
+      # Device or reporter restarted: new session (or same random session, but far behind)
+      self.missing.clear()
+      self.expected = None
+      self.restarts += 1
+    self.session = session
+    if flags & SEQ_FLAG_RETRANSMIT or seq in self.missing:
+      if seq not in self.missing:
+        self.duplicates += 1
+        return False
+      self.recovered += 1
+      self.recovery_s.append(now - self.missing.pop(seq)[0])
+      return True
+    if self.expected is not None and seq < self.expected:
+      # Mesh duplicate or reordered batch, already received
+      self.duplicates += 1
+      return False
+    if self.expected is not None:
+      for missing in range(max(self.expected, seq - MAX_MISSING), seq):
+        self.missing[missing] = [now, now - NACK_INTERVAL_S, 0]
+    self.expected = seq + 1
+    return True
+
+  def gone(self, first, last, flags):
+    if flags >> SEQ_SESSION_SHIFT != self.session:
+      return
+    for seq in range(first, last + 1):
+      if self.missing.pop(seq, None) is not None:
+        self.lost += 1
+
+  def nack(self, now):
+    """ NACK for the missing batches not requested for NACK_INTERVAL_S, None if none """
+    due = []
+    for seq in sorted(self.missing):
+      state = self.missing[seq]
+      if now - state[1] < NACK_INTERVAL_S:
+        continue
+      if state[2] == NACK_MAX_TRIES:
+        del self.missing[seq]
+        self.lost += 1
+        continue
+      due.append(seq)
+    ranges = []
+    for seq in due:
+      if ranges and ranges[-1][1] == seq - 1:
+        ranges[-1][1] = seq
+      elif len(ranges) < NACK_MAX_RANGES:
+        ranges.append([seq, seq])
+      else:
+        # Not in this NACK: requested in a next one, without using a try
+        continue
+      state = self.missing[seq]
+      state[1] = now
+      state[2] += 1
+    if not ranges:
+      return None
+    return bytes([NACK_MAGIC, len(ranges)]) + b"".join(struct.pack(">II", first, last) for first, last in ranges)
+
+  def summary(self):
+    elapsed = max(time.monotonic() - self.start, 1e-3)
+    latency = ""
+    if self.recovery_s:
+      latency = f", recovery latency avg {1000*sum(self.recovery_s)/len(self.recovery_s):.0f} ms max {1000*max(self.recovery_s):.0f} ms"
+    return (f"{self.batches} batches, {self.recovered} recovered, {self.lost} lost, {len(self.missing)} missing, "
+            f"{self.duplicates} duplicates, {self.restarts} restarts, goodput {self.text_bytes/elapsed:.0f} B/s{latency}")
+
+def lz_decompress(data):
+  if data[1] >> 4 != LZ_DICTIONARY_VERSION:
+    raise ValueError(f"unknown dictionary version {data[1] >> 4}")
+  raw_len = (data[2] << 8) | data[3]
+  window = bytearray(LZ_DICTIONARY)
+  end = len(LZ_DICTIONARY) + raw_len
+  i = 4
+  while len(window) < end:
+    control = data[i]
+    i += 1
+    for bit in range(8):
+      if len(window) >= end:
+        break
+      if control & (1 << bit):
+        window.append(data[i])
+        i += 1
+      else:
+        distance = ((data[i] << 4) | (data[i+1] >> 4)) + 1
+        length = (data[i+1] & 0x0F) + 3
+        i += 2
+        for _ in range(length):
+          window.append(window[-distance])
+  return bytes(window[len(LZ_DICTIONARY):])
+
 help_text = """
 # Call with
 #  direct_connect_receiver.py <REPORTER_PORT>
@@ -36,32 +176,74 @@ print(f"[{now_str}] Receiving on {HOST_IP}/{PORT}...", flush=True)
 rx_count = 0
 previous_line = 0
 previous_tag = ""
+compressed_count = 0
+wire_bytes = 0
+text_bytes = 0
+decompress_ns = 0
+streams = {}
+
+sock.settimeout(NACK_INTERVAL_S / 2)
 
 try:
   while True:
-    data, addr = sock.recvfrom(2048) # buffer size is 2048 bytes
+    # NACKs for the missing batches
+    for stream_addr, stream in streams.items():
+      nack = stream.nack(time.monotonic())
+      if nack:
+        sock.sendto(nack, (stream_addr, PORT))
+
+    try:
+      data, addr = sock.recvfrom(2048) # buffer size is 2048 bytes
+    except socket.timeout:
+      continue
     addr_string = addr[0]
     now = datetime.datetime.now()
     now_str = str(now.strftime('%Y-%m-%d %H:%M:%S'))
     rx_count += 1
+    recovered_string = ""
 
     try:
-      message_string = data.decode("utf-8")
       nb_data = len(data)
+      wire_bytes += nb_data
+      if nb_data >= SEQ_HEADER_LEN and data[0] == SEQ_MAGIC:
+        flags = data[1]
+        seq, = struct.unpack_from(">I", data, 2)
+        stream = streams.setdefault(addr_string, ReporterStream())
+        if flags & SEQ_FLAG_GONE:
+          last, = struct.unpack_from(">I", data, SEQ_HEADER_LEN)
+          stream.gone(seq, last, flags)
+          print(f"[{now_str}] batches {seq}-{last} no longer available on the device", flush=True)
+          continue
+        if not stream.receive(seq, flags, time.monotonic()):
+          continue
+        if flags & SEQ_FLAG_RETRANSMIT:
+          recovered_string = f"(seq {seq} recovered after {1000*stream.recovery_s[-1]:.0f} ms) "
+        data = data[SEQ_HEADER_LEN:]
+      if len(data) > 4 and data[0] == LZ_MAGIC:
+        start_ns = time.perf_counter_ns()
+        data = lz_decompress(data)
+        decompress_ns += time.perf_counter_ns() - start_ns
+        compressed_count += 1
+      text_bytes += len(data)
+      if addr_string in streams:
+        streams[addr_string].batches += 1
+        streams[addr_string].text_bytes += len(data)
+      message_string = data.decode("utf-8")
     except Exception as e:
       print(f"Exception {e} (from {addr})", flush=True)
       print(traceback.format_exc())
+      continue
 
     tag = addr_string.replace(':',"")[-4:]
     if tag != previous_tag:
       print(f"\n \n new device: {tag}\n")
       previous_tag = tag
-    info_string = f"[{now_str}] [{tag}] "
+    info_string = f"[{now_str}] [{tag}] {recovered_string}"
     len_info_string = len(info_string)
     line_count = 0
     for line in message_string.split('\n'):
       split_line = line.split('_')
-      if line[0] == '_':
+      if line[:1] == '_' and not recovered_string:
         try:
           line_number = int(split_line[1])
           line_delta = line_number - previous_line
@@ -75,5 +257,9 @@ try:
       if "Rx" in info_string:
         info_string = " "*len_info_string
 except KeyboardInterrupt:
-    quit()
-
+    if compressed_count:
+      print(f"\n{rx_count} batches, {compressed_count} compressed: {wire_bytes} bytes received for {text_bytes} bytes of text "
+            f"({100*wire_bytes//text_bytes}%), decompression {decompress_ns/1000*1024/text_bytes:.1f} us/KB", flush=True)
+    for stream_addr, stream in streams.items():
+      print(f"{stream_addr}: {stream.summary()}", flush=True)
+    quit()
\ No newline at end of file
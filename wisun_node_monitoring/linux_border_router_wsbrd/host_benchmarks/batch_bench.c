@@ -0,0 +1,173 @@
+/* Host benchmark of the LFN status batching (app_tlv.c app_tlv_batch_add(), as used by
+ *  app.c _batch_status())
+ *  TLV status records of a router every period_sec for 24 hours, batched for several
+ *  batch_count values (1: no batching). Per hour:
+ *   - transmissions: datagrams, and 6LoWPAN frames (fragments of frame_payload bytes,
+ *     after 40 bytes of IPv6/UDP headers)
+ *   - radio active time: wake_ms per datagram, its airtime at rate_bps, and frame_ms per
+ *     frame for CSMA/CA, acknowledgment and turnarounds
+ *   - estimated EM2 residency, with only the status sends keeping the device out of EM2
+ *  and the average/max delay of the samples.
+ *  The radio figures are estimates: on the device, /statistics/app/notifications reports
+ *  the sends per hour and the measured EM2 residency (with the power manager).
+ *  Fails if a batch does not hold the samples added to it.
+ *  Usage: batch_bench [period_sec] [batch_max_bytes] [batch_max_age_sec] [rate_bps]
+ *                     [frame_payload] [frame_ms] [wake_ms]
+ */
+#include "../../app_tlv.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_status.h"
+
+#define BENCH_IPV6_UDP_HEADER 40
+#define BENCH_DURATION_SEC    (24 * 3600)
+#define BENCH_MAX_LEN         512       // app.c APP_BATCH_MAX_LEN
+
+typedef struct {
+  uint32_t period_sec;
+  uint16_t max_bytes;
+  uint32_t max_age_sec;
+  uint32_t rate_bps;
+  uint32_t frame_payload;
+  double   frame_ms;
+  double   wake_ms;
+} bench_config_t;
+
+typedef struct {
+  uint32_t datagrams;
+  uint64_t bytes;
+  uint64_t frames;
+  double   active_ms;
+  uint64_t samples;
+  uint64_t delay_sec;
+  uint32_t max_delay_sec;
+  uint32_t errors;
+} bench_result_t;
+
+static uint64_t batch_times[256];
+
+static void bench_send(const bench_config_t *config, bench_result_t *result, uint16_t len) {
+  uint32_t frames = (len + BENCH_IPV6_UDP_HEADER + config->frame_payload - 1) / config->frame_payload;
+
+  result->datagrams++;
+  result->bytes  += len;
+  result->frames += frames;
+  result->active_ms += config->wake_ms
+                     + frames * config->frame_ms
+                     + (len + BENCH_IPV6_UDP_HEADER) * 8000.0 / config->rate_bps;
+}
+
+// Send a batch: the receiver finds one SAMPLE per status record added
+static void bench_flush(const bench_config_t *config, bench_result_t *result, app_tlv_batch_t *batch,
+                        uint8_t *buf, uint64_t now) {
+  uint8_t count = batch->count;
+  uint16_t samples = 0;
+  uint16_t offset;
+  uint16_t field_len;
+  uint16_t len;
+  uint8_t i;
+
+  len = app_tlv_batch_end(batch, now);
+  for (offset = APP_TLV_HEADER_LEN; (field_len = _app_tlv_field_len(buf, len, offset)) != 0; offset += field_len) {
+    if (buf[offset] == APP_TLV_ID_SAMPLE) {
+      samples++;
+    }
+  }
+  if ((len == 0) || (samples != count)) {
+    result->errors++;
+  }
+  for (i = 0; i < count; i++) {
+    result->samples++;
+    result->delay_sec += now - batch_times[i];
+    if (now - batch_times[i] > result->max_delay_sec) {
+      result->max_delay_sec = (uint32_t)(now - batch_times[i]);
+    }
+  }
+  bench_send(config, result, len);
+}
+
+static void bench_run(const bench_config_t *config, uint8_t batch_count, bench_result_t *result) {
+  bench_status_t status;
+  app_tlv_batch_t batch = { 0 };
+  app_tlv_batch_result_t added;
+  uint8_t record[256];
+  uint8_t buf[BENCH_MAX_LEN];
+  uint16_t record_len;
+  uint64_t now;
+
+  srand(1);
+  bench_status_init(&status);
+  for (now = config->period_sec; now <= BENCH_DURATION_SEC; now += config->period_sec) {
+    bench_status_step(&status, config->period_sec);
+    record_len = bench_status_tlv(&status, record, sizeof(record));
+    if (batch_count <= 1) {
+      result->samples++;
+      bench_send(config, result, record_len);
+      continue;
+    }
+    added = app_tlv_batch_add(&batch, buf, config->max_bytes, batch_count, config->max_age_sec, now,
+                              record, record_len);
+    if (added == APP_TLV_BATCH_FULL) {
+      bench_flush(config, result, &batch, buf, now);
+      added = app_tlv_batch_add(&batch, buf, config->max_bytes, batch_count, config->max_age_sec, now,
+                                record, record_len);
+    }
+    if (added == APP_TLV_BATCH_TOO_LONG) {
+      result->samples++;
+      bench_send(config, result, record_len);
+      continue;
+    }
+    batch_times[batch.count - 1] = now;
+    if (added == APP_TLV_BATCH_READY) {
+      bench_flush(config, result, &batch, buf, now);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  bench_config_t config;
+  bench_result_t result;
+  uint8_t batch_counts[] = { 1, 2, 3, 4, 8 };
+  double hours = BENCH_DURATION_SEC / 3600.0;
+  uint32_t errors = 0;
+  uint8_t c;
+
+  config.period_sec    = (argc > 1) ? (uint32_t)atoi(argv[1]) : 60;
+  config.max_bytes     = (argc > 2) ? (uint16_t)atoi(argv[2]) : BENCH_MAX_LEN;
+  config.max_age_sec   = (argc > 3) ? (uint32_t)atoi(argv[3]) : 900;
+  config.rate_bps      = (argc > 4) ? (uint32_t)atoi(argv[4]) : 50000;
+  config.frame_payload = (argc > 5) ? (uint32_t)atoi(argv[5]) : 100;
+  config.frame_ms      = (argc > 6) ? atof(argv[6]) : 10.0;
+  config.wake_ms       = (argc > 7) ? atof(argv[7]) : 5.0;
+  if ((config.max_bytes == 0) || (config.max_bytes > BENCH_MAX_LEN)) {
+    config.max_bytes = BENCH_MAX_LEN;
+  }
+
+  printf("TLV status every %u s for 24 h, batch_max_bytes %u, batch_max_age_sec %u\n",
+         config.period_sec, config.max_bytes, config.max_age_sec);
+  printf("Estimates: %u bps, %u bytes per frame, %.1f ms per frame, %.1f ms per wake-up\n",
+         config.rate_bps, config.frame_payload, config.frame_ms, config.wake_ms);
+  printf("%11s %12s %9s %14s %8s %13s %8s %10s %10s\n", "batch_count", "datagrams/h", "frames/h",
+         "samples/dgram", "bytes/h", "active ms/h", "EM2 %", "avg delay", "max delay");
+  for (c = 0; c < sizeof(batch_counts); c++) {
+    memset(&result, 0, sizeof(result));
+    bench_run(&config, batch_counts[c], &result);
+    errors += result.errors;
+    printf("%11u %12.1f %9.1f %14.2f %8.0f %13.1f %8.4f %8.0f s %8u s\n", batch_counts[c],
+           result.datagrams / hours,
+           result.frames / hours,
+           (double)result.samples / result.datagrams,
+           result.bytes / hours,
+           result.active_ms / hours,
+           100.0 - result.active_ms / hours / 36000.0,
+           (double)result.delay_sec / result.samples,
+           result.max_delay_sec);
+  }
+  if (errors) {
+    printf("%u batches without their samples\n", errors);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+/* Status messages of one connected router, for the host benchmarks
+ *  Values evolve between status messages as on a device in a stable network.
+ *  bench_status_json() uses the format of app.c _status_json_string(), without heap_used,
+ *  bench_status_tlv() the app_tlv.c calls of app.c _status_tlv_fields(): keep them in sync
+ *  (app.c needs the whole SDK and is not compiled on the host)
+ */
+#ifndef BENCH_STATUS_H
+#define BENCH_STATUS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "app_tlv.h"
+
+#define BENCH_JOIN_STATE_OPERATIONAL 5
+
+#define BENCH_STATUS_JSON_FORMAT_STR       \
+  "{\n"                                    \
+  "\"ipv6\":\"%s\",\n"                     \
+  "\"device\":\"%s\",\n"                   \
+  "\"chip\":\"%s\",\n"                     \
+  "\"type\":\"%s\",\n"                     \
+  "\"MAC\":\"%s\",\n"                      \
+  "\"parent\":\"%s\",\n"                   \
+  "\"rpl_rank\":\"%d\",\n"                 \
+  "\"etx\":\"%d\",\n"                      \
+  "\"routing_cost\":\"%d\",\n"             \
+  "\"rsl_in\":\"%d\",\n"                   \
+  "\"rsl_out\":\"%d\",\n"                  \
+  "\"running\":\"%s\",\n"                  \
+  "\"msg_count\":\"%ld\",\n"               \
+  "\"connected\":\"%s\",\n"                \
+  "\"disconnected\":\"%s\",\n"             \
+  "\"connections\":\"%d\",\n"              \
+  "\"network_connections\":\"%d\",\n"      \
+  "\"availability\":\"%6.2f\",\n"          \
+  "\"connected_total\":\"%s\",\n"          \
+  "\"disconnected_total\":\"%s\",\n"       \
+  "\"hop_count\":\"%d\",\n"                \
+  "\"phy.crc_fails\": \"%ld\",\n"          \
+  "\"phy.tx_timeouts\": \"%ld\",\n"        \
+  "\"phy.rx_timeouts\": \"%ld\",\n"        \
+  "\"mac.failed_cca_count\": \"%ld\",\n"   \
+  "\"mac.tx_count\": \"%ld\",\n"           \
+  "\"mac.tx_failed_count\": \"%ld\",\n"    \
+  "\"mac.rx_count\": \"%ld\",\n"           \
+  "\"mac.rx_availability_percentage\": \"%d\",\n" \
+  "\"network.ip_no_route\":\"%ld\",\n"     \
+  "\"network.ip_routeloop_detect\": \"%ld\"\n" \
+  "}\n"
+
+typedef struct {
+  uint8_t  ipv6[16];
+  char     ipv6_string[40];
+  uint8_t  mac[8];
+  char     mac_string[24];
+  char     tag[5];
+  char     parent[5];
+  uint16_t rpl_rank;
+  uint16_t etx;
+  uint8_t  rsl_in;
+  uint8_t  rsl_out;
+  uint64_t running_sec;
+  uint64_t connected_sec;
+  uint32_t msg_count;
+  uint32_t crc_fails;
+  uint32_t tx_timeouts;
+  uint32_t rx_timeouts;
+  uint32_t failed_cca_count;
+  uint32_t tx_count;
+  uint32_t tx_failed_count;
+  uint32_t rx_count;
+} bench_status_t;
+
+static inline int bench_status_random(int min, int max) {
+  return min + rand() % (max - min + 1);
+}
+
+static inline const char *bench_status_dhms(uint64_t sec, char *buf) {
+  sprintf(buf, "%d-%02d:%02d:%02d", (int)(sec / 86400), (int)(sec / 3600 % 24),
+          (int)(sec / 60 % 60), (int)(sec % 60));
+  return buf;
+}
+
+static inline void bench_status_init(bench_status_t *status) {
+  int i;
+
+  status->ipv6[0] = 0xfd;
+  status->ipv6[1] = 0x12;
+  status->ipv6[2] = 0x34;
+  status->ipv6[3] = 0x56;
+  for (i = 8; i < 16; i++) {
+    status->ipv6[i] = (uint8_t)rand();
+  }
+  sprintf(status->ipv6_string, "fd12:3456::%02x%02x:%02x%02x:%02x%02x:%02x%02x",
+          status->ipv6[8], status->ipv6[9], status->ipv6[10], status->ipv6[11],
+          status->ipv6[12], status->ipv6[13], status->ipv6[14], status->ipv6[15]);
+  // Silabs OUI
+  status->mac[0] = 0x00;
+  status->mac[1] = 0x0b;
+  status->mac[2] = 0x57;
+  for (i = 3; i < 8; i++) {
+    status->mac[i] = (uint8_t)rand();
+  }
+  sprintf(status->mac_string, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+          status->mac[0], status->mac[1], status->mac[2], status->mac[3],
+          status->mac[4], status->mac[5], status->mac[6], status->mac[7]);
+  sprintf(status->tag, "%02x%02x", status->mac[6], status->mac[7]);
+  sprintf(status->parent, "%04x", bench_status_random(0, 0xffff));
+  status->rpl_rank         = (uint16_t)bench_status_random(256, 1023);
+  status->etx              = (uint16_t)bench_status_random(128, 511);
+  status->rsl_in           = (uint8_t)bench_status_random(60, 89);
+  status->rsl_out          = (uint8_t)bench_status_random(60, 89);
+  status->running_sec      = 3 * 86400 + bench_status_random(0, 86399);
+  status->connected_sec    = status->running_sec - 600;
+  status->msg_count        = (uint32_t)(status->running_sec / 60);
+  status->crc_fails        = bench_status_random(100, 9999);
+  status->tx_timeouts      = bench_status_random(100, 9999);
+  status->rx_timeouts      = bench_status_random(100, 9999);
+  status->failed_cca_count = bench_status_random(100, 9999);
+  status->tx_count         = bench_status_random(100, 9999);
+  status->tx_failed_count  = bench_status_random(100, 9999);
+  status->rx_count         = bench_status_random(100, 9999);
+}
+
+// Values 'period_sec' later: counters increase, link metrics drift, rare parent changes
+static inline void bench_status_step(bench_status_t *status, uint32_t period_sec) {
+  if (rand() % 50 == 0) {
+    sprintf(status->parent, "%04x", bench_status_random(0, 0xffff));
+  }
+  status->rpl_rank = (uint16_t)(status->rpl_rank + bench_status_random(-16, 16));
+  if (status->rpl_rank < 256) status->rpl_rank = 256;
+  status->etx = (uint16_t)(status->etx + bench_status_random(-8, 8));
+  if (status->etx < 128) status->etx = 128;
+  status->rsl_in  = (uint8_t)(status->rsl_in  + bench_status_random(-3, 3));
+  if (status->rsl_in < 20 || status->rsl_in > 120) status->rsl_in = 70;
+  status->rsl_out = (uint8_t)(status->rsl_out + bench_status_random(-3, 3));
+  if (status->rsl_out < 20 || status->rsl_out > 120) status->rsl_out = 70;
+  status->running_sec   += period_sec;
+  status->connected_sec += period_sec;
+  status->msg_count++;
+  status->crc_fails        += bench_status_random(0, period_sec / 10);
+  status->tx_timeouts      += bench_status_random(0, period_sec / 100);
+  status->rx_timeouts      += bench_status_random(0, period_sec / 100);
+  status->failed_cca_count += bench_status_random(0, period_sec / 10);
+  status->tx_count         += bench_status_random(0, period_sec * 8 / 5);
+  status->tx_failed_count  += bench_status_random(0, period_sec / 25);
+  status->rx_count         += bench_status_random(0, period_sec * 6);
+}
+
+static inline int bench_status_json(const bench_status_t *status, char *buf, uint16_t size) {
+  char running[20];
+  char connected[20];
+  char connected_total[20];
+  char disconnected_total[20];
+
+  return snprintf(buf, size, BENCH_STATUS_JSON_FORMAT_STR,
+                  status->ipv6_string, status->tag, "xG25", "FFN", status->mac_string,
+                  status->parent, status->rpl_rank, status->etx,
+                  status->rpl_rank + status->etx / 2, status->rsl_in, status->rsl_out,
+                  bench_status_dhms(status->running_sec, running),
+                  (long)status->msg_count,
+                  bench_status_dhms(status->connected_sec, connected), "no",
+                  1, 1, 100.0,
+                  bench_status_dhms(status->running_sec - 120, connected_total),
+                  bench_status_dhms(120, disconnected_total),
+                  2,
+                  (long)status->crc_fails, (long)status->tx_timeouts, (long)status->rx_timeouts,
+                  (long)status->failed_cca_count, (long)status->tx_count,
+                  (long)status->tx_failed_count, (long)status->rx_count,
+                  100, 0L, 0L);
+}
+
+static inline uint16_t bench_status_tlv(const bench_status_t *status, uint8_t *buf, uint16_t size) {
+  app_tlv_writer_t writer;
+
+  app_tlv_begin(&writer, buf, size, APP_TLV_MSG_STATUS);
+  app_tlv_put_bytes(&writer, APP_TLV_ID_IPV6, status->ipv6, sizeof(status->ipv6));
+  app_tlv_put_str  (&writer, APP_TLV_ID_DEVICE, status->tag);
+  app_tlv_put_str  (&writer, APP_TLV_ID_CHIP, "xG25");
+  app_tlv_put_str  (&writer, APP_TLV_ID_TYPE, "FFN");
+  app_tlv_put_bytes(&writer, APP_TLV_ID_MAC, status->mac, sizeof(status->mac));
+  app_tlv_put_str  (&writer, APP_TLV_ID_PARENT, status->parent);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RPL_RANK, status->rpl_rank);
+  app_tlv_put_uint (&writer, APP_TLV_ID_ETX, status->etx);
+  app_tlv_put_uint (&writer, APP_TLV_ID_ROUTING_COST, status->rpl_rank + status->etx / 2);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RSL_IN, status->rsl_in);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RSL_OUT, status->rsl_out);
+  app_tlv_put_uint (&writer, APP_TLV_ID_RUNNING, status->running_sec);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MSG_COUNT, status->msg_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_JOIN_STATE, BENCH_JOIN_STATE_OPERATIONAL);
+  app_tlv_put_uint (&writer, APP_TLV_ID_CONNECTED, status->connected_sec);
+  app_tlv_put_uint (&writer, APP_TLV_ID_CONNECTIONS, 1);
+  app_tlv_put_uint (&writer, APP_TLV_ID_NETWORK_CONNECTIONS, 1);
+  app_tlv_put_uint (&writer, APP_TLV_ID_AVAILABILITY, 10000);
+  app_tlv_put_uint (&writer, APP_TLV_ID_CONNECTED_TOTAL, status->running_sec - 120);
+  app_tlv_put_uint (&writer, APP_TLV_ID_DISCONNECTED_TOTAL, 120);
+  app_tlv_put_uint (&writer, APP_TLV_ID_HOP_COUNT, 2);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PHY_CRC_FAILS, status->crc_fails);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PHY_TX_TIMEOUTS, status->tx_timeouts);
+  app_tlv_put_uint (&writer, APP_TLV_ID_PHY_RX_TIMEOUTS, status->rx_timeouts);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MAC_FAILED_CCA_COUNT, status->failed_cca_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MAC_TX_COUNT, status->tx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MAC_TX_FAILED_COUNT, status->tx_failed_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MAC_RX_COUNT, status->rx_count);
+  app_tlv_put_uint (&writer, APP_TLV_ID_MAC_RX_AVAILABILITY_PERCENTAGE, 100);
+  app_tlv_put_uint (&writer, APP_TLV_ID_NETWORK_IP_NO_ROUTE, 0);
+  app_tlv_put_uint (&writer, APP_TLV_ID_NETWORK_IP_ROUTELOOP_DETECT, 0);
+  return app_tlv_end(&writer);
+}
+
+#endif /* BENCH_STATUS_H */
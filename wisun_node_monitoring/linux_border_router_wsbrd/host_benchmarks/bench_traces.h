@@ -0,0 +1,103 @@
+/* RTT trace corpus for the host benchmarks of the reporter
+ *  Lines of a trace file (one trace per line, '-' for stdin), or generated Wi-SUN like
+ *  traces: a few templates with changing numbers, in streaks of the same event
+ */
+#ifndef BENCH_TRACES_H
+#define BENCH_TRACES_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  char   *text;
+  size_t  len;
+  const char *name;
+} bench_traces_t;
+
+static const char *bench_trace_templates[] = {
+  "[%lu] [INFO][ws  ] neighbor %s rssi -%d dBm lqi %d",
+  "[%lu] [DBG ][mac ] tx done handle %d status %d retries %d",
+  "[%lu] [INFO][app ] status sent %d bytes to %d:%d",
+  "[%lu] [WARN][rpl ] parent %s rank %d -> %d",
+  "[%lu] [INFO][ws  ] pan %d hop %d pan_cost %d routing_cost %d",
+  "[%lu] [DBG ][ws  ] async frame %d channel %d",
+};
+#define BENCH_TRACE_TEMPLATES (sizeof(bench_trace_templates) / sizeof(bench_trace_templates[0]))
+
+static inline int bench_trace_number(void) {
+  return 1 + rand() % 4999;
+}
+
+// 'count' generated lines, each followed by '\n'
+static inline void bench_traces_generate(bench_traces_t *traces, uint32_t count) {
+  char macs[4][24];
+  const char *mac;
+  size_t size = (size_t)count * 128;
+  unsigned template;
+  uint32_t t;
+  int i;
+
+  for (i = 0; i < 4; i++) {
+    snprintf(macs[i], sizeof(macs[i]), "00:0b:57:%02x:%02x:%02x:%02x:%02x",
+             rand() & 0xff, rand() & 0xff, rand() & 0xff, rand() & 0xff, rand() & 0xff);
+  }
+  traces->text = malloc(size);
+  traces->len = 0;
+  traces->name = "generated traces";
+  template = (unsigned)rand() % BENCH_TRACE_TEMPLATES;
+  for (t = 0; t < count; t++) {
+    if (rand() % 10 >= 7) {
+      template = (unsigned)rand() % BENCH_TRACE_TEMPLATES;
+    }
+    mac = macs[rand() % 4];
+    switch (template) {
+      case 0:
+      case 3:
+        traces->len += snprintf(traces->text + traces->len, size - traces->len, bench_trace_templates[template],
+                                (unsigned long)t * 47, mac, bench_trace_number(), bench_trace_number());
+        break;
+      default:
+        traces->len += snprintf(traces->text + traces->len, size - traces->len, bench_trace_templates[template],
+                                (unsigned long)t * 47, bench_trace_number(), bench_trace_number(), bench_trace_number(),
+                                bench_trace_number());
+        break;
+    }
+    traces->text[traces->len++] = '\n';
+  }
+}
+
+// Trace file 'name' ('-' for stdin), or 'count' generated lines if NULL. Returns false on error
+static inline bool bench_traces_load(bench_traces_t *traces, const char *name, uint32_t count) {
+  FILE *f;
+  size_t size = 1 << 20;
+  size_t n;
+
+  if (name == NULL) {
+    bench_traces_generate(traces, count);
+    return true;
+  }
+  f = strcmp(name, "-") ? fopen(name, "rb") : stdin;
+  if (f == NULL) {
+    perror(name);
+    return false;
+  }
+  traces->text = malloc(size);
+  traces->len = 0;
+  traces->name = strcmp(name, "-") ? name : "stdin";
+  while ((n = fread(traces->text + traces->len, 1, size - traces->len, f)) > 0) {
+    traces->len += n;
+    if (traces->len == size) {
+      size *= 2;
+      traces->text = realloc(traces->text, size);
+    }
+  }
+  if (f != stdin) {
+    fclose(f);
+  }
+  return traces->len > 0;
+}
+
+#endif /* BENCH_TRACES_H */
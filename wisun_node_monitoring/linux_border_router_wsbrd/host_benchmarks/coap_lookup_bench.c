@@ -0,0 +1,148 @@
+/* Host benchmark of the CoAP URI lookup (app_coap_lookup.c)
+ *  With 8 to 250 URIs, the host time to find the resource of a request path:
+ *   - lookup: app_coap_lookup_find() (one FNV-1a hash, usually one compare)
+ *   - linear: strncmp() of the path against each URI in turn, as done when each URI
+ *     is registered to the resource handler
+ *  Paths are those of the URIs (without leading '/', as parsed) and 1 in 8 unknown ones.
+ *  Also prints the longest probe sequence of the lookup.
+ *  Fails if a lookup returns another index than the linear search.
+ */
+#define APP_COAP_LOOKUP_SIZE 512
+#include "../../app_coap_lookup.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX_URIS     250
+#define BENCH_URI_MAX_LEN  48
+#define BENCH_PATHS        1024
+
+static char bench_uris[BENCH_MAX_URIS][BENCH_URI_MAX_LEN];
+static uint16_t bench_uri_count;
+
+// Sub-paths of the application prefixes, as in app_coap_sub_resources[]
+static const char *bench_prefixes[] = {
+  "/statistics/app/", "/reporter/", "/status/", "/settings/", "/info/",
+};
+static const char *bench_names[] = {
+  "all", "join_states_sec", "disconnected_total", "connections", "availability",
+  "connected_total", "rssi", "neighbor", "parent", "send", "slot", "period",
+  "match", "compress", "loss", "counters",
+};
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static const char *bench_uri_at(uint16_t index) {
+  return bench_uris[index];
+}
+
+static int16_t bench_linear_find(const char *path, uint16_t len) {
+  uint16_t i;
+
+  for (i = 0; i < bench_uri_count; i++) {
+    if ((strlen(bench_uris[i] + 1) == len) && !strncmp(bench_uris[i] + 1, path, len)) {
+      return (int16_t)i;
+    }
+  }
+  return APP_COAP_LOOKUP_NONE;
+}
+
+// Probes needed to find each URI
+static uint16_t bench_max_probes(const app_coap_lookup_t *lookup) {
+  uint16_t max_probes = 0;
+  uint16_t probes;
+  uint16_t slot;
+  uint16_t len;
+  const char *path;
+  uint16_t i;
+
+  for (i = 0; i < bench_uri_count; i++) {
+    len = (uint16_t)strlen(bench_uris[i]);
+    path = app_coap_lookup_skip_slash(bench_uris[i], &len);
+    slot = _app_coap_lookup_slot(path, len);
+    for (probes = 1; lookup->slots[slot] != i + 1; probes++) {
+      slot = (slot + 1) & (APP_COAP_LOOKUP_SIZE - 1);
+    }
+    if (probes > max_probes) {
+      max_probes = probes;
+    }
+  }
+  return max_probes;
+}
+
+int main(int argc, char **argv) {
+  uint32_t reps = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200;
+  uint16_t counts[] = { 8, 16, 32, 48, 64, 128, 250 };
+  static char paths[BENCH_PATHS][BENCH_URI_MAX_LEN];
+  static uint16_t path_lens[BENCH_PATHS];
+  static app_coap_lookup_t lookup;
+  uint32_t errors = 0;
+  uint64_t lookup_ns;
+  uint64_t linear_ns;
+  uint64_t start;
+  volatile int32_t sink = 0;
+  uint16_t c;
+  uint32_t p;
+  uint32_t r;
+  uint16_t i;
+
+  srand(1);
+  printf("CoAP URI lookup, %u x %u paths, host ns per path\n", reps, BENCH_PATHS);
+  printf("%5s %9s %9s %11s\n", "URIs", "lookup", "linear", "max probes");
+  for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    bench_uri_count = counts[c];
+    app_coap_lookup_init(&lookup);
+    for (i = 0; i < bench_uri_count; i++) {
+      snprintf(bench_uris[i], BENCH_URI_MAX_LEN, "%s%s_%u",
+               bench_prefixes[i % (sizeof(bench_prefixes) / sizeof(bench_prefixes[0]))],
+               bench_names[(i / 5U) % (sizeof(bench_names) / sizeof(bench_names[0]))], i);
+      if (!app_coap_lookup_add(&lookup, i, bench_uris[i])) {
+        errors++;
+      }
+    }
+    for (p = 0; p < BENCH_PATHS; p++) {
+      if ((rand() % 8) == 0) {
+        snprintf(paths[p], BENCH_URI_MAX_LEN, "statistics/app/unknown_%u", (unsigned)rand() % 1000);
+      } else {
+        snprintf(paths[p], BENCH_URI_MAX_LEN, "%s", bench_uris[(uint16_t)rand() % bench_uri_count] + 1);
+      }
+      path_lens[p] = (uint16_t)strlen(paths[p]);
+      if (app_coap_lookup_find(&lookup, bench_uri_at, paths[p], path_lens[p])
+          != bench_linear_find(paths[p], path_lens[p])) {
+        errors++;
+      }
+    }
+
+    start = bench_ns();
+    for (r = 0; r < reps; r++) {
+      for (p = 0; p < BENCH_PATHS; p++) {
+        sink += app_coap_lookup_find(&lookup, bench_uri_at, paths[p], path_lens[p]);
+      }
+    }
+    lookup_ns = bench_ns() - start;
+    start = bench_ns();
+    for (r = 0; r < reps; r++) {
+      for (p = 0; p < BENCH_PATHS; p++) {
+        sink += bench_linear_find(paths[p], path_lens[p]);
+      }
+    }
+    linear_ns = bench_ns() - start;
+
+    printf("%5u %9.1f %9.1f %11u\n", bench_uri_count,
+           (double)lookup_ns / reps / BENCH_PATHS,
+           (double)linear_ns / reps / BENCH_PATHS,
+           bench_max_probes(&lookup));
+  }
+  (void)sink;
+  if (errors) {
+    printf("%u lookup errors\n", errors);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,173 @@
+/* Host benchmark of the CoAP response buffer pool (app_coap_response.c), with the pthread
+ *  backed cmsis_os2 stub
+ *  1 to 6 threads call a handler in a loop for 'duration_ms', as the resource handler
+ *  thread and app_task() (Observe) call the resource callbacks:
+ *   - the handler writes a payload specific to its thread and call in the buffer from
+ *     app_coap_response_acquire(), and returns it, or returns NULL (a 5.03 response) if
+ *     app_coap_response_acquire() returned NULL
+ *   - the caller yields (the response is being sent), then checks that the payload is
+ *     still the one written by its handler
+ *   - odd threads release their buffer after each response (as app_coap_observe_process()),
+ *     even ones keep it until their next call (as the resource handler thread)
+ *  Reports the responses per second, the payload mismatches, the 5.03 responses, and the
+ *  pool counters. With more threads than APP_COAP_RESPONSE_POOL_COUNT buffers, waits then
+ *  5.03 responses are expected.
+ *  Fails if a payload is changed, or if the 5.03 responses don't match the 'exhausted' counter.
+ *  Usage: coap_pool_bench [duration_ms]
+ */
+#include "../../app_coap_response.c"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_MAX_THREADS 6
+
+uint64_t host_sleeptimer_ticks = 0;
+
+static volatile bool bench_stop;
+static volatile uint8_t bench_finished;
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+  uint8_t  id;
+  uint32_t responses;
+  uint32_t mismatches;
+  uint32_t unavailable;
+} bench_thread_t;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Payload of 'thread' for its call 'seq': a header and a filler, up to COAP_MAX_RESPONSE_LEN - 1
+static uint16_t bench_payload(char *buf, uint8_t thread, uint32_t seq) {
+  uint16_t len;
+  uint16_t total = (uint16_t)(64 + (seq * 37U + thread * 101U) % (COAP_MAX_RESPONSE_LEN - 65));
+
+  len = (uint16_t)snprintf(buf, COAP_MAX_RESPONSE_LEN, "{\"thread\": %u, \"seq\": %lu, \"filler\": \"",
+                           thread, (unsigned long)seq);
+  memset(buf + len, 'a' + (char)((thread + seq) % 26), total - len - 2U);
+  memcpy(buf + total - 2, "\"}", 2);
+  buf[total] = '\0';
+  return total;
+}
+
+// Resource callback: writes its response in the buffer of the calling thread, NULL for a 5.03
+static char *bench_handler(uint8_t thread, uint32_t seq) {
+  char *buf = app_coap_response_acquire();
+
+  if (buf == NULL) {
+    return NULL;
+  }
+  (void)bench_payload(buf, thread, seq);
+  return buf;
+}
+
+static void bench_thread(void *argument) {
+  bench_thread_t *thread = (bench_thread_t *)argument;
+  char expected[COAP_MAX_RESPONSE_LEN];
+  uint16_t len;
+  char *response;
+  uint32_t seq;
+
+  for (seq = 0; !bench_stop; seq++) {
+    response = bench_handler(thread->id, seq);
+    // Sending: other threads run their handlers meanwhile
+    sched_yield();
+    if (response == NULL) {
+      thread->unavailable++;
+    } else {
+      len = bench_payload(expected, thread->id, seq);
+      if (memcmp(response, expected, len + 1U)) {
+        thread->mismatches++;
+      }
+    }
+    if (thread->id & 1U) {
+      app_coap_response_release();
+    }
+    thread->responses++;
+  }
+  app_coap_response_release();
+  pthread_mutex_lock(&bench_lock);
+  bench_finished++;
+  pthread_mutex_unlock(&bench_lock);
+}
+
+int main(int argc, char **argv) {
+  uint32_t duration_ms = (argc > 1) ? (uint32_t)atoi(argv[1]) : 500;
+  uint8_t counts[] = { 1, 2, 3, 4, 6 };
+  static bench_thread_t threads[BENCH_MAX_THREADS];
+  app_coap_response_pool_counters_t counters;
+  uint32_t mismatches;
+  uint32_t unavailable;
+  uint32_t responses;
+  uint32_t failures = 0;
+  uint64_t start;
+  uint64_t elapsed_ns;
+  uint8_t c;
+  uint8_t t;
+  bool done;
+
+  app_coap_response_pool_init();
+  printf("CoAP response pool, %u buffers, %u ms per run\n",
+         APP_COAP_RESPONSE_POOL_COUNT, duration_ms);
+  printf("%7s %12s %10s %6s %8s %7s %9s %11s\n",
+         "threads", "responses/s", "mismatches", "5.03", "reused", "waits", "exhausted", "peak_in_use");
+  for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    app_coap_response_pool_reset();
+    for (t = 0; t < counts[c]; t++) {
+      threads[t].id = t;
+      threads[t].responses = 0;
+      threads[t].mismatches = 0;
+      threads[t].unavailable = 0;
+    }
+    bench_stop = false;
+    bench_finished = 0;
+    start = bench_ns();
+    for (t = 0; t < counts[c]; t++) {
+      assert(osThreadNew(bench_thread, &threads[t], NULL) != NULL);
+    }
+    osDelay(duration_ms);
+    bench_stop = true;
+    // Threads are detached: wait for their last response (they release their buffer)
+    do {
+      osDelay(1);
+      pthread_mutex_lock(&bench_lock);
+      done = (bench_finished == counts[c]);
+      pthread_mutex_unlock(&bench_lock);
+    } while (!done);
+    elapsed_ns = bench_ns() - start;
+    app_coap_response_pool_counters(&counters);
+
+    mismatches = 0;
+    unavailable = 0;
+    responses = 0;
+    for (t = 0; t < counts[c]; t++) {
+      mismatches += threads[t].mismatches;
+      unavailable += threads[t].unavailable;
+      responses += threads[t].responses;
+    }
+    if (mismatches || (unavailable != counters.exhausted)) {
+      failures++;
+    }
+    printf("%7u %12.0f %10u %6u %8lu %7lu %9lu %11u\n", counts[c],
+           (double)responses * 1e9 / (double)elapsed_ns,
+           mismatches,
+           unavailable,
+           (unsigned long)counters.reused,
+           (unsigned long)counters.waits,
+           (unsigned long)counters.exhausted,
+           counters.peak_in_use);
+  }
+  printf("Mismatches are payloads changed by another thread before being sent. With more threads\n"
+         "than buffers, requests without a buffer ('exhausted') are answered with 5.03\n");
+  if (failures) {
+    printf("%u runs with mismatches, or with 5.03 responses not counted as exhausted\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+/* Host benchmark of the reporter line collapsing and rate limits (app_reporter.c
+ *  filter_log_lines()), with several match strings (set by app_start_reporter())
+ *  The trace corpus comes at 'lines_per_sec' and is drained every 'period_ms' (at most
+ *  BUFFER_SIZE_UP bytes per drain, as the reporter drains the RTT up buffer), at the
+ *  sleeptimer time of the drain (used by the rate limits).
+ *  For each match string: matching, collapsed and rate limited lines (reporter_counters),
+ *  bytes of the matching lines, bytes sent (filter_log_lines() output, one '\n' per batch),
+ *  bytes saved and the saved_bytes counter, host ns per line.
+ *  Fails if the counters don't account for the matching lines, or if saved_bytes is below
+ *  the bytes actually saved (it only differs above, when a summary was longer than the
+ *  lines it replaced and saved_bytes was kept at 0).
+ *  Usage: collapse_bench [match_string] [trace_file] [lines_per_sec] [period_ms]
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// app_start_reporter() traces its settings: not in the results
+static bool bench_quiet;
+static int bench_printf(const char *format, ...) {
+  va_list args;
+  int len;
+
+  if (bench_quiet) {
+    return 0;
+  }
+  va_start(args, format);
+  len = vprintf(format, args);
+  va_end(args);
+  return len;
+}
+#define printf bench_printf
+#include "../../app_reporter.c"
+#undef printf
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_traces.h"
+
+#define BENCH_TRACE_LINES 5000
+
+uint64_t host_sleeptimer_ticks = 0;
+uint32_t host_sendto_count;
+uint64_t host_sendto_bytes;
+SEGGER_RTT_CB _SEGGER_RTT;
+char device_mac_string[40] = "00:0b:57:00:00:00:00:01";
+
+static const char *bench_match_strings[] = {
+  "*", "*~", "*~@5", "ws  ]~|rpl@2", "rssi~@1|status",
+};
+
+typedef struct {
+  uint32_t matching_lines;
+  uint64_t matching_bytes;
+  uint64_t sent_bytes;
+  uint64_t ns;
+} bench_result_t;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Whether 'line' matches a match string, walking the automaton as filter_log_lines()
+static bool bench_line_matches(const char *line, size_t len) {
+  uint8_t state = REPORTER_AC_ROOT;
+  uint8_t next;
+  size_t i;
+
+  if (reporter_match_all) {
+    return true;
+  }
+  for (i = 0; (i < len) && (reporter_ac[state].match == 0); i++) {
+    while (((next = reporter_ac_child(state, line[i])) == REPORTER_AC_ROOT) && (state != REPORTER_AC_ROOT)) {
+      state = reporter_ac[state].fail;
+    }
+    state = next;
+  }
+  return reporter_ac[state].match != 0;
+}
+
+static void bench_run(const bench_traces_t *traces, const char *match_string, uint32_t lines_per_sec,
+                      uint32_t period_ms, bench_result_t *result) {
+  static char batch_lines[BUFFER_SIZE_UP];
+  char match[MAX_MATCH_STRING_LEN];
+  uint64_t drain_ms = period_ms;
+  uint64_t start;
+  uint32_t line_index = 0;
+  uint16_t sent;
+  size_t offset = 0;
+  size_t line_start;
+  size_t last_end;
+  size_t len;
+  size_t i;
+
+  snprintf(match, sizeof(match), "%s", match_string);
+  bench_quiet = true;
+  host_sleeptimer_ticks = 0;
+  app_start_reporter("fd00::1", period_ms, match);
+  app_reporter_statistics_reset();
+  bench_quiet = false;
+
+  while (offset < traces->len) {
+    // Lines written before the drain, within the size of a drain
+    for (len = 0, last_end = 0; (offset + len < traces->len) && (len < BUFFER_SIZE_UP)
+                                && ((uint64_t)line_index * 1000 / lines_per_sec < drain_ms); len++) {
+      if (traces->text[offset + len] == '\n') {
+        line_index++;
+        last_end = len + 1;
+      }
+    }
+    // A line cut by BUFFER_SIZE_UP is read by the next drain, as from the RTT up buffer
+    if ((len == BUFFER_SIZE_UP) && last_end) {
+      len = last_end;
+    }
+    // Matching lines, as filter_log_lines() cuts them
+    for (i = 0, line_start = 0; i <= len; i++) {
+      if ((i == len) || (traces->text[offset + i] == '\n')) {
+        if ((i > line_start) && bench_line_matches(traces->text + offset + line_start, i - line_start)) {
+          result->matching_lines++;
+          result->matching_bytes += i - line_start + 1;
+        }
+        line_start = i + 1;
+      }
+    }
+    if (len) {
+      memcpy(batch_lines, traces->text + offset, len);
+      host_sleeptimer_ticks = drain_ms * HOST_SLEEPTIMER_FREQUENCY / 1000;
+      start = bench_ns();
+      sent = filter_log_lines(batch_lines, (uint16_t)len, lines_to_send, REPORTER_LINES_SIZE);
+      result->ns += bench_ns() - start;
+      result->sent_bytes += sent ? sent + 1U : 0;
+      offset += len;
+    }
+    if ((uint64_t)line_index * 1000 / lines_per_sec >= drain_ms) {
+      drain_ms += period_ms;
+    }
+  }
+  app_stop_reporter();
+}
+
+int main(int argc, char **argv) {
+  const char **match_strings = bench_match_strings;
+  uint32_t count = sizeof(bench_match_strings) / sizeof(bench_match_strings[0]);
+  uint32_t lines_per_sec = (argc > 3) ? (uint32_t)atoi(argv[3]) : 20;
+  uint32_t period_ms = (argc > 4) ? (uint32_t)atoi(argv[4]) : 1000;
+  bench_traces_t traces;
+  bench_result_t result;
+  app_reporter_counters_t *c = &reporter_counters;
+  uint64_t saved;
+  uint32_t errors = 0;
+  uint32_t i;
+
+  srand(1);
+  if (argc > 1) {
+    match_strings = (const char **)&argv[1];
+    count = 1;
+  }
+  if (!bench_traces_load(&traces, (argc > 2) ? argv[2] : NULL, BENCH_TRACE_LINES)) {
+    return 1;
+  }
+  lines_per_sec = lines_per_sec ? lines_per_sec : 1;
+  period_ms = MAX(period_ms, REPORTER_MIN_PERIOD_MS);
+  printf("%s: %lu bytes, %u lines/s, %u ms period\n", traces.name, (unsigned long)traces.len,
+         lines_per_sec, period_ms);
+  printf("%-16s %6s %10s %8s %9s %8s %8s %12s %6s %8s\n", "match_string", "lines", "collapsed", "limited",
+         "matching", "sent", "saved", "saved_bytes", "saved", "ns/line");
+  for (i = 0; i < count; i++) {
+    memset(&result, 0, sizeof(result));
+    bench_run(&traces, match_strings[i], lines_per_sec, period_ms, &result);
+    saved = result.matching_bytes - MIN(result.matching_bytes, result.sent_bytes);
+    if ((c->lines != result.matching_lines) || (c->saved_bytes < saved)) {
+      errors++;
+    }
+    printf("%-16s %6lu %10lu %8lu %9lu %8lu %8lu %12lu %5.1f%% %8.1f\n", match_strings[i],
+           (unsigned long)c->lines, (unsigned long)c->collapsed_lines, (unsigned long)c->rate_limited_lines,
+           (unsigned long)result.matching_bytes, (unsigned long)result.sent_bytes, (unsigned long)saved,
+           (unsigned long)c->saved_bytes,
+           result.matching_bytes ? 100.0 * saved / result.matching_bytes : 0.0,
+           result.matching_lines ? (double)result.ns / result.matching_lines : 0.0);
+  }
+  if (errors) {
+    printf("%u match strings with lines or saved_bytes counters not matching the lines sent\n", errors);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,243 @@
+/* Host benchmark of the reporter batch compression (app_reporter.c reporter_lz_compress())
+ *  The trace corpus is cut in batches of lines_per_sec * period_ms / 1000 lines (at most
+ *  BUFFER_SIZE_UP bytes, as the reporter drains the RTT up buffer), filtered
+ *  with the '*' match string (identical lines collapsed, as by the reporter), then
+ *  compressed with the dictionary and without it (window prefix cleared). For each:
+ *  batches compressed, bytes sent, compression ratio and host CPU time per KB of text.
+ *  The device reports its own CPU time per KB in /reporter/compress (us_per_kb).
+ *  Fails if a batch is not decompressed back as direct_connect_receiver.py lz_decompress()
+ *  does, or if the dictionaries of app_reporter.c and direct_connect_receiver.py differ.
+ *  Usage: compress_bench [lines_per_sec] [period_ms] [repetitions] [trace_file]
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// app_start_reporter() traces its settings: not in the results
+static bool bench_quiet;
+static int bench_printf(const char *format, ...) {
+  va_list args;
+  int len;
+
+  if (bench_quiet) {
+    return 0;
+  }
+  va_start(args, format);
+  len = vprintf(format, args);
+  va_end(args);
+  return len;
+}
+#define printf bench_printf
+#include "../../app_reporter.c"
+#undef printf
+
+#include <libgen.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_traces.h"
+
+#define BENCH_TRACE_LINES 20000
+
+uint64_t host_sleeptimer_ticks = 0;
+uint32_t host_sendto_count;
+uint64_t host_sendto_bytes;
+SEGGER_RTT_CB _SEGGER_RTT;
+char device_mac_string[40] = "00:0b:57:00:00:00:00:01";
+
+typedef struct {
+  uint32_t batches;
+  uint32_t compressed_batches;
+  uint64_t raw_bytes;
+  uint64_t sent_bytes;
+  uint64_t ns;
+  uint32_t errors;
+} bench_result_t;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// lz_decompress() of direct_connect_receiver.py, with 'dictionary' as window prefix
+static uint16_t bench_lz_decompress(const uint8_t *data, uint16_t len, const char *dictionary, char *raw) {
+  static char window[REPORTER_LZ_WINDOW_SIZE];
+  uint16_t raw_len = (uint16_t)((data[2] << 8) | data[3]);
+  uint16_t end = (uint16_t)(REPORTER_LZ_DICTIONARY_LEN + raw_len);
+  uint16_t w = REPORTER_LZ_DICTIONARY_LEN;
+  uint16_t i = REPORTER_LZ_HEADER_LEN;
+  uint16_t distance;
+  uint16_t length;
+  uint8_t control;
+  uint8_t bit;
+
+  if ((data[0] != REPORTER_LZ_MAGIC) || (end > sizeof(window))) {
+    return 0;
+  }
+  memcpy(window, dictionary, REPORTER_LZ_DICTIONARY_LEN);
+  while (w < end) {
+    if (i >= len) {
+      return 0;
+    }
+    control = data[i++];
+    for (bit = 0; (bit < 8) && (w < end); bit++) {
+      if (control & (1 << bit)) {
+        window[w++] = (char)data[i++];
+      } else {
+        distance = (uint16_t)(((data[i] << 4) | (data[i + 1] >> 4)) + 1);
+        length = (uint16_t)((data[i + 1] & 0x0F) + REPORTER_LZ_MIN_MATCH);
+        i += 2;
+        if ((distance > w) || (w + length > end)) {
+          return 0;
+        }
+        for (; length; length--, w++) {
+          window[w] = window[w - distance];
+        }
+      }
+    }
+  }
+  memcpy(raw, window + REPORTER_LZ_DICTIONARY_LEN, raw_len);
+  return raw_len;
+}
+
+// LZ_DICTIONARY of direct_connect_receiver.py (its b"..." literals), length or -1 if not found
+static int bench_receiver_dictionary(char *dictionary, int size) {
+  char path[512];
+  char line[512];
+  char *c;
+  FILE *f;
+  int len = -1;
+
+  snprintf(path, sizeof(path), "%s", __FILE__);
+  snprintf(line, sizeof(line), "%s/../direct_connect_receiver.py", dirname(path));
+  f = fopen(line, "r");
+  if (f == NULL) {
+    perror(line);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (len < 0) {
+      len = (strncmp(line, "LZ_DICTIONARY = (", 17) == 0) ? 0 : -1;
+      continue;
+    }
+    if (line[0] == ')') {
+      break;
+    }
+    c = strstr(line, "b\"");
+    for (c = (c != NULL) ? c + 2 : line + strlen(line); *c && (*c != '"') && (len < size); c++) {
+      if (*c == '\\') {
+        c++;
+        dictionary[len++] = (*c == 'n') ? '\n' : *c;
+      } else {
+        dictionary[len++] = *c;
+      }
+    }
+  }
+  fclose(f);
+  return len;
+}
+
+static void bench_run(const bench_traces_t *traces, uint32_t lines_per_batch, uint32_t repetitions,
+                      bool dictionary, bench_result_t *result) {
+  static char batch_lines[REPORTER_LINES_SIZE];
+  static char raw[REPORTER_LINES_SIZE];
+  char prefix[REPORTER_LZ_DICTIONARY_LEN];
+  size_t offset;
+  size_t len;
+  uint16_t raw_len;
+  uint16_t compressed_len = 0;
+  uint64_t start;
+  uint32_t lines;
+  uint32_t r;
+
+  bench_quiet = true;
+  app_start_reporter("fd00::1", 1000, "*");
+  app_reporter_set_compress(APP_REPORTER_COMPRESS_ON);
+  bench_quiet = false;
+  if (!dictionary) {
+    // Never matched by text lines
+    memset(reporter_window, 0, REPORTER_LZ_DICTIONARY_LEN);
+  }
+  memcpy(prefix, reporter_window, REPORTER_LZ_DICTIONARY_LEN);
+
+  for (offset = 0; offset < traces->len; offset += len) {
+    // The next lines_per_batch lines, within the size of a drain
+    for (len = 0, lines = 0; (offset + len < traces->len) && (lines < lines_per_batch)
+                             && (len < BUFFER_SIZE_UP); len++) {
+      if (traces->text[offset + len] == '\n') {
+        lines++;
+      }
+    }
+    memcpy(batch_lines, traces->text + offset, len);
+    if (filter_log_lines(batch_lines, (uint16_t)len, lines_to_send, REPORTER_LINES_SIZE) == 0) {
+      continue;
+    }
+    raw_len = (uint16_t)strlen(lines_to_send);
+    start = bench_ns();
+    for (r = 0; r < repetitions; r++) {
+      compressed_len = reporter_lz_compress(raw_len);
+    }
+    result->ns += (bench_ns() - start) / repetitions;
+    result->batches++;
+    result->raw_bytes += raw_len;
+    if (compressed_len == 0) {
+      result->sent_bytes += raw_len;
+      continue;
+    }
+    result->compressed_batches++;
+    result->sent_bytes += compressed_len;
+    if ((bench_lz_decompress(reporter_lz->out, compressed_len, prefix, raw) != raw_len)
+        || memcmp(raw, lines_to_send, raw_len)) {
+      result->errors++;
+    }
+  }
+  app_reporter_set_compress(APP_REPORTER_COMPRESS_OFF);
+}
+
+int main(int argc, char **argv) {
+  uint32_t lines_per_sec = (argc > 1) ? (uint32_t)atoi(argv[1]) : 10;
+  uint32_t period_ms = (argc > 2) ? (uint32_t)atoi(argv[2]) : 1000;
+  uint32_t repetitions = (argc > 3) ? (uint32_t)atoi(argv[3]) : 10;
+  uint32_t lines_per_batch;
+  char receiver[2 * REPORTER_LZ_DICTIONARY_LEN];
+  bench_traces_t traces;
+  bench_result_t result;
+  uint32_t errors = 0;
+  int receiver_len;
+  int d;
+
+  srand(1);
+  receiver_len = bench_receiver_dictionary(receiver, sizeof(receiver));
+  if ((receiver_len != REPORTER_LZ_DICTIONARY_LEN) || memcmp(receiver, reporter_lz_dictionary, receiver_len)) {
+    printf("reporter_lz_dictionary (app_reporter.c) and LZ_DICTIONARY (direct_connect_receiver.py) differ\n");
+    return 1;
+  }
+  if (!bench_traces_load(&traces, (argc > 4) ? argv[4] : NULL, BENCH_TRACE_LINES)) {
+    return 1;
+  }
+  repetitions = repetitions ? repetitions : 1;
+  lines_per_batch = MAX(1, lines_per_sec * period_ms / 1000);
+  printf("%s: %lu bytes, %u lines/s, %u ms period: %u lines per batch (%u bytes dictionary)\n",
+         traces.name, (unsigned long)traces.len, lines_per_sec, period_ms, lines_per_batch,
+         REPORTER_LZ_DICTIONARY_LEN);
+  printf("%10s %11s %11s %11s %7s %11s\n", "dictionary", "compressed", "raw bytes", "sent bytes",
+         "ratio", "host us/KB");
+  for (d = 1; d >= 0; d--) {
+    memset(&result, 0, sizeof(result));
+    bench_run(&traces, lines_per_batch, repetitions, d, &result);
+    errors += result.errors;
+    printf("%10s %5u/%-5u %11lu %11lu %6.1f%% %11.2f\n", d ? "yes" : "no",
+           result.compressed_batches, result.batches,
+           (unsigned long)result.raw_bytes, (unsigned long)result.sent_bytes,
+           100.0 * result.sent_bytes / result.raw_bytes,
+           result.ns / 1000.0 / (result.raw_bytes / 1024.0));
+  }
+  if (errors) {
+    printf("%u batches not decompressed back\n", errors);
+    return 1;
+  }
+  return 0;
+}
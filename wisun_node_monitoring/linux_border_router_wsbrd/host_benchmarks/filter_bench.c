@@ -0,0 +1,306 @@
+/* Host benchmark of the reporter line filter (app_reporter.c filter_log_lines())
+ *  The trace corpus is read in chunks of BUFFER_SIZE_UP bytes, as the reporter drains the
+ *  RTT up buffer, and filtered with 1, 5 and 10 match strings (set by app_start_reporter()):
+ *   - automaton: filter_log_lines(), one pass over each chunk
+ *   - strstr: the previous filter, strtok() of the lines, strstr() of each match string
+ *     and strcat() of the matching lines
+ *   - byte strstr: the same with a byte by byte strstr(), as the size optimized newlib
+ *     of the target (the host strstr() uses SIMD instructions the target does not have)
+ *  in MB/s of traces (host).
+ *  Then checks that both select the same lines, on random match strings and lines from a
+ *  small alphabet (many overlapping and nested match strings), and that the automaton
+ *  (reporter_ac_build()) finds the match string ending first, the longest one if several
+ *  end there (its rate limit applies to the line). Fails if not.
+ *  Usage: filter_bench [repetitions] [tests] [trace_file]
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// app_start_reporter() traces each match string: not while checking
+static bool bench_quiet;
+static int bench_printf(const char *format, ...) {
+  va_list args;
+  int len;
+
+  if (bench_quiet) {
+    return 0;
+  }
+  va_start(args, format);
+  len = vprintf(format, args);
+  va_end(args);
+  return len;
+}
+#define printf bench_printf
+#include "../../app_reporter.c"
+#undef printf
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_traces.h"
+
+#define BENCH_TRACE_LINES 20000
+
+uint64_t host_sleeptimer_ticks = 0;
+uint32_t host_sendto_count;
+uint64_t host_sendto_bytes;
+SEGGER_RTT_CB _SEGGER_RTT;
+char device_mac_string[40] = "00:0b:57:00:00:00:00:01";
+
+static const char *bench_patterns[REPORTER_MAX_MATCHES] = {
+  "[WARN]", "rank", "status sent", "channel", "neighbor",
+  "tx done", "pan_cost", "[ERR ]", "async", "retries",
+};
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_start_reporter(const char *match_string) {
+  char match[MAX_MATCH_STRING_LEN];
+
+  snprintf(match, sizeof(match), "%s", match_string);
+  bench_quiet = true;
+  app_start_reporter("fd00::1", 1000, match);
+  bench_quiet = false;
+}
+
+// strstr() of newlib built for size
+static char *bench_byte_strstr(const char *haystack, const char *needle) {
+  const char *h;
+  const char *n;
+
+  for (; *haystack; haystack++) {
+    for (h = haystack, n = needle; *n && (*h == *n); h++, n++) {
+    }
+    if (*n == '\0') {
+      return (char *)haystack;
+    }
+  }
+  return (*needle == '\0') ? (char *)haystack : NULL;
+}
+
+// filter_log_lines() before the automaton
+static uint16_t bench_strstr_filter(char *log_lines, char *lines_to_send,
+                                    char *(*find)(const char *, const char *)) {
+  const char crlf[] = "\n";
+  char *line;
+  uint8_t matches;
+  uint8_t i;
+  uint8_t line_count = 0;
+
+  sprintf(lines_to_send, "%s ", device_mac_string);
+  line = strtok(log_lines, crlf);
+  while (line != NULL) {
+    matches = 0;
+    if (strcmp(reporter_matches.match[0], "*") == 0) {
+      matches++;
+    } else {
+      for (i = 0; i < reporter_matches.nb_matches; i++) {
+        if ((strlen(reporter_matches.match[i]) > 1) && (find(line, reporter_matches.match[i]) != NULL)) {
+          matches++;
+        }
+      }
+    }
+    if (matches) {
+      line_count++;
+      if (line_count > 1) {
+        strcat(lines_to_send, "\n");
+      }
+      strcat(lines_to_send, line);
+    }
+    line = strtok(NULL, crlf);
+  }
+  return (uint16_t)(strlen(lines_to_send) - strlen(device_mac_string) - 1);
+}
+
+// MB/s of traces through filter_log_lines(), or the strstr filter with 'find' if not NULL
+static double bench_filter(const bench_traces_t *traces, uint32_t repetitions,
+                           char *(*find)(const char *, const char *)) {
+  static char chunk[BUFFER_SIZE_UP + 1];
+  static char strstr_lines[REPORTER_LINES_SIZE + BUFFER_SIZE_UP];
+  size_t offset;
+  uint16_t len;
+  uint64_t start;
+  uint64_t bytes = 0;
+  uint32_t r;
+
+  start = bench_ns();
+  for (r = 0; r < repetitions; r++) {
+    for (offset = 0; offset < traces->len; offset += len) {
+      len = (uint16_t)MIN(traces->len - offset, BUFFER_SIZE_UP);
+      memcpy(chunk, traces->text + offset, len);
+      chunk[len] = '\0';
+      if (find == NULL) {
+        filter_log_lines(chunk, len, lines_to_send, REPORTER_LINES_SIZE);
+      } else {
+        bench_strstr_filter(chunk, strstr_lines, find);
+      }
+      bytes += len;
+    }
+  }
+  return bytes * 1000.0 / (bench_ns() - start);
+}
+
+static char bench_random_char(const char *alphabet) {
+  return alphabet[rand() % strlen(alphabet)];
+}
+
+// Up to REPORTER_MAX_MATCHES + 2 '|' separated strings, shorter than MAX_MATCH_STRING_LEN
+static void bench_random_match_string(char *match_string, const char *alphabet) {
+  int count = 1 + rand() % (REPORTER_MAX_MATCHES + 2);
+  int len = 0;
+  int match_len;
+  int i;
+  int j;
+
+  for (i = 0; i < count; i++) {
+    match_len = 1 + rand() % 7;
+    if (len + match_len + 1 >= MAX_MATCH_STRING_LEN) {
+      break;
+    }
+    if (i) {
+      match_string[len++] = '|';
+    }
+    for (j = 0; j < match_len; j++) {
+      match_string[len++] = bench_random_char(alphabet);
+    }
+  }
+  match_string[len] = '\0';
+}
+
+// Match string of 'line' with the automaton, as filter_log_lines() walks it (index + 1, 0: none)
+static uint8_t bench_ac_match(const char *line, uint16_t len) {
+  uint8_t state = REPORTER_AC_ROOT;
+  uint8_t next;
+  uint16_t i;
+
+  if (reporter_match_all) {
+    return reporter_match_all;
+  }
+  for (i = 0; (i < len) && (reporter_ac[state].match == 0); i++) {
+    while (((next = reporter_ac_child(state, line[i])) == REPORTER_AC_ROOT) && (state != REPORTER_AC_ROOT)) {
+      state = reporter_ac[state].fail;
+    }
+    state = next;
+  }
+  return reporter_ac[state].match;
+}
+
+// Match string ending first in 'line', the longest one if several end there (index + 1, 0: none)
+static uint8_t bench_reference_match(const char *line, uint16_t len) {
+  const char *found;
+  size_t match_len;
+  size_t end;
+  size_t best_end = SIZE_MAX;
+  size_t best_len = 0;
+  uint8_t best = 0;
+  uint8_t i;
+  char text[64];
+
+  if (reporter_match_all) {
+    return reporter_match_all;
+  }
+  snprintf(text, sizeof(text), "%.*s", (int)len, line);
+  for (i = 0; i < reporter_matches.nb_matches; i++) {
+    match_len = strlen(reporter_matches.match[i]);
+    if ((match_len <= 1) || ((found = strstr(text, reporter_matches.match[i])) == NULL)) {
+      continue;
+    }
+    end = (size_t)(found - text) + match_len;
+    if ((end < best_end) || ((end == best_end) && (match_len > best_len))) {
+      best_end = end;
+      best_len = match_len;
+      best = i + 1;
+    }
+  }
+  return best;
+}
+
+// Random match strings and lines: same lines selected by both filters, same match strings
+static uint32_t bench_check(uint32_t tests) {
+  static char log_lines[BUFFER_SIZE_UP];
+  static char strstr_lines[REPORTER_LINES_SIZE + BUFFER_SIZE_UP];
+  char match_string[MAX_MATCH_STRING_LEN];
+  uint16_t log_len;
+  uint16_t line_start;
+  uint32_t errors = 0;
+  uint32_t t;
+  int line;
+  int len;
+  int i;
+
+  for (t = 0; t < tests; t++) {
+    bench_random_match_string(match_string, "abc");
+    bench_start_reporter(match_string);
+    log_len = 0;
+    for (line = 0; line < 20; line++) {
+      len = rand() % 40;
+      line_start = log_len;
+      for (i = 0; i < len; i++) {
+        log_lines[log_len++] = bench_random_char("abc 0");
+      }
+      if (bench_ac_match(&log_lines[line_start], (uint16_t)len) != bench_reference_match(&log_lines[line_start], (uint16_t)len)) {
+        errors++;
+        printf("match string differs for '%s' line '%.*s'\n", match_string, len, &log_lines[line_start]);
+      }
+      // Never identical to the previous line: not collapsed
+      log_len += (uint16_t)sprintf(&log_lines[log_len], " #%d\n", line);
+    }
+    log_lines[log_len] = '\0';
+    filter_log_lines(log_lines, log_len, lines_to_send, REPORTER_LINES_SIZE);
+    bench_strstr_filter(log_lines, strstr_lines, strstr);
+    if (strcmp(lines_to_send, strstr_lines)) {
+      errors++;
+      printf("selection differs for '%s'\n", match_string);
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  uint32_t repetitions = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20;
+  uint32_t tests = (argc > 2) ? (uint32_t)atoi(argv[2]) : 2000;
+  char match_string[MAX_MATCH_STRING_LEN];
+  bench_traces_t traces;
+  uint8_t counts[] = { 1, 5, 10 };
+  uint32_t errors;
+  double automaton;
+  double strstr_mb;
+  double byte_mb;
+  uint8_t c;
+  uint8_t i;
+
+  srand(1);
+  if (!bench_traces_load(&traces, (argc > 3) ? argv[3] : NULL, BENCH_TRACE_LINES)) {
+    return 1;
+  }
+  printf("%s: %lu bytes, %u repetitions, chunks of %u bytes\n", traces.name,
+         (unsigned long)traces.len, repetitions, BUFFER_SIZE_UP);
+  printf("%8s %14s %11s %16s %8s\n", "patterns", "automaton MB/s", "strstr MB/s", "byte strstr MB/s",
+         "speedup");
+  for (c = 0; c < sizeof(counts); c++) {
+    match_string[0] = '\0';
+    for (i = 0; i < counts[c]; i++) {
+      strcat(match_string, i ? "|" : "");
+      strcat(match_string, bench_patterns[i]);
+    }
+    bench_start_reporter(match_string);
+    automaton = bench_filter(&traces, repetitions, NULL);
+    strstr_mb = bench_filter(&traces, repetitions, strstr);
+    byte_mb = bench_filter(&traces, repetitions, bench_byte_strstr);
+    printf("%8u %14.1f %11.1f %16.1f %7.1fx\n", counts[c], automaton, strstr_mb, byte_mb, automaton / byte_mb);
+  }
+
+  errors = bench_check(tests);
+  printf("speedup: automaton / byte strstr, closer to the target than the host strstr()\n");
+  printf("%u random match strings: %u difference%s with the strstr() filter and match strings\n",
+         tests, errors, (errors != 1) ? "s" : "");
+  return errors ? 1 : 0;
+}
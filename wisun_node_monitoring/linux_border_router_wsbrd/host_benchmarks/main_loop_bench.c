@@ -0,0 +1,168 @@
+/* Host benchmark of the app_task() wake-ups (app_task_deadline.c, with the deadlines of the
+ *  app.c _msec_to_next_deadline())
+ *  One device connected for 'hours', its app_task() loop running app_do_your_things() (model:
+ *  status every auto_send_sec, 60 if 0, heap sample every APP_TRACK_HEAP_PERIOD_S and button
+ *  check every BUTTON_CHECK_DELAY, LED change every second with LEDs) then waiting, without
+ *  any event, as:
+ *   - before: the previous osDelay(), 1 msec on routers, auto_send_sec (60 if 0) on LFNs
+ *   - after:  app_task_deadline_msec() of the router (status, heap, buttons, LEDs) or LFN
+ *     (status) deadlines, capped to APP_TASK_SOCKET_POLL_MSEC for non-blocking UDP/TCP servers
+ *  Time is the sleeptimer stub (now_sec()/now_msec() of app_timestamp.c), advanced by each
+ *  wait (at least 1 msec) from a connection at a random point of a second. LFNs only wake up
+ *  for their status, their heap and buttons are checked at the same time.
+ *  Reports the wake-ups per hour before and after, their ratio and the statuses per hour.
+ *  Fails if 'after' doesn't serve the same statuses, heap samples, button checks and LED
+ *  changes as 'before', or serves one it wakes up for after its deadline second.
+ *  Usage: main_loop_bench [hours]
+ */
+#include "../../app_timestamp.c"
+#include "../../app_task_deadline.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sl_wisun_common.h"
+
+// app.c periods
+#define APP_TASK_DEFAULT_STATUS_PERIOD_S  60
+#define APP_TRACK_HEAP_PERIOD_S            5
+#define BUTTON_CHECK_DELAY                 2
+#define APP_TASK_SOCKET_POLL_MSEC         10
+
+typedef struct {
+  const char *name;
+  bool     router;
+  uint32_t auto_send_sec;
+  bool     heap;          // APP_TRACK_HEAP without the action scheduler
+  bool     buttons;
+  bool     leds;
+  bool     socket_poll;   // non-blocking UDP/TCP servers
+} bench_device_t;
+
+typedef struct {
+  uint64_t wakeups;
+  uint32_t statuses;
+  uint32_t heap_samples;
+  uint32_t button_checks;
+  uint32_t led_changes;
+  uint32_t late;          // served after their deadline second
+} bench_result_t;
+
+uint64_t host_sleeptimer_ticks = 0;
+
+static const bench_device_t bench_devices[] = {
+  // name               router auto_send heap   buttons leds   socket_poll
+  { "router",           true,    0,      true,  false,  false, false },
+  { "router auto 10",   true,   10,      true,  false,  false, false },
+  { "router dev kit",   true,    0,      true,  true,   true,  false },
+  { "router poll",      true,    0,      true,  false,  false, true  },
+  { "lfn",              false,   0,      true,  true,   true,  false },
+  { "lfn auto 300",     false, 300,      true,  true,   true,  false },
+};
+
+// app_do_your_things() check of one deadline: true (and next deadline) if reached
+static bool bench_due(uint64_t *next_sec, uint64_t connected_delay_sec, uint32_t period_sec,
+                      bool waited, bench_result_t *result) {
+  if (connected_delay_sec < *next_sec) {
+    return false;
+  }
+  if (waited && (connected_delay_sec > *next_sec)) {
+    result->late++;
+  }
+  *next_sec = connected_delay_sec + period_sec;
+  return true;
+}
+
+static void bench_run(const bench_device_t *device, bool after, uint32_t hours, bench_result_t *result) {
+  uint32_t status_period_sec = device->auto_send_sec ? device->auto_send_sec : APP_TASK_DEFAULT_STATUS_PERIOD_S;
+  uint64_t deadlines_sec[APP_TASK_DEADLINE_MAX_COUNT];
+  uint64_t connection_timestamp;
+  uint64_t connected_delay_sec;
+  uint64_t next_status_sec, next_heap_sec, next_button_sec;
+  uint64_t led_sec;
+  uint64_t start_tick;
+  uint64_t elapsed_msec = 0;
+  uint32_t delay_msec;
+  uint8_t  count;
+
+  memset(result, 0, sizeof(*result));
+  start_tick = 1000ULL * HOST_SLEEPTIMER_FREQUENCY + 12345;
+  host_sleeptimer_ticks = start_tick;
+  connection_timestamp = now_sec();
+  next_status_sec = next_heap_sec = next_button_sec = now_sec() - connection_timestamp;
+  led_sec = UINT64_MAX;
+
+  while ((connected_delay_sec = now_sec() - connection_timestamp) < (uint64_t)hours * 3600) {
+    // app_do_your_things()
+    if (bench_due(&next_status_sec, connected_delay_sec, status_period_sec, true, result)) {
+      result->statuses++;
+    }
+    if (device->heap
+        && bench_due(&next_heap_sec, connected_delay_sec, APP_TRACK_HEAP_PERIOD_S, device->router, result)) {
+      result->heap_samples++;
+    }
+    if (device->buttons
+        && bench_due(&next_button_sec, connected_delay_sec, BUTTON_CHECK_DELAY, device->router, result)) {
+      result->button_checks++;
+    }
+    if (device->router && device->leds && (connected_delay_sec != led_sec)) {
+      // LEDs follow connected_delay_sec % 4
+      if ((led_sec != UINT64_MAX) && (connected_delay_sec > led_sec + 1)) {
+        result->late++;
+      }
+      led_sec = connected_delay_sec;
+      result->led_changes++;
+    }
+
+    // Wait
+    if (!after) {
+      delay_msec = device->router ? 1 : status_period_sec * 1000;
+    } else {
+      // _msec_to_next_deadline()
+      count = 0;
+      deadlines_sec[count++] = next_status_sec;
+      if (device->router) {
+        if (device->heap   ) { deadlines_sec[count++] = next_heap_sec; }
+        if (device->buttons) { deadlines_sec[count++] = next_button_sec; }
+        if (device->leds   ) { deadlines_sec[count++] = connected_delay_sec + 1; }
+      }
+      delay_msec = app_task_deadline_msec(deadlines_sec, count, connection_timestamp,
+                                          device->socket_poll ? APP_TASK_SOCKET_POLL_MSEC : UINT32_MAX);
+    }
+    result->wakeups++;
+    // Ticks rounded up, for now_msec() to read elapsed_msec
+    elapsed_msec += MAX(delay_msec, 1);
+    host_sleeptimer_ticks = start_tick + (elapsed_msec * HOST_SLEEPTIMER_FREQUENCY + 999) / 1000;
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t hours = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1;
+  bench_result_t before, after;
+  uint32_t errors = 0;
+  size_t i;
+
+  hours = MAX(hours, 1);
+  app_timestamp_init();
+  printf("app_task() loop of a device connected for %u hour(s), no event\n", hours);
+  printf("%-16s %15s %14s %7s %10s %5s\n", "device", "before wakeup/h", "after wakeup/h", "ratio",
+         "statuses/h", "late");
+  for (i = 0; i < sizeof(bench_devices) / sizeof(bench_devices[0]); i++) {
+    bench_run(&bench_devices[i], false, hours, &before);
+    bench_run(&bench_devices[i], true, hours, &after);
+
+    printf("%-16s %15.0f %14.0f %6.0fx %10.0f %5u\n", bench_devices[i].name,
+           (double)before.wakeups / hours, (double)after.wakeups / hours,
+           (double)before.wakeups / after.wakeups, (double)after.statuses / hours, after.late);
+    if ((after.statuses != before.statuses) || (after.heap_samples != before.heap_samples)
+        || (after.button_checks != before.button_checks) || (after.led_changes != before.led_changes)
+        || after.late) {
+      printf("%s: after serves %u/%u/%u/%u statuses/heap/buttons/LEDs (%u late), before %u/%u/%u/%u\n",
+             bench_devices[i].name, after.statuses, after.heap_samples, after.button_checks,
+             after.led_changes, after.late, before.statuses, before.heap_samples,
+             before.button_checks, before.led_changes);
+      errors++;
+    }
+  }
+  return errors ? 1 : 0;
+}
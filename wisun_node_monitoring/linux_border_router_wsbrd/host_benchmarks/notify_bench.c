@@ -0,0 +1,271 @@
+/* Host benchmark of the notification send path (app_notify.c app_notify_send()), with the
+ *  socket and CoAP builder stubs
+ *  Status notifications of a router every period_sec go through the UDP and CoAP sends of
+ *  app.c print_and_send_notification() (console and RTT prints excluded):
+ *   - before: the previous path, snprintf() copies to udp_msg[] and coap_msg[], and an
+ *     sl_malloc() of the CoAP message on each CoAP send
+ *   - json, tlv, tlv delta: app_notify_send() of the JSON text, TLV record or delta-encoded
+ *     record (app_tlv.c), as print_and_send_messages() and print_and_send_notification()
+ *   - connection: the same for the connection message in JSON (app.c _connection_json_string())
+ *   - oversized: binary payloads longer than APP_NOTIFY_MAX_LEN, using the heap fallback
+ *  JSON payloads longer than SL_WISUN_STATUS_JSON_STR_MAX_LEN are not sent over CoAP, as in
+ *  print_and_send_messages().
+ *  Reports per notification: payload bytes, UDP and CoAP datagrams, bytes sent, payload bytes
+ *  copied and heap allocations (sl_malloc() stub), host ns.
+ *  Fails if app_notify_send() allocates for payloads up to APP_NOTIFY_MAX_LEN, or if the
+ *  app_notify_counters() sends, bytes_copied and allocs don't match the datagrams, CoAP
+ *  payload bytes and sl_malloc() calls.
+ *  Usage: notify_bench [notifications] [period_sec] [keyframe_interval]
+ */
+#include "../../app_notify.c"
+#include "../../app_tlv.c"
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "bench_status.h"
+
+#define BENCH_BUF_LEN                    1024
+#define SL_WISUN_STATUS_JSON_STR_MAX_LEN 512   // app.c
+#define BENCH_URI_PATH                   "/status/connection"
+
+uint32_t host_sendto_count;
+uint64_t host_sendto_bytes;
+
+typedef enum {
+  BENCH_JSON_BEFORE,
+  BENCH_JSON,
+  BENCH_CONNECTION_BEFORE,
+  BENCH_CONNECTION,
+  BENCH_TLV,
+  BENCH_TLV_DELTA,
+  BENCH_OVERSIZED,
+  BENCH_FORMATS
+} bench_format_t;
+
+typedef struct {
+  uint64_t payload_bytes;
+  uint32_t udp_sends;
+  uint32_t coap_sends;
+  uint64_t sent_bytes;
+  uint64_t bytes_copied;
+  uint32_t allocs;
+  uint64_t ns;
+  app_notify_counters_t counters;
+} bench_result_t;
+
+static char udp_msg[BENCH_BUF_LEN];
+static char coap_msg[BENCH_BUF_LEN];
+static sl_wisun_coap_packet_t bench_coap_pkt;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// app.c _connection_json_string()
+static uint16_t bench_connection_json(const bench_status_t *status, char *buf, uint16_t size) {
+  char running[20];
+
+  return (uint16_t)snprintf(buf, size,
+                            "{\n"
+                            "\"ipv6\":\"%s\",\n"
+                            "\"device\":\"%s\",\n"
+                            "\"chip\":\"%s\",\n"
+                            "\"type\":\"%s\",\n"
+                            "\"MAC\":\"%s\",\n"
+                            "\"parent\":\"%s\",\n"
+                            "\"rpl_rank\":\"%d\",\n"
+                            "\"etx\":\"%d\",\n"
+                            "\"routing_cost\":\"%d\",\n"
+                            "\"rsl_in\":\"%d\",\n"
+                            "\"rsl_out\":\"%d\",\n"
+                            "\"running\":\"%s\",\n"
+                            "\"msg_count\":\"%ld\",\n"
+                            "\"PAN_ID\":\"0x%04x (%d)\",\n"
+                            "\"preferred_pan_id\":\"0x%04x (%d)\",\n"
+                            "\"hop_count\":\"%d\",\n"
+                            "\"join_states_sec\": \"%llu %llu %llu %llu %llu\",\n"
+                            "\"application\": \"%s\"\n"
+                            "}\n",
+                            status->ipv6_string, status->tag, "xG25", "FFN", status->mac_string,
+                            status->parent, status->rpl_rank, status->etx,
+                            status->rpl_rank + status->etx / 2, status->rsl_in, status->rsl_out,
+                            bench_status_dhms(status->running_sec, running), (long)status->msg_count,
+                            0x1234, 0x1234, 0xffff, 0xffff, 2,
+                            12ULL, 15ULL, 31ULL, 45ULL, 62ULL, "Wi-SUN Node Monitoring V6.0.0");
+}
+
+// Previous print_and_send_messages() and _coap_notify() sends. Returns the bytes copied
+static uint32_t bench_send_before(const char *in_msg, bool to_udp, bool to_coap) {
+  const sockaddr_in6_t addr = { 0 };
+  uint32_t copied = 0;
+  uint16_t udp_msg_len;
+  uint16_t coap_msg_len;
+  uint16_t req_buff_size;
+  uint8_t *buff;
+
+  if (to_udp) {
+    udp_msg_len = (uint16_t)snprintf(udp_msg, sizeof(udp_msg), "%s", in_msg);
+    copied += udp_msg_len;
+    sendto(1, udp_msg, udp_msg_len, 0, (const struct sockaddr *)&addr, sizeof(addr));
+  }
+  if (to_coap) {
+    coap_msg_len = (uint16_t)snprintf(coap_msg, sizeof(coap_msg), "%s", in_msg);
+    copied += coap_msg_len;
+    if (coap_msg_len <= SL_WISUN_STATUS_JSON_STR_MAX_LEN) {
+      bench_coap_pkt.payload_ptr = (uint8_t *)coap_msg;
+      bench_coap_pkt.payload_len = coap_msg_len;
+      req_buff_size = sl_wisun_coap_builder_calc_size(&bench_coap_pkt);
+      buff = (uint8_t *)sl_malloc(req_buff_size);
+      sl_wisun_coap_builder(buff, &bench_coap_pkt);
+      copied += coap_msg_len;
+      sendto(2, buff, req_buff_size, 0, (const struct sockaddr *)&addr, sizeof(addr));
+      sl_free(buff);
+    }
+  }
+  return copied;
+}
+
+// print_and_send_messages()/print_and_send_notification() sends. Returns the CoAP payload bytes
+static uint32_t bench_send(const uint8_t *msg, uint16_t msg_len, bool binary, bool to_udp, bool to_coap) {
+  if (!binary && (msg_len > SL_WISUN_STATUS_JSON_STR_MAX_LEN)) {
+    to_coap = false;
+  }
+  app_notify_send(msg, msg_len, binary, to_udp, to_coap);
+  return to_coap ? msg_len : 0;
+}
+
+int main(int argc, char **argv) {
+  uint32_t notifications     = (argc > 1) ? (uint32_t)atoi(argv[1]) : 10000;
+  uint32_t period_sec        = (argc > 2) ? (uint32_t)atoi(argv[2]) : 60;
+  uint16_t keyframe_interval = (argc > 3) ? (uint16_t)atoi(argv[3]) : 10;
+  const char *names[BENCH_FORMATS] = { "json before", "json", "conn before", "connection", "tlv",
+                                       "tlv delta", "oversized" };
+  static bench_result_t results[BENCH_FORMATS];
+  const sockaddr_in6_t addr = { 0 };
+  bench_status_t status;
+  app_tlv_delta_t delta;
+  char json[BENCH_BUF_LEN];
+  uint8_t record[BENCH_BUF_LEN];
+  uint8_t msg[BENCH_BUF_LEN];
+  bench_result_t *r;
+  uint32_t errors = 0;
+  uint32_t sendto_count;
+  uint64_t sendto_bytes;
+  uint32_t malloc_count;
+  uint32_t coap_bytes = 0;
+  uint32_t copied = 0;
+  uint64_t start;
+  uint16_t record_len;
+  uint16_t len = 0;
+  uint32_t n;
+  int f;
+
+  srand(1);
+  notifications = notifications ? notifications : 1;
+  bench_status_init(&status);
+  app_tlv_delta_reset(&delta);
+  app_notify_set_udp(1, &addr);
+  app_notify_set_coap(2, &addr, BENCH_URI_PATH);
+  bench_coap_pkt.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+  bench_coap_pkt.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+  bench_coap_pkt.content_format = COAP_CT_JSON;
+  bench_coap_pkt.uri_path_ptr = (uint8_t *)BENCH_URI_PATH;
+  bench_coap_pkt.uri_path_len = (uint16_t)strlen(BENCH_URI_PATH);
+
+  for (n = 0; n < notifications; n++) {
+    bench_status_step(&status, period_sec);
+    record_len = bench_status_tlv(&status, record, sizeof(record));
+    for (f = 0; f < BENCH_FORMATS; f++) {
+      r = &results[f];
+      // Payload (formatting not timed)
+      switch (f) {
+        case BENCH_JSON_BEFORE:
+        case BENCH_JSON:
+          len = (uint16_t)bench_status_json(&status, json, sizeof(json));
+          break;
+        case BENCH_CONNECTION_BEFORE:
+        case BENCH_CONNECTION:
+          len = bench_connection_json(&status, json, sizeof(json));
+          break;
+        case BENCH_TLV:
+          len = record_len;
+          break;
+        case BENCH_TLV_DELTA:
+          len = app_tlv_delta_encode(&delta, keyframe_interval, record, record_len, msg, sizeof(msg));
+          break;
+        case BENCH_OVERSIZED:
+          for (len = 0; len <= APP_NOTIFY_MAX_LEN; len = (uint16_t)(len + record_len)) {
+            memcpy(msg + len, record, record_len);
+          }
+          break;
+      }
+      sendto_count = host_sendto_count;
+      sendto_bytes = host_sendto_bytes;
+      malloc_count = host_malloc_count;
+      app_notify_reset();
+      start = bench_ns();
+      switch (f) {
+        case BENCH_JSON_BEFORE:
+        case BENCH_CONNECTION_BEFORE:
+          copied = bench_send_before(json, true, true);
+          coap_bytes = (len <= SL_WISUN_STATUS_JSON_STR_MAX_LEN) ? len : 0;
+          break;
+        case BENCH_JSON:
+        case BENCH_CONNECTION:
+          coap_bytes = bench_send((const uint8_t *)json, len, false, true, true);
+          break;
+        case BENCH_TLV:
+          coap_bytes = bench_send(record, len, true, true, true);
+          break;
+        default:
+          coap_bytes = bench_send(msg, len, true, true, true);
+          break;
+      }
+      r->ns += bench_ns() - start;
+      r->payload_bytes += len;
+      r->udp_sends++;
+      r->coap_sends += coap_bytes ? 1 : 0;
+      r->sent_bytes += host_sendto_bytes - sendto_bytes;
+      r->allocs += host_malloc_count - malloc_count;
+      if ((f == BENCH_JSON_BEFORE) || (f == BENCH_CONNECTION_BEFORE)) {
+        r->bytes_copied += copied;
+        continue;
+      }
+      app_notify_counters(&r->counters);
+      r->bytes_copied += r->counters.bytes_copied;
+      // The counters reported by /statistics/app/notifications
+      if ((r->counters.sends != host_sendto_count - sendto_count)
+          || (r->counters.bytes_copied != coap_bytes)
+          || (r->counters.allocs != host_malloc_count - malloc_count)
+          || ((len <= APP_NOTIFY_MAX_LEN) && (host_malloc_count != malloc_count))) {
+        errors++;
+      }
+    }
+  }
+
+  printf("%u status notifications to UDP and CoAP, every %u s, keyframe every %u messages\n",
+         notifications, period_sec, keyframe_interval);
+  printf("%-12s %10s %8s %8s %10s %11s %11s %8s\n", "format", "bytes/msg", "udp/msg", "coap/msg",
+         "sent/msg", "copied/msg", "allocs/msg", "ns/msg");
+  for (f = 0; f < BENCH_FORMATS; f++) {
+    r = &results[f];
+    printf("%-12s %10.1f %8.2f %8.2f %10.1f %11.1f %11.2f %8.1f\n", names[f],
+           (double)r->payload_bytes / notifications,
+           (double)r->udp_sends / notifications,
+           (double)r->coap_sends / notifications,
+           (double)r->sent_bytes / notifications,
+           (double)r->bytes_copied / notifications,
+           (double)r->allocs / notifications,
+           (double)r->ns / notifications);
+  }
+  if (errors) {
+    printf("%u notifications with allocations below APP_NOTIFY_MAX_LEN, or app_notify counters "
+           "not matching the sends, copies and allocations\n", errors);
+    return 1;
+  }
+  return 0;
+}
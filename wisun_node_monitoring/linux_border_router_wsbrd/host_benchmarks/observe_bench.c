@@ -0,0 +1,185 @@
+/* Host benchmark of the Observe change key (app_coap_change_key.c app_coap_change_key(),
+ *  used by app_coap_observe.c _app_coap_observe_hash()) on /status/all
+ *  An observer registers at t=0 and is checked as by _app_coap_observe_check(): every pmin,
+ *  notified if the change key of the payload changed, or after pmax without notification.
+ *  The /status/all payload is that of coap_callback_all_statuses(), with the running and
+ *  connected times of the check, a parent and a neighbor count changing as Poisson processes.
+ *  The change key is computed with the whole payload (NULL) then without the values of the
+ *  volatile fields of /status/all ("running|connected", _change_keys[] of app_coap_observe.c).
+ *  Reports checks, notifications (per hour), status changes, min/max gap between
+ *  notifications and host ns per change key.
+ *  Fails if notifications are less than pmin or more than pmax apart, or if the change key
+ *  without the volatile fields differs between payloads differing only in their values.
+ *  Usage: observe_bench [pmin_sec] [pmax_sec] [hours] [parent_change_min] [neighbor_change_min]
+ */
+#include "../../app_coap_change_key.c"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sl_wisun_common.h"
+
+#define BENCH_STATUS_ALL_VOLATILE_FIELDS "running|connected"
+#define BENCH_PAYLOAD_LEN                256
+
+typedef struct {
+  uint32_t checks;
+  uint32_t notifications;
+  uint32_t changes;
+  uint32_t min_gap_sec;
+  uint32_t max_gap_sec;
+  uint32_t key_errors;
+  uint64_t ns;
+} bench_result_t;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Exponential delay of mean 'mean_sec', for Poisson processes
+static double bench_exp(double mean_sec) {
+  return -log(1.0 - (double)rand() / ((double)RAND_MAX + 1.0)) * mean_sec;
+}
+
+// dhms_r() format of app_timestamp.c
+static void bench_dhms(uint32_t secs, char *buf, size_t size) {
+  snprintf(buf, size, "%u-%02u:%02u:%02u", secs / 86400, (secs / 3600) % 24, (secs / 60) % 60, secs % 60);
+}
+
+// coap_callback_all_statuses() payload (app_coap.c)
+static uint16_t bench_status_all(char *buf, uint32_t running_sec, uint32_t connected_sec,
+                                 uint16_t parent, uint8_t neighbor_count) {
+  char running_str[40];
+  char connected_str[40];
+
+  bench_dhms(running_sec, running_str, sizeof(running_str));
+  bench_dhms(connected_sec, connected_str, sizeof(connected_str));
+  return (uint16_t)snprintf(buf, BENCH_PAYLOAD_LEN,
+                            "{\n"
+                            "  \"running\": \"%s\",\n"
+                            "  \"connected\": \"%s\",\n"
+                            "  \"parent\": \"%04x\",\n"
+                            "  \"neighbor_count\": \"%d\"\n"
+                            "}\n",
+                            running_str, connected_str, parent, neighbor_count);
+}
+
+static uint32_t bench_key(const char *payload, uint16_t len, const char *volatile_fields,
+                          bench_result_t *result) {
+  uint64_t start = bench_ns();
+  uint32_t key = app_coap_change_key((const uint8_t *)payload, len, volatile_fields);
+
+  result->ns += bench_ns() - start;
+  return key;
+}
+
+static void bench_run(uint32_t pmin_sec, uint32_t pmax_sec, uint32_t duration_sec, double parent_change_sec,
+                      double neighbor_change_sec, const char *volatile_fields, bench_result_t *result) {
+  char payload[BENCH_PAYLOAD_LEN];
+  char other[BENCH_PAYLOAD_LEN];
+  uint16_t parent = (uint16_t)rand();
+  uint8_t neighbor_count = 3;
+  uint32_t observer_key;
+  uint32_t key;
+  uint32_t last_notify = 0;
+  uint32_t next_check = pmin_sec;
+  uint32_t max_age;
+  uint32_t t;
+  uint16_t len;
+  double next_parent = bench_exp(parent_change_sec);
+  double next_neighbor = bench_exp(neighbor_change_sec);
+
+  // Registration
+  len = bench_status_all(payload, 0, 0, parent, neighbor_count);
+  observer_key = bench_key(payload, len, volatile_fields, result);
+  result->notifications = 1;
+  result->min_gap_sec = UINT32_MAX;
+  while (next_check < duration_sec) {
+    t = next_check;
+    while (next_parent <= t) {
+      parent = (uint16_t)rand();
+      result->changes++;
+      next_parent += bench_exp(parent_change_sec);
+    }
+    while (next_neighbor <= t) {
+      neighbor_count = (rand() & 1) ? neighbor_count + 1 : MAX(neighbor_count - 1, 1);
+      result->changes++;
+      next_neighbor += bench_exp(neighbor_change_sec);
+    }
+    // _app_coap_observe_check()
+    max_age = last_notify + pmax_sec;
+    next_check = MIN(t + pmin_sec, max_age);
+    result->checks++;
+    len = bench_status_all(payload, t, t, parent, neighbor_count);
+    key = bench_key(payload, len, volatile_fields, result);
+    if (volatile_fields != NULL) {
+      // Same status read at another time
+      len = bench_status_all(other, t + 86400 + 3599, t / 2, parent, neighbor_count);
+      if (app_coap_change_key((const uint8_t *)other, len, volatile_fields) != key) {
+        result->key_errors++;
+      }
+    }
+    if ((key == observer_key) && (t < max_age)) {
+      continue;
+    }
+    observer_key = key;
+    result->min_gap_sec = MIN(result->min_gap_sec, t - last_notify);
+    result->max_gap_sec = MAX(result->max_gap_sec, t - last_notify);
+    last_notify = t;
+    next_check = t + pmin_sec;
+    result->notifications++;
+  }
+  if (result->min_gap_sec == UINT32_MAX) {
+    result->min_gap_sec = 0;
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t pmin_sec = (argc > 1) ? (uint32_t)atoi(argv[1]) : 10;
+  uint32_t pmax_sec = (argc > 2) ? (uint32_t)atoi(argv[2]) : 300;
+  uint32_t hours = (argc > 3) ? (uint32_t)atoi(argv[3]) : 24;
+  uint32_t parent_change_min = (argc > 4) ? (uint32_t)atoi(argv[4]) : 120;
+  uint32_t neighbor_change_min = (argc > 5) ? (uint32_t)atoi(argv[5]) : 20;
+  const char *names[] = { "whole payload", "running|connected out" };
+  const char *volatile_fields[] = { NULL, BENCH_STATUS_ALL_VOLATILE_FIELDS };
+  bench_result_t result;
+  uint32_t errors = 0;
+  uint32_t key_errors = 0;
+  int i;
+
+  pmin_sec = MAX(pmin_sec, 1);
+  pmax_sec = MAX(pmax_sec, pmin_sec);
+  hours = MAX(hours, 1);
+  printf("/status/all observer, pmin %u s, pmax %u s, %u h, parent change every %u min, "
+         "neighbor count change every %u min (average)\n",
+         pmin_sec, pmax_sec, hours, parent_change_min, neighbor_change_min);
+  printf("%-22s %7s %7s %9s %8s %8s %8s %8s\n", "change key", "checks", "notif.", "notif./h", "changes",
+         "min gap", "max gap", "ns/key");
+  for (i = 0; i < 2; i++) {
+    // Same status changes for both change keys
+    srand(1);
+    memset(&result, 0, sizeof(result));
+    bench_run(pmin_sec, pmax_sec, hours * 3600, parent_change_min * 60.0, neighbor_change_min * 60.0,
+              volatile_fields[i], &result);
+    if ((result.notifications > 1)
+        && ((result.min_gap_sec < pmin_sec) || (result.max_gap_sec > pmax_sec))) {
+      errors++;
+    }
+    key_errors += result.key_errors;
+    printf("%-22s %7u %7u %9.1f %8u %8u %8u %8.1f\n", names[i], result.checks, result.notifications,
+           (double)result.notifications / hours, result.changes, result.min_gap_sec, result.max_gap_sec,
+           (double)result.ns / (result.checks + 1));
+  }
+  if (errors) {
+    printf("notifications less than pmin or more than pmax apart\n");
+  }
+  if (key_errors) {
+    printf("%u change keys depending on the volatile fields\n", key_errors);
+  }
+  return (errors || key_errors) ? 1 : 0;
+}
@@ -0,0 +1,405 @@
+/* Host benchmark of the CoAP request parsing in place (app_coap_parse.c) and of the
+ *  parameter assignments (app_parameters_scan.c scan_app_parameter())
+ *  Representative requests of the app_coap.c handlers, parsed as the handlers do:
+ *   - payloads: /settings/auto_send, /settings/trace_level, "reset", "max_age_ms <ms>",
+ *     an IPv6 address, /settings/parameter PUTs (int, IPv6 and quoted string values, a
+ *     quoted value containing ';') and a transaction (assignments split in place by
+ *     find_app_parameters_separator(), as set_app_parameters_transaction() does)
+ *   - URI queries: group requests ('g', 'if') and /batch ('fmt', 'f')
+ *  against the previous handlers: a NUL-terminated copy of the payload on the heap
+ *  (sl_wisun_coap_get_payload_str()) parsed with sscanf(), then freed.
+ *  Reports host ns and heap allocations (sl_malloc() stub) per request of both.
+ *  Fails if a request is not parsed to its expected values (a single parameter PUT taken
+ *  as a transaction included), or if the parsing in place allocates.
+ *  Usage: parse_bench [repetitions]
+ */
+#include "../../app_coap_parse.c"
+#include "../../app_parameters_scan.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sl_memory_manager.h"
+
+#define BENCH_VALUE_STR_LEN     1000   // value_str of coap_callback_setting_parameter()
+#define APP_COAP_BLOCK1_MAX_LEN 512    // app_coap.h
+
+typedef struct {
+  const char *name;
+  const char *payload;
+  const char *query;
+  bool (*parse)(const sl_wisun_coap_packet_t *req_packet);
+  bool (*parse_before)(const sl_wisun_coap_packet_t *req_packet);
+} bench_request_t;
+
+static volatile uint32_t bench_sink;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// sl_wisun_coap_get_payload_str(): NUL-terminated copy of the payload, on the heap
+static char *bench_get_payload_str(const sl_wisun_coap_packet_t *req_packet) {
+  char *str = (char *)sl_malloc(req_packet->payload_len + 1);
+
+  if (str != NULL) {
+    memcpy(str, req_packet->payload_ptr, req_packet->payload_len);
+    str[req_packet->payload_len] = '\0';
+  }
+  return str;
+}
+
+// coap_callback_auto_send()
+static bool bench_auto_send(const sl_wisun_coap_packet_t *req_packet) {
+  app_coap_token_t token;
+  uint32_t sec = 0;
+
+  if ((app_coap_payload_tokens(req_packet, &token, 1) != 1) || !app_coap_token_uint(&token, &sec)) {
+    return false;
+  }
+  bench_sink += sec;
+  return sec == 60;
+}
+
+static bool bench_auto_send_before(const sl_wisun_coap_packet_t *req_packet) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  int sec = 0;
+  int res = 0;
+
+  if (payload_str != NULL) {
+    res = sscanf(payload_str, "%d", &sec);
+  }
+  sl_free(payload_str);
+  bench_sink += (uint32_t)sec;
+  return (res == 1) && (sec == 60);
+}
+
+// coap_callback_trace_level()
+static bool bench_trace_level(const sl_wisun_coap_packet_t *req_packet) {
+  app_coap_token_t tokens[2];
+  int32_t group = 0;
+  int32_t level = 0;
+
+  if ((app_coap_payload_tokens(req_packet, tokens, 2) != 2)
+      || !app_coap_token_int(&tokens[0], &group) || !app_coap_token_int(&tokens[1], &level)) {
+    return false;
+  }
+  bench_sink += (uint32_t)(group + level);
+  return (group == 3) && (level == 4);
+}
+
+static bool bench_trace_level_before(const sl_wisun_coap_packet_t *req_packet) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  int group = 0;
+  int level = 0;
+  int res = 0;
+
+  if (payload_str != NULL) {
+    res = sscanf(payload_str, "%d %d", &group, &level);
+  }
+  sl_free(payload_str);
+  bench_sink += (uint32_t)(group + level);
+  return (res == 2) && (group == 3) && (level == 4);
+}
+
+// "reset" of the statistics resources
+static bool bench_reset(const sl_wisun_coap_packet_t *req_packet) {
+  return app_coap_payload_is(req_packet, "reset");
+}
+
+static bool bench_reset_before(const sl_wisun_coap_packet_t *req_packet) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  char cmd[40];
+  bool reset = false;
+
+  if ((payload_str != NULL) && (sscanf(payload_str, "%39s", cmd) == 1)) {
+    reset = !strcmp(cmd, "reset");
+  }
+  sl_free(payload_str);
+  return reset;
+}
+
+// "max_age_ms <ms>" of the statistics snapshot
+static bool bench_max_age(const sl_wisun_coap_packet_t *req_packet) {
+  app_coap_token_t tokens[2];
+  uint32_t max_age_ms = 0;
+
+  if ((app_coap_payload_tokens(req_packet, tokens, 2) != 2)
+      || !app_coap_token_is(&tokens[0], "max_age_ms") || !app_coap_token_uint(&tokens[1], &max_age_ms)) {
+    return false;
+  }
+  bench_sink += max_age_ms;
+  return max_age_ms == 5000;
+}
+
+static bool bench_max_age_before(const sl_wisun_coap_packet_t *req_packet) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  char cmd[40];
+  unsigned long max_age_ms = 0;
+  bool ok = false;
+
+  if ((payload_str != NULL) && (sscanf(payload_str, "%39s %lu", cmd, &max_age_ms) == 2)) {
+    ok = !strcmp(cmd, "max_age_ms") && (max_age_ms == 5000);
+  }
+  sl_free(payload_str);
+  bench_sink += (uint32_t)max_age_ms;
+  return ok;
+}
+
+// IPv6 address payload (reporter and notification destinations)
+static const uint8_t bench_ipv6[16] = { 0xfd, 0x00, 0x61, 0x72, 0x6d, 0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02 };
+
+static bool bench_ipv6_address(const sl_wisun_coap_packet_t *req_packet) {
+  app_coap_token_t token;
+  in6_addr_t address;
+
+  if ((app_coap_payload_tokens(req_packet, &token, 1) != 1) || !app_coap_token_ipv6(&token, &address)) {
+    return false;
+  }
+  bench_sink += address.address[15];
+  return !memcmp(address.address, bench_ipv6, sizeof(bench_ipv6));
+}
+
+static bool bench_ipv6_address_before(const sl_wisun_coap_packet_t *req_packet) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  char str[48];
+  in6_addr_t address;
+  bool ok = false;
+
+  if ((payload_str != NULL) && (sscanf(payload_str, "%47s", str) == 1)) {
+    ok = sl_wisun_stoip6(str, strlen(str), &address)
+         && !memcmp(address.address, bench_ipv6, sizeof(bench_ipv6));
+  }
+  sl_free(payload_str);
+  bench_sink += address.address[15];
+  return ok;
+}
+
+// coap_callback_setting_parameter() PUT: the payload copy (in the response buffer) is scanned
+static bool bench_parameter(const sl_wisun_coap_packet_t *req_packet, const char *name, int expected_index,
+                            uint32_t expected_value, const char *expected_str) {
+  char payload_str[APP_COAP_BLOCK1_MAX_LEN + 1];
+  char parameter_name[APP_PARAMETER_NAME_MAX_LEN];
+  char value_str[BENCH_VALUE_STR_LEN];
+  app_coap_token_t payload;
+  uint32_t value = 0;
+  int index = 10;
+
+  payload.ptr = (const char *)req_packet->payload_ptr;
+  payload.len = req_packet->payload_len;
+  if (!app_coap_token_copy(&payload, payload_str, sizeof(payload_str))) {
+    return false;
+  }
+  if (find_app_parameters_separator(payload_str) != NULL) {
+    // Would be handled as a transaction
+    return false;
+  }
+  sprintf(value_str, "%s", "(no_value_str)");
+  if (scan_app_parameter(payload_str, parameter_name, &index, &value, value_str) != 3) {
+    return false;
+  }
+  bench_sink += value;
+  return !strcmp(parameter_name, name) && (index == expected_index)
+         && (expected_str ? !strcmp(value_str, expected_str) : (value == expected_value));
+}
+
+// The sscanf() cascade of the previous coap_callback_setting_parameter()
+static bool bench_parameter_before(const sl_wisun_coap_packet_t *req_packet, const char *name,
+                                   int expected_index, uint32_t expected_value, const char *expected_str) {
+  char *payload_str = bench_get_payload_str(req_packet);
+  char parameter_name[APP_PARAMETER_NAME_MAX_LEN];
+  char value_str[BENCH_VALUE_STR_LEN];
+  long value = 0;
+  int index = 10;
+  int done = 0;
+
+  sprintf(value_str, "%s", "(no_value_str)");
+  if (payload_str != NULL) {
+    if (3 == sscanf(payload_str, "%39s %d %ld", parameter_name, &index, &value)) { done = 1; }
+    if (!done && (3 == sscanf(payload_str, "%39s %d %999s", parameter_name, &index, value_str))) { done = 2; }
+  }
+  sl_free(payload_str);
+  bench_sink += (uint32_t)value;
+  return done && !strcmp(parameter_name, name) && (index == expected_index)
+         && (expected_str ? !strcmp(value_str, expected_str) : ((uint32_t)value == expected_value));
+}
+
+#define BENCH_PARAMETER(fn, name, index, value, str)                                \
+  static bool fn(const sl_wisun_coap_packet_t *req_packet) {                       \
+    return bench_parameter(req_packet, name, index, value, str);                   \
+  }                                                                                \
+  static bool fn##_before(const sl_wisun_coap_packet_t *req_packet) {              \
+    return bench_parameter_before(req_packet, name, index, value, str);            \
+  }
+
+BENCH_PARAMETER(bench_param_int, "auto_send_sec", 0, 60, NULL)
+BENCH_PARAMETER(bench_param_ipv6, "udp_notif_dest", 1, 0, "fd00:6172:6d00::2")
+// The previous sscanf() stopped at the first space of a quoted string
+BENCH_PARAMETER(bench_param_quoted, "network_name", 0, 0, "\"Wi-SUN Network\"")
+// A ';' inside a quoted value doesn't make it a transaction
+BENCH_PARAMETER(bench_param_semicolon, "network_name", 0, 0, "\"Wi;SUN\"")
+
+// set_app_parameters_transaction() split and scan of its assignments
+static bool bench_transaction(const sl_wisun_coap_packet_t *req_packet) {
+  static const char *names[] = { "auto_send_sec", "network_name" };
+  static const char *values[] = { NULL, "'a;b'" };
+  char payload_str[APP_COAP_BLOCK1_MAX_LEN + 1];
+  char parameter_name[APP_PARAMETER_NAME_MAX_LEN];
+  char value_str[BENCH_VALUE_STR_LEN];
+  app_coap_token_t payload;
+  uint32_t value;
+  uint8_t count = 0;
+  int index;
+  char *c;
+  char *next;
+
+  payload.ptr = (const char *)req_packet->payload_ptr;
+  payload.len = req_packet->payload_len;
+  if (!app_coap_token_copy(&payload, payload_str, sizeof(payload_str))
+      || (find_app_parameters_separator(payload_str) == NULL)) {
+    return false;
+  }
+  for (c = payload_str; c != NULL; c = next) {
+    next = find_app_parameters_separator(c);
+    if (next != NULL) {
+      *next++ = '\0';
+    }
+    while (*c == ' ') { c++; }
+    if (*c == '\0') {
+      continue;
+    }
+    if (count == sizeof(names) / sizeof(names[0])) {
+      return false;
+    }
+    index = 10;
+    value = 0;
+    sprintf(value_str, "%s", "(no_value_str)");
+    if ((scan_app_parameter(c, parameter_name, &index, &value, value_str) != 3)
+        || strcmp(parameter_name, names[count])
+        || (values[count] ? strcmp(value_str, values[count]) : (value != 60))) {
+      return false;
+    }
+    bench_sink += value;
+    count++;
+  }
+  return count == sizeof(names) / sizeof(names[0]);
+}
+
+// _app_coap_group_check() and app_coap_group_leisure_ms() of a group request
+static bool bench_group(const sl_wisun_coap_packet_t *req_packet) {
+  app_coap_token_t param;
+  uint32_t group_size = 0;
+
+  if (!app_coap_query_param(req_packet, "g", &param) || !app_coap_token_uint(&param, &group_size)
+      || !app_coap_query_param(req_packet, "if", &param)) {
+    return false;
+  }
+  bench_sink += group_size + param.len;
+  return (group_size == 20) && app_coap_token_is(&param, "parent:a1b2");
+}
+
+// coap_callback_batch() selectors
+static bool bench_batch(const sl_wisun_coap_packet_t *req_packet) {
+  char selectors[200];
+  app_coap_token_t param;
+  bool tlv;
+
+  tlv = app_coap_query_param(req_packet, "fmt", &param) && app_coap_token_is(&param, "tlv");
+  if (!app_coap_query_param(req_packet, "f", &param)
+      || !app_coap_token_copy(&param, selectors, sizeof(selectors))) {
+    return false;
+  }
+  bench_sink += (uint32_t)strlen(selectors);
+  return tlv && !strcmp(selectors, "running,connected,parent");
+}
+
+static const bench_request_t bench_requests[] = {
+  { "auto_send",         "60",                                NULL, bench_auto_send,    bench_auto_send_before },
+  { "trace_level",       "3 4",                               NULL, bench_trace_level,  bench_trace_level_before },
+  { "reset",             "reset",                             NULL, bench_reset,        bench_reset_before },
+  { "max_age_ms",        "max_age_ms 5000",                   NULL, bench_max_age,      bench_max_age_before },
+  { "ipv6",              "fd00:6172:6d00::2",                 NULL, bench_ipv6_address, bench_ipv6_address_before },
+  { "parameter int",     "auto_send_sec 0 60",                NULL, bench_param_int,    bench_param_int_before },
+  { "parameter ipv6",    "udp_notif_dest 1 fd00:6172:6d00::2", NULL, bench_param_ipv6,  bench_param_ipv6_before },
+  { "parameter quoted",  "network_name 0 \"Wi-SUN Network\"", NULL, bench_param_quoted, bench_param_quoted_before },
+  { "parameter ';'",     "network_name 0 \"Wi;SUN\"",         NULL, bench_param_semicolon, bench_param_semicolon_before },
+  { "transaction",       "auto_send_sec 0 60;network_name 0 'a;b'", NULL, bench_transaction, NULL },
+  { "group query",       NULL, "g=20&if=parent:a1b2",               bench_group,        NULL },
+  { "batch query",       NULL, "fmt=tlv&f=running,connected,parent", bench_batch,       NULL },
+};
+
+// Host ns and allocations per request of 'parse', false if a request is not parsed as expected
+static bool bench_run(bool (*parse)(const sl_wisun_coap_packet_t *), const sl_wisun_coap_packet_t *req_packet,
+                      uint32_t reps, double *ns, double *allocs) {
+  uint32_t malloc_count = host_malloc_count;
+  uint64_t start;
+  bool ok = true;
+  uint32_t r;
+
+  start = bench_ns();
+  for (r = 0; r < reps; r++) {
+    ok &= parse(req_packet);
+  }
+  *ns = (double)(bench_ns() - start) / reps;
+  *allocs = (double)(host_malloc_count - malloc_count) / reps;
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  uint32_t reps = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+  const bench_request_t *request;
+  sl_wisun_coap_packet_t req_packet;
+  sn_coap_options_list_s options;
+  double ns, allocs, ns_before, allocs_before;
+  uint32_t errors = 0;
+  uint32_t allocating = 0;
+  size_t i;
+
+  reps = MAX(reps, 1);
+  printf("CoAP request parsing, %u repetitions, host ns and heap allocations per request\n", reps);
+  printf("%-17s %-36s %9s %9s %13s %7s\n", "request", "payload or query", "ns before", "ns",
+         "allocs before", "allocs");
+  for (i = 0; i < sizeof(bench_requests) / sizeof(bench_requests[0]); i++) {
+    request = &bench_requests[i];
+    memset(&req_packet, 0, sizeof(req_packet));
+    memset(&options, 0, sizeof(options));
+    req_packet.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+    req_packet.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+    if (request->payload != NULL) {
+      req_packet.payload_ptr = (uint8_t *)request->payload;
+      req_packet.payload_len = (uint16_t)strlen(request->payload);
+    }
+    if (request->query != NULL) {
+      options.uri_query_ptr = (uint8_t *)request->query;
+      options.uri_query_len = (uint16_t)strlen(request->query);
+      req_packet.options_list_ptr = &options;
+    }
+    if (!bench_run(request->parse, &req_packet, reps, &ns, &allocs)) {
+      printf("%s: not parsed as expected\n", request->name);
+      errors++;
+    }
+    if (allocs != 0) {
+      allocating++;
+    }
+    if (request->parse_before != NULL) {
+      // The previous quoted string value was cut at its first space: not an error of this benchmark
+      (void)bench_run(request->parse_before, &req_packet, reps, &ns_before, &allocs_before);
+      printf("%-17s %-36s %9.1f %9.1f %13.2f %7.2f\n", request->name,
+             request->payload ? request->payload : request->query, ns_before, ns, allocs_before, allocs);
+    } else {
+      printf("%-17s %-36s %9s %9.1f %13s %7.2f\n", request->name,
+             request->payload ? request->payload : request->query, "-", ns, "-", allocs);
+    }
+  }
+  if (errors) {
+    printf("%u requests not parsed as expected\n", errors);
+  }
+  if (allocating) {
+    printf("%u requests parsed in place with heap allocations\n", allocating);
+  }
+  return (errors || allocating) ? 1 : 0;
+}
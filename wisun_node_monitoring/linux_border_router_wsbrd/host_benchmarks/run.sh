@@ -0,0 +1,37 @@
+#!/bin/bash
+# Build and run the host benchmarks, which compile the application C modules with the
+#  host stubs of the SDK (stubs/): host_benchmarks/run.sh [benchmark [args]]
+#  Without argument, all *_bench.c are run with their default arguments
+# Usage examples:
+#  host_benchmarks/run.sh
+#  host_benchmarks/run.sh scheduler 10000
+
+dir=$(cd "$(dirname "$0")" && pwd)
+build=${BUILD_DIR:-/tmp/host_benchmarks}
+CC=${CC:-cc}
+mkdir -p "${build}"
+
+run_bench () {
+  name=$1
+  shift
+  if ! ${CC} -O2 -Wall -Wextra -pthread -I"${dir}/stubs" -I"${dir}/stubs/socket" -I"${dir}/../.." \
+       "${dir}/${name}_bench.c" -o "${build}/${name}_bench" -lm; then
+    echo "${name}: build failed"
+    return 1
+  fi
+  echo "=== ${name}"
+  "${build}/${name}_bench" "$@"
+}
+
+if [ $# -gt 0 ]; then
+  run_bench "$@"
+  exit $?
+fi
+
+status=0
+for bench in "${dir}"/*_bench.c; do
+  name=$(basename "${bench}" _bench.c)
+  run_bench "${name}" || status=1
+  echo
+done
+exit ${status}
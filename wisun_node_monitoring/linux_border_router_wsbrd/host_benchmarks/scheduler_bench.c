@@ -0,0 +1,154 @@
+/* Host benchmark of the action scheduler heap (app_action_scheduler.c)
+ *  With 8 to 4096 scheduled periodic actions, the host time of:
+ *   - insert: app_scheduler_action_schedule() of one more action
+ *   - cancel: app_scheduler_action_stop() of this action (bucket lookup + O(log n) removal)
+ *   - remaining: app_scheduler_action_get_remaining() of this action (bucket lookup)
+ *   - fire: one due action run and rescheduled by process_due_actions()
+ *  Fails if an action is left due after process_due_actions(), if a stopped action is still
+ *  scheduled, or if the heap order or the callback buckets are broken.
+ *  Host times (ns) only compare the sizes: target times are longer, with interrupts
+ *  disabled for the whole call (except for the callback)
+ */
+#define APP_SCHEDULER_SLOTS_LIMIT 4096U
+#define APP_SCHEDULER_MAX_SLOTS   4096U
+
+// The benchmark calls process_due_actions() itself: no worker task, which would run the due
+//  actions concurrently (the critical sections of the em_core.h stub don't lock)
+#include "cmsis_os2.h"
+#define osThreadNew(func, argument, attr) ((void)(func), (void)(argument), (void)(attr), (osThreadId_t)NULL)
+#include "../../app_action_scheduler.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// sizeof(app_scheduler_action_state_t) with the 4 bytes pointers of the target
+#define BENCH_TARGET_ENTRY_BYTES (64 + sizeof(queue_link_t) + sizeof(uint16_t))
+
+uint64_t host_sleeptimer_ticks = 0;
+
+static uint32_t bench_order_errors;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_set_ms(uint64_t ms) {
+  host_sleeptimer_ticks = ms * HOST_SLEEPTIMER_FREQUENCY / 1000;
+}
+
+static uint32_t bench_periodic_cb(void *context) {
+  (void)context;
+  return 0U;
+}
+
+static uint32_t bench_one_cb(void *context) {
+  (void)context;
+  return 0U;
+}
+
+// No child before its parent, each entry in the list of its bucket
+static void bench_heap_check(void) {
+  uint16_t linked = 0;
+  uint16_t idx;
+  uint16_t i;
+
+  for (i = 1; i < g_scheduler_count; i++) {
+    if (queue_before(&g_scheduler_queue[i], &g_scheduler_queue[(i - 1U) / 2U])) {
+      bench_order_errors++;
+    }
+  }
+  for (i = 0; i < APP_SCHEDULER_MAX_SLOTS; i++) {
+    for (idx = g_scheduler_buckets[i]; idx != APP_SCHEDULER_NO_ENTRY; idx = g_scheduler_links[idx].next) {
+      if ((idx >= g_scheduler_count) || (queue_bucket(g_scheduler_queue[idx].action_fn) != i)) {
+        bench_order_errors++;
+        break;
+      }
+      linked++;
+    }
+  }
+  if (linked != g_scheduler_count) {
+    bench_order_errors++;
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t reps = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2000;
+  uint32_t counts[] = { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+  uint32_t remaining;
+  uint64_t start;
+  uint64_t insert_ns;
+  uint64_t cancel_ns;
+  uint64_t remaining_ns;
+  uint64_t fire_ns;
+  uint64_t now;
+  uint32_t fired;
+  uint32_t c;
+  uint32_t i;
+  uint32_t r;
+
+  srand(1);
+  printf("Action scheduler heap, %u repetitions, host ns per call\n", reps);
+  printf("%7s %9s %9s %9s %9s %11s\n", "actions", "insert", "cancel", "remaining", "fire", "target RAM");
+  for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    app_scheduler_action_init();
+    bench_set_ms(0);
+    // Periodic actions spread over one period of 'count' ms
+    for (i = 0; i < counts[c] - 1; i++) {
+      app_scheduler_action_schedule(bench_periodic_cb, 1000 + (uint32_t)rand() % counts[c], counts[c], NULL);
+    }
+
+    insert_ns = cancel_ns = remaining_ns = 0;
+    for (r = 0; r < reps; r++) {
+      start = bench_ns();
+      app_scheduler_action_schedule(bench_one_cb, 1000 + (uint32_t)rand() % counts[c], 0, NULL);
+      insert_ns += bench_ns() - start;
+      start = bench_ns();
+      app_scheduler_action_get_remaining(bench_one_cb, &remaining);
+      remaining_ns += bench_ns() - start;
+      start = bench_ns();
+      app_scheduler_action_stop(bench_one_cb);
+      cancel_ns += bench_ns() - start;
+      if (app_scheduler_action_get_remaining(bench_one_cb, &remaining)) {
+        bench_order_errors++;
+      }
+    }
+    bench_heap_check();
+
+    // One ms at a time: about one action due per call
+    fired = g_scheduler_fired;
+    now = 1000;
+    start = bench_ns();
+    for (r = 0; r < reps; r++) {
+      bench_set_ms(now++);
+      process_due_actions();
+    }
+    fire_ns = bench_ns() - start;
+    fired = g_scheduler_fired - fired;
+    if (g_scheduler_queue[0].deadline_ms <= now_ms()) {
+      bench_order_errors++;
+    }
+    bench_heap_check();
+    app_scheduler_action_stop(bench_periodic_cb);
+    if (g_scheduler_count != 0) {
+      bench_order_errors++;
+    }
+
+    printf("%7u %9lu %9lu %9lu %9lu %11lu\n", counts[c],
+           (unsigned long)(insert_ns / reps),
+           (unsigned long)(cancel_ns / reps),
+           (unsigned long)(remaining_ns / reps),
+           (unsigned long)(fired ? fire_ns / fired : 0),
+           (unsigned long)(counts[c] * BENCH_TARGET_ENTRY_BYTES));
+  }
+  printf("insert, fire and cancel are O(log n), remaining O(1) for distinct callbacks,\n"
+         "all in critical sections\n");
+  if (bench_order_errors) {
+    printf("%u heap order or bucket errors\n", bench_order_errors);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,229 @@
+/* Host benchmark of the status send slots (app_send_slot.c)
+ *  N devices connect within 'join_spread_sec' and send their status every 'period_sec',
+ *  with the slots disabled (first status at the connection) then enabled. The state of
+ *  app_send_slot.c (one device) is saved and restored around the calls of each device.
+ *  Seconds with more than 'msg_per_sec' status messages are congested: their senders see
+ *  (sends - msg_per_sec) / sends MAC failures in the snapshot of
+ *  app_stats_snapshot_acquire() (stub), which app_send_slot_sent() reads.
+ *  Reports the sends per second (max, 99th percentile over the seconds with sends), the
+ *  share of sends in congested seconds, the max backoff and the host ns per status.
+ *  Fails if a status is sent outside its slot (offset + n * period, up to the max backoff),
+ *  or if app_stats_snapshot_acquire()/app_stats_snapshot_release() are unbalanced.
+ *  Usage: send_slot_bench [nodes] [period_sec] [join_spread_sec] [msg_per_sec] [periods]
+ */
+#include "../../app_send_slot.c"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX_NODES 1000
+
+uint64_t host_sleeptimer_ticks = 0;
+
+typedef struct {
+  // app_send_slot.c state of the device
+  bool     enabled;
+  uint32_t hash;
+  uint32_t random;
+  uint32_t backoff_sec;
+  uint32_t period_sec;
+  app_send_slot_counters_t counters;
+  uint32_t tx_count;
+  uint32_t tx_failed_count;
+  uint32_t failed_cca_count;
+  bool     first_period;
+  // MAC counters of the device
+  sl_wisun_statistics_mac_t mac;
+  uint64_t join_sec;
+  uint64_t next_sec;                  // from the connection time
+} bench_device_t;
+
+typedef struct {
+  uint32_t sends;
+  uint32_t max_per_sec;
+  uint32_t p99_per_sec;
+  uint32_t congested_sends;
+  uint32_t max_backoff_sec;
+  uint32_t out_of_slot;
+  uint64_t ns;
+} bench_result_t;
+
+static bench_device_t bench_devices[BENCH_MAX_NODES];
+static bench_device_t *bench_device;   // device calling app_send_slot.c
+static app_stats_snapshot_t bench_snapshot;
+static int32_t bench_acquired;
+
+const app_stats_snapshot_t *app_stats_snapshot_acquire(void) {
+  bench_acquired++;
+  bench_snapshot.mac.mac = bench_device->mac;
+  return &bench_snapshot;
+}
+
+void app_stats_snapshot_release(void) {
+  bench_acquired--;
+}
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_select(bench_device_t *device) {
+  bench_device = device;
+  _enabled = device->enabled;
+  _hash = device->hash;
+  _random = device->random;
+  _backoff_sec = device->backoff_sec;
+  _period_sec = device->period_sec;
+  _counters = device->counters;
+  _tx_count = device->tx_count;
+  _tx_failed_count = device->tx_failed_count;
+  _failed_cca_count = device->failed_cca_count;
+  _first_period = device->first_period;
+}
+
+static void bench_deselect(bench_device_t *device) {
+  device->enabled = _enabled;
+  device->hash = _hash;
+  device->random = _random;
+  device->backoff_sec = _backoff_sec;
+  device->period_sec = _period_sec;
+  device->counters = _counters;
+  device->tx_count = _tx_count;
+  device->tx_failed_count = _tx_failed_count;
+  device->failed_cca_count = _failed_cca_count;
+  device->first_period = _first_period;
+}
+
+static int bench_compare(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+static void bench_run(const sl_wisun_mac_address_t *macs, const uint64_t *joins, uint32_t nodes,
+                      uint32_t period_sec, uint32_t msg_per_sec, uint32_t periods, bool enabled,
+                      bench_result_t *result) {
+  static bench_device_t *senders[BENCH_MAX_NODES];
+  static uint32_t sends_per_sec[BENCH_MAX_NODES * 64];
+  uint32_t seconds = 0;
+  uint32_t count;
+  uint32_t fail_pct;
+  uint64_t end_sec = 0;
+  uint64_t now;
+  uint64_t sent_sec;
+  uint64_t start;
+  bench_device_t *device;
+  uint32_t i;
+
+  memset(bench_devices, 0, sizeof(bench_devices));
+  for (i = 0; i < nodes; i++) {
+    device = &bench_devices[i];
+    bench_select(device);
+    memset(&_counters, 0, sizeof(_counters));
+    _tx_count = _tx_failed_count = _failed_cca_count = 0;
+    app_send_slot_init(&macs[i]);
+    app_send_slot_enable(enabled);
+    // Status times are relative to the connection time (connected_delay_sec in app.c)
+    device->join_sec = joins[i];
+    start = bench_ns();
+    device->next_sec = app_send_slot_first_sec(0, period_sec);
+    result->ns += bench_ns() - start;
+    bench_deselect(device);
+    end_sec = MAX(end_sec, joins[i] + (uint64_t)periods * period_sec);
+  }
+
+  for (;;) {
+    now = UINT64_MAX;
+    for (i = 0; i < nodes; i++) {
+      now = MIN(now, bench_devices[i].join_sec + bench_devices[i].next_sec);
+    }
+    if ((now >= end_sec) || (seconds == sizeof(sends_per_sec) / sizeof(sends_per_sec[0]))) {
+      break;
+    }
+    for (i = 0, count = 0; i < nodes; i++) {
+      if (bench_devices[i].join_sec + bench_devices[i].next_sec == now) {
+        senders[count++] = &bench_devices[i];
+      }
+    }
+    fail_pct = 0;
+    if (count > msg_per_sec) {
+      fail_pct = 100 * (count - msg_per_sec) / count;
+      result->congested_sends += count;
+    }
+    for (i = 0; i < count; i++) {
+      device = senders[i];
+      sent_sec = device->next_sec;
+      // MAC tx attempts of this status: 'fail_pct' of 100 fail
+      device->mac.tx_count += 100 - fail_pct;
+      device->mac.tx_failed_count += fail_pct / 2;
+      device->mac.failed_cca_count += fail_pct - fail_pct / 2;
+      bench_select(device);
+      if (enabled && period_sec
+          && ((sent_sec + period_sec - _hash % period_sec) % period_sec > period_sec / 2)) {
+        result->out_of_slot++;
+      }
+      start = bench_ns();
+      app_send_slot_sent(false);
+      device->next_sec = app_send_slot_next_sec(sent_sec, period_sec);
+      result->ns += bench_ns() - start;
+      result->max_backoff_sec = MAX(result->max_backoff_sec, _counters.max_backoff_sec);
+      bench_deselect(device);
+    }
+    sends_per_sec[seconds++] = count;
+    result->sends += count;
+    result->max_per_sec = MAX(result->max_per_sec, count);
+  }
+  qsort(sends_per_sec, seconds, sizeof(sends_per_sec[0]), bench_compare);
+  result->p99_per_sec = seconds ? sends_per_sec[MIN(seconds - 1, seconds * 99 / 100)] : 0;
+}
+
+int main(int argc, char **argv) {
+  uint32_t nodes = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100;
+  uint32_t period_sec = (argc > 2) ? (uint32_t)atoi(argv[2]) : 60;
+  uint32_t spread_sec = (argc > 3) ? (uint32_t)atoi(argv[3]) : 10;
+  uint32_t msg_per_sec = (argc > 4) ? (uint32_t)atoi(argv[4]) : 4;
+  uint32_t periods = (argc > 5) ? (uint32_t)atoi(argv[5]) : 20;
+  static sl_wisun_mac_address_t macs[BENCH_MAX_NODES];
+  static uint64_t joins[BENCH_MAX_NODES];
+  const char *names[] = { "connection", "slots" };
+  bench_result_t result;
+  uint32_t errors = 0;
+  uint32_t i;
+  int s;
+
+  srand(1);
+  nodes = MIN(MAX(nodes, 1), BENCH_MAX_NODES);
+  for (i = 0; i < nodes; i++) {
+    // Silabs OUI, random device part
+    macs[i].address[0] = 0x00;
+    macs[i].address[1] = 0x0B;
+    macs[i].address[2] = 0x57;
+    for (s = 3; s < SL_WISUN_MAC_ADDRESS_SIZE; s++) {
+      macs[i].address[s] = (uint8_t)rand();
+    }
+    joins[i] = (uint64_t)rand() % (spread_sec + 1);
+  }
+  printf("%u devices connecting within %u s, status every %u s, %u msg/s before congestion, %u periods\n",
+         nodes, spread_sec, period_sec, msg_per_sec, periods);
+  printf("%-10s %7s %6s %6s %10s %12s %10s\n", "schedule", "sends", "max/s", "p99/s", "congested",
+         "max_backoff", "ns/status");
+  for (s = 0; s < 2; s++) {
+    memset(&result, 0, sizeof(result));
+    bench_run(macs, joins, nodes, period_sec, msg_per_sec, periods, s == 1, &result);
+    errors += result.out_of_slot;
+    printf("%-10s %7u %6u %6u %9.1f%% %10u s %10.1f\n", names[s], result.sends, result.max_per_sec,
+           result.p99_per_sec, result.sends ? 100.0 * result.congested_sends / result.sends : 0.0,
+           result.max_backoff_sec, result.sends ? (double)result.ns / (result.sends + nodes) : 0.0);
+  }
+  if (errors) {
+    printf("%u status messages sent outside their slot\n", errors);
+  }
+  if (bench_acquired) {
+    printf("app_stats_snapshot_acquire() and app_stats_snapshot_release() unbalanced: %d\n", bench_acquired);
+  }
+  return (errors || bench_acquired) ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+/* Host stub of SEGGER_RTT.h for the host benchmarks: RTT up buffer 0 only, the other up
+ *  channels are written by SEGGER_RTT_Write(), defined by the benchmarks which use it */
+#ifndef __HOST_SEGGER_RTT_H__
+#define __HOST_SEGGER_RTT_H__
+
+#ifndef BUFFER_SIZE_UP
+#define BUFFER_SIZE_UP 1024
+#endif
+
+typedef struct {
+  const char *sName;
+  char *pBuffer;
+  unsigned SizeOfBuffer;
+  unsigned WrOff;
+  volatile unsigned RdOff;
+  unsigned Flags;
+} SEGGER_RTT_BUFFER_UP;
+
+typedef struct {
+  char acID[16];
+  int MaxNumUpBuffers;
+  int MaxNumDownBuffers;
+  SEGGER_RTT_BUFFER_UP aUp[1];
+} SEGGER_RTT_CB;
+
+extern SEGGER_RTT_CB _SEGGER_RTT;
+
+#define SEGGER_RTT_LOCK()
+#define SEGGER_RTT_UNLOCK()
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP 0
+
+static inline int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char *sName, void *pBuffer,
+                                            unsigned BufferSize, unsigned Flags) {
+  (void)BufferIndex; (void)sName; (void)pBuffer; (void)BufferSize; (void)Flags;
+  return 0;
+}
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes);
+
+#endif
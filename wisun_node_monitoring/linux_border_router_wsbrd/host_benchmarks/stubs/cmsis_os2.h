@@ -0,0 +1,289 @@
+/* Host stub of cmsis_os2.h for the host benchmarks, backed by pthreads: threads, mutexes,
+ *  event flags and memory pools block and time out as on the target (1 tick = 1 ms) */
+#ifndef __HOST_CMSIS_OS2_H__
+#define __HOST_CMSIS_OS2_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+
+typedef enum {
+  osOK = 0,
+  osError = -1,
+  osErrorTimeout = -2,
+  osErrorResource = -3,
+  osErrorParameter = -4,
+} osStatus_t;
+
+typedef enum {
+  osPriorityLow = 8,
+  osPriorityLow3 = 8+3,
+  osPriorityBelowNormal = 16,
+  osPriorityNormal = 24,
+  osPriorityAboveNormal = 32,
+  osPriorityHigh = 40,
+} osPriority_t;
+
+typedef void *osThreadId_t;
+typedef void *osMutexId_t;
+typedef void *osEventFlagsId_t;
+typedef void *osMemoryPoolId_t;
+typedef void (*osThreadFunc_t)(void *argument);
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+  uint32_t tz_module;
+  uint32_t reserved;
+} osThreadAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osMutexAttr_t, osEventFlagsAttr_t, osMemoryPoolAttr_t;
+
+#define osWaitForever         0xFFFFFFFFU
+#define osFlagsWaitAny        0x00000000U
+#define osFlagsWaitAll        0x00000001U
+#define osFlagsNoClear        0x00000002U
+#define osFlagsError          0x80000000U
+#define osFlagsErrorTimeout   0xFFFFFFFEU
+#define osThreadDetached      0x00000000U
+#define osMutexRecursive      0x00000001U
+#define osMutexPrioInherit    0x00000002U
+#define CMSIS_RTOS_ERROR_MASK 0x80000000U
+
+// One lock and condition per object, waits time out after 'timeout' ms
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+} host_os_sync_t;
+
+typedef struct {
+  host_os_sync_t  sync;
+  uint32_t        flags;
+} host_os_event_flags_t;
+
+typedef struct {
+  host_os_sync_t  sync;
+  uint8_t        *blocks;
+  void          **free_list;
+  uint32_t        free_count;
+} host_os_memory_pool_t;
+
+typedef struct {
+  osThreadFunc_t  func;
+  void           *argument;
+} host_os_thread_t;
+
+// Address of a thread local variable: one id per thread
+static __thread char host_os_thread_id;
+
+static inline void host_os_sync_init(host_os_sync_t *sync) {
+  pthread_mutex_init(&sync->lock, NULL);
+  pthread_cond_init(&sync->cond, NULL);
+}
+
+// Deadline of a wait of 'timeout' ms
+static inline struct timespec host_os_deadline(uint32_t timeout) {
+  struct timespec deadline;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  if (timeout != osWaitForever) {
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+  }
+  return deadline;
+}
+
+// Wait on 'sync' (locked) until signaled or 'deadline'. Returns false on timeout
+static inline bool host_os_sync_wait(host_os_sync_t *sync, uint32_t timeout, const struct timespec *deadline) {
+  if (timeout == 0) {
+    return false;
+  }
+  if (timeout == osWaitForever) {
+    pthread_cond_wait(&sync->cond, &sync->lock);
+    return true;
+  }
+  return pthread_cond_timedwait(&sync->cond, &sync->lock, deadline) != ETIMEDOUT;
+}
+
+static inline uint32_t osKernelGetTickCount(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U);
+}
+
+static inline osStatus_t osDelay(uint32_t ticks) {
+  struct timespec ts = { (time_t)(ticks / 1000), (long)(ticks % 1000) * 1000000L };
+
+  nanosleep(&ts, NULL);
+  return osOK;
+}
+
+static inline void *host_os_thread_start(void *arg) {
+  host_os_thread_t thread = *(host_os_thread_t *)arg;
+
+  free(arg);
+  thread.func(thread.argument);
+  return NULL;
+}
+
+static inline osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+  host_os_thread_t *thread = (host_os_thread_t *)malloc(sizeof(host_os_thread_t));
+  pthread_t id;
+
+  (void)attr;
+  if (thread == NULL) {
+    return NULL;
+  }
+  thread->func = func;
+  thread->argument = argument;
+  if (pthread_create(&id, NULL, host_os_thread_start, thread) != 0) {
+    free(thread);
+    return NULL;
+  }
+  pthread_detach(id);
+  return (osThreadId_t)thread;
+}
+static inline osThreadId_t osThreadGetId(void) { return &host_os_thread_id; }
+static inline void osThreadExit(void) { pthread_exit(NULL); }
+
+static inline osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+  pthread_mutex_t *mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
+  pthread_mutexattr_t mutex_attr;
+
+  if (mutex == NULL) {
+    return NULL;
+  }
+  pthread_mutexattr_init(&mutex_attr);
+  if ((attr != NULL) && (attr->attr_bits & osMutexRecursive)) {
+    pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+  }
+  pthread_mutex_init(mutex, &mutex_attr);
+  pthread_mutexattr_destroy(&mutex_attr);
+  return mutex;
+}
+static inline osStatus_t osMutexAcquire(osMutexId_t id, uint32_t timeout) {
+  (void)timeout;
+  return pthread_mutex_lock((pthread_mutex_t *)id) ? osError : osOK;
+}
+static inline osStatus_t osMutexRelease(osMutexId_t id) {
+  return pthread_mutex_unlock((pthread_mutex_t *)id) ? osError : osOK;
+}
+
+static inline osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+  host_os_event_flags_t *ef = (host_os_event_flags_t *)calloc(1, sizeof(host_os_event_flags_t));
+
+  (void)attr;
+  if (ef != NULL) {
+    host_os_sync_init(&ef->sync);
+  }
+  return ef;
+}
+static inline uint32_t osEventFlagsSet(osEventFlagsId_t id, uint32_t flags) {
+  host_os_event_flags_t *ef = (host_os_event_flags_t *)id;
+
+  pthread_mutex_lock(&ef->sync.lock);
+  flags = (ef->flags |= flags);
+  pthread_cond_broadcast(&ef->sync.cond);
+  pthread_mutex_unlock(&ef->sync.lock);
+  return flags;
+}
+static inline uint32_t osEventFlagsClear(osEventFlagsId_t id, uint32_t flags) {
+  host_os_event_flags_t *ef = (host_os_event_flags_t *)id;
+  uint32_t previous;
+
+  pthread_mutex_lock(&ef->sync.lock);
+  previous = ef->flags;
+  ef->flags &= ~flags;
+  pthread_mutex_unlock(&ef->sync.lock);
+  return previous;
+}
+static inline uint32_t osEventFlagsWait(osEventFlagsId_t id, uint32_t flags, uint32_t options, uint32_t timeout) {
+  host_os_event_flags_t *ef = (host_os_event_flags_t *)id;
+  struct timespec deadline = host_os_deadline(timeout);
+  uint32_t set;
+
+  pthread_mutex_lock(&ef->sync.lock);
+  for (;;) {
+    set = ef->flags & flags;
+    if ((options & osFlagsWaitAll) ? (set == flags) : (set != 0U)) {
+      break;
+    }
+    if (!host_os_sync_wait(&ef->sync, timeout, &deadline)) {
+      pthread_mutex_unlock(&ef->sync.lock);
+      return osFlagsErrorTimeout;
+    }
+  }
+  if (!(options & osFlagsNoClear)) {
+    ef->flags &= ~set;
+  }
+  pthread_mutex_unlock(&ef->sync.lock);
+  return set;
+}
+
+static inline osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+  host_os_memory_pool_t *mp = (host_os_memory_pool_t *)calloc(1, sizeof(host_os_memory_pool_t));
+  uint32_t i;
+
+  (void)attr;
+  if (mp == NULL) {
+    return NULL;
+  }
+  mp->blocks = (uint8_t *)malloc((size_t)block_count * block_size);
+  mp->free_list = (void **)malloc(block_count * sizeof(void *));
+  assert((mp->blocks != NULL) && (mp->free_list != NULL));
+  for (i = 0; i < block_count; i++) {
+    mp->free_list[i] = mp->blocks + (size_t)i * block_size;
+  }
+  mp->free_count = block_count;
+  host_os_sync_init(&mp->sync);
+  return mp;
+}
+static inline void *osMemoryPoolAlloc(osMemoryPoolId_t id, uint32_t timeout) {
+  host_os_memory_pool_t *mp = (host_os_memory_pool_t *)id;
+  struct timespec deadline = host_os_deadline(timeout);
+  void *block = NULL;
+
+  pthread_mutex_lock(&mp->sync.lock);
+  while ((mp->free_count == 0) && host_os_sync_wait(&mp->sync, timeout, &deadline)) {
+  }
+  if (mp->free_count > 0) {
+    block = mp->free_list[--mp->free_count];
+  }
+  pthread_mutex_unlock(&mp->sync.lock);
+  return block;
+}
+static inline osStatus_t osMemoryPoolFree(osMemoryPoolId_t id, void *block) {
+  host_os_memory_pool_t *mp = (host_os_memory_pool_t *)id;
+
+  pthread_mutex_lock(&mp->sync.lock);
+  mp->free_list[mp->free_count++] = block;
+  pthread_cond_signal(&mp->sync.cond);
+  pthread_mutex_unlock(&mp->sync.lock);
+  return osOK;
+}
+
+#endif
@@ -0,0 +1,9 @@
+/* Host stub of em_core.h for the host benchmarks: single thread, no interrupts */
+#ifndef __HOST_EM_CORE_H__
+#define __HOST_EM_CORE_H__
+
+#define CORE_DECLARE_IRQ_STATE  int host_irq_state = 0
+#define CORE_ENTER_CRITICAL()   (void)host_irq_state
+#define CORE_EXIT_CRITICAL()    (void)host_irq_state
+
+#endif
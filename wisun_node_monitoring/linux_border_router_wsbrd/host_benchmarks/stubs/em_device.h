@@ -0,0 +1,27 @@
+/* Host stub of em_device.h for the host benchmarks: DWT cycle counter always 0 */
+#ifndef __HOST_EM_DEVICE_H__
+#define __HOST_EM_DEVICE_H__
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+} host_dwt_t;
+
+typedef struct {
+  volatile uint32_t DEMCR;
+} host_core_debug_t;
+
+static host_dwt_t host_dwt;
+static host_core_debug_t host_core_debug;
+#define DWT                         (&host_dwt)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug                   (&host_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+// Start of the target RAM. The host addresses (truncated to 32 bits) are all below: the host
+//  strings are handled as the constant strings of the target flash
+#define SRAM_BASE                   0xFFFFFFFFUL
+
+#endif
@@ -0,0 +1,7 @@
+/* Host stub of printf.h for the host benchmarks: libc printf */
+#ifndef __HOST_PRINTF_H__
+#define __HOST_PRINTF_H__
+
+#include <stdio.h>
+
+#endif
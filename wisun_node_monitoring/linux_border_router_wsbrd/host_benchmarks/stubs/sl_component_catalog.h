@@ -0,0 +1,8 @@
+/* Host stub of sl_component_catalog.h for the host benchmarks: the components that the
+ *  benchmarked modules use */
+#ifndef __HOST_SL_COMPONENT_CATALOG_H__
+#define __HOST_SL_COMPONENT_CATALOG_H__
+
+#define SL_CATALOG_WISUN_COAP_PRESENT
+
+#endif
@@ -0,0 +1,25 @@
+/* Host stub of sl_memory_manager.h for the host benchmarks: allocations counted */
+#ifndef __HOST_SL_MEMORY_MANAGER_H__
+#define __HOST_SL_MEMORY_MANAGER_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// sl_malloc()/sl_realloc() calls since the start of the benchmark (one program per benchmark)
+static uint32_t host_malloc_count;
+
+static inline void *sl_malloc(size_t size) {
+  host_malloc_count++;
+  return malloc(size);
+}
+
+static inline void *sl_realloc(void *ptr, size_t size) {
+  host_malloc_count++;
+  return realloc(ptr, size);
+}
+
+static inline void sl_free(void *ptr) {
+  free(ptr);
+}
+
+#endif
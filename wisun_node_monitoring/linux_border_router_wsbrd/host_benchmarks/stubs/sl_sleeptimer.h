@@ -0,0 +1,64 @@
+/* Host stub of sl_sleeptimer.h for the host benchmarks: time set by the benchmark */
+#ifndef __HOST_SL_SLEEPTIMER_H__
+#define __HOST_SL_SLEEPTIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// uint32_t is unsigned long on the target: sl_status_t values are printed with %lu
+typedef unsigned long sl_status_t;
+#define SL_STATUS_OK                  0x0000
+#define SL_STATUS_INVALID_STATE       0x0002
+#define SL_STATUS_ALREADY_INITIALIZED 0x0011
+
+typedef uint64_t sl_sleeptimer_timestamp_64_t;
+
+typedef struct sl_sleeptimer_timer_handle sl_sleeptimer_timer_handle_t;
+typedef void (*sl_sleeptimer_timer_callback_t)(sl_sleeptimer_timer_handle_t *handle, void *data);
+struct sl_sleeptimer_timer_handle {
+  void *callback_data;
+  sl_sleeptimer_timer_callback_t callback;
+  uint32_t period_ms;
+};
+
+// Current time, in ticks of host_sleeptimer_frequency
+extern uint64_t host_sleeptimer_ticks;
+#define HOST_SLEEPTIMER_FREQUENCY 32768
+
+static inline sl_status_t sl_sleeptimer_init(void) { return SL_STATUS_ALREADY_INITIALIZED; }
+static inline uint64_t sl_sleeptimer_get_tick_count64(void) { return host_sleeptimer_ticks; }
+static inline uint32_t sl_sleeptimer_get_tick_count(void) { return (uint32_t)host_sleeptimer_ticks; }
+static inline uint32_t sl_sleeptimer_get_timer_frequency(void) { return HOST_SLEEPTIMER_FREQUENCY; }
+static inline uint32_t sl_sleeptimer_ms_to_tick(uint32_t ms) { return (uint32_t)((uint64_t)ms * HOST_SLEEPTIMER_FREQUENCY / 1000); }
+static inline uint32_t sl_sleeptimer_tick_to_ms(uint32_t ticks) { return (uint32_t)((uint64_t)ticks * 1000 / HOST_SLEEPTIMER_FREQUENCY); }
+static inline uint64_t sl_sleeptimer_tick64_to_ms(uint64_t ticks, uint64_t *ms) { *ms = ticks * 1000 / HOST_SLEEPTIMER_FREQUENCY; return SL_STATUS_OK; }
+
+static inline sl_status_t sl_sleeptimer_start_timer_ms(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+                                                       sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                                       uint8_t priority, uint16_t option_flags)
+{
+  (void)timeout_ms; (void)priority; (void)option_flags;
+  handle->callback = callback;
+  handle->callback_data = callback_data;
+  handle->period_ms = 0;
+  return SL_STATUS_OK;
+}
+static inline sl_status_t sl_sleeptimer_restart_timer_ms(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+                                                         sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                                         uint8_t priority, uint16_t option_flags)
+{
+  return sl_sleeptimer_start_timer_ms(handle, timeout_ms, callback, callback_data, priority, option_flags);
+}
+static inline sl_status_t sl_sleeptimer_start_periodic_timer_ms(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+                                                                sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                                                uint8_t priority, uint16_t option_flags)
+{
+  (void)priority; (void)option_flags;
+  handle->callback = callback;
+  handle->callback_data = callback_data;
+  handle->period_ms = timeout_ms;
+  return SL_STATUS_OK;
+}
+static inline sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle) { handle->callback = 0; return SL_STATUS_OK; }
+
+#endif
@@ -0,0 +1,11 @@
+/* Host stub of sl_string.h for the host benchmarks */
+#ifndef __HOST_SL_STRING_H__
+#define __HOST_SL_STRING_H__
+
+#include <string.h>
+#include <strings.h>
+
+#define sl_strnlen(str, max_len)  strnlen(str, max_len)
+#define sl_strcasecmp(s1, s2)     strcasecmp(s1, s2)
+
+#endif
@@ -0,0 +1,124 @@
+/* Host stub of sl_wisun_coap.h for the host benchmarks: only the packet fields used by
+ *  the benchmarked modules, and a builder writing the CoAP header (RFC 7252) and payload */
+#ifndef __HOST_SL_WISUN_COAP_H__
+#define __HOST_SL_WISUN_COAP_H__
+
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+  COAP_MSG_CODE_EMPTY         = 0,
+  COAP_MSG_CODE_REQUEST_GET   = 1,
+  COAP_MSG_CODE_REQUEST_POST  = 2,
+  COAP_MSG_CODE_REQUEST_PUT   = 3,
+} sn_coap_msg_code_e;
+
+typedef enum {
+  COAP_MSG_TYPE_CONFIRMABLE     = 0x00,
+  COAP_MSG_TYPE_NON_CONFIRMABLE = 0x10,
+} sn_coap_msg_type_e;
+
+typedef enum {
+  COAP_CT_NONE         = -1,
+  COAP_CT_TEXT_PLAIN   = 0,
+  COAP_CT_OCTET_STREAM = 42,
+  COAP_CT_JSON         = 50,
+} sn_coap_content_format_e;
+
+typedef struct {
+  uint8_t  *etag_ptr;
+  uint8_t   etag_len;
+  uint8_t  *uri_query_ptr;
+  uint16_t  uri_query_len;
+} sn_coap_options_list_s;
+
+typedef struct {
+  sn_coap_msg_code_e        msg_code;
+  sn_coap_msg_type_e        msg_type;
+  sn_coap_content_format_e  content_format;
+  uint16_t                  msg_id;
+  uint16_t                  uri_path_len;
+  uint8_t                  *uri_path_ptr;
+  uint8_t                   token_len;
+  uint8_t                  *token_ptr;
+  uint16_t                  payload_len;
+  uint8_t                  *payload_ptr;
+  sn_coap_options_list_s   *options_list_ptr;
+} sl_wisun_coap_packet_t;
+
+// Option of 'len' bytes, 'delta' after the previous one. Writes it if 'dest', returns its size
+static inline uint16_t host_coap_option(uint8_t *dest, uint16_t delta, const uint8_t *value, uint16_t len) {
+  uint16_t size = 1;
+  uint8_t nibbles[2] = { (uint8_t)delta, (uint8_t)len };
+  uint8_t ext[4];
+  uint8_t ext_len = 0;
+  uint16_t values[2] = { delta, len };
+  int i;
+
+  for (i = 0; i < 2; i++) {
+    if (values[i] >= 269) {
+      nibbles[i] = 14;
+      ext[ext_len++] = (uint8_t)((values[i] - 269) >> 8);
+      ext[ext_len++] = (uint8_t)(values[i] - 269);
+    } else if (values[i] >= 13) {
+      nibbles[i] = 13;
+      ext[ext_len++] = (uint8_t)(values[i] - 13);
+    }
+  }
+  size += ext_len + len;
+  if (dest != NULL) {
+    dest[0] = (uint8_t)((nibbles[0] << 4) | nibbles[1]);
+    memcpy(dest + 1, ext, ext_len);
+    memcpy(dest + 1 + ext_len, value, len);
+  }
+  return size;
+}
+
+// Header, Uri-Path (11) and Content-Format (12) options, payload. Writes them if 'dest'
+static inline uint16_t host_coap_build(uint8_t *dest, const sl_wisun_coap_packet_t *message) {
+  uint16_t size = 4 + message->token_len;
+  uint16_t option = 0;
+  uint16_t start = 0;
+  uint16_t i;
+  uint8_t format;
+
+  if (dest != NULL) {
+    dest[0] = (uint8_t)(0x40 | (message->msg_type & 0x30) | message->token_len);
+    dest[1] = (uint8_t)message->msg_code;
+    dest[2] = (uint8_t)(message->msg_id >> 8);
+    dest[3] = (uint8_t)message->msg_id;
+    memcpy(dest + 4, message->token_ptr, message->token_len);
+  }
+  for (i = 0; i <= message->uri_path_len; i++) {
+    if ((i == message->uri_path_len) || (message->uri_path_ptr[i] == '/')) {
+      if (i > start) {
+        size += host_coap_option(dest ? dest + size : NULL, 11 - option, message->uri_path_ptr + start,
+                                 (uint16_t)(i - start));
+        option = 11;
+      }
+      start = (uint16_t)(i + 1);
+    }
+  }
+  if (message->content_format != COAP_CT_NONE) {
+    format = (uint8_t)message->content_format;
+    size += host_coap_option(dest ? dest + size : NULL, 12 - option, &format, format ? 1 : 0);
+  }
+  if (message->payload_len) {
+    if (dest != NULL) {
+      dest[size] = 0xFF;
+      memcpy(dest + size + 1, message->payload_ptr, message->payload_len);
+    }
+    size += 1 + message->payload_len;
+  }
+  return size;
+}
+
+static inline uint16_t sl_wisun_coap_builder_calc_size(const sl_wisun_coap_packet_t *message) {
+  return host_coap_build(NULL, message);
+}
+
+static inline int16_t sl_wisun_coap_builder(uint8_t *dest_buff, const sl_wisun_coap_packet_t *message) {
+  return (int16_t)host_coap_build(dest_buff, message);
+}
+
+#endif
@@ -0,0 +1,20 @@
+/* Host stub of sl_wisun_common.h for the host benchmarks */
+#ifndef __HOST_SL_WISUN_COMMON_H__
+#define __HOST_SL_WISUN_COMMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef union {
+  uint8_t  address[16];
+  uint32_t value[4];
+} in6_addr_t;
+
+#endif
@@ -0,0 +1,71 @@
+/* Host stub of sl_wisun_ip6string.h for the host benchmarks: hexadecimal groups and '::'
+ *  (no IPv4 suffix). The host inet_pton() needs the system socket headers, which conflict
+ *  with the socket stub */
+#ifndef __HOST_SL_WISUN_IP6STRING_H__
+#define __HOST_SL_WISUN_IP6STRING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "sl_wisun_common.h"
+
+static inline bool sl_wisun_stoip6(const char *str, size_t len, void *dest) {
+  uint8_t *address = (uint8_t *)dest;
+  uint16_t groups[8];
+  int count = 0;
+  int gap = -1;               // group index of '::'
+  size_t i = 0;
+  int digits;
+  int g;
+
+  memset(dest, 0, 16);
+  if ((len >= 2) && (str[0] == ':') && (str[1] == ':')) {
+    gap = 0;
+    i = 2;
+  }
+  while ((i < len) && (count < 8)) {
+    groups[count] = 0;
+    for (digits = 0; (i < len) && (digits < 4); digits++, i++) {
+      char c = str[i];
+
+      if ((c >= '0') && (c <= '9')) {
+        groups[count] = (uint16_t)((groups[count] << 4) | (uint16_t)(c - '0'));
+      } else if (((c | 0x20) >= 'a') && ((c | 0x20) <= 'f')) {
+        groups[count] = (uint16_t)((groups[count] << 4) | (uint16_t)((c | 0x20) - 'a' + 10));
+      } else {
+        break;
+      }
+    }
+    if (digits == 0) {
+      return false;
+    }
+    count++;
+    if (i == len) {
+      break;
+    }
+    if (str[i++] != ':') {
+      return false;
+    }
+    if ((i < len) && (str[i] == ':')) {
+      if (gap >= 0) {
+        return false;
+      }
+      gap = count;
+      i++;
+    } else if (i == len) {
+      return false;         // trailing single ':'
+    }
+  }
+  if ((i < len) || ((gap < 0) && (count != 8)) || ((gap >= 0) && (count > 7))) {
+    return false;
+  }
+  for (g = 0; g < count; g++) {
+    int pos = ((gap >= 0) && (g >= gap)) ? 8 - count + g : g;
+
+    address[2 * pos] = (uint8_t)(groups[g] >> 8);
+    address[2 * pos + 1] = (uint8_t)groups[g];
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/* Host stub of sl_wisun_types.h for the host benchmarks: only the types and fields
+ *  used by the benchmarked modules */
+#ifndef __HOST_SL_WISUN_TYPES_H__
+#define __HOST_SL_WISUN_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sl_wisun_common.h"
+
+#define SL_WISUN_MAC_ADDRESS_SIZE 8
+
+typedef struct {
+  uint8_t address[SL_WISUN_MAC_ADDRESS_SIZE];
+} sl_wisun_mac_address_t;
+
+typedef struct {
+  uint32_t tx_count;
+  uint32_t rx_count;
+  uint32_t tx_failed_count;
+  uint32_t failed_cca_count;
+} sl_wisun_statistics_mac_t;
+
+typedef union {
+  sl_wisun_statistics_mac_t mac;
+} sl_wisun_statistics_t;
+
+typedef struct {
+  uint32_t pan_id;
+  uint16_t rpl_rank;
+  uint8_t  hop_count;
+} sl_wisun_network_info_t;
+
+typedef struct {
+  uint32_t type;
+  int16_t  rsl_in;
+  int16_t  rsl_out;
+  uint16_t etx;
+  uint32_t lifetime;
+} sl_wisun_neighbor_info_t;
+
+#endif
@@ -0,0 +1,61 @@
+/* Host stub of socket/socket.h for the host benchmarks: datagrams counted, not sent */
+#ifndef __HOST_SOCKET_H__
+#define __HOST_SOCKET_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sl_wisun_common.h"
+
+typedef int32_t sl_wisun_socket_id_t;
+typedef uint32_t socklen_t;
+
+#define AF_INET6                               10
+#define SOCK_DGRAM                             2
+#define SOCK_STREAM                            1
+#define SOCK_NONBLOCK                          0x4000
+#define IPPROTO_UDP                            17
+#define SOCKET_INVALID_ID                      -1
+#define SOCKET_RETVAL_ERROR                    -1
+#define SOCKET_RETVAL_OK                       0
+#define APP_LEVEL_SOCKET                       0
+#define SOCKET_EVENT_MODE                      0
+#define SL_WISUN_SOCKET_EVENT_MODE_INDICATION  0
+#define IN6ADDR_ANY_INIT                       { { 0 } }
+
+struct sockaddr {
+  uint16_t sa_family;
+  uint8_t  sa_data[26];
+};
+
+typedef struct {
+  uint16_t   sin6_family;
+  uint16_t   sin6_port;
+  uint32_t   sin6_flowinfo;
+  in6_addr_t sin6_addr;
+  uint32_t   sin6_scope_id;
+} sockaddr_in6_t;
+
+#define htons(x) ((uint16_t)((((x) & 0xFF) << 8) | (((x) >> 8) & 0xFF)))
+
+// Datagrams and bytes 'sent' since the start of the benchmark
+extern uint32_t host_sendto_count;
+extern uint64_t host_sendto_bytes;
+
+static inline int32_t socket(int32_t family, int32_t type, int32_t protocol) { (void)family; (void)type; (void)protocol; return 1; }
+static inline int32_t bind(int32_t sockid, const struct sockaddr *addr, socklen_t addrlen) { (void)sockid; (void)addr; (void)addrlen; return SOCKET_RETVAL_OK; }
+static inline int32_t close(int32_t sockid) { (void)sockid; return SOCKET_RETVAL_OK; }
+static inline int32_t setsockopt(int32_t sockid, int32_t level, int32_t optname, const void *optval, socklen_t optlen) { (void)sockid; (void)level; (void)optname; (void)optval; (void)optlen; return SOCKET_RETVAL_OK; }
+static inline int32_t sendto(int32_t sockid, const void *buf, uint32_t len, int32_t flags, const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+  (void)sockid; (void)buf; (void)flags; (void)dest_addr; (void)addrlen;
+  host_sendto_count++;
+  host_sendto_bytes += len;
+  return (int32_t)len;
+}
+static inline int32_t recvfrom(int32_t sockid, void *buf, uint32_t len, int32_t flags, struct sockaddr *src_addr, socklen_t *addrlen)
+{
+  (void)sockid; (void)buf; (void)len; (void)flags; (void)src_addr; (void)addrlen;
+  return SOCKET_RETVAL_ERROR;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/* Host benchmark of the status notification formats (app_tlv.c)
+ *  For a router status message every period_sec, the bytes and host encode time per message:
+ *   - json: snprintf() of the JSON text, as app.c _status_json_string()
+ *   - tlv: app_tlv_put_*() of the TLV record, as app.c _status_tlv()
+ *   - tlv delta: app_tlv_delta_encode() of this record (after it is built), with a keyframe
+ *     every keyframe_interval
+ *  and the 6LoWPAN frames per message (fragments of frame_payload bytes, after 40 bytes of
+ *  IPv6/UDP headers).
+ *  Fails if app_tlv_json() of a record does not give back its values.
+ *  Usage: tlv_bench [samples] [period_sec] [keyframe_interval] [frame_payload]
+ */
+#include "../../app_tlv.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_status.h"
+
+#define BENCH_BUF_LEN         1024
+#define BENCH_IPV6_UDP_HEADER 40
+
+typedef struct {
+  const char *name;
+  uint64_t bytes;
+  uint64_t frames;
+  uint64_t ns;
+} bench_format_t;
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_add(bench_format_t *format, uint32_t len, uint64_t ns, uint32_t frame_payload) {
+  format->bytes  += len;
+  format->frames += (len + BENCH_IPV6_UDP_HEADER + frame_payload - 1) / frame_payload;
+  format->ns     += ns;
+}
+
+int main(int argc, char **argv) {
+  uint32_t samples           = (argc > 1) ? (uint32_t)atoi(argv[1]) : 10000;
+  uint32_t period_sec        = (argc > 2) ? (uint32_t)atoi(argv[2]) : 60;
+  uint16_t keyframe_interval = (argc > 3) ? (uint16_t)atoi(argv[3]) : 10;
+  uint32_t frame_payload     = (argc > 4) ? (uint32_t)atoi(argv[4]) : 100;
+  bench_format_t formats[3] = { { "json", 0, 0, 0 }, { "tlv", 0, 0, 0 }, { "tlv delta", 0, 0, 0 } };
+  bench_status_t status;
+  app_tlv_delta_t delta;
+  char json[BENCH_BUF_LEN];
+  uint8_t record[BENCH_BUF_LEN];
+  uint8_t msg[BENCH_BUF_LEN];
+  char expected[64];
+  uint32_t errors = 0;
+  uint64_t start;
+  uint16_t record_len;
+  uint16_t len;
+  uint32_t s;
+  int i;
+
+  srand(1);
+  bench_status_init(&status);
+  app_tlv_delta_reset(&delta);
+  for (s = 0; s < samples; s++) {
+    bench_status_step(&status, period_sec);
+
+    start = bench_ns();
+    len = (uint16_t)bench_status_json(&status, json, sizeof(json));
+    bench_add(&formats[0], len, bench_ns() - start, frame_payload);
+
+    start = bench_ns();
+    record_len = bench_status_tlv(&status, record, sizeof(record));
+    bench_add(&formats[1], record_len, bench_ns() - start, frame_payload);
+
+    start = bench_ns();
+    len = app_tlv_delta_encode(&delta, keyframe_interval, record, record_len, msg, sizeof(msg));
+    bench_add(&formats[2], len, bench_ns() - start, frame_payload);
+
+    // What udp_notification_receiver.py displays
+    app_tlv_json(record, record_len, "msg_count", json, sizeof(json));
+    snprintf(expected, sizeof(expected), "{\"msg_count\":\"%lu\"}", (unsigned long)status.msg_count);
+    if ((record_len == 0) || (len == 0) || strcmp(json, expected)) {
+      errors++;
+    }
+  }
+
+  printf("%u status messages, every %u s, keyframe every %u messages, %u bytes per frame\n",
+         samples, period_sec, keyframe_interval, frame_payload);
+  printf("%-10s %10s %8s %11s %14s\n", "format", "bytes/msg", "vs json", "frames/msg", "host ns/msg");
+  for (i = 0; i < 3; i++) {
+    printf("%-10s %10.1f %7.1f%% %11.2f %14.0f\n", formats[i].name,
+           (double)formats[i].bytes / samples,
+           100.0 * formats[i].bytes / formats[0].bytes,
+           (double)formats[i].frames / samples,
+           (double)formats[i].ns / samples);
+  }
+  if (errors) {
+    printf("%u records not decoded back\n", errors);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,199 @@
+/* Host benchmark of the tokenized traces (app_timestamp.c app_trace_token(), APP_TRACE_TOKENS)
+ *  printfBoth()/printfBothTime() calls of the tree (app.c, app_coap.c, app_direct_connect.c,
+ *  app_parameters.c formats and arguments), as:
+ *   - text: the printfBoth()/printfBothTime() macros without APP_TRACE_TOKENS, snprintf() to
+ *     timestamped_msg then its RTT write, with the '[<now_str()>] ' prefix for printfBothTime()
+ *     (the console printf() is excluded: tokenized traces are not copied to the console)
+ *   - token: the app_trace_token() record
+ *  SEGGER_RTT_Write() is stubbed, keeping the last record. 'l' arguments are 4 bytes on the
+ *  target: they are read from the host 8 bytes argument slots as such.
+ *  Reports per call: RTT bytes of the text and of the record, record size compared to the
+ *  text, host ns of both.
+ *  Fails if a record doesn't have its expected header (sync, length, flags, format address)
+ *  and size (arguments in binary, strings with their '\0'), or if the app_trace_tokens_string()
+ *  counters don't match the records written.
+ *  Usage: trace_bench [repetitions]
+ */
+#define SL_CATALOG_SEGGER_RTT_PRESENT
+#define APP_TRACE_TOKENS
+#include "../../app_timestamp.c"
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "sl_wisun_common.h"
+
+#define BENCH_NETWORK_NAME  "Wi-SUN Network"
+#define BENCH_PHY           "FAN1.1 NA ChanPlanId 1 PhyModeId 2"
+#define BENCH_IPV6          "fd00:6172:6d00::2"
+#define BENCH_COAP_PAYLOAD  "auto_send_sec 0 60"
+
+typedef struct bench_trace bench_trace_t;
+struct bench_trace {
+  const char *name;
+  const char *format;
+  uint8_t     flags;
+  uint16_t    args_len;       // expected binary arguments length
+  void (*token)(const bench_trace_t *trace);
+  void (*text)(const bench_trace_t *trace);
+};
+
+uint64_t host_sleeptimer_ticks = 0;
+
+// RTT channels 0 (text) and APP_TRACE_TOKENS_RTT_CHANNEL: bytes written, last record
+static uint64_t bench_rtt_bytes[APP_TRACE_TOKENS_RTT_CHANNEL + 1];
+static uint8_t  bench_record[TIMESTAMP_MSG_LEN];
+static unsigned bench_record_len;
+static char     bench_rtt_line[TIMESTAMP_MSG_LEN + 32];
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes) {
+  if (BufferIndex == APP_TRACE_TOKENS_RTT_CHANNEL) {
+    memcpy(bench_record, pBuffer, NumBytes);
+    bench_record_len = NumBytes;
+  }
+  bench_rtt_bytes[BufferIndex] += NumBytes;
+  return NumBytes;
+}
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// SEGGER_RTT_printf() of the text, formatted by snprintf() to timestamped_msg
+static void bench_rtt_text(uint8_t flags, int text_len) {
+  int len;
+
+  if (flags & APP_TRACE_TOKEN_FLAG_TIME) {
+    len = snprintf(bench_rtt_line, sizeof(bench_rtt_line), "[%s] %s", now_str(), timestamped_msg);
+    SEGGER_RTT_Write(0, bench_rtt_line, (unsigned)len);
+  } else {
+    SEGGER_RTT_Write(0, timestamped_msg, (unsigned)text_len);
+  }
+}
+
+// 'fn' and 'fn'_text: the token and the text of a printfBoth()/printfBothTime() call
+#define BENCH_TRACE(fn, fmt, ...)                                                     \
+  static const char fn##_format[] = fmt;                                              \
+  static void fn(const bench_trace_t *trace) {                                        \
+    app_trace_token(trace->flags, trace->format, __VA_ARGS__);                        \
+  }                                                                                   \
+  static void fn##_text(const bench_trace_t *trace) {                                 \
+    bench_rtt_text(trace->flags,                                                      \
+                   snprintf(timestamped_msg, TIMESTAMP_MSG_LEN, trace->format, __VA_ARGS__)); \
+  }
+
+// app.c
+BENCH_TRACE(bench_join_state, "[Join state %u->%u]\n", 4U, 5U)
+BENCH_TRACE(bench_reconnected, "Reconnected after %llu sec\n", 3605ULL)
+BENCH_TRACE(bench_heap, "heap free %8d used %8d %6.2f%% (free diff %5d)\n",
+            51234, 78122, 1.0 * 78122 / (129356 / 100), -120)
+BENCH_TRACE(bench_joining,
+            "Joining Network[%d]: \"%s\": %s]\r\n", 0, BENCH_NETWORK_NAME, BENCH_PHY)
+BENCH_TRACE(bench_neighbor_sizes,
+            "[Failed: unable to set neighbor table sizes (%d, %d, %d): %lu]\r\n", 22, 32, 64, 0x0021UL)
+BENCH_TRACE(bench_udp_dest,
+            "UDP  Notification destination: %s/%5d\n", BENCH_IPV6, 1237)
+BENCH_TRACE(bench_neighbor_count,
+            "[Failed: sl_wisun_get_neighbor_count() returned 0x%04x]\n", (uint16_t)0x0003)
+// app_coap.c
+BENCH_TRACE(bench_coap_request,
+            "coap_request code %d, payload %.*s\n", 3, (int)strlen(BENCH_COAP_PAYLOAD), BENCH_COAP_PAYLOAD)
+// app_direct_connect.c
+BENCH_TRACE(bench_direct_connect,
+            "Direct Connect Link Connected with %s\r\n", BENCH_IPV6)
+// app_parameters.c
+BENCH_TRACE(bench_network_name,
+            "network[%d] network_name     %s\n", 0, BENCH_NETWORK_NAME)
+
+#define BENCH_ENTRY(fn, flags, args_len) { #fn + 6, fn##_format, flags, args_len, fn, fn##_text }
+#define T APP_TRACE_TOKEN_FLAG_TIME
+
+static const bench_trace_t bench_traces[] = {
+  BENCH_ENTRY(bench_join_state,     T, 8),
+  BENCH_ENTRY(bench_reconnected,    T, 8),
+  BENCH_ENTRY(bench_heap,           T, 20),
+  BENCH_ENTRY(bench_joining,        T, 4 + sizeof(BENCH_NETWORK_NAME) + sizeof(BENCH_PHY)),
+  BENCH_ENTRY(bench_neighbor_sizes, 0, 16),
+  BENCH_ENTRY(bench_udp_dest,       T, sizeof(BENCH_IPV6) + 4),
+  BENCH_ENTRY(bench_neighbor_count, T, 4),
+  BENCH_ENTRY(bench_coap_request,   T, 8 + sizeof(BENCH_COAP_PAYLOAD)),
+  BENCH_ENTRY(bench_direct_connect, T, sizeof(BENCH_IPV6)),
+  BENCH_ENTRY(bench_network_name,   0, 4 + sizeof(BENCH_NETWORK_NAME)),
+};
+
+// Header and size of the last record of 'trace'
+static bool bench_check_record(const bench_trace_t *trace) {
+  uint32_t address;
+
+  memcpy(&address, bench_record + APP_TRACE_TOKEN_HEADER_LEN, sizeof(address));
+  return (bench_record_len == APP_TRACE_TOKEN_HEADER_LEN + sizeof(address) + trace->args_len)
+         && (bench_record[0] == APP_TRACE_TOKEN_SYNC)
+         && ((unsigned)(bench_record[1] | (bench_record[2] << 8)) == bench_record_len - 3)
+         && (bench_record[3] == trace->flags)
+         && (address == (uint32_t)(uintptr_t)trace->format);
+}
+
+int main(int argc, char **argv) {
+  uint32_t reps = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100000;
+  const bench_trace_t *trace;
+  char counters[160];
+  unsigned long records = 0;
+  unsigned long dropped = 0;
+  unsigned long long bytes = 0;
+  uint64_t calls = 0;
+  uint64_t text_bytes, token_bytes;
+  uint64_t start, text_ns, token_ns;
+  uint32_t errors = 0;
+  uint32_t r;
+  size_t i;
+
+  reps = MAX(reps, 1);
+  app_timestamp_init();
+  // now_str() of a device running for 3 days
+  host_sleeptimer_ticks = 3ULL * 86400 * HOST_SLEEPTIMER_FREQUENCY + 12345;
+  app_trace_tokens_reset();
+  printf("printfBoth()/printfBothTime() traces, %u repetitions, RTT bytes and host ns per call\n", reps);
+  printf("%-16s %10s %12s %7s %8s %9s\n", "call", "text bytes", "record bytes", "record",
+         "text ns", "token ns");
+  for (i = 0; i < sizeof(bench_traces) / sizeof(bench_traces[0]); i++) {
+    trace = &bench_traces[i];
+
+    text_bytes = bench_rtt_bytes[0];
+    start = bench_ns();
+    for (r = 0; r < reps; r++) {
+      trace->text(trace);
+    }
+    text_ns = bench_ns() - start;
+    text_bytes = bench_rtt_bytes[0] - text_bytes;
+
+    token_bytes = bench_rtt_bytes[APP_TRACE_TOKENS_RTT_CHANNEL];
+    start = bench_ns();
+    for (r = 0; r < reps; r++) {
+      trace->token(trace);
+    }
+    token_ns = bench_ns() - start;
+    token_bytes = bench_rtt_bytes[APP_TRACE_TOKENS_RTT_CHANNEL] - token_bytes;
+    calls += reps;
+
+    if (!bench_check_record(trace)) {
+      printf("%s: record of %u bytes, flags 0x%02x, not as expected\n", trace->name, bench_record_len,
+             bench_record[3]);
+      errors++;
+    }
+    printf("%-16s %10.1f %12.1f %6.0f%% %8.1f %9.1f\n", trace->name, (double)text_bytes / reps,
+           (double)token_bytes / reps, 100.0 * token_bytes / text_bytes, (double)text_ns / reps,
+           (double)token_ns / reps);
+  }
+  app_trace_tokens_string(counters, sizeof(counters));
+  printf("%s\n", counters);
+  if ((sscanf(counters, "{\"records\":%lu,\"dropped\":%lu,\"bytes\":%llu", &records, &dropped, &bytes) != 3)
+      || (records != calls) || dropped || (bytes != bench_rtt_bytes[APP_TRACE_TOKENS_RTT_CHANNEL])) {
+    printf("app_trace_tokens_string() counters don't match the %llu records written\n",
+           (unsigned long long)calls);
+    errors++;
+  }
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+#!/usr/bin/env python
+# Decodes the tokenized traces of the Wi-SUN Node Monitoring application
+#  (built with APP_TRACE_TOKENS, see app_timestamp.h)
+# Call with
+# trace_token_decoder.py <application .axf/.out file> <records file> [-f]
+
+import struct
+import sys
+import time
+
+help_text = """
+# Capture RTT channel 1 (APP_TRACE_TOKENS_RTT_CHANNEL) in a file, then decode it with the application file
+#  JLinkRTTLogger -Device EFR32FG25BxxxF1920 -If SWD -Speed 4000 -RTTChannel 1 tokens.bin
+#  trace_token_decoder.py wisun_node_monitoring.axf tokens.bin
+# '-f' keeps reading the file while it's written
+#  trace_token_decoder.py wisun_node_monitoring.axf tokens.bin -f
+"""
+
+# Must match app_timestamp.h
+TOKEN_SYNC = 0xA7
+TOKEN_HEADER_LEN = 8
+FLAG_TIME = 1 << 0
+FLAG_TEXT = 1 << 1
+FLAG_TRUNCATED = 1 << 2
+
+class ElfStrings:
+  """ Strings of the allocated sections of an ELF32 little endian file, by address """
+  def __init__(self, path):
+    with open(path, "rb") as f:
+      self.data = f.read()
+    if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+      raise ValueError(f"{path} is not an ELF32 little endian file")
+    shoff, = struct.unpack_from("<I", self.data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+    self.sections = []
+    for i in range(shnum):
+      _, sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from("<IIIIII", self.data, shoff + i * shentsize)
+      # SHT_PROGBITS, SHF_ALLOC
+      if sh_type == 1 and sh_flags & 0x2 and sh_addr:
+        self.sections.append((sh_addr, sh_offset, sh_size))
+
+  def string(self, address):
+    for sh_addr, sh_offset, sh_size in self.sections:
+      if sh_addr <= address < sh_addr + sh_size:
+        start = sh_offset + address - sh_addr
+        end = self.data.index(b"\0", start)
+        return self.data[start:end].decode("utf-8", errors="replace")
+    return None
+
+def format_record(format, args):
+  """ Rebuilds the text of 'format' with the binary 'args', parsed like _app_trace_token_args() """
+  out = []
+  pos = 0
+  i = 0
+  n = len(format)
+  def take(size, kind):
+    nonlocal pos
+    value, = struct.unpack_from(kind, args, pos)
+    pos += size
+    return value
+  while i < n:
+    c = format[i]
+    if c != '%':
+      out.append(c)
+      i += 1
+      continue
+    i += 1
+    if i < n and format[i] == '%':
+      out.append('%')
+      i += 1
+      continue
+    spec = "%"
+    while i < n and format[i] in "-+ #0":
+      spec += format[i]
+      i += 1
+    if i < n and format[i] == '*':
+      spec += str(take(4, "<i"))
+      i += 1
+    else:
+      while i < n and format[i].isdigit():
+        spec += format[i]
+        i += 1
+    if i < n and format[i] == '.':
+      spec += '.'
+      i += 1
+      if i < n and format[i] == '*':
+        spec += str(max(take(4, "<i"), 0))
+        i += 1
+      else:
+        while i < n and format[i].isdigit():
+          spec += format[i]
+          i += 1
+    long_long = False
+    if format[i:i+2] in ("hh", "ll"):
+      long_long = format[i] == 'l'
+      i += 2
+    elif i < n and format[i] in "hljztL":
+      long_long = format[i] == 'j'
+      i += 1
+    if i >= n:
+      break
+    conversion = format[i]
+    i += 1
+    if conversion in "diuxXoc":
+      if long_long:
+        value = take(8, "<q" if conversion in "di" else "<Q")
+      else:
+        value = take(4, "<i" if conversion in "di" else "<I")
+      if conversion == 'c':
+        out.append(chr(value & 0xFF))
+      else:
+        out.append((spec + conversion.replace('u', 'd').replace('i', 'd')) % value)
+    elif conversion == 'p':
+      out.append("0x%x" % take(4, "<I"))
+    elif conversion in "fFeEgGaA":
+      value = take(8, "<d")
+      out.append((spec + conversion.replace('a', 'e').replace('A', 'E')) % value)
+    elif conversion == 's':
+      end = args.index(b"\0", pos)
+      value = args[pos:end].decode("utf-8", errors="replace")
+      pos = end + 1
+      out.append((spec + 's') % value)
+    elif conversion == 'n':
+      pass
+    else:
+      break
+  return "".join(out)
+
+def dhms(msec):
+  secs = msec // 1000
+  return f"{secs // 86400}-{secs // 3600 % 24:02d}:{secs // 60 % 60:02d}:{secs % 60:02d}.{msec % 1000:03d}"
+
+def records(stream, follow):
+  """ Yields the records of 'stream': (flags, msec, payload), resynchronizing on TOKEN_SYNC """
+  buffer = b""
+  while True:
+    chunk = stream.read(4096)
+    if not chunk:
+      if not follow:
+        return
+      time.sleep(0.1)
+      continue
+    buffer += chunk
+    while len(buffer) >= TOKEN_HEADER_LEN:
+      if buffer[0] != TOKEN_SYNC:
+        sync = buffer.find(bytes([TOKEN_SYNC]))
+        buffer = buffer[sync:] if sync >= 0 else b""
+        continue
+      length = buffer[1] | (buffer[2] << 8)
+      if len(buffer) < length + 3:
+        break
+      flags = buffer[3]
+      msec, = struct.unpack_from("<I", buffer, 4)
+      yield flags, msec, buffer[TOKEN_HEADER_LEN:length + 3]
+      buffer = buffer[length + 3:]
+
+if len(sys.argv) < 3:
+  print(f"{help_text}")
+  quit()
+
+elf = ElfStrings(sys.argv[1])
+follow = "-f" in sys.argv[3:]
+
+record_count = 0
+record_bytes = 0
+text_bytes = 0
+decode_ns = 0
+unknown_count = 0
+
+try:
+  with open(sys.argv[2], "rb") as stream:
+    for flags, msec, payload in records(stream, follow):
+      start_ns = time.perf_counter_ns()
+      if flags & FLAG_TEXT:
+        text = payload.decode("utf-8", errors="replace")
+      else:
+        address, = struct.unpack_from("<I", payload, 0)
+        format = elf.string(address)
+        if format is None:
+          unknown_count += 1
+          text = f"<unknown format 0x{address:08x}>\n"
+        else:
+          try:
+            text = format_record(format, payload[4:])
+          except (struct.error, ValueError, TypeError) as e:
+            text = f"<{e} decoding '{format.strip()}'>\n"
+      if flags & FLAG_TIME:
+        text = f"[{dhms(msec)}] {text}"
+      if flags & FLAG_TRUNCATED:
+        text = text.rstrip("\n") + " <truncated>\n"
+      decode_ns += time.perf_counter_ns() - start_ns
+      record_count += 1
+      record_bytes += TOKEN_HEADER_LEN + len(payload)
+      text_bytes += len(text.encode("utf-8"))
+      print(text, end="", flush=True)
+except KeyboardInterrupt:
+  pass
+
+if record_count:
+  print(f"\n{record_count} records ({unknown_count} unknown formats): {record_bytes} bytes "
+        f"({record_bytes / record_count:.1f}/record) for {text_bytes} bytes of text ({text_bytes / record_count:.1f}/line, "
+        f"{text_bytes / record_bytes:.1f}x), decoding {decode_ns / 1000 / record_count:.1f} us/record", file=sys.stderr)
@@ -2,13 +2,223 @@
 # Used to receive UDP notifications strings
 # Call with
 # udp_notification_receiver.py 1237 " "
+# Binary (TLV) notifications (see app_tlv.h) are decoded to the same JSON text
 
 import socket
 import os
 import sys
 import datetime
+import ipaddress
 import traceback
 
+# Mirror of APP_TLV_FIELDS in app_tlv.h: id: (json key, value type)
+TLV_MAGIC   = 0xB5
+TLV_VERSION = 1
+TLV_MSG_STATUS_DELTA = 3
+TLV_MSG_BATCH        = 4
+TLV_ID_RUNNING       = 12
+TLV_ID_SEQ           = 38
+TLV_ID_KEYFRAME_SEQ  = 39
+TLV_ID_SAMPLE        = 40
+TLV_FIELDS = {
+   1: ("ipv6"                          , "IPV6"),
+   2: ("device"                        , "STR"),
+   3: ("chip"                          , "STR"),
+   4: ("type"                          , "STR"),
+   5: ("MAC"                           , "MAC"),
+   6: ("parent"                        , "STR"),
+   7: ("rpl_rank"                      , "UINT"),
+   8: ("etx"                           , "UINT"),
+   9: ("routing_cost"                  , "UINT"),
+  10: ("rsl_in"                        , "UINT"),
+  11: ("rsl_out"                       , "UINT"),
+  12: ("running"                       , "DHMS"),
+  13: ("msg_count"                     , "UINT"),
+  14: ("heap_used"                     , "CENTI"),
+  15: ("join_state"                    , "UINT"),
+  16: ("connected"                     , "DHMS"),
+  17: ("disconnected"                  , "DHMS"),
+  18: ("connections"                   , "UINT"),
+  19: ("network_connections"           , "UINT"),
+  20: ("availability"                  , "CENTI"),
+  21: ("connected_total"               , "DHMS"),
+  22: ("disconnected_total"            , "DHMS"),
+  23: ("hop_count"                     , "UINT"),
+  24: ("phy.crc_fails"                 , "UINT"),
+  25: ("phy.tx_timeouts"               , "UINT"),
+  26: ("phy.rx_timeouts"               , "UINT"),
+  27: ("mac.failed_cca_count"          , "UINT"),
+  28: ("mac.tx_count"                  , "UINT"),
+  29: ("mac.tx_failed_count"           , "UINT"),
+  30: ("mac.rx_count"                  , "UINT"),
+  31: ("mac.rx_availability_percentage", "UINT"),
+  32: ("network.ip_no_route"           , "UINT"),
+  33: ("network.ip_routeloop_detect"   , "UINT"),
+  34: ("PAN_ID"                        , "HEX16"),
+  35: ("preferred_pan_id"              , "HEX16"),
+  36: ("join_states_sec"               , "UINT_LIST"),
+  37: ("application"                   , "STR"),
+  38: ("seq"                           , "UINT"),
+  39: ("keyframe_seq"                  , "UINT"),
+  40: ("sample"                        , "RECORD"),
+  41: ("version"                       , "STR"),
+  42: ("board"                         , "STR"),
+  43: ("neighbor_count"                , "UINT"),
+  44: ("parent.mac_tx_count"           , "UINT"),
+  45: ("parent.mac_tx_failed_count"    , "UINT"),
+  46: ("secondary"                     , "STR"),
+  47: ("secondary.rpl_rank"            , "UINT"),
+  48: ("secondary.etx"                 , "UINT"),
+  49: ("secondary.rsl_in"              , "UINT"),
+  50: ("secondary.rsl_out"             , "UINT"),
+  51: ("secondary.mac_tx_count"        , "UINT"),
+  52: ("secondary.mac_tx_failed_count" , "UINT"),
+  53: ("fhss.drift_compensation"       , "SINT"),
+  54: ("fhss.hop_count"                , "UINT"),
+  55: ("fhss.synch_interval"           , "UINT"),
+  56: ("fhss.prev_avg_synch_fix"       , "SINT"),
+  57: ("fhss.synch_lost"               , "UINT"),
+  58: ("fhss.unknown_neighbor"         , "UINT"),
+  59: ("wisun.pan_control_tx_count"    , "UINT"),
+  60: ("wisun.pan_control_rx_count"    , "UINT"),
+  61: ("regulation.arib.tx_duration_ms", "UINT"),
+}
+
+# Delta-encoded status messages, per device address
+keyframes = {}  # addr: (keyframe seq, [(field id, value bytes)])
+last_seqs = {}  # addr: last seq received
+
+def read_varints(value):
+  numbers = []
+  number = 0
+  shift = 0
+  for byte in value:
+    number |= (byte & 0x7f) << shift
+    shift += 7
+    if not (byte & 0x80):
+      numbers.append(number)
+      number = 0
+      shift = 0
+  return numbers
+
+def dhms(secs):
+  days, secs = divmod(secs, 86400)
+  hours, secs = divmod(secs, 3600)
+  mins, secs = divmod(secs, 60)
+  return f"{days}-{hours:02d}:{mins:02d}:{secs:02d}"
+
+def tlv_value_string(value_type, value):
+  if value_type == "STR":
+    return value.decode("utf-8", errors="replace")
+  if value_type == "IPV6":
+    return str(ipaddress.IPv6Address(bytes(value)))
+  if value_type == "MAC":
+    return ":".join(f"{byte:02x}" for byte in value)
+  numbers = read_varints(value)
+  if value_type == "UINT_LIST":
+    return " ".join(str(number) for number in numbers)
+  number = numbers[0] if numbers else 0
+  if value_type == "SINT":
+    return str((number >> 1) ^ -(number & 1))
+  if value_type == "HEX16":
+    return f"0x{number:04x} ({number})"
+  if value_type == "CENTI":
+    return f"{number/100:6.2f}"
+  if value_type == "DHMS":
+    return dhms(number)
+  return str(number)
+
+def tlv_fields(data, i=3):
+  fields = []
+  while i + 2 <= len(data):
+    length = data[i+1]
+    fields.append((data[i], data[i+2:i+2+length]))
+    i += 2 + length
+  return fields
+
+def tlv_seq(fields, field_id):
+  """Pop the leading sequence number field, None if not present"""
+  if fields and fields[0][0] == field_id:
+    return read_varints(fields.pop(0)[1])[0]
+  return None
+
+def tlv_rebuild(fields, addr):
+  """Rebuild the complete field list of a status message, None if its keyframe is missing"""
+  seq = tlv_seq(fields, TLV_ID_SEQ)
+  keyframe_seq = tlv_seq(fields, TLV_ID_KEYFRAME_SEQ)
+  if seq is None:
+    # Not delta-encoded
+    return fields
+  last_seq = last_seqs.get(addr)
+  if last_seq is not None and seq > last_seq + 1:
+    print(f"{addr}: {seq - last_seq - 1} status messages lost (seq {last_seq} -> {seq})", flush=True)
+  if last_seq is not None and seq <= last_seq:
+    print(f"{addr}: sequence restarted (seq {last_seq} -> {seq})", flush=True)
+  last_seqs[addr] = seq
+  if keyframe_seq is None:
+    keyframes[addr] = (seq, fields)
+    return fields
+  keyframe = keyframes.get(addr)
+  if keyframe is None or keyframe[0] != keyframe_seq:
+    print(f"{addr}: missing keyframe {keyframe_seq} for delta {seq}, waiting for the next keyframe", flush=True)
+    return None
+  changed = dict(fields)
+  return [(field_id, changed.get(field_id, value)) for field_id, value in keyframe[1]]
+
+def tlv_batch(fields):
+  """Rebuild one JSON text per batched sample, time-stamped from its 'running' time"""
+  batch_running = None
+  samples = []
+  for field_id, value in fields:
+    if field_id == TLV_ID_SAMPLE:
+      samples.append(tlv_fields(value, 0))
+    elif field_id == TLV_ID_RUNNING:
+      batch_running = read_varints(value)[0]
+  now = datetime.datetime.now()
+  text = ""
+  for sample in samples:
+    items = []
+    running = dict(sample).get(TLV_ID_RUNNING)
+    if batch_running is not None and running is not None:
+      sample_time = now - datetime.timedelta(seconds=batch_running - read_varints(running)[0])
+      items.append(("sample_time", sample_time.strftime('%Y-%m-%d %H:%M:%S')))
+    text += tlv_json(sample, items)
+  return text
+
+def tlv_decode(data, addr):
+  """Rebuild the JSON text of a TLV notification, as sent by the device in JSON format"""
+  if len(data) < 3 or data[0] != TLV_MAGIC or data[1] != TLV_VERSION:
+    raise ValueError(f"not a TLV v{TLV_VERSION} message")
+  if data[2] == TLV_MSG_BATCH:
+    return tlv_batch(tlv_fields(data))
+  fields = tlv_rebuild(tlv_fields(data), addr[0])
+  if fields is None:
+    return None
+  return tlv_json(fields)
+
+def tlv_json(fields, items=None):
+  """JSON text of a complete status or connection field list"""
+  items = list(items or [])
+  join_state = None
+  for field_id, value in fields:
+    if field_id not in TLV_FIELDS:
+      items.append((f"field_{field_id}", value.hex()))
+      continue
+    key, value_type = TLV_FIELDS[field_id]
+    value_string = tlv_value_string(value_type, value)
+    # 'join_state' is only sent to rebuild the 'connected'/'disconnected' strings
+    if key == "join_state":
+      join_state = value_string
+    elif key == "connected":
+      items.append(("connected", value_string))
+      items.append(("disconnected", "no"))
+    elif key == "disconnected":
+      items.append(("connected", f" no (join_state {join_state})"))
+      items.append(("disconnected", value_string))
+    else:
+      items.append((key, value_string))
+  return "{\n" + ",\n".join(f"\"{key}\":\"{value}\"" for key, value in items) + "\n}\n"
+
 HOST_IP = "::" # Host own address (tun0 IPv6 address)
 
 rcv_port = int(sys.argv[1])
@@ -55,14 +265,20 @@ while True:
   now = datetime.datetime.now()
   now_str = str(now.strftime('%Y-%m-%d %H:%M:%S'))
 
+  message_string = None
   try:
-    message_string = data.decode("utf-8").replace(" ", space).replace("\n", newline)
-    print (f"[{now_str}] Rx {PORT}: {newline}", message_string, flush=True)
+    if len(data) and data[0] == TLV_MAGIC:
+      json_string = tlv_decode(data, addr)
+    else:
+      json_string = data.decode("utf-8")
+    if json_string is not None:
+      message_string = json_string.replace(" ", space).replace("\n", newline)
+      print (f"[{now_str}] Rx {PORT}: {newline}", message_string, flush=True)
   except Exception as e:
     print(f"Exception {e} (from {addr})", flush=True)
     print(traceback.format_exc())
 
-  if monitoring_path:
+  if monitoring_path and message_string is not None:
     try:
       device_path        = os.path.join(monitoring_path, f"{addr_string}")
 